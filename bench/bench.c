@@ -0,0 +1,31 @@
+#include <stdlib.h>
+
+#include "harness.h"
+
+int main(int argc, const char* argv[])
+{
+    bench_options_t options = bench_parse_options(argc, argv);
+
+    const struct {
+        const bench_case_t* cases;
+        size_t count;
+    } suites[] = {
+        { LIST_CASES, LIST_CASES_COUNT },
+        { TREE_CASES, TREE_CASES_COUNT },
+    };
+
+    // All suites run as one, so they share a single table and JSON file
+    size_t total = 0;
+    for (size_t i = 0; i < sizeof(suites) / sizeof(suites[0]); i++)
+        total += suites[i].count;
+    bench_case_t* cases = malloc(total * sizeof(bench_case_t));
+    size_t count = 0;
+    for (size_t i = 0; i < sizeof(suites) / sizeof(suites[0]); i++) {
+        for (size_t j = 0; j < suites[i].count; j++)
+            cases[count++] = suites[i].cases[j];
+    }
+
+    bool ok = bench_run_suite(&options, cases, count);
+    free(cases);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
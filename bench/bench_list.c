@@ -0,0 +1,130 @@
+#include <stdlib.h>
+
+#include "harness.h"
+#include "list.h"
+
+/**
+ * @file bench_list.c
+ *
+ * Singly linked list benchmarks. Lookups are positional, using the key as index, because that is
+ * the only lookup the list offers. Lookups and deletions walk the list, so they are capped to a
+ * sample of the keys and to sizes where that stays affordable.
+ */
+
+#define LIST_SCAN_OPS 1000
+#define LIST_SCAN_MAX_SIZE 100000
+
+typedef struct list_state {
+    ll_uint32_t list;
+    ll_node_uint32_t* cursor;
+} list_state_t;
+
+//--------------------------------------------------
+// Helper functions
+
+static void* _setup_empty(const uint32_t* keys, size_t size)
+{
+    list_state_t* state = malloc(sizeof(list_state_t));
+    state->list = ll_new_list_uint32_t();
+    state->cursor = nullptr;
+    return state;
+}
+
+static void* _setup_filled(const uint32_t* keys, size_t size)
+{
+    list_state_t* state = _setup_empty(keys, size);
+    for (size_t i = 0; i < size; i++)
+        ll_add_value_uint32_t(&state->list, keys[i]);
+    state->cursor = state->list.head;
+    return state;
+}
+
+static void _teardown(void* state)
+{
+    ll_clear_list_uint32_t(&((list_state_t*)state)->list);
+    free(state);
+}
+
+static void _run_insert(void* state, const uint32_t* op_keys, size_t begin, size_t end)
+{
+    list_state_t* s = state;
+    for (size_t i = begin; i < end; i++)
+        ll_add_value_uint32_t(&s->list, op_keys[i]);
+}
+
+static void _run_lookup(void* state, const uint32_t* op_keys, size_t begin, size_t end)
+{
+    list_state_t* s = state;
+    uint64_t sum = 0;
+    for (size_t i = begin; i < end; i++) {
+        Result_uint32_t value_result = ll_get_uint32_t(&s->list, op_keys[i]);
+        sum += Result_uint32_t_unwrap_or(&value_result, 0);
+    }
+    bench_sink += sum;
+}
+
+static void _run_delete(void* state, const uint32_t* op_keys, size_t begin, size_t end)
+{
+    list_state_t* s = state;
+    for (size_t i = begin; i < end; i++)
+        ll_del_value_uint32_t(&s->list, op_keys[i]);
+}
+
+/**
+ * @brief Steps the cursor over end - begin nodes, starting over at the head after the tail
+ */
+static void _run_iterate(void* state, const uint32_t* op_keys, size_t begin, size_t end)
+{
+    list_state_t* s = state;
+    ll_node_uint32_t* cur = s->cursor;
+    uint64_t sum = 0;
+    for (size_t i = begin; i < end; i++) {
+        if (cur == nullptr)
+            cur = s->list.head;
+        sum += cur->value;
+        cur = cur->next;
+    }
+    s->cursor = cur;
+    bench_sink += sum;
+}
+
+//--------------------------------------------------
+
+const bench_case_t LIST_CASES[] = {
+    {
+        .structure = "ll",
+        .operation = "insert",
+        .setup = _setup_empty,
+        .run = _run_insert,
+        .teardown = _teardown,
+    },
+    {
+        .structure = "ll",
+        .operation = "lookup",
+        .setup = _setup_filled,
+        .run = _run_lookup,
+        .teardown = _teardown,
+        .max_ops = LIST_SCAN_OPS,
+        .max_size = { LIST_SCAN_MAX_SIZE, LIST_SCAN_MAX_SIZE, LIST_SCAN_MAX_SIZE },
+        .read_only = true,
+    },
+    {
+        .structure = "ll",
+        .operation = "delete",
+        .setup = _setup_filled,
+        .run = _run_delete,
+        .teardown = _teardown,
+        .max_ops = LIST_SCAN_OPS,
+        .max_size = { LIST_SCAN_MAX_SIZE, LIST_SCAN_MAX_SIZE, LIST_SCAN_MAX_SIZE },
+    },
+    {
+        .structure = "ll",
+        .operation = "iterate",
+        .setup = _setup_filled,
+        .run = _run_iterate,
+        .teardown = _teardown,
+        .read_only = true,
+    },
+};
+
+const size_t LIST_CASES_COUNT = sizeof(LIST_CASES) / sizeof(LIST_CASES[0]);
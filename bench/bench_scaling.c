@@ -0,0 +1,510 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "concurrent_tree.h"
+#include "skiplist.h"
+#include "tree.h"
+#include "utils/panic.h"
+
+/**
+ * @file bench_scaling.c
+ *
+ * Read scaling benchmark of the trees and the skip list.
+ *
+ * A structure is filled with the even keys of [0, 2 * size) in random order, then 1 up to max
+ * threads look up random keys of that range at the same time, half of them hits. Optionally one
+ * more thread keeps inserting and deleting odd keys during the whole run. The reported throughput
+ * only counts lookups, so it shows how much readers get in each other's and the writer's way.
+ *
+ * The binary tree is benchmarked behind one process-wide mutex and behind one process-wide
+ * reader-writer lock, the concurrent tree with its per-node locks and the concurrent skip list
+ * with its lock-free searches.
+ */
+
+typedef struct scaling_options {
+    size_t size;
+    size_t ops;
+    int max_threads;
+    int repetitions;
+    const char* json_path;
+} scaling_options_t;
+
+/**
+ * @brief A tree together with the operations of one locking scheme
+ */
+typedef struct scaling_case {
+    const char* structure;
+    void* (*setup)(const uint32_t* keys, size_t size);
+    bool (*contains)(void* state, uint32_t key);
+    void (*update)(void* state, uint32_t key, bool insert);
+    void (*teardown)(void* state);
+    /**
+     * @brief Optional, creates the state a thread passes to contains and update instead of the
+     *        shared one, e.g. to register the thread. detach releases it
+     */
+    void* (*attach)(void* state);
+    void (*detach)(void* thread_state);
+} scaling_case_t;
+
+typedef struct locked_tree {
+    bt_uint32_t tree;
+    pthread_mutex_t mutex;
+    pthread_rwlock_t rwlock;
+} locked_tree_t;
+
+/**
+ * @brief A skip list together with the epoch handle of one thread
+ */
+typedef struct attached_list {
+    csl_uint32_t* list;
+    ebr_thread_t* thread;
+} attached_list_t;
+
+typedef struct scaling_thread {
+    const scaling_case_t* bench;
+    void* state;
+    size_t size;
+    size_t ops;
+    uint64_t seed;
+    uint64_t found;
+    pthread_barrier_t* start;
+    atomic_bool* stop;
+} scaling_thread_t;
+
+//--------------------------------------------------
+// Helper functions
+
+static uint64_t _now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief splitmix64, the same generator the single-threaded harness uses
+ */
+static uint64_t _next_random(uint64_t* state)
+{
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+static void* _setup_locked(const uint32_t* keys, size_t size)
+{
+    locked_tree_t* state = malloc(sizeof(locked_tree_t));
+    state->tree = bt_new_uint32_t();
+    pthread_mutex_init(&state->mutex, nullptr);
+    pthread_rwlock_init(&state->rwlock, nullptr);
+    for (size_t i = 0; i < size; i++)
+        bt_add_value_uint32_t(&state->tree, keys[i]);
+    return state;
+}
+
+static bool _contains_mutex(void* state, uint32_t key)
+{
+    locked_tree_t* s = state;
+    pthread_mutex_lock(&s->mutex);
+    bool found = bt_contains_uint32_t(&s->tree, key);
+    pthread_mutex_unlock(&s->mutex);
+    return found;
+}
+
+static void _update_mutex(void* state, uint32_t key, bool insert)
+{
+    locked_tree_t* s = state;
+    pthread_mutex_lock(&s->mutex);
+    if (insert) {
+        bt_add_value_uint32_t(&s->tree, key);
+    } else {
+        bt_del_value_uint32_t(&s->tree, key);
+    }
+    pthread_mutex_unlock(&s->mutex);
+}
+
+static bool _contains_rwlock(void* state, uint32_t key)
+{
+    locked_tree_t* s = state;
+    pthread_rwlock_rdlock(&s->rwlock);
+    bool found = bt_contains_uint32_t(&s->tree, key);
+    pthread_rwlock_unlock(&s->rwlock);
+    return found;
+}
+
+static void _update_rwlock(void* state, uint32_t key, bool insert)
+{
+    locked_tree_t* s = state;
+    pthread_rwlock_wrlock(&s->rwlock);
+    if (insert) {
+        bt_add_value_uint32_t(&s->tree, key);
+    } else {
+        bt_del_value_uint32_t(&s->tree, key);
+    }
+    pthread_rwlock_unlock(&s->rwlock);
+}
+
+static void _teardown_locked(void* state)
+{
+    locked_tree_t* s = state;
+    bt_clear_uint32_t(&s->tree);
+    pthread_mutex_destroy(&s->mutex);
+    pthread_rwlock_destroy(&s->rwlock);
+    free(s);
+}
+
+static void* _setup_concurrent(const uint32_t* keys, size_t size)
+{
+    cbt_uint32_t* tree = malloc(sizeof(cbt_uint32_t));
+    cbt_init_uint32_t(tree);
+    for (size_t i = 0; i < size; i++)
+        cbt_add_value_uint32_t(tree, keys[i]);
+    return tree;
+}
+
+static bool _contains_concurrent(void* state, uint32_t key)
+{
+    return cbt_contains_uint32_t(state, key);
+}
+
+static void _update_concurrent(void* state, uint32_t key, bool insert)
+{
+    if (insert) {
+        cbt_add_value_uint32_t(state, key);
+    } else {
+        cbt_del_value_uint32_t(state, key);
+    }
+}
+
+static void _teardown_concurrent(void* state)
+{
+    cbt_clear_uint32_t(state);
+    free(state);
+}
+
+static void* _setup_skiplist(const uint32_t* keys, size_t size)
+{
+    csl_uint32_t* list = malloc(sizeof(csl_uint32_t));
+    *list = csl_new_uint32_t();
+    ebr_thread_t* thread = ebr_register(&list->ebr);
+    for (size_t i = 0; i < size; i++)
+        csl_add_value_uint32_t(list, thread, keys[i]);
+    ebr_unregister(thread);
+    return list;
+}
+
+static void* _attach_skiplist(void* state)
+{
+    attached_list_t* attached = malloc(sizeof(attached_list_t));
+    attached->list = state;
+    attached->thread = ebr_register(&attached->list->ebr);
+    return attached;
+}
+
+static void _detach_skiplist(void* thread_state)
+{
+    attached_list_t* attached = thread_state;
+    ebr_unregister(attached->thread);
+    free(attached);
+}
+
+static bool _contains_skiplist(void* state, uint32_t key)
+{
+    attached_list_t* attached = state;
+    return csl_contains_uint32_t(attached->list, attached->thread, key);
+}
+
+static void _update_skiplist(void* state, uint32_t key, bool insert)
+{
+    attached_list_t* attached = state;
+    if (insert) {
+        csl_add_value_uint32_t(attached->list, attached->thread, key);
+    } else {
+        csl_del_value_uint32_t(attached->list, attached->thread, key);
+    }
+}
+
+static void _teardown_skiplist(void* state)
+{
+    csl_clear_uint32_t(state);
+    free(state);
+}
+
+/**
+ * @brief The state thread passes to the operations, attaching it to the shared state if needed
+ */
+static void* _attach(scaling_thread_t* thread)
+{
+    if (thread->bench->attach == nullptr)
+        return thread->state;
+    return thread->bench->attach(thread->state);
+}
+
+static void _detach(scaling_thread_t* thread, void* state)
+{
+    if (thread->bench->detach != nullptr)
+        thread->bench->detach(state);
+}
+
+static void* _reader(void* arg)
+{
+    scaling_thread_t* thread = arg;
+    void* state = _attach(thread);
+    pthread_barrier_wait(thread->start);
+    uint64_t found = 0;
+    for (size_t i = 0; i < thread->ops; i++) {
+        uint32_t key = _next_random(&thread->seed) % (2 * thread->size);
+        found += thread->bench->contains(state, key);
+    }
+    thread->found = found;
+    _detach(thread, state);
+    return nullptr;
+}
+
+/**
+ * @brief Inserts and then deletes random odd keys until the readers are done
+ */
+static void* _writer(void* arg)
+{
+    scaling_thread_t* thread = arg;
+    void* state = _attach(thread);
+    pthread_barrier_wait(thread->start);
+    while (!atomic_load(thread->stop)) {
+        uint32_t key = (_next_random(&thread->seed) % thread->size) * 2 + 1;
+        thread->bench->update(state, key, true);
+        thread->bench->update(state, key, false);
+    }
+    _detach(thread, state);
+    return nullptr;
+}
+
+/**
+ * @brief Runs threads readers and optionally a writer once, returning the lookups per second
+ */
+static double _run_once(
+    const scaling_case_t* bench,
+    void* state,
+    const scaling_options_t* options,
+    const int threads,
+    const bool writer)
+{
+    int total = threads + (writer ? 1 : 0);
+    pthread_t* ids = malloc(total * sizeof(pthread_t));
+    scaling_thread_t* args = malloc(total * sizeof(scaling_thread_t));
+    pthread_barrier_t start;
+    pthread_barrier_init(&start, nullptr, total + 1);
+    atomic_bool stop = false;
+
+    for (int i = 0; i < total; i++) {
+        args[i] = (scaling_thread_t) {
+            .bench = bench,
+            .state = state,
+            .size = options->size,
+            .ops = options->ops,
+            .seed = 42 + i,
+            .start = &start,
+            .stop = &stop,
+        };
+        if (pthread_create(&ids[i], nullptr, (i < threads) ? _reader : _writer, &args[i]) != 0)
+            panic("Could not create a benchmark thread");
+    }
+
+    pthread_barrier_wait(&start);
+    uint64_t begin = _now_ns();
+    for (int i = 0; i < threads; i++)
+        pthread_join(ids[i], nullptr);
+    uint64_t elapsed = _now_ns() - begin;
+    atomic_store(&stop, true);
+    if (writer)
+        pthread_join(ids[threads], nullptr);
+
+    pthread_barrier_destroy(&start);
+    free(args);
+    free(ids);
+    return (double)threads * (double)options->ops / ((double)elapsed / 1e9);
+}
+
+static void _print_usage(const char* program)
+{
+    fprintf(
+        stderr,
+        "Usage: %s [options]\n"
+        "  --size N         Number of keys in the structure (default 1000000)\n"
+        "  --ops N          Lookups per reader thread (default 1000000)\n"
+        "  --threads N      Largest number of reader threads, doubling from 1 (default 8)\n"
+        "  --reps N         Timed repetitions, the best one is reported (default 3)\n"
+        "  --json FILE      Also write the results as JSON to FILE\n",
+        program);
+}
+
+static size_t _parse_number(const char* program, const char* text)
+{
+    char* end;
+    unsigned long long value = strtoull(text, &end, 10);
+    if (*text == '\0' || *end != '\0') {
+        _print_usage(program);
+        exit(EXIT_FAILURE);
+    }
+    return value;
+}
+
+static scaling_options_t _parse_options(int argc, const char* argv[])
+{
+    scaling_options_t options = {
+        .size = 1000000,
+        .ops = 1000000,
+        .max_threads = 8,
+        .repetitions = 3,
+        .json_path = nullptr,
+    };
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            _print_usage(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+        const char* value = argv[++i];
+        if (strcmp(argv[i - 1], "--size") == 0) {
+            options.size = _parse_number(argv[0], value);
+        } else if (strcmp(argv[i - 1], "--ops") == 0) {
+            options.ops = _parse_number(argv[0], value);
+        } else if (strcmp(argv[i - 1], "--threads") == 0) {
+            options.max_threads = _parse_number(argv[0], value);
+        } else if (strcmp(argv[i - 1], "--reps") == 0) {
+            options.repetitions = _parse_number(argv[0], value);
+        } else if (strcmp(argv[i - 1], "--json") == 0) {
+            options.json_path = value;
+        } else {
+            _print_usage(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (options.size < 1 || options.max_threads < 1 || options.repetitions < 1) {
+        _print_usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    return options;
+}
+
+//--------------------------------------------------
+
+static const scaling_case_t CASES[] = {
+    {
+        .structure = "bt_mutex",
+        .setup = _setup_locked,
+        .contains = _contains_mutex,
+        .update = _update_mutex,
+        .teardown = _teardown_locked,
+    },
+    {
+        .structure = "bt_rwlock",
+        .setup = _setup_locked,
+        .contains = _contains_rwlock,
+        .update = _update_rwlock,
+        .teardown = _teardown_locked,
+    },
+    {
+        .structure = "cbt",
+        .setup = _setup_concurrent,
+        .contains = _contains_concurrent,
+        .update = _update_concurrent,
+        .teardown = _teardown_concurrent,
+    },
+    {
+        .structure = "csl",
+        .setup = _setup_skiplist,
+        .contains = _contains_skiplist,
+        .update = _update_skiplist,
+        .teardown = _teardown_skiplist,
+        .attach = _attach_skiplist,
+        .detach = _detach_skiplist,
+    },
+};
+
+int main(int argc, const char* argv[])
+{
+    scaling_options_t options = _parse_options(argc, argv);
+
+    // Even keys in random order, so the unbalanced trees end up with logarithmic height
+    uint32_t* keys = malloc(options.size * sizeof(uint32_t));
+    if (keys == nullptr)
+        panic("Out of memory while generating keys");
+    uint64_t seed = 42;
+    for (size_t i = 0; i < options.size; i++)
+        keys[i] = 2 * i;
+    for (size_t i = options.size - 1; i > 0; i--) {
+        size_t j = _next_random(&seed) % (i + 1);
+        uint32_t tmp = keys[i];
+        keys[i] = keys[j];
+        keys[j] = tmp;
+    }
+
+    FILE* json = nullptr;
+    if (options.json_path != nullptr) {
+        json = fopen(options.json_path, "w");
+        if (json == nullptr) {
+            perror(options.json_path);
+            return EXIT_FAILURE;
+        }
+        fprintf(json, "[");
+    }
+
+    printf("%-10s %-7s %7s %14s %8s\n", "structure", "writer", "threads", "lookups/s", "speedup");
+    bool first = true;
+    for (size_t c = 0; c < sizeof(CASES) / sizeof(CASES[0]); c++) {
+        const scaling_case_t* bench = &CASES[c];
+        void* state = bench->setup(keys, options.size);
+        for (int writer = 0; writer <= 1; writer++) {
+            double single = 0;
+            for (int threads = 1; threads <= options.max_threads; threads *= 2) {
+                double best = 0;
+                for (int rep = 0; rep < options.repetitions; rep++) {
+                    double throughput = _run_once(bench, state, &options, threads, writer);
+                    best = (throughput > best) ? throughput : best;
+                }
+                if (threads == 1)
+                    single = best;
+                printf(
+                    "%-10s %-7s %7d %14.0f %7.2fx\n",
+                    bench->structure,
+                    writer ? "yes" : "no",
+                    threads,
+                    best,
+                    best / single);
+                fflush(stdout);
+
+                if (json == nullptr)
+                    continue;
+                fprintf(
+                    json,
+                    "%s\n  {\"structure\": \"%s\", \"writer\": %s, \"threads\": %d, "
+                    "\"size\": %zu, \"ops\": %zu, \"lookups_per_s\": %.0f}",
+                    first ? "" : ",",
+                    bench->structure,
+                    writer ? "true" : "false",
+                    threads,
+                    options.size,
+                    options.ops,
+                    best);
+                first = false;
+            }
+        }
+        bench->teardown(state);
+    }
+    free(keys);
+
+    if (json != nullptr) {
+        fprintf(json, "\n]\n");
+        if (fclose(json) != 0) {
+            perror(options.json_path);
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,346 @@
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "harness.h"
+#include "lsm.h"
+#include "tree.h"
+#include "utils/panic.h"
+
+/**
+ * @file bench_tree.c
+ *
+ * Binary tree benchmarks, with malloc'ed, pooled and array-indexed nodes. The trees don't
+ * rebalance on insertion, so sorted keys build a chain and every insertion walks all of it. Zipfian
+ * keys repeat the hot keys, which end up as chains of duplicates. Both are capped to sizes where
+ * the quadratic setup stays affordable.
+ */
+
+#define TREE_SORTED_MAX_SIZE 10000
+#define TREE_ZIPFIAN_MAX_SIZE 100000
+
+/**
+ * @brief Number of keys per call of the batched lookups
+ */
+#define BATCH_SIZE 256
+
+/**
+ * @brief Directory of the set of the lsm case, emptied before and removed after every repetition
+ */
+#define LSM_DIR "bench_lsm"
+#define LSM_MEMTABLE_LIMIT 16384
+
+typedef struct tree_state {
+    bt_uint32_t tree;
+    bt_iter_uint32_t iter;
+} tree_state_t;
+
+typedef struct frozen_state {
+    bt_frozen_uint32_t frozen;
+} frozen_state_t;
+
+//--------------------------------------------------
+// Helper functions
+
+static tree_state_t* _new_state(bt_uint32_t tree)
+{
+    tree_state_t* state = malloc(sizeof(tree_state_t));
+    state->tree = tree;
+    state->iter = bt_iter_begin_uint32_t(&state->tree);
+    return state;
+}
+
+static void _fill(tree_state_t* state, const uint32_t* keys, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+        bt_add_value_uint32_t(&state->tree, keys[i]);
+    state->iter = bt_iter_begin_uint32_t(&state->tree);
+}
+
+static void* _setup_empty(const uint32_t* keys, size_t size)
+{
+    return _new_state(bt_new_uint32_t());
+}
+
+static void* _setup_filled(const uint32_t* keys, size_t size)
+{
+    tree_state_t* state = _new_state(bt_new_uint32_t());
+    _fill(state, keys, size);
+    return state;
+}
+
+static void* _setup_pooled_empty(const uint32_t* keys, size_t size)
+{
+    return _new_state(bt_new_pooled_uint32_t());
+}
+
+static void* _setup_pooled_filled(const uint32_t* keys, size_t size)
+{
+    tree_state_t* state = _new_state(bt_new_pooled_uint32_t());
+    _fill(state, keys, size);
+    return state;
+}
+
+static void _teardown(void* state)
+{
+    bt_clear_uint32_t(&((tree_state_t*)state)->tree);
+    free(state);
+}
+
+/**
+ * @brief Freezes a filled tree and throws the tree away, only the index is kept
+ */
+static void* _setup_frozen(const uint32_t* keys, size_t size)
+{
+    bt_uint32_t tree = bt_new_pooled_uint32_t();
+    for (size_t i = 0; i < size; i++)
+        bt_add_value_uint32_t(&tree, keys[i]);
+    frozen_state_t* state = malloc(sizeof(frozen_state_t));
+    state->frozen = bt_freeze_uint32_t(&tree);
+    bt_clear_uint32_t(&tree);
+    return state;
+}
+
+static void _teardown_frozen(void* state)
+{
+    bt_frozen_clear_uint32_t(&((frozen_state_t*)state)->frozen);
+    free(state);
+}
+
+static void* _setup_ibt_empty(const uint32_t* keys, size_t size)
+{
+    ibt_uint32_t* tree = malloc(sizeof(ibt_uint32_t));
+    *tree = ibt_new_uint32_t();
+    return tree;
+}
+
+static void* _setup_ibt_filled(const uint32_t* keys, size_t size)
+{
+    ibt_uint32_t* tree = _setup_ibt_empty(keys, size);
+    for (size_t i = 0; i < size; i++)
+        ibt_add_value_uint32_t(tree, keys[i]);
+    return tree;
+}
+
+static void _teardown_ibt(void* state)
+{
+    ibt_clear_uint32_t(state);
+    free(state);
+}
+
+/**
+ * @brief Deletes the directory of the lsm case and the runs in it
+ */
+static void _remove_lsm_dir()
+{
+    DIR* dir = opendir(LSM_DIR);
+    for (struct dirent* entry = (dir != nullptr) ? readdir(dir) : nullptr; entry != nullptr;
+         entry = readdir(dir)) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+            continue;
+        // Room for the directory, the separator and any name, so the path is never truncated
+        char path[sizeof(LSM_DIR) + sizeof(entry->d_name)];
+        snprintf(path, sizeof(path), "%s/%s", LSM_DIR, entry->d_name);
+        remove(path);
+    }
+    if (dir != nullptr)
+        closedir(dir);
+    rmdir(LSM_DIR);
+}
+
+/**
+ * @brief Opens an empty set. Runs left behind by an aborted benchmark are deleted first, so they
+ *        neither count as part of the set nor get merged during the timed run
+ */
+static void* _setup_lsm(const uint32_t* keys, size_t size)
+{
+    _remove_lsm_dir();
+    lsm_set_t* set = malloc(sizeof(lsm_set_t));
+    if (set == nullptr || !lsm_open(set, LSM_DIR, LSM_MEMTABLE_LIMIT))
+        panic("Could not create the set of the lsm case in " LSM_DIR);
+    return set;
+}
+
+/**
+ * @brief Closes the set, which writes the last memtable outside of the timed run, and deletes it
+ */
+static void _teardown_lsm(void* state)
+{
+    lsm_close(state);
+    free(state);
+    _remove_lsm_dir();
+}
+
+static void _run_insert(void* state, const uint32_t* op_keys, size_t begin, size_t end)
+{
+    tree_state_t* s = state;
+    for (size_t i = begin; i < end; i++)
+        bt_add_value_uint32_t(&s->tree, op_keys[i]);
+}
+
+static void _run_lookup(void* state, const uint32_t* op_keys, size_t begin, size_t end)
+{
+    tree_state_t* s = state;
+    uint64_t found = 0;
+    for (size_t i = begin; i < end; i++)
+        found += bt_contains_uint32_t(&s->tree, op_keys[i]);
+    bench_sink += found;
+}
+
+/**
+ * @brief Same lookups as _run_lookup, handed to bt_contains_batch in chunks of BATCH_SIZE keys
+ */
+static void _run_lookup_batch(void* state, const uint32_t* op_keys, size_t begin, size_t end)
+{
+    tree_state_t* s = state;
+    uint64_t found = 0;
+    bool out[BATCH_SIZE];
+    for (size_t i = begin; i < end; i += BATCH_SIZE) {
+        size_t count = (end - i < BATCH_SIZE) ? end - i : BATCH_SIZE;
+        bt_contains_batch_uint32_t(&s->tree, &op_keys[i], count, out);
+        for (size_t j = 0; j < count; j++)
+            found += out[j];
+    }
+    bench_sink += found;
+}
+
+static void _run_frozen_lookup(void* state, const uint32_t* op_keys, size_t begin, size_t end)
+{
+    frozen_state_t* s = state;
+    uint64_t found = 0;
+    for (size_t i = begin; i < end; i++)
+        found += bt_frozen_contains_uint32_t(&s->frozen, op_keys[i]);
+    bench_sink += found;
+}
+
+static void _run_ibt_insert(void* state, const uint32_t* op_keys, size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; i++)
+        ibt_add_value_uint32_t(state, op_keys[i]);
+}
+
+static void _run_ibt_lookup(void* state, const uint32_t* op_keys, size_t begin, size_t end)
+{
+    uint64_t found = 0;
+    for (size_t i = begin; i < end; i++)
+        found += ibt_contains_uint32_t(state, op_keys[i]);
+    bench_sink += found;
+}
+
+static void _run_lsm_insert(void* state, const uint32_t* op_keys, size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; i++)
+        lsm_add(state, op_keys[i]);
+}
+
+static void _run_delete(void* state, const uint32_t* op_keys, size_t begin, size_t end)
+{
+    tree_state_t* s = state;
+    for (size_t i = begin; i < end; i++)
+        bt_del_value_uint32_t(&s->tree, op_keys[i]);
+}
+
+/**
+ * @brief Steps the iterator over end - begin values, starting over after the max value
+ */
+static void _run_iterate(void* state, const uint32_t* op_keys, size_t begin, size_t end)
+{
+    tree_state_t* s = state;
+    uint64_t sum = 0;
+    for (size_t i = begin; i < end; i++) {
+        if (!bt_iter_valid_uint32_t(&s->iter))
+            s->iter = bt_iter_begin_uint32_t(&s->tree);
+        sum += s->iter.node->value;
+        bt_iter_next_uint32_t(&s->iter);
+    }
+    bench_sink += sum;
+}
+
+//--------------------------------------------------
+
+#define TREE_CASES_FOR(name, setup_empty, setup_filled)                                            \
+    {                                                                                              \
+        .structure = name,                                                                         \
+        .operation = "insert",                                                                     \
+        .setup = setup_empty,                                                                      \
+        .run = _run_insert,                                                                        \
+        .teardown = _teardown,                                                                     \
+        .max_size = { TREE_SORTED_MAX_SIZE, 0, TREE_ZIPFIAN_MAX_SIZE },                            \
+    },                                                                                             \
+    {                                                                                              \
+        .structure = name,                                                                         \
+        .operation = "lookup",                                                                     \
+        .setup = setup_filled,                                                                     \
+        .run = _run_lookup,                                                                        \
+        .teardown = _teardown,                                                                     \
+        .max_size = { TREE_SORTED_MAX_SIZE, 0, TREE_ZIPFIAN_MAX_SIZE },                            \
+        .read_only = true,                                                                         \
+    },                                                                                             \
+    {                                                                                              \
+        .structure = name,                                                                         \
+        .operation = "lookup_batch",                                                               \
+        .setup = setup_filled,                                                                     \
+        .run = _run_lookup_batch,                                                                  \
+        .teardown = _teardown,                                                                     \
+        .max_size = { TREE_SORTED_MAX_SIZE, 0, TREE_ZIPFIAN_MAX_SIZE },                            \
+        .read_only = true,                                                                         \
+    },                                                                                             \
+    {                                                                                              \
+        .structure = name,                                                                         \
+        .operation = "delete",                                                                     \
+        .setup = setup_filled,                                                                     \
+        .run = _run_delete,                                                                        \
+        .teardown = _teardown,                                                                     \
+        .max_size = { TREE_SORTED_MAX_SIZE, 0, TREE_ZIPFIAN_MAX_SIZE },                            \
+    },                                                                                             \
+    {                                                                                              \
+        .structure = name,                                                                         \
+        .operation = "iterate",                                                                    \
+        .setup = setup_filled,                                                                     \
+        .run = _run_iterate,                                                                       \
+        .teardown = _teardown,                                                                     \
+        .max_size = { TREE_SORTED_MAX_SIZE, 0, TREE_ZIPFIAN_MAX_SIZE },                            \
+        .read_only = true,                                                                         \
+    }
+
+const bench_case_t TREE_CASES[] = {
+    TREE_CASES_FOR("bt", _setup_empty, _setup_filled),
+    TREE_CASES_FOR("bt_pooled", _setup_pooled_empty, _setup_pooled_filled),
+    {
+        .structure = "bt_frozen",
+        .operation = "lookup",
+        .setup = _setup_frozen,
+        .run = _run_frozen_lookup,
+        .teardown = _teardown_frozen,
+        .max_size = { TREE_SORTED_MAX_SIZE, 0, TREE_ZIPFIAN_MAX_SIZE },
+        .read_only = true,
+    },
+    {
+        .structure = "ibt",
+        .operation = "insert",
+        .setup = _setup_ibt_empty,
+        .run = _run_ibt_insert,
+        .teardown = _teardown_ibt,
+        .max_size = { TREE_SORTED_MAX_SIZE, 0, TREE_ZIPFIAN_MAX_SIZE },
+    },
+    {
+        .structure = "ibt",
+        .operation = "lookup",
+        .setup = _setup_ibt_filled,
+        .run = _run_ibt_lookup,
+        .teardown = _teardown_ibt,
+        .max_size = { TREE_SORTED_MAX_SIZE, 0, TREE_ZIPFIAN_MAX_SIZE },
+        .read_only = true,
+    },
+    {
+        .structure = "lsm",
+        .operation = "insert",
+        .setup = _setup_lsm,
+        .run = _run_lsm_insert,
+        .teardown = _teardown_lsm,
+    },
+};
+
+const size_t TREE_CASES_COUNT = sizeof(TREE_CASES) / sizeof(TREE_CASES[0]);
@@ -0,0 +1,382 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "harness.h"
+#include "utils/panic.h"
+
+volatile uint64_t bench_sink;
+
+static const size_t SIZES[BENCH_SIZES] = { 1000, 10000, 100000, 1000000, 10000000 };
+
+static const char* DISTRIBUTION_NAMES[BENCH_DISTRIBUTIONS] = { "sorted", "random", "zipfian" };
+
+/**
+ * @brief Skew of the zipfian distribution, the same as YCSB uses
+ */
+#define ZIPF_THETA 0.99
+
+/**
+ * @brief Prime bigger than every size, so multiplying by it modulo the size permutes the keys
+ */
+#define KEY_SCRAMBLE 2654435761ull
+
+typedef struct bench_result {
+    double mean;
+    double min;
+    double p50;
+    double p90;
+    double p99;
+    double max;
+    size_t ops;
+} bench_result_t;
+
+//--------------------------------------------------
+// Helper functions
+
+/**
+ * @brief Monotonic time in nanoseconds
+ */
+static uint64_t _now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief splitmix64, good enough for key generation and independent of the libc rand
+ */
+static uint64_t _next_random(uint64_t* state)
+{
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Uniform double in [0, 1)
+ */
+static double _next_uniform(uint64_t* state)
+{
+    return (double)(_next_random(state) >> 11) / (double)(1ull << 53);
+}
+
+/**
+ * @brief Draws size zipfian ranks with the method of Gray et al., which needs O(1) per key
+ *
+ * @details The ranks are scrambled into keys so that the hot keys are spread over the key range
+ *          instead of being the smallest ones.
+ */
+static void _fill_zipfian(uint32_t* keys, const size_t size, uint64_t* state)
+{
+    double zetan = 0;
+    for (size_t i = 1; i <= size; i++)
+        zetan += 1.0 / pow((double)i, ZIPF_THETA);
+    double zeta2 = 1.0 + 1.0 / pow(2.0, ZIPF_THETA);
+    double alpha = 1.0 / (1.0 - ZIPF_THETA);
+    double eta = (1.0 - pow(2.0 / (double)size, 1.0 - ZIPF_THETA)) / (1.0 - zeta2 / zetan);
+
+    for (size_t i = 0; i < size; i++) {
+        double u = _next_uniform(state);
+        double uz = u * zetan;
+        uint64_t rank;
+        if (uz < 1.0) {
+            rank = 0;
+        } else if (uz < zeta2) {
+            rank = 1;
+        } else {
+            rank = (uint64_t)((double)size * pow(eta * u - eta + 1.0, alpha));
+        }
+        if (rank >= size)
+            rank = size - 1;
+        keys[i] = (uint32_t)(rank * KEY_SCRAMBLE % size);
+    }
+}
+
+/**
+ * @brief Generates size keys in [0, size) following distribution
+ */
+static uint32_t* _generate_keys(const bench_distribution_t distribution, const size_t size)
+{
+    uint32_t* keys = malloc(size * sizeof(uint32_t));
+    if (keys == nullptr)
+        panic("Out of memory while generating keys");
+    uint64_t state = 42;
+
+    switch (distribution) {
+    case BENCH_SORTED:
+        for (size_t i = 0; i < size; i++)
+            keys[i] = i;
+        break;
+    case BENCH_RANDOM:
+        for (size_t i = 0; i < size; i++)
+            keys[i] = i;
+        for (size_t i = size - 1; i > 0; i--) {
+            size_t j = _next_random(&state) % (i + 1);
+            uint32_t tmp = keys[i];
+            keys[i] = keys[j];
+            keys[j] = tmp;
+        }
+        break;
+    case BENCH_ZIPFIAN:
+        _fill_zipfian(keys, size, &state);
+        break;
+    default:
+        panicf("Unknown distribution %d", distribution);
+    }
+
+    return keys;
+}
+
+/**
+ * @brief Picks ops keys spread evenly over keys, so capped operations still see the whole range
+ */
+static uint32_t* _sample_keys(const uint32_t* keys, const size_t size, const size_t ops)
+{
+    uint32_t* op_keys = malloc(ops * sizeof(uint32_t));
+    if (op_keys == nullptr)
+        panic("Out of memory while sampling keys");
+    for (size_t i = 0; i < ops; i++)
+        op_keys[i] = keys[i * size / ops];
+    return op_keys;
+}
+
+static int _compare_doubles(const void* a, const void* b)
+{
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Nearest-rank percentile of sorted samples
+ */
+static double _percentile(const double* sorted, const size_t count, const double percent)
+{
+    size_t rank = (size_t)ceil(percent / 100.0 * (double)count);
+    return sorted[(rank == 0) ? 0 : rank - 1];
+}
+
+/**
+ * @brief Times warmup and repetitions of a case and summarizes the ns/op samples
+ */
+static bench_result_t _run_case(
+    const bench_options_t* options,
+    const bench_case_t* bench,
+    const uint32_t* keys,
+    const size_t size)
+{
+    size_t ops = (bench->max_ops == 0 || bench->max_ops > size) ? size : bench->max_ops;
+    uint32_t* op_keys = (ops == size) ? nullptr : _sample_keys(keys, size, ops);
+    const uint32_t* run_keys = (op_keys == nullptr) ? keys : op_keys;
+    size_t batches = (ops < BENCH_BATCHES) ? ops : BENCH_BATCHES;
+    size_t sample_count = batches * options->repetitions;
+    double* samples = malloc(sample_count * sizeof(double));
+    if (samples == nullptr)
+        panic("Out of memory while allocating samples");
+
+    size_t samples_taken = 0;
+    double total_ns = 0;
+    void* state = bench->read_only ? bench->setup(keys, size) : nullptr;
+    for (int rep = 0; rep < options->warmup + options->repetitions; rep++) {
+        if (!bench->read_only)
+            state = bench->setup(keys, size);
+
+        for (size_t batch = 0; batch < batches; batch++) {
+            size_t begin = batch * ops / batches;
+            size_t end = (batch + 1) * ops / batches;
+            uint64_t start = _now_ns();
+            bench->run(state, run_keys, begin, end);
+            uint64_t elapsed = _now_ns() - start;
+            if (rep >= options->warmup) {
+                samples[samples_taken++] = (double)elapsed / (double)(end - begin);
+                total_ns += (double)elapsed;
+            }
+        }
+
+        if (!bench->read_only)
+            bench->teardown(state);
+    }
+    if (bench->read_only)
+        bench->teardown(state);
+
+    qsort(samples, sample_count, sizeof(double), _compare_doubles);
+    bench_result_t result = {
+        .mean = total_ns / (double)(ops * options->repetitions),
+        .min = samples[0],
+        .p50 = _percentile(samples, sample_count, 50),
+        .p90 = _percentile(samples, sample_count, 90),
+        .p99 = _percentile(samples, sample_count, 99),
+        .max = samples[sample_count - 1],
+        .ops = ops,
+    };
+    free(samples);
+    free(op_keys);
+    return result;
+}
+
+static void _print_usage(const char* program)
+{
+    fprintf(
+        stderr,
+        "Usage: %s [options]\n"
+        "  --min-size N     Smallest size to run (default 1000)\n"
+        "  --max-size N     Biggest size to run (default 10000000)\n"
+        "  --warmup N       Untimed repetitions before measuring (default 1)\n"
+        "  --reps N         Timed repetitions (default 5)\n"
+        "  --filter TEXT    Only run cases whose \"structure/operation\" contains TEXT\n"
+        "  --json FILE      Also write the results as JSON to FILE\n",
+        program);
+}
+
+static size_t _parse_number(const char* program, const char* text)
+{
+    char* end;
+    unsigned long long value = strtoull(text, &end, 10);
+    if (*text == '\0' || *end != '\0') {
+        _print_usage(program);
+        exit(EXIT_FAILURE);
+    }
+    return value;
+}
+
+//--------------------------------------------------
+
+bench_options_t bench_parse_options(int argc, const char* argv[])
+{
+    bench_options_t options = {
+        .min_size = SIZES[0],
+        .max_size = SIZES[BENCH_SIZES - 1],
+        .warmup = 1,
+        .repetitions = 5,
+        .filter = nullptr,
+        .json_path = nullptr,
+    };
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            _print_usage(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+        const char* value = argv[++i];
+        if (strcmp(argv[i - 1], "--min-size") == 0) {
+            options.min_size = _parse_number(argv[0], value);
+        } else if (strcmp(argv[i - 1], "--max-size") == 0) {
+            options.max_size = _parse_number(argv[0], value);
+        } else if (strcmp(argv[i - 1], "--warmup") == 0) {
+            options.warmup = _parse_number(argv[0], value);
+        } else if (strcmp(argv[i - 1], "--reps") == 0) {
+            options.repetitions = _parse_number(argv[0], value);
+        } else if (strcmp(argv[i - 1], "--filter") == 0) {
+            options.filter = value;
+        } else if (strcmp(argv[i - 1], "--json") == 0) {
+            options.json_path = value;
+        } else {
+            _print_usage(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (options.repetitions < 1) {
+        _print_usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    return options;
+}
+
+bool bench_run_suite(const bench_options_t* options, const bench_case_t* cases, size_t count)
+{
+    FILE* json = nullptr;
+    if (options->json_path != nullptr) {
+        json = fopen(options->json_path, "w");
+        if (json == nullptr) {
+            perror(options->json_path);
+            return false;
+        }
+        fprintf(json, "[");
+    }
+
+    printf(
+        "%-10s %-12s %-8s %9s %9s %10s %10s %10s %10s\n",
+        "structure",
+        "operation",
+        "keys",
+        "size",
+        "ops",
+        "mean ns",
+        "p50 ns",
+        "p90 ns",
+        "p99 ns");
+
+    bool first = true;
+    for (size_t s = 0; s < BENCH_SIZES; s++) {
+        size_t size = SIZES[s];
+        if (size < options->min_size || size > options->max_size)
+            continue;
+        for (int d = 0; d < BENCH_DISTRIBUTIONS; d++) {
+            uint32_t* keys = nullptr;
+            for (size_t c = 0; c < count; c++) {
+                const bench_case_t* bench = &cases[c];
+                char name[64];
+                snprintf(name, sizeof(name), "%s/%s", bench->structure, bench->operation);
+                if (options->filter != nullptr && strstr(name, options->filter) == nullptr)
+                    continue;
+                if (bench->max_size[d] != 0 && size > bench->max_size[d])
+                    continue;
+
+                if (keys == nullptr)
+                    keys = _generate_keys(d, size);
+                bench_result_t result = _run_case(options, bench, keys, size);
+                printf(
+                    "%-10s %-12s %-8s %9zu %9zu %10.1f %10.1f %10.1f %10.1f\n",
+                    bench->structure,
+                    bench->operation,
+                    DISTRIBUTION_NAMES[d],
+                    size,
+                    result.ops,
+                    result.mean,
+                    result.p50,
+                    result.p90,
+                    result.p99);
+                fflush(stdout);
+
+                if (json == nullptr)
+                    continue;
+                fprintf(
+                    json,
+                    "%s\n  {\"structure\": \"%s\", \"operation\": \"%s\", "
+                    "\"distribution\": \"%s\", \"size\": %zu, \"ops\": %zu, "
+                    "\"warmup\": %d, \"repetitions\": %d, \"mean_ns\": %.2f, \"min_ns\": %.2f, "
+                    "\"p50_ns\": %.2f, \"p90_ns\": %.2f, \"p99_ns\": %.2f, \"max_ns\": %.2f}",
+                    first ? "" : ",",
+                    bench->structure,
+                    bench->operation,
+                    DISTRIBUTION_NAMES[d],
+                    size,
+                    result.ops,
+                    options->warmup,
+                    options->repetitions,
+                    result.mean,
+                    result.min,
+                    result.p50,
+                    result.p90,
+                    result.p99,
+                    result.max);
+                first = false;
+            }
+            free(keys);
+        }
+    }
+
+    if (json != nullptr) {
+        fprintf(json, "\n]\n");
+        if (fclose(json) != 0) {
+            perror(options->json_path);
+            return false;
+        }
+    }
+    return true;
+}
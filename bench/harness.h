@@ -0,0 +1,101 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file harness.h
+ *
+ * Microbenchmark harness.
+ *
+ * A benchmark case times one operation of one structure. For every key distribution and size the
+ * harness generates a key sequence, lets the case build its state outside of the timed region and
+ * then times the operation in batches. Every batch gives one ns/op sample, so the reported
+ * percentiles describe the spread within and across repetitions. Warmup repetitions are run the
+ * same way but their samples are dropped.
+ */
+
+/**
+ * @brief Number of timed batches a repetition is split into
+ */
+#define BENCH_BATCHES 100
+
+/**
+ * @brief Number of sizes the suite runs, 1e3 up to 1e7
+ */
+#define BENCH_SIZES 5
+
+/**
+ * @brief Distribution of the key sequence handed to a case
+ *
+ * @details All distributions produce keys in [0, size). Sorted and random are permutations of that
+ *          range, zipfian draws keys with skew 0.99 and therefore repeats the hot keys.
+ */
+typedef enum bench_distribution {
+    BENCH_SORTED,
+    BENCH_RANDOM,
+    BENCH_ZIPFIAN,
+    BENCH_DISTRIBUTIONS,
+} bench_distribution_t;
+
+typedef struct bench_case {
+    const char* structure;
+    const char* operation;
+    /**
+     * @brief Builds the state for a repetition out of all keys. Not timed
+     */
+    void* (*setup)(const uint32_t* keys, size_t size);
+    /**
+     * @brief Runs the operation for the op keys in [begin, end). Timed
+     */
+    void (*run)(void* state, const uint32_t* op_keys, size_t begin, size_t end);
+    /**
+     * @brief Releases the state. Not timed
+     */
+    void (*teardown)(void* state);
+    /**
+     * @brief Number of operations per repetition, 0 meaning one per key. Caps O(n) operations
+     */
+    size_t max_ops;
+    /**
+     * @brief Biggest size to run per distribution, 0 meaning no limit. Caps quadratic setups
+     */
+    size_t max_size[BENCH_DISTRIBUTIONS];
+    /**
+     * @brief Whether run leaves the state unchanged, so it can be set up once for all repetitions
+     */
+    bool read_only;
+} bench_case_t;
+
+typedef struct bench_options {
+    size_t min_size;
+    size_t max_size;
+    int warmup;
+    int repetitions;
+    const char* filter;
+    const char* json_path;
+} bench_options_t;
+
+/**
+ * @brief Results of the operations are added to the sink so the compiler can't drop them
+ */
+extern volatile uint64_t bench_sink;
+
+/**
+ * @brief Parses the command line. Prints the usage and exits on invalid arguments
+ */
+bench_options_t bench_parse_options(int argc, const char* argv[]);
+
+/**
+ * @brief Runs all cases matching the filter and prints a table. Returns false on I/O errors
+ */
+bool bench_run_suite(const bench_options_t* options, const bench_case_t* cases, size_t count);
+
+//--------------------------------------------------
+// Benchmark suites
+
+extern const bench_case_t LIST_CASES[];
+extern const size_t LIST_CASES_COUNT;
+
+extern const bench_case_t TREE_CASES[];
+extern const size_t TREE_CASES_COUNT;
@@ -1,3 +1,294 @@
+#include <stdio.h>
+#include <stdlib.h>
+
 #include "tree.h"
 
+//--------------------------------------------------
+// Helper functions
+
+/**
+ * @brief Height of a subtree. The empty subtree has height 0
+ */
+static int _height(avl_node_uint32_t* node)
+{
+    return (node == nullptr) ? 0 : node->height;
+}
+
+/**
+ * @brief Recomputes the height of node from its children
+ */
+static void _update_height(avl_node_uint32_t* node)
+{
+    int lheight = _height(node->left);
+    int rheight = _height(node->right);
+    node->height = 1 + ((lheight > rheight) ? lheight : rheight);
+}
+
+/**
+ * @brief Balance factor of node. Positive values mean the left subtree is higher
+ */
+static int _balance_factor(avl_node_uint32_t* node)
+{
+    return _height(node->left) - _height(node->right);
+}
+
+/**
+ * @brief Rotates the subtree to the right and returns the new subtree root
+ *
+ *        node            left
+ *        /  \            /  \
+ *     left   C   ->     A   node
+ *     /  \                  /  \
+ *    A    B                B    C
+ */
+static avl_node_uint32_t* _rotate_right(avl_node_uint32_t* node)
+{
+    avl_node_uint32_t* left = node->left;
+    node->left = left->right;
+    left->right = node;
+    _update_height(node);
+    _update_height(left);
+    return left;
+}
+
+/**
+ * @brief Rotates the subtree to the left and returns the new subtree root
+ *
+ *      node                 right
+ *      /  \                 /  \
+ *     A   right    ->    node   C
+ *         /  \           /  \
+ *        B    C         A    B
+ */
+static avl_node_uint32_t* _rotate_left(avl_node_uint32_t* node)
+{
+    avl_node_uint32_t* right = node->right;
+    node->right = right->left;
+    right->left = node;
+    _update_height(node);
+    _update_height(right);
+    return right;
+}
+
+/**
+ * @brief Restores the AVL property of node, assuming both of its subtrees are balanced and differ
+ *        in height by at most two. Returns the new subtree root
+ */
+static avl_node_uint32_t* _rebalance(avl_node_uint32_t* node)
+{
+    _update_height(node);
+    int balance = _balance_factor(node);
+
+    if (balance > 1) { // Left heavy
+        if (_balance_factor(node->left) < 0) // Left-right case
+            node->left = _rotate_left(node->left);
+        return _rotate_right(node);
+    } else if (balance < -1) { // Right heavy
+        if (_balance_factor(node->right) > 0) // Right-left case
+            node->right = _rotate_right(node->right);
+        return _rotate_left(node);
+    }
+    return node;
+}
+
+/**
+ * @brief Inserts new_node into the subtree and returns the new subtree root
+ */
+static avl_node_uint32_t* _insert_node(avl_node_uint32_t* node, avl_node_uint32_t* new_node)
+{
+    if (node == nullptr)
+        return new_node;
+
+    if (new_node->value < node->value) {
+        node->left = _insert_node(node->left, new_node);
+    } else {
+        node->right = _insert_node(node->right, new_node);
+    }
+    return _rebalance(node);
+}
+
+/**
+ * @brief Unlinks the min node of the subtree and returns the new subtree root
+ *
+ * @param node Root of the subtree, must not be nullptr
+ * @param min Is set to the unlinked min node
+ */
+static avl_node_uint32_t* _unlink_min_node(avl_node_uint32_t* node, avl_node_uint32_t** min)
+{
+    if (node->left == nullptr) {
+        *min = node;
+        return node->right;
+    }
+    node->left = _unlink_min_node(node->left, min);
+    return _rebalance(node);
+}
+
+/**
+ * @brief Removes the first node matching value from the subtree and returns the new subtree root
+ *
+ * @param removed Is set to true if a node was removed
+ */
+static avl_node_uint32_t* _remove_node(
+    avl_node_uint32_t* node, const uint32_t value, bool* removed)
+{
+    if (node == nullptr)
+        return nullptr;
+
+    if (value < node->value) {
+        node->left = _remove_node(node->left, value, removed);
+    } else if (value > node->value) {
+        node->right = _remove_node(node->right, value, removed);
+    } else {
+        avl_node_uint32_t* replacement;
+        *removed = true;
+        if (node->left == nullptr || node->right == nullptr) {
+            replacement = (node->left != nullptr) ? node->left : node->right;
+            free(node);
+            return replacement;
+        }
+        // Both children present: the in-order successor takes the place of node
+        avl_node_uint32_t* right = _unlink_min_node(node->right, &replacement);
+        replacement->left = node->left;
+        replacement->right = right;
+        free(node);
+        return _rebalance(replacement);
+    }
+    return _rebalance(node);
+}
+
+/**
+ * @brief Frees all nodes of the subtree. Recursion depth is bounded by the tree height
+ */
+static void _free_subtree(avl_node_uint32_t* node)
+{
+    if (node == nullptr)
+        return;
+    _free_subtree(node->left);
+    _free_subtree(node->right);
+    free(node);
+}
+
+//--------------------------------------------------
+
+/**
+ * @brief Creates a new tree
+ */
+avl_uint32_t avl_new_uint32_t()
+{
+    return (avl_uint32_t) { .root = nullptr, .size = 0 };
+}
+
+/**
+ * @brief Adds value to the tree and rebalances it
+ */
+bool avl_add_value_uint32_t(avl_uint32_t* tree, const uint32_t value)
+{
+    avl_node_uint32_t* new_node = malloc(sizeof(avl_node_uint32_t));
+    if (new_node == nullptr) {
+        return false;
+    }
+    *new_node = (avl_node_uint32_t) {
+        .value = value,
+        .height = 1,
+        .left = nullptr,
+        .right = nullptr,
+    };
+
+    tree->root = _insert_node(tree->root, new_node);
+    tree->size++;
+    return true;
+}
+
+/**
+ * @brief Deletes the first appearance of value and rebalances the tree
+ */
+bool avl_del_value_uint32_t(avl_uint32_t* tree, const uint32_t value)
+{
+    bool removed = false;
+    tree->root = _remove_node(tree->root, value, &removed);
+    if (removed)
+        tree->size--;
+    return removed;
+}
+
+/**
+ * @brief Checks whether value is in the tree
+ */
+bool avl_contains_uint32_t(avl_uint32_t* tree, const uint32_t value)
+{
+    avl_node_uint32_t* cur = tree->root;
+
+    while (cur != nullptr) {
+        if (cur->value == value)
+            return true;
+        cur = (value < cur->value) ? cur->left : cur->right;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Checks whether tree is empty
+ */
+bool avl_is_empty_uint32_t(avl_uint32_t* tree)
+{
+    return tree->root == nullptr;
+}
+
+/**
+ * @brief Clears tree
+ */
+bool avl_clear_uint32_t(avl_uint32_t* tree)
+{
+    _free_subtree(tree->root);
+    tree->root = nullptr;
+    tree->size = 0;
+    return true;
+}
+
+/**
+ * @brief Returns the number of values in the tree
+ */
+size_t avl_size_uint32_t(avl_uint32_t* tree)
+{
+    return tree->size;
+}
 
+/**
+ * @brief Prints AVL tree
+ */
+static void _print_node_inorder(avl_node_uint32_t* node)
+{
+    if (node == nullptr)
+        return;
+    _print_node_inorder(node->left);
+    printf("%u ", node->value);
+    _print_node_inorder(node->right);
+}
+static void _print_tree_traverse(avl_node_uint32_t* node, const int depth, bool left_child)
+{
+    for (int i = 0; i < depth - 1; i++) {
+        printf("    ");
+    }
+    if (depth > 0) {
+        printf("%s─%s ", left_child ? "├" : "└", left_child ? "L" : "R");
+    }
+    if (node == nullptr) {
+        printf("nil\n");
+        return;
+    }
+    printf("%u (h=%d)\n", node->value, node->height);
+    _print_tree_traverse(node->left, depth + 1, true);
+    _print_tree_traverse(node->right, depth + 1, false);
+}
+void avl_print_uint32_t(avl_uint32_t* tree)
+{
+    printf("------------------------------\n");
+    printf("As list:\n");
+    printf("[");
+    _print_node_inorder(tree->root);
+    printf("]\n");
+    printf("As tree:\n");
+    _print_tree_traverse(tree->root, 0, true);
+    printf("------------------------------\n");
+}
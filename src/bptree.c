@@ -0,0 +1,554 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bptree.h"
+
+/**
+ * @brief Upper bound of the height of a tree
+ *
+ * @details Every node below the root has at least BP_TREE_MIN_KEYS + 1 children, so a tree of 8
+ *          levels would hold more than the 2^32 distinct uint32_t keys.
+ */
+#define MAX_HEIGHT 8
+
+/**
+ * @brief Nodes allocated up front for the splits of one insertion
+ */
+typedef struct reserve {
+    bpt_leaf_uint32_t* leaf;
+    bpt_inner_uint32_t* inners[MAX_HEIGHT];
+    uint32_t num_inners;
+} reserve_t;
+
+//--------------------------------------------------
+// Helper functions
+
+static bpt_inner_uint32_t* _as_inner(bpt_node_uint32_t* node)
+{
+    return (bpt_inner_uint32_t*)node;
+}
+
+static bpt_leaf_uint32_t* _as_leaf(bpt_node_uint32_t* node)
+{
+    return (bpt_leaf_uint32_t*)node;
+}
+
+static bpt_leaf_uint32_t* _new_leaf()
+{
+    bpt_leaf_uint32_t* leaf = malloc(sizeof(bpt_leaf_uint32_t));
+    if (leaf == nullptr)
+        return nullptr;
+    leaf->node.is_leaf = true;
+    leaf->node.num_keys = 0;
+    leaf->next = nullptr;
+    return leaf;
+}
+
+static bpt_inner_uint32_t* _new_inner()
+{
+    bpt_inner_uint32_t* inner = malloc(sizeof(bpt_inner_uint32_t));
+    if (inner == nullptr)
+        return nullptr;
+    inner->node.is_leaf = false;
+    inner->node.num_keys = 0;
+    return inner;
+}
+
+/**
+ * @brief Index of the first key that is not smaller than value
+ */
+static uint32_t _lower_bound_idx(bpt_node_uint32_t* node, const uint32_t value)
+{
+    uint32_t lo = 0, hi = node->num_keys;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (node->keys[mid] < value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief Index of the child an inner node routes value to
+ *
+ * @details The separator keys[i] is not bigger than any key in children[i + 1] and bigger than
+ *          every key in children[i], so we take the first separator that is bigger than value.
+ */
+static uint32_t _child_idx(bpt_node_uint32_t* node, const uint32_t value)
+{
+    uint32_t lo = 0, hi = node->num_keys;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (node->keys[mid] <= value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief Descends to the leaf that holds value if it is in the tree
+ */
+static bpt_leaf_uint32_t* _find_leaf(bpt_uint32_t* tree, const uint32_t value)
+{
+    bpt_node_uint32_t* node = tree->root;
+    if (node == nullptr)
+        return nullptr;
+    while (!node->is_leaf) {
+        node = _as_inner(node)->children[_child_idx(node, value)];
+    }
+    return _as_leaf(node);
+}
+
+/**
+ * @brief Frees the reserved nodes that were not used
+ */
+static void _release_nodes(reserve_t* reserve)
+{
+    free(reserve->leaf);
+    reserve->leaf = nullptr;
+    while (reserve->num_inners > 0)
+        free(reserve->inners[--reserve->num_inners]);
+}
+
+/**
+ * @brief Allocates the nodes that inserting value splits off, before the tree is changed
+ *
+ * @details A split starts at a full leaf and moves up through the full inner nodes above it. If it
+ *          reaches the root, a new root is needed as well. Allocating all of them up front lets an
+ *          insertion either fail without touching the tree or succeed completely.
+ *
+ * @return false if value is already present or memory ran out
+ */
+static bool _reserve_nodes(bpt_uint32_t* tree, const uint32_t value, reserve_t* reserve)
+{
+    *reserve = (reserve_t) { .leaf = nullptr, .num_inners = 0 };
+    uint32_t height = 0;
+    uint32_t full = 0; // Number of full nodes directly above and including the leaf
+    bpt_node_uint32_t* node = tree->root;
+    while (true) {
+        height++;
+        full = (node->num_keys == BP_TREE_MAX_KEYS) ? full + 1 : 0;
+        if (node->is_leaf)
+            break;
+        node = _as_inner(node)->children[_child_idx(node, value)];
+    }
+
+    uint32_t idx = _lower_bound_idx(node, value);
+    if (idx < node->num_keys && node->keys[idx] == value)
+        return false;
+    if (full == 0)
+        return true;
+
+    reserve->leaf = _new_leaf();
+    bool ok = reserve->leaf != nullptr;
+    uint32_t inners = (full == height) ? full : full - 1;
+    while (ok && reserve->num_inners < inners) {
+        reserve->inners[reserve->num_inners] = _new_inner();
+        ok = reserve->inners[reserve->num_inners] != nullptr;
+        if (ok)
+            reserve->num_inners++;
+    }
+    if (!ok)
+        _release_nodes(reserve);
+    return ok;
+}
+
+/**
+ * @brief Inserts value, which is not in the tree yet, into the subtree rooted at node
+ *
+ * @details If node has to be split, its right half is returned through split_node and the smallest
+ *          key routed to it through split_key. The caller then links it into the parent. The nodes
+ *          split off are taken from reserve, so inserting can't fail.
+ */
+static void _insert(
+    bpt_node_uint32_t* node,
+    const uint32_t value,
+    reserve_t* reserve,
+    uint32_t* split_key,
+    bpt_node_uint32_t** split_node)
+{
+    uint32_t keys[BP_TREE_MAX_KEYS + 1];
+    *split_node = nullptr;
+
+    if (node->is_leaf) {
+        uint32_t idx = _lower_bound_idx(node, value);
+        if (node->num_keys < BP_TREE_MAX_KEYS) {
+            memmove(
+                &node->keys[idx + 1], &node->keys[idx], (node->num_keys - idx) * sizeof(uint32_t));
+            node->keys[idx] = value;
+            node->num_keys++;
+            return;
+        }
+
+        // Leaf is full: split the MAX + 1 keys into two leaves
+        bpt_leaf_uint32_t* right = reserve->leaf;
+        reserve->leaf = nullptr;
+        memcpy(keys, node->keys, idx * sizeof(uint32_t));
+        keys[idx] = value;
+        memcpy(&keys[idx + 1], &node->keys[idx], (node->num_keys - idx) * sizeof(uint32_t));
+
+        uint32_t left_keys = (BP_TREE_MAX_KEYS + 1) / 2;
+        node->num_keys = left_keys;
+        memcpy(node->keys, keys, left_keys * sizeof(uint32_t));
+        right->node.num_keys = BP_TREE_MAX_KEYS + 1 - left_keys;
+        memcpy(right->node.keys, &keys[left_keys], right->node.num_keys * sizeof(uint32_t));
+
+        right->next = _as_leaf(node)->next;
+        _as_leaf(node)->next = right;
+        *split_key = right->node.keys[0];
+        *split_node = &right->node;
+        return;
+    }
+
+    bpt_inner_uint32_t* inner = _as_inner(node);
+    uint32_t idx = _child_idx(node, value);
+    uint32_t child_key;
+    bpt_node_uint32_t* child_node;
+    _insert(inner->children[idx], value, reserve, &child_key, &child_node);
+    if (child_node == nullptr)
+        return;
+
+    if (node->num_keys < BP_TREE_MAX_KEYS) {
+        memmove(&node->keys[idx + 1], &node->keys[idx], (node->num_keys - idx) * sizeof(uint32_t));
+        memmove(
+            &inner->children[idx + 2],
+            &inner->children[idx + 1],
+            (node->num_keys - idx) * sizeof(bpt_node_uint32_t*));
+        node->keys[idx] = child_key;
+        inner->children[idx + 1] = child_node;
+        node->num_keys++;
+        return;
+    }
+
+    // Inner node is full: the middle key moves up, the keys around it are split
+    bpt_node_uint32_t* children[BP_TREE_MAX_KEYS + 2];
+    bpt_inner_uint32_t* right = reserve->inners[--reserve->num_inners];
+    memcpy(keys, node->keys, idx * sizeof(uint32_t));
+    keys[idx] = child_key;
+    memcpy(&keys[idx + 1], &node->keys[idx], (node->num_keys - idx) * sizeof(uint32_t));
+    memcpy(children, inner->children, (idx + 1) * sizeof(bpt_node_uint32_t*));
+    children[idx + 1] = child_node;
+    memcpy(
+        &children[idx + 2],
+        &inner->children[idx + 1],
+        (node->num_keys - idx) * sizeof(bpt_node_uint32_t*));
+
+    uint32_t mid = (BP_TREE_MAX_KEYS + 1) / 2;
+    node->num_keys = mid;
+    memcpy(node->keys, keys, mid * sizeof(uint32_t));
+    memcpy(inner->children, children, (mid + 1) * sizeof(bpt_node_uint32_t*));
+    right->node.num_keys = BP_TREE_MAX_KEYS - mid;
+    memcpy(right->node.keys, &keys[mid + 1], right->node.num_keys * sizeof(uint32_t));
+    memcpy(
+        right->children,
+        &children[mid + 1],
+        (right->node.num_keys + 1) * sizeof(bpt_node_uint32_t*));
+
+    *split_key = keys[mid];
+    *split_node = &right->node;
+}
+
+/**
+ * @brief Merges children[idx + 1] of parent into children[idx] and frees it
+ */
+static void _merge_children(bpt_inner_uint32_t* parent, uint32_t idx)
+{
+    bpt_node_uint32_t* left = parent->children[idx];
+    bpt_node_uint32_t* right = parent->children[idx + 1];
+
+    if (left->is_leaf) {
+        memcpy(&left->keys[left->num_keys], right->keys, right->num_keys * sizeof(uint32_t));
+        left->num_keys += right->num_keys;
+        _as_leaf(left)->next = _as_leaf(right)->next;
+    } else {
+        // The separator moves down between the keys of both nodes
+        left->keys[left->num_keys] = parent->node.keys[idx];
+        memcpy(&left->keys[left->num_keys + 1], right->keys, right->num_keys * sizeof(uint32_t));
+        memcpy(
+            &_as_inner(left)->children[left->num_keys + 1],
+            _as_inner(right)->children,
+            (right->num_keys + 1) * sizeof(bpt_node_uint32_t*));
+        left->num_keys += right->num_keys + 1;
+    }
+    free(right);
+
+    uint32_t moved = parent->node.num_keys - idx - 1;
+    memmove(&parent->node.keys[idx], &parent->node.keys[idx + 1], moved * sizeof(uint32_t));
+    memmove(
+        &parent->children[idx + 1], &parent->children[idx + 2], moved * sizeof(bpt_node_uint32_t*));
+    parent->node.num_keys--;
+}
+
+/**
+ * @brief Refills children[idx] of parent after it dropped below BP_TREE_MIN_KEYS keys
+ *
+ * @details Borrows a key from a sibling that can spare one, otherwise merges with a sibling.
+ */
+static void _fix_underflow(bpt_inner_uint32_t* parent, uint32_t idx)
+{
+    bpt_node_uint32_t* child = parent->children[idx];
+    bpt_node_uint32_t* left = (idx > 0) ? parent->children[idx - 1] : nullptr;
+    bpt_node_uint32_t* right = (idx < parent->node.num_keys) ? parent->children[idx + 1] : nullptr;
+
+    if (left != nullptr && left->num_keys > BP_TREE_MIN_KEYS) { // Borrow from left sibling
+        memmove(&child->keys[1], child->keys, child->num_keys * sizeof(uint32_t));
+        if (child->is_leaf) {
+            child->keys[0] = left->keys[left->num_keys - 1];
+            parent->node.keys[idx - 1] = child->keys[0];
+        } else {
+            bpt_inner_uint32_t* inner = _as_inner(child);
+            memmove(
+                &inner->children[1],
+                inner->children,
+                (child->num_keys + 1) * sizeof(bpt_node_uint32_t*));
+            inner->children[0] = _as_inner(left)->children[left->num_keys];
+            child->keys[0] = parent->node.keys[idx - 1];
+            parent->node.keys[idx - 1] = left->keys[left->num_keys - 1];
+        }
+        child->num_keys++;
+        left->num_keys--;
+    } else if (right != nullptr && right->num_keys > BP_TREE_MIN_KEYS) { // Borrow from right
+        if (child->is_leaf) {
+            child->keys[child->num_keys] = right->keys[0];
+            memmove(right->keys, &right->keys[1], (right->num_keys - 1) * sizeof(uint32_t));
+            parent->node.keys[idx] = right->keys[0];
+        } else {
+            bpt_inner_uint32_t* inner = _as_inner(right);
+            child->keys[child->num_keys] = parent->node.keys[idx];
+            _as_inner(child)->children[child->num_keys + 1] = inner->children[0];
+            parent->node.keys[idx] = right->keys[0];
+            memmove(right->keys, &right->keys[1], (right->num_keys - 1) * sizeof(uint32_t));
+            memmove(
+                inner->children, &inner->children[1], right->num_keys * sizeof(bpt_node_uint32_t*));
+        }
+        child->num_keys++;
+        right->num_keys--;
+    } else if (left != nullptr) {
+        _merge_children(parent, idx - 1);
+    } else {
+        _merge_children(parent, idx);
+    }
+}
+
+/**
+ * @brief Removes value from the subtree rooted at node
+ *
+ * @details Separators in the inner nodes are not updated when a leaf loses its smallest key, they
+ *          still route correctly since they stay bigger than every key to their left.
+ */
+static bool _remove(bpt_node_uint32_t* node, const uint32_t value)
+{
+    if (node->is_leaf) {
+        uint32_t idx = _lower_bound_idx(node, value);
+        if (idx == node->num_keys || node->keys[idx] != value)
+            return false;
+        memmove(
+            &node->keys[idx], &node->keys[idx + 1], (node->num_keys - idx - 1) * sizeof(uint32_t));
+        node->num_keys--;
+        return true;
+    }
+
+    uint32_t idx = _child_idx(node, value);
+    bpt_node_uint32_t* child = _as_inner(node)->children[idx];
+    if (!_remove(child, value))
+        return false;
+    if (child->num_keys < BP_TREE_MIN_KEYS)
+        _fix_underflow(_as_inner(node), idx);
+    return true;
+}
+
+/**
+ * @brief Frees all nodes of the subtree. Recursion depth is bounded by the tree height
+ */
+static void _free_subtree(bpt_node_uint32_t* node)
+{
+    if (!node->is_leaf) {
+        for (uint32_t i = 0; i <= node->num_keys; i++) {
+            _free_subtree(_as_inner(node)->children[i]);
+        }
+    }
+    free(node);
+}
+
+//--------------------------------------------------
+
+/**
+ * @brief Creates a new tree
+ */
+bpt_uint32_t bpt_new_uint32_t()
+{
+    return (bpt_uint32_t) { .root = nullptr, .size = 0 };
+}
+
+/**
+ * @brief Adds value to the tree
+ *
+ * @return false if it's already present or memory ran out, the tree is unchanged then
+ */
+bool bpt_add_value_uint32_t(bpt_uint32_t* tree, const uint32_t value)
+{
+    if (tree->root == nullptr) {
+        bpt_leaf_uint32_t* leaf = _new_leaf();
+        if (leaf == nullptr)
+            return false;
+        tree->root = &leaf->node;
+    }
+
+    reserve_t reserve;
+    if (!_reserve_nodes(tree, value, &reserve))
+        return false;
+    uint32_t split_key;
+    bpt_node_uint32_t* split_node;
+    _insert(tree->root, value, &reserve, &split_key, &split_node);
+
+    if (split_node != nullptr) { // Root was split, the tree grows by one level
+        bpt_inner_uint32_t* root = reserve.inners[--reserve.num_inners];
+        root->node.num_keys = 1;
+        root->node.keys[0] = split_key;
+        root->children[0] = tree->root;
+        root->children[1] = split_node;
+        tree->root = &root->node;
+    }
+    tree->size++;
+    return true;
+}
+
+/**
+ * @brief Deletes value from the tree. Returns false if it's not present
+ */
+bool bpt_del_value_uint32_t(bpt_uint32_t* tree, const uint32_t value)
+{
+    if (tree->root == nullptr || !_remove(tree->root, value))
+        return false;
+    tree->size--;
+
+    bpt_node_uint32_t* root = tree->root;
+    if (root->num_keys == 0) { // Root ran empty, the tree shrinks by one level
+        tree->root = root->is_leaf ? nullptr : _as_inner(root)->children[0];
+        free(root);
+    }
+    return true;
+}
+
+/**
+ * @brief Checks whether value is in the tree
+ */
+bool bpt_contains_uint32_t(bpt_uint32_t* tree, const uint32_t value)
+{
+    bpt_leaf_uint32_t* leaf = _find_leaf(tree, value);
+    if (leaf == nullptr)
+        return false;
+    uint32_t idx = _lower_bound_idx(&leaf->node, value);
+    return idx < leaf->node.num_keys && leaf->node.keys[idx] == value;
+}
+
+/**
+ * @brief Checks whether tree is empty
+ */
+bool bpt_is_empty_uint32_t(bpt_uint32_t* tree)
+{
+    return tree->root == nullptr;
+}
+
+/**
+ * @brief Clears tree
+ */
+bool bpt_clear_uint32_t(bpt_uint32_t* tree)
+{
+    if (tree->root != nullptr)
+        _free_subtree(tree->root);
+    tree->root = nullptr;
+    tree->size = 0;
+    return true;
+}
+
+/**
+ * @brief Returns the number of keys in the tree
+ */
+size_t bpt_size_uint32_t(bpt_uint32_t* tree)
+{
+    return tree->size;
+}
+
+/**
+ * @brief Calls consume for every key in [lo, hi] in ascending order
+ *
+ * @details Descends once to the leaf of lo and then follows the leaf chain.
+ *
+ * @return Number of consumed keys
+ */
+size_t bpt_range_uint32_t(
+    bpt_uint32_t* tree,
+    const uint32_t lo,
+    const uint32_t hi,
+    void (*consume)(uint32_t value, void* ctx),
+    void* ctx)
+{
+    size_t count = 0;
+    bpt_leaf_uint32_t* leaf = _find_leaf(tree, lo);
+    if (leaf == nullptr || hi < lo)
+        return 0;
+
+    uint32_t idx = _lower_bound_idx(&leaf->node, lo);
+    while (leaf != nullptr) {
+        for (; idx < leaf->node.num_keys; idx++) {
+            if (leaf->node.keys[idx] > hi)
+                return count;
+            consume(leaf->node.keys[idx], ctx);
+            count++;
+        }
+        leaf = leaf->next;
+        idx = 0;
+    }
+    return count;
+}
+
+/**
+ * @brief Prints B+ tree
+ */
+static void _print_tree_traverse(bpt_node_uint32_t* node, const int depth)
+{
+    for (int i = 0; i < depth; i++) {
+        printf("    ");
+    }
+    printf("%s[", node->is_leaf ? "leaf " : "");
+    for (uint32_t i = 0; i < node->num_keys; i++) {
+        printf((i == 0) ? "%u" : " %u", node->keys[i]);
+    }
+    printf("]\n");
+    if (!node->is_leaf) {
+        for (uint32_t i = 0; i <= node->num_keys; i++) {
+            _print_tree_traverse(_as_inner(node)->children[i], depth + 1);
+        }
+    }
+}
+void bpt_print_uint32_t(bpt_uint32_t* tree)
+{
+    printf("------------------------------\n");
+    printf("As list:\n");
+    printf("[");
+    bpt_node_uint32_t* node = tree->root;
+    while (node != nullptr && !node->is_leaf) {
+        node = _as_inner(node)->children[0];
+    }
+    for (bpt_leaf_uint32_t* leaf = _as_leaf(node); leaf != nullptr; leaf = leaf->next) {
+        for (uint32_t i = 0; i < leaf->node.num_keys; i++) {
+            printf("%u ", leaf->node.keys[i]);
+        }
+    }
+    printf("]\n");
+    printf("As tree:\n");
+    if (tree->root == nullptr) {
+        printf("nil\n");
+    } else {
+        _print_tree_traverse(tree->root, 0);
+    }
+    printf("------------------------------\n");
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file bptree.h
+ *
+ * B+ tree: a high fanout search tree whose nodes hold many sorted keys.
+ *
+ * All keys are stored in the leaves, inner nodes only hold separator keys to route lookups. Leaves
+ * are linked from left to right, so range scans walk the leaf chain instead of the tree. With
+ * BP_TREE_MAX_KEYS keys per node a lookup on tens of millions of keys visits only four or five
+ * nodes, each of them a few adjacent cache lines.
+ *
+ * Keys are unique: adding a key that is already present returns false.
+ */
+
+/**
+ * @brief Max number of keys per node. A leaf of 4-byte keys is 256 bytes
+ *
+ * @details Must be even, so that two nodes at the minimum fill of BP_TREE_MAX_KEYS / 2 keys can
+ *          always be merged into one node.
+ */
+#define BP_TREE_MAX_KEYS 60
+
+#define BP_TREE_MIN_KEYS (BP_TREE_MAX_KEYS / 2)
+
+#define BP_TREE(type) bpt_##type
+
+/**
+ * @brief Header shared by inner nodes and leaves. is_leaf tells which of the two it belongs to
+ */
+#define BP_TREE_NODE(type) bpt_node_##type
+
+#define BP_TREE_INNER(type) bpt_inner_##type
+
+#define BP_TREE_LEAF(type) bpt_leaf_##type
+
+#define BP_TREE_DECLARE(type)                                                                      \
+    typedef struct BP_TREE_NODE(type) {                                                            \
+        bool is_leaf;                                                                              \
+        uint32_t num_keys;                                                                         \
+        type keys[BP_TREE_MAX_KEYS];                                                               \
+    } BP_TREE_NODE(type);                                                                          \
+    typedef struct BP_TREE_INNER(type) {                                                           \
+        BP_TREE_NODE(type) node;                                                                   \
+        BP_TREE_NODE(type) * children[BP_TREE_MAX_KEYS + 1];                                       \
+    } BP_TREE_INNER(type);                                                                         \
+    typedef struct BP_TREE_LEAF(type) {                                                            \
+        BP_TREE_NODE(type) node;                                                                   \
+        struct BP_TREE_LEAF(type) * next;                                                          \
+    } BP_TREE_LEAF(type);                                                                          \
+    typedef struct BP_TREE(type) {                                                                 \
+        BP_TREE_NODE(type) * root;                                                                 \
+        size_t size;                                                                               \
+    } BP_TREE(type);                                                                               \
+    BP_TREE(type) bpt_new_##type();                                                                \
+    bool bpt_add_value_##type(BP_TREE(type) * tree, const type value);                             \
+    bool bpt_del_value_##type(BP_TREE(type) * tree, const type value);                             \
+    bool bpt_contains_##type(BP_TREE(type) * tree, const type value);                              \
+    bool bpt_is_empty_##type(BP_TREE(type) * tree);                                                \
+    bool bpt_clear_##type(BP_TREE(type) * tree);                                                   \
+    size_t bpt_size_##type(BP_TREE(type) * tree);                                                  \
+    size_t bpt_range_##type(                                                                       \
+        BP_TREE(type) * tree,                                                                      \
+        const type lo,                                                                             \
+        const type hi,                                                                             \
+        void (*consume)(type value, void* ctx),                                                    \
+        void* ctx);                                                                                \
+    void bpt_print_##type(BP_TREE(type) * tree);
+
+BP_TREE_DECLARE(uint32_t);
@@ -0,0 +1,208 @@
+#include "concurrent_list.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Bit of a next pointer marking the node owning it as deleted
+ */
+#define CLL_MARK ((uintptr_t)1)
+
+//--------------------------------------------------
+// Helper functions
+
+static bool _is_marked(const uintptr_t link)
+{
+    return (link & CLL_MARK) != 0;
+}
+
+static cll_node_uint32_t* _get_node(const uintptr_t link)
+{
+    return (cll_node_uint32_t*)(link & ~CLL_MARK);
+}
+
+/**
+ * @brief Finds the first node whose value is not smaller than value
+ *
+ * @details Marked nodes on the way are unlinked and retired. On return prev is the link pointing
+ *          to cur, cur is the found node or nullptr, and neither was marked when they were read.
+ *
+ * @return Whether cur holds value
+ */
+static bool _cll_find(
+    cll_uint32_t* list,
+    ebr_thread_t* thread,
+    const uint32_t value,
+    _Atomic(uintptr_t) * *prev,
+    cll_node_uint32_t** cur)
+{
+retry:
+    *prev = &list->head;
+    *cur = _get_node(atomic_load_explicit(*prev, memory_order_acquire));
+    while (*cur != nullptr) {
+        uintptr_t next = atomic_load_explicit(&(*cur)->next, memory_order_acquire);
+        if (_is_marked(next)) {
+            // Fails if prev got marked or changed, in which case we can't trust our position
+            uintptr_t expected = (uintptr_t)*cur;
+            if (!atomic_compare_exchange_strong(*prev, &expected, next & ~CLL_MARK))
+                goto retry;
+            ebr_retire(thread, *cur, free);
+            *cur = _get_node(next);
+            continue;
+        }
+        if ((*cur)->value >= value)
+            return (*cur)->value == value;
+        *prev = &(*cur)->next;
+        *cur = _get_node(next);
+    }
+    return false;
+}
+
+//--------------------------------------------------
+
+/**
+ * @brief: A new list is just the nullptr pointer
+ */
+cll_uint32_t cll_new_list_uint32_t()
+{
+    cll_uint32_t list;
+    atomic_init(&list.head, (uintptr_t) nullptr);
+    list.ebr = ebr_new();
+    return list;
+}
+
+/**
+ * @brief: Inserts the value at its sorted position
+ *
+ * @return false if the value is already in the list or out of memory
+ */
+bool cll_add_value_uint32_t(cll_uint32_t* list, ebr_thread_t* thread, const uint32_t value)
+{
+    cll_node_uint32_t* new_node = malloc(sizeof(cll_node_uint32_t));
+    if (new_node == nullptr) {
+        return false;
+    }
+    new_node->value = value;
+
+    _Atomic(uintptr_t)* prev;
+    cll_node_uint32_t* cur;
+    bool added = false;
+    ebr_enter(thread);
+    while (true) {
+        if (_cll_find(list, thread, value, &prev, &cur))
+            break;
+        atomic_init(&new_node->next, (uintptr_t)cur);
+        uintptr_t expected = (uintptr_t)cur;
+        if (atomic_compare_exchange_strong(prev, &expected, (uintptr_t)new_node)) {
+            added = true;
+            break;
+        }
+    }
+    ebr_exit(thread);
+
+    if (!added)
+        free(new_node);
+    return added;
+}
+
+/**
+ * @brief: Deletes the value from the list
+ *
+ * @return Whether this call deleted the value
+ */
+bool cll_del_value_uint32_t(cll_uint32_t* list, ebr_thread_t* thread, const uint32_t value)
+{
+    _Atomic(uintptr_t)* prev;
+    cll_node_uint32_t* cur;
+    bool deleted = false;
+    ebr_enter(thread);
+    while (_cll_find(list, thread, value, &prev, &cur)) {
+        uintptr_t next = atomic_load(&cur->next);
+        if (_is_marked(next))
+            continue;
+        // Marking is the linearization point, whoever marks the node deleted the value
+        if (!atomic_compare_exchange_strong(&cur->next, &next, next | CLL_MARK))
+            continue;
+        deleted = true;
+
+        uintptr_t expected = (uintptr_t)cur;
+        if (atomic_compare_exchange_strong(prev, &expected, next)) {
+            ebr_retire(thread, cur, free);
+        } else {
+            // Someone changed prev, let a traversal unlink the node instead
+            _cll_find(list, thread, value, &prev, &cur);
+        }
+        break;
+    }
+    ebr_exit(thread);
+    return deleted;
+}
+
+/**
+ * @brief: Checks whether the value is in the list without writing to it
+ */
+bool cll_contains_uint32_t(cll_uint32_t* list, ebr_thread_t* thread, const uint32_t value)
+{
+    ebr_enter(thread);
+    cll_node_uint32_t* cur = _get_node(atomic_load_explicit(&list->head, memory_order_acquire));
+    while (cur != nullptr && cur->value < value)
+        cur = _get_node(atomic_load_explicit(&cur->next, memory_order_acquire));
+    bool found = cur != nullptr && cur->value == value
+        && !_is_marked(atomic_load_explicit(&cur->next, memory_order_acquire));
+    ebr_exit(thread);
+    return found;
+}
+
+bool cll_is_empty_uint32_t(cll_uint32_t* list, ebr_thread_t* thread)
+{
+    return cll_length_uint32_t(list, thread) == 0;
+}
+
+/**
+ * @brief: Counts the values that are not deleted
+ *
+ * @details Only exact if no other thread modifies the list at the same time.
+ */
+size_t cll_length_uint32_t(cll_uint32_t* list, ebr_thread_t* thread)
+{
+    size_t length = 0;
+    ebr_enter(thread);
+    uintptr_t link = atomic_load_explicit(&list->head, memory_order_acquire);
+    while (_get_node(link) != nullptr) {
+        link = atomic_load_explicit(&_get_node(link)->next, memory_order_acquire);
+        if (!_is_marked(link))
+            length++;
+    }
+    ebr_exit(thread);
+    return length;
+}
+
+/**
+ * @brief: Delete the entire list, including all retired nodes and thread handles
+ */
+bool cll_clear_list_uint32_t(cll_uint32_t* list)
+{
+    cll_node_uint32_t* cur = _get_node(atomic_load(&list->head));
+    cll_node_uint32_t* next;
+    while (cur != nullptr) {
+        next = _get_node(atomic_load(&cur->next));
+        free(cur);
+        cur = next;
+    }
+    atomic_store(&list->head, (uintptr_t) nullptr);
+    ebr_clear(&list->ebr);
+    return true;
+}
+
+void cll_print_uint32_t(cll_uint32_t* list)
+{
+    cll_node_uint32_t* cur = _get_node(atomic_load(&list->head));
+    printf("[");
+    while (cur != nullptr) {
+        uintptr_t next = atomic_load(&cur->next);
+        if (!_is_marked(next))
+            printf("%u%s", cur->value, (_get_node(next) != nullptr) ? ", " : "");
+        cur = _get_node(next);
+    }
+    printf("]\n");
+}
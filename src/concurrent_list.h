@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "utils/ebr.h"
+
+/**
+ * @file concurrent_list.h
+ *
+ * Lock-free linked list for any number of concurrent readers and writers.
+ *
+ * The list is kept sorted and holds every value at most once, which is what makes concurrent
+ * insertion and deletion possible without locks (Harris, Michael). Deleting a node first marks
+ * the lowest bit of its next pointer, so no insertion can link behind it anymore, and only then
+ * unlinks it. Any thread that comes across a marked node helps unlinking it. Unlinked nodes are
+ * freed through epoch-based reclamation once no thread can still be reading them.
+ *
+ * Every thread registers with the domain of the list, ebr_register(&list->ebr), and passes its
+ * handle to the operations. Creating, clearing and printing the list must not run concurrently
+ * with anything else.
+ */
+
+#define CLL(type) cll_##type
+
+#define CLL_NODE(type) cll_node_##type
+
+#define CLL_DECLARE(type)                                                                          \
+    typedef struct CLL_NODE(type) {                                                                \
+        type value;                                                                                \
+        _Atomic(uintptr_t) next;                                                                   \
+    } CLL_NODE(type);                                                                              \
+    typedef struct CLL(type) {                                                                     \
+        _Atomic(uintptr_t) head;                                                                   \
+        ebr_domain_t ebr;                                                                          \
+    } CLL(type);                                                                                   \
+    CLL(type) cll_new_list_##type();                                                               \
+    bool cll_add_value_##type(CLL(type) * list, ebr_thread_t* thread, const type value);           \
+    bool cll_del_value_##type(CLL(type) * list, ebr_thread_t* thread, const type value);           \
+    bool cll_contains_##type(CLL(type) * list, ebr_thread_t* thread, const type value);            \
+    bool cll_is_empty_##type(CLL(type) * list, ebr_thread_t* thread);                              \
+    size_t cll_length_##type(CLL(type) * list, ebr_thread_t* thread);                              \
+    bool cll_clear_list_##type(CLL(type) * list);                                                  \
+    void cll_print_##type(CLL(type) * list);
+
+CLL_DECLARE(uint32_t);
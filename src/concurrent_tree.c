@@ -0,0 +1,261 @@
+#include "concurrent_tree.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+//--------------------------------------------------
+// Helper functions
+
+static void _cbt_free_node(cbt_node_uint32_t* node)
+{
+    pthread_rwlock_destroy(&node->lock);
+    free(node);
+}
+
+/**
+ * @brief Releases the lock guarding the link to a node, the root lock if parent is nullptr
+ */
+static void _cbt_unlock_parent(cbt_uint32_t* tree, cbt_node_uint32_t* parent)
+{
+    pthread_rwlock_unlock((parent == nullptr) ? &tree->root_lock : &parent->lock);
+}
+
+/**
+ * @brief Frees every node below node without recursion, since a tree built from sorted values is a
+ *        chain as deep as it is large. Right rotations lift each left child above its parent until
+ *        the current node has none, then the node is freed and the walk continues to the right
+ */
+static void _cbt_free_subtree(cbt_node_uint32_t* node)
+{
+    while (node != nullptr) {
+        cbt_node_uint32_t* next;
+        if (node->left != nullptr) {
+            next = node->left;
+            node->left = next->right;
+            next->right = node;
+        } else {
+            next = node->right;
+            _cbt_free_node(node);
+        }
+        node = next;
+    }
+}
+
+/**
+ * @brief Prints the values below node in order without recursion or a stack (Morris traversal).
+ *        Before descending left, the right link of the in order predecessor is pointed back at the
+ *        node, and the link is reset once the walk returns through it, restoring the tree
+ */
+static void _cbt_print_subtree(cbt_node_uint32_t* node)
+{
+    bool first = true;
+    while (node != nullptr) {
+        if (node->left != nullptr) {
+            cbt_node_uint32_t* pred = node->left;
+            while (pred->right != nullptr && pred->right != node)
+                pred = pred->right;
+            if (pred->right == nullptr) {
+                pred->right = node;
+                node = node->left;
+                continue;
+            }
+            pred->right = nullptr;
+        }
+        printf("%s%u", first ? "" : ", ", node->value);
+        first = false;
+        node = node->right;
+    }
+}
+
+//--------------------------------------------------
+
+/**
+ * @brief: A new tree is just the nullptr root behind its lock
+ */
+void cbt_init_uint32_t(cbt_uint32_t* tree)
+{
+    tree->root = nullptr;
+    pthread_rwlock_init(&tree->root_lock, nullptr);
+    atomic_init(&tree->size, 0);
+}
+
+/**
+ * @brief: Adds the value as a new leaf, write locking the path hand over hand
+ *
+ * @return false if the value is already in the tree or out of memory
+ */
+bool cbt_add_value_uint32_t(cbt_uint32_t* tree, const uint32_t value)
+{
+    cbt_node_uint32_t* new_node = malloc(sizeof(cbt_node_uint32_t));
+    if (new_node == nullptr) {
+        return false;
+    }
+    new_node->value = value;
+    new_node->left = nullptr;
+    new_node->right = nullptr;
+    pthread_rwlock_init(&new_node->lock, nullptr);
+
+    pthread_rwlock_wrlock(&tree->root_lock);
+    if (tree->root == nullptr) {
+        tree->root = new_node;
+        pthread_rwlock_unlock(&tree->root_lock);
+        atomic_fetch_add(&tree->size, 1);
+        return true;
+    }
+    cbt_node_uint32_t* cur = tree->root;
+    pthread_rwlock_wrlock(&cur->lock);
+    pthread_rwlock_unlock(&tree->root_lock);
+
+    while (cur->value != value) {
+        cbt_node_uint32_t** link = (value < cur->value) ? &cur->left : &cur->right;
+        if (*link == nullptr) {
+            *link = new_node;
+            pthread_rwlock_unlock(&cur->lock);
+            atomic_fetch_add(&tree->size, 1);
+            return true;
+        }
+        cbt_node_uint32_t* next = *link;
+        pthread_rwlock_wrlock(&next->lock);
+        pthread_rwlock_unlock(&cur->lock);
+        cur = next;
+    }
+
+    pthread_rwlock_unlock(&cur->lock);
+    _cbt_free_node(new_node);
+    return false;
+}
+
+/**
+ * @brief: Deletes the value from the tree, write locking the path hand over hand
+ *
+ * @details The node is unlinked while both it and its parent are locked. Reaching the node
+ *          requires the lock of its parent, so nobody holds or waits for the node once it is
+ *          unlinked and it can be freed right away. A node with two children takes the value of
+ *          its successor instead, which is unlinked the same way while the node stays locked.
+ *
+ * @return Whether the value was deleted
+ */
+bool cbt_del_value_uint32_t(cbt_uint32_t* tree, const uint32_t value)
+{
+    pthread_rwlock_wrlock(&tree->root_lock);
+    cbt_node_uint32_t* parent = nullptr;
+    cbt_node_uint32_t** link = &tree->root;
+    cbt_node_uint32_t* cur = tree->root;
+    if (cur == nullptr) {
+        pthread_rwlock_unlock(&tree->root_lock);
+        return false;
+    }
+    pthread_rwlock_wrlock(&cur->lock);
+
+    while (cur->value != value) {
+        cbt_node_uint32_t** next_link = (value < cur->value) ? &cur->left : &cur->right;
+        if (*next_link == nullptr) {
+            pthread_rwlock_unlock(&cur->lock);
+            _cbt_unlock_parent(tree, parent);
+            return false;
+        }
+        pthread_rwlock_wrlock(&(*next_link)->lock);
+        _cbt_unlock_parent(tree, parent);
+        parent = cur;
+        link = next_link;
+        cur = *next_link;
+    }
+
+    if (cur->left == nullptr || cur->right == nullptr) {
+        *link = (cur->left != nullptr) ? cur->left : cur->right;
+        pthread_rwlock_unlock(&cur->lock);
+        _cbt_unlock_parent(tree, parent);
+        _cbt_free_node(cur);
+        atomic_fetch_sub(&tree->size, 1);
+        return true;
+    }
+
+    // The link to cur doesn't change, so the parent can go
+    _cbt_unlock_parent(tree, parent);
+    cbt_node_uint32_t* successor_parent = cur;
+    cbt_node_uint32_t* successor = cur->right;
+    pthread_rwlock_wrlock(&successor->lock);
+    while (successor->left != nullptr) {
+        pthread_rwlock_wrlock(&successor->left->lock);
+        if (successor_parent != cur)
+            pthread_rwlock_unlock(&successor_parent->lock);
+        successor_parent = successor;
+        successor = successor->left;
+    }
+
+    cur->value = successor->value;
+    if (successor_parent == cur) {
+        cur->right = successor->right;
+    } else {
+        successor_parent->left = successor->right;
+        pthread_rwlock_unlock(&successor_parent->lock);
+    }
+    pthread_rwlock_unlock(&successor->lock);
+    pthread_rwlock_unlock(&cur->lock);
+    _cbt_free_node(successor);
+    atomic_fetch_sub(&tree->size, 1);
+    return true;
+}
+
+/**
+ * @brief: Checks whether the value is in the tree, read locking the path hand over hand
+ */
+bool cbt_contains_uint32_t(cbt_uint32_t* tree, const uint32_t value)
+{
+    pthread_rwlock_rdlock(&tree->root_lock);
+    cbt_node_uint32_t* cur = tree->root;
+    if (cur == nullptr) {
+        pthread_rwlock_unlock(&tree->root_lock);
+        return false;
+    }
+    pthread_rwlock_rdlock(&cur->lock);
+    pthread_rwlock_unlock(&tree->root_lock);
+
+    while (cur->value != value) {
+        cbt_node_uint32_t* next = (value < cur->value) ? cur->left : cur->right;
+        if (next == nullptr) {
+            pthread_rwlock_unlock(&cur->lock);
+            return false;
+        }
+        pthread_rwlock_rdlock(&next->lock);
+        pthread_rwlock_unlock(&cur->lock);
+        cur = next;
+    }
+    pthread_rwlock_unlock(&cur->lock);
+    return true;
+}
+
+bool cbt_is_empty_uint32_t(cbt_uint32_t* tree)
+{
+    return cbt_size_uint32_t(tree) == 0;
+}
+
+/**
+ * @brief: Number of values, counted by every successful add and del
+ */
+size_t cbt_size_uint32_t(cbt_uint32_t* tree)
+{
+    return atomic_load(&tree->size);
+}
+
+/**
+ * @brief: Delete the entire tree. No other thread may use it at the same time
+ */
+bool cbt_clear_uint32_t(cbt_uint32_t* tree)
+{
+    _cbt_free_subtree(tree->root);
+    tree->root = nullptr;
+    atomic_store(&tree->size, 0);
+    return true;
+}
+
+/**
+ * @brief: Prints the values in order. It briefly relinks nodes, so no other thread may use the tree
+ *         at the same time
+ */
+void cbt_print_uint32_t(cbt_uint32_t* tree)
+{
+    printf("[");
+    _cbt_print_subtree(tree->root);
+    printf("]\n");
+}
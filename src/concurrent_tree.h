@@ -0,0 +1,49 @@
+#pragma once
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file concurrent_tree.h
+ *
+ * Binary search tree with a reader-writer lock per node.
+ *
+ * Operations descend hand over hand: the lock of a child is taken before the lock of its parent is
+ * released, so a thread only holds a small window of the path and threads can't overtake each
+ * other on it. Lookups take read locks and therefore run in parallel with each other, inserts
+ * and deletes take write locks and only block the threads that want to pass through the nodes
+ * they currently hold. A writer is only in the way of everyone while it passes the root.
+ *
+ * Like bt_uint32_t the tree doesn't rebalance itself. Unlike bt_uint32_t it holds every value at
+ * most once. POSIX locks must not be copied, so the tree is initialized in place by cbt_init
+ * instead of being returned by value.
+ */
+
+#define CBT(type) cbt_##type
+
+#define CBT_NODE(type) cbt_node_##type
+
+#define CBT_DECLARE(type)                                                                          \
+    typedef struct CBT_NODE(type) {                                                                \
+        type value;                                                                                \
+        struct CBT_NODE(type) * left;                                                              \
+        struct CBT_NODE(type) * right;                                                             \
+        pthread_rwlock_t lock;                                                                     \
+    } CBT_NODE(type);                                                                              \
+    typedef struct CBT(type) {                                                                     \
+        CBT_NODE(type) * root;                                                                     \
+        pthread_rwlock_t root_lock;                                                                \
+        atomic_size_t size;                                                                        \
+    } CBT(type);                                                                                   \
+    void cbt_init_##type(CBT(type) * tree);                                                        \
+    bool cbt_add_value_##type(CBT(type) * tree, const type value);                                 \
+    bool cbt_del_value_##type(CBT(type) * tree, const type value);                                 \
+    bool cbt_contains_##type(CBT(type) * tree, const type value);                                  \
+    bool cbt_is_empty_##type(CBT(type) * tree);                                                    \
+    size_t cbt_size_##type(CBT(type) * tree);                                                      \
+    bool cbt_clear_##type(CBT(type) * tree);                                                       \
+    void cbt_print_##type(CBT(type) * tree);
+
+CBT_DECLARE(uint32_t);
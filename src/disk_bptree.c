@@ -0,0 +1,784 @@
+#include <assert.h>
+#include <string.h>
+
+#include "disk_bptree.h"
+
+#define DBPT_MAGIC "DSBPTRE"
+
+/**
+ * @brief Metadata of the tree, kept in the user bytes of the pager header
+ */
+typedef struct meta {
+    char magic[8];
+    uint32_t key_size;
+    page_id_t root;
+    uint64_t size;
+} meta_t;
+
+/**
+ * @brief Start of every node page. The keys follow at DBPT_PAGE_HEADER
+ *
+ * @details Inner nodes store their child page ids behind room for inner_max keys. Leaves link to
+ *          the next leaf through next, 0 marking the last leaf.
+ */
+typedef struct node {
+    uint32_t is_leaf;
+    uint32_t num_keys;
+    page_id_t next;
+    uint32_t reserved;
+} node_t;
+
+static_assert(sizeof(meta_t) <= PAGER_USER_META, "Tree metadata must fit the pager header");
+static_assert(sizeof(node_t) == DBPT_PAGE_HEADER, "Node header must match DBPT_PAGE_HEADER");
+
+/**
+ * @brief Everything the key size independent helpers need
+ *
+ * @details Keys are 4 or 8 bytes wide. They are handled as uint64_t in memory and stored in their
+ *          own width in the pages, so a tree of 4-byte keys gets twice the fanout.
+ */
+typedef struct core {
+    pager_t* pager;
+    meta_t* meta;
+    size_t key_size;
+    uint32_t leaf_max;
+    uint32_t inner_max;
+} core_t;
+
+/**
+ * @brief Upper bound of the height of a tree
+ *
+ * @details Even with 8-byte keys every node below the root has more than 100 children, so a tree
+ *          of 8 levels would need more pages than 32-bit page ids can address.
+ */
+#define MAX_HEIGHT 8
+
+/**
+ * @brief Pinned pages allocated up front for the splits of one insertion
+ */
+typedef struct reserve {
+    page_id_t ids[MAX_HEIGHT];
+    node_t* pages[MAX_HEIGHT];
+    uint32_t count;
+} reserve_t;
+
+//--------------------------------------------------
+// Helper functions
+
+/**
+ * @brief Both maxima are even, so that two nodes at the min fill can always be merged
+ */
+static core_t _core(pager_t* pager)
+{
+    meta_t* meta = pager_user_meta(pager);
+    size_t key_size = meta->key_size;
+    size_t room = PAGER_PAGE_SIZE - DBPT_PAGE_HEADER;
+    return (core_t) {
+        .pager = pager,
+        .meta = meta,
+        .key_size = key_size,
+        .leaf_max = (uint32_t)(room / key_size) & ~1u,
+        .inner_max = (uint32_t)((room - sizeof(page_id_t)) / (key_size + sizeof(page_id_t))) & ~1u,
+    };
+}
+
+static uint32_t _min_keys(const core_t* c, const node_t* node)
+{
+    return (node->is_leaf ? c->leaf_max : c->inner_max) / 2;
+}
+
+static unsigned char* _key_ptr(const core_t* c, node_t* node, const uint32_t i)
+{
+    return (unsigned char*)node + DBPT_PAGE_HEADER + i * c->key_size;
+}
+
+static uint64_t _key(const core_t* c, node_t* node, const uint32_t i)
+{
+    if (c->key_size == sizeof(uint32_t)) {
+        uint32_t key;
+        memcpy(&key, _key_ptr(c, node, i), sizeof(uint32_t));
+        return key;
+    }
+    uint64_t key;
+    memcpy(&key, _key_ptr(c, node, i), sizeof(uint64_t));
+    return key;
+}
+
+static void _set_key(const core_t* c, node_t* node, const uint32_t i, const uint64_t key)
+{
+    if (c->key_size == sizeof(uint32_t)) {
+        uint32_t narrow = (uint32_t)key;
+        memcpy(_key_ptr(c, node, i), &narrow, sizeof(uint32_t));
+    } else {
+        memcpy(_key_ptr(c, node, i), &key, sizeof(uint64_t));
+    }
+}
+
+/**
+ * @brief Moves count keys from position from of src to position to of dst, which may overlap
+ */
+static void _move_keys(
+    const core_t* c,
+    node_t* dst,
+    const uint32_t to,
+    node_t* src,
+    const uint32_t from,
+    const uint32_t count)
+{
+    memmove(_key_ptr(c, dst, to), _key_ptr(c, src, from), count * c->key_size);
+}
+
+static page_id_t* _children(const core_t* c, node_t* node)
+{
+    return (page_id_t*)((unsigned char*)node + DBPT_PAGE_HEADER + c->inner_max * c->key_size);
+}
+
+/**
+ * @brief Index of the first key that is not smaller than value
+ */
+static uint32_t _lower_bound_idx(const core_t* c, node_t* node, const uint64_t value)
+{
+    uint32_t lo = 0, hi = node->num_keys;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (_key(c, node, mid) < value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief Index of the child an inner node routes value to, see _child_idx of bptree.c
+ */
+static uint32_t _child_idx(const core_t* c, node_t* node, const uint64_t value)
+{
+    uint32_t lo = 0, hi = node->num_keys;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (_key(c, node, mid) <= value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief Descends to the leaf that holds value if it is in the tree and pins it
+ *
+ * @return 0 if the tree is empty or a page can't be read
+ */
+static page_id_t _find_leaf(const core_t* c, const uint64_t value, node_t** leaf)
+{
+    page_id_t id = c->meta->root;
+    if (id == 0)
+        return 0;
+    node_t* node = pager_get(c->pager, id);
+    while (node != nullptr && !node->is_leaf) {
+        page_id_t child = _children(c, node)[_child_idx(c, node, value)];
+        pager_release(c->pager, id, false);
+        id = child;
+        node = pager_get(c->pager, id);
+    }
+    *leaf = node;
+    return (node != nullptr) ? id : 0;
+}
+
+/**
+ * @brief Frees the reserved pages that were not used
+ */
+static void _release_pages(const core_t* c, reserve_t* reserve)
+{
+    while (reserve->count > 0) {
+        reserve->count--;
+        pager_free(c->pager, reserve->ids[reserve->count]);
+    }
+}
+
+/**
+ * @brief Allocates the pages that inserting value splits off, before the tree is changed
+ *
+ * @details The same count as _reserve_nodes of bptree.c: a split starts at a full leaf, moves up
+ *          through the full inner nodes above it and needs a new root if it reaches the root. The
+ *          pages stay pinned, so using them later can't fail.
+ *
+ * @return false if value is already present or a page couldn't be read or allocated
+ */
+static bool _reserve_pages(const core_t* c, const uint64_t value, reserve_t* reserve)
+{
+    reserve->count = 0;
+    uint32_t height = 0;
+    uint32_t full = 0; // Number of full nodes directly above and including the leaf
+    page_id_t id = c->meta->root;
+    node_t* node = pager_get(c->pager, id);
+    while (node != nullptr) {
+        height++;
+        full = (node->num_keys == (node->is_leaf ? c->leaf_max : c->inner_max)) ? full + 1 : 0;
+        if (node->is_leaf)
+            break;
+        page_id_t child = _children(c, node)[_child_idx(c, node, value)];
+        pager_release(c->pager, id, false);
+        id = child;
+        node = pager_get(c->pager, id);
+    }
+    if (node == nullptr)
+        return false;
+
+    uint32_t idx = _lower_bound_idx(c, node, value);
+    bool present = idx < node->num_keys && _key(c, node, idx) == value;
+    pager_release(c->pager, id, false);
+    if (present)
+        return false;
+
+    uint32_t pages = (full == height) ? full + 1 : full;
+    while (reserve->count < pages) {
+        node_t* page = pager_allocate(c->pager, &reserve->ids[reserve->count]);
+        if (page == nullptr) {
+            _release_pages(c, reserve);
+            return false;
+        }
+        reserve->pages[reserve->count++] = page;
+    }
+    return true;
+}
+
+/**
+ * @brief Takes one of the reserved pages
+ */
+static node_t* _take_page(reserve_t* reserve, page_id_t* id)
+{
+    reserve->count--;
+    *id = reserve->ids[reserve->count];
+    return reserve->pages[reserve->count];
+}
+
+/**
+ * @brief Inserts value, which is not in the tree yet, into a pinned leaf and releases it,
+ *        splitting the leaf if it's full
+ */
+static void _insert_leaf(
+    const core_t* c,
+    const page_id_t id,
+    node_t* node,
+    const uint64_t value,
+    reserve_t* reserve,
+    uint64_t* split_key,
+    page_id_t* split_id)
+{
+    uint32_t idx = _lower_bound_idx(c, node, value);
+    if (node->num_keys < c->leaf_max) {
+        _move_keys(c, node, idx + 1, node, idx, node->num_keys - idx);
+        _set_key(c, node, idx, value);
+        node->num_keys++;
+        pager_release(c->pager, id, true);
+        return;
+    }
+
+    // Leaf is full: the upper half moves to a new right leaf and value goes to its side
+    page_id_t right_id;
+    node_t* right = _take_page(reserve, &right_id);
+    uint32_t half = c->leaf_max / 2;
+    right->is_leaf = true;
+    right->num_keys = node->num_keys - half;
+    _move_keys(c, right, 0, node, half, right->num_keys);
+    node->num_keys = half;
+
+    node_t* target = (idx <= half) ? node : right;
+    uint32_t target_idx = (idx <= half) ? idx : idx - half;
+    _move_keys(c, target, target_idx + 1, target, target_idx, target->num_keys - target_idx);
+    _set_key(c, target, target_idx, value);
+    target->num_keys++;
+
+    right->next = node->next;
+    node->next = right_id;
+    *split_key = _key(c, right, 0);
+    *split_id = right_id;
+    pager_release(c->pager, right_id, true);
+    pager_release(c->pager, id, true);
+}
+
+static bool _insert(
+    const core_t* c,
+    const page_id_t id,
+    const uint64_t value,
+    reserve_t* reserve,
+    uint64_t* split_key,
+    page_id_t* split_id);
+
+/**
+ * @brief Inserts value below a pinned inner node and releases it, splitting the node if a split
+ *        child doesn't fit any more
+ */
+static bool _insert_inner(
+    const core_t* c,
+    const page_id_t id,
+    node_t* node,
+    const uint64_t value,
+    reserve_t* reserve,
+    uint64_t* split_key,
+    page_id_t* split_id)
+{
+    page_id_t* children = _children(c, node);
+    uint32_t idx = _child_idx(c, node, value);
+    uint64_t child_key;
+    page_id_t child_id;
+    if (!_insert(c, children[idx], value, reserve, &child_key, &child_id)) {
+        pager_release(c->pager, id, false);
+        return false;
+    }
+    if (child_id == 0) {
+        pager_release(c->pager, id, false);
+        return true;
+    }
+
+    uint32_t num_keys = node->num_keys;
+    if (num_keys < c->inner_max) {
+        _move_keys(c, node, idx + 1, node, idx, num_keys - idx);
+        memmove(&children[idx + 2], &children[idx + 1], (num_keys - idx) * sizeof(page_id_t));
+        _set_key(c, node, idx, child_key);
+        children[idx + 1] = child_id;
+        node->num_keys++;
+        pager_release(c->pager, id, true);
+        return true;
+    }
+
+    // Inner node is full: the middle key moves up, the keys around it are split
+    page_id_t right_id;
+    node_t* right = _take_page(reserve, &right_id);
+    uint64_t keys[PAGER_PAGE_SIZE / sizeof(uint32_t)];
+    page_id_t all_children[PAGER_PAGE_SIZE / sizeof(page_id_t)];
+    for (uint32_t i = 0, j = 0; i <= num_keys; i++)
+        keys[i] = (i == idx) ? child_key : _key(c, node, j++);
+    memcpy(all_children, children, (idx + 1) * sizeof(page_id_t));
+    all_children[idx + 1] = child_id;
+    memcpy(&all_children[idx + 2], &children[idx + 1], (num_keys - idx) * sizeof(page_id_t));
+
+    uint32_t mid = (c->inner_max + 1) / 2;
+    node->num_keys = mid;
+    for (uint32_t i = 0; i < mid; i++)
+        _set_key(c, node, i, keys[i]);
+    memcpy(children, all_children, (mid + 1) * sizeof(page_id_t));
+    right->is_leaf = false;
+    right->num_keys = c->inner_max - mid;
+    for (uint32_t i = 0; i < right->num_keys; i++)
+        _set_key(c, right, i, keys[mid + 1 + i]);
+    memcpy(
+        _children(c, right), &all_children[mid + 1], (right->num_keys + 1) * sizeof(page_id_t));
+
+    *split_key = keys[mid];
+    *split_id = right_id;
+    pager_release(c->pager, right_id, true);
+    pager_release(c->pager, id, true);
+    return true;
+}
+
+/**
+ * @brief Inserts value, which is not in the tree yet, into the subtree of page id
+ *
+ * @details Like _insert of bptree.c, a split returns the new right node through split_id and the
+ *          smallest key routed to it through split_key. split_id is 0 if there was no split. The
+ *          pages split off are taken from reserve.
+ *
+ * @return false if a page couldn't be read. Pages are only read on the way down and changed on
+ *         the way up, so the tree is unchanged then
+ */
+static bool _insert(
+    const core_t* c,
+    const page_id_t id,
+    const uint64_t value,
+    reserve_t* reserve,
+    uint64_t* split_key,
+    page_id_t* split_id)
+{
+    *split_id = 0;
+    node_t* node = pager_get(c->pager, id);
+    if (node == nullptr) {
+        return false;
+    }
+    if (node->is_leaf) {
+        _insert_leaf(c, id, node, value, reserve, split_key, split_id);
+        return true;
+    }
+    return _insert_inner(c, id, node, value, reserve, split_key, split_id);
+}
+
+/**
+ * @brief Merges children[idx + 1] of the pinned parent into children[idx] and frees its page
+ */
+static void _merge_children(
+    const core_t* c,
+    node_t* parent,
+    const uint32_t idx,
+    node_t* left,
+    node_t* right)
+{
+    page_id_t* parent_children = _children(c, parent);
+    page_id_t right_id = parent_children[idx + 1];
+
+    if (left->is_leaf) {
+        _move_keys(c, left, left->num_keys, right, 0, right->num_keys);
+        left->num_keys += right->num_keys;
+        left->next = right->next;
+    } else {
+        // The separator moves down between the keys of both nodes
+        _set_key(c, left, left->num_keys, _key(c, parent, idx));
+        _move_keys(c, left, left->num_keys + 1, right, 0, right->num_keys);
+        memcpy(
+            &_children(c, left)[left->num_keys + 1],
+            _children(c, right),
+            (right->num_keys + 1) * sizeof(page_id_t));
+        left->num_keys += right->num_keys + 1;
+    }
+    pager_free(c->pager, right_id);
+
+    uint32_t moved = parent->num_keys - idx - 1;
+    _move_keys(c, parent, idx, parent, idx + 1, moved);
+    memmove(&parent_children[idx + 1], &parent_children[idx + 2], moved * sizeof(page_id_t));
+    parent->num_keys--;
+}
+
+/**
+ * @brief Refills children[idx] of the pinned parent after it dropped below its min fill
+ *
+ * @details Borrows a key from a sibling that can spare one, otherwise merges with a sibling. The
+ *          same steps as _fix_underflow of bptree.c, on pinned pages.
+ *
+ * @return false if a page couldn't be read. The tree is left unchanged then
+ */
+static bool _fix_underflow(const core_t* c, node_t* parent, const uint32_t idx)
+{
+    page_id_t* parent_children = _children(c, parent);
+    page_id_t child_id = parent_children[idx];
+    page_id_t left_id = (idx > 0) ? parent_children[idx - 1] : 0;
+    page_id_t right_id = (idx < parent->num_keys) ? parent_children[idx + 1] : 0;
+    node_t* child = pager_get(c->pager, child_id);
+    node_t* left = (left_id != 0) ? pager_get(c->pager, left_id) : nullptr;
+    node_t* right = (right_id != 0) ? pager_get(c->pager, right_id) : nullptr;
+    bool ok = child != nullptr && (left_id == 0 || left != nullptr)
+        && (right_id == 0 || right != nullptr);
+    bool right_freed = false;
+
+    if (!ok) {
+        // Nothing to do, the pages that could be read are released below
+    } else if (left != nullptr && left->num_keys > _min_keys(c, left)) { // Borrow from left
+        _move_keys(c, child, 1, child, 0, child->num_keys);
+        if (child->is_leaf) {
+            _set_key(c, child, 0, _key(c, left, left->num_keys - 1));
+            _set_key(c, parent, idx - 1, _key(c, child, 0));
+        } else {
+            page_id_t* children = _children(c, child);
+            memmove(&children[1], children, (child->num_keys + 1) * sizeof(page_id_t));
+            children[0] = _children(c, left)[left->num_keys];
+            _set_key(c, child, 0, _key(c, parent, idx - 1));
+            _set_key(c, parent, idx - 1, _key(c, left, left->num_keys - 1));
+        }
+        child->num_keys++;
+        left->num_keys--;
+    } else if (right != nullptr && right->num_keys > _min_keys(c, right)) { // Borrow from right
+        if (child->is_leaf) {
+            _set_key(c, child, child->num_keys, _key(c, right, 0));
+            _move_keys(c, right, 0, right, 1, right->num_keys - 1);
+            _set_key(c, parent, idx, _key(c, right, 0));
+        } else {
+            page_id_t* children = _children(c, right);
+            _set_key(c, child, child->num_keys, _key(c, parent, idx));
+            _children(c, child)[child->num_keys + 1] = children[0];
+            _set_key(c, parent, idx, _key(c, right, 0));
+            _move_keys(c, right, 0, right, 1, right->num_keys - 1);
+            memmove(children, &children[1], right->num_keys * sizeof(page_id_t));
+        }
+        child->num_keys++;
+        right->num_keys--;
+    } else if (left != nullptr) {
+        _merge_children(c, parent, idx - 1, left, child);
+        child_id = 0;
+    } else {
+        _merge_children(c, parent, idx, child, right);
+        right_freed = true;
+    }
+
+    // Merged away pages were already released by pager_free
+    if (child != nullptr && child_id != 0)
+        pager_release(c->pager, child_id, ok);
+    if (left != nullptr)
+        pager_release(c->pager, left_id, ok);
+    if (right != nullptr && !right_freed)
+        pager_release(c->pager, right_id, ok);
+    return ok;
+}
+
+/**
+ * @brief Removes value from the subtree of page id
+ *
+ * @details As in bptree.c, separators are not updated when a leaf loses its smallest key.
+ *
+ * @param underflow Receives whether the node dropped below its min fill
+ */
+static bool _remove(const core_t* c, const page_id_t id, const uint64_t value, bool* underflow)
+{
+    node_t* node = pager_get(c->pager, id);
+    if (node == nullptr) {
+        return false;
+    }
+
+    bool removed = false;
+    if (node->is_leaf) {
+        uint32_t idx = _lower_bound_idx(c, node, value);
+        if (idx < node->num_keys && _key(c, node, idx) == value) {
+            _move_keys(c, node, idx, node, idx + 1, node->num_keys - idx - 1);
+            node->num_keys--;
+            removed = true;
+        }
+    } else {
+        uint32_t idx = _child_idx(c, node, value);
+        bool child_underflow;
+        removed = _remove(c, _children(c, node)[idx], value, &child_underflow);
+        if (removed && child_underflow)
+            _fix_underflow(c, node, idx);
+    }
+    *underflow = node->num_keys < _min_keys(c, node);
+    pager_release(c->pager, id, removed);
+    return removed;
+}
+
+static bool _open(pager_t* pager, const char* path, const size_t memory_budget, size_t key_size)
+{
+    if (!pager_open(pager, path, memory_budget)) {
+        return false;
+    }
+    meta_t* meta = pager_user_meta(pager);
+    if (pager_is_new(pager)) {
+        memcpy(meta->magic, DBPT_MAGIC, sizeof(meta->magic));
+        meta->key_size = (uint32_t)key_size;
+        meta->root = 0;
+        meta->size = 0;
+        pager_mark_meta_dirty(pager);
+        return true;
+    }
+    if (memcmp(meta->magic, DBPT_MAGIC, sizeof(meta->magic)) != 0 || meta->key_size != key_size) {
+        pager_close(pager);
+        return false;
+    }
+    return true;
+}
+
+static bool _add(pager_t* pager, const uint64_t value)
+{
+    core_t c = _core(pager);
+    if (c.meta->root == 0) {
+        page_id_t id;
+        node_t* leaf = pager_allocate(pager, &id);
+        if (leaf == nullptr)
+            return false;
+        leaf->is_leaf = true;
+        pager_release(pager, id, true);
+        c.meta->root = id;
+        pager_mark_meta_dirty(pager);
+    }
+
+    reserve_t reserve;
+    if (!_reserve_pages(&c, value, &reserve))
+        return false;
+    uint64_t split_key;
+    page_id_t split_id;
+    if (!_insert(&c, c.meta->root, value, &reserve, &split_key, &split_id)) {
+        _release_pages(&c, &reserve);
+        return false;
+    }
+
+    if (split_id != 0) { // Root was split, the tree grows by one level
+        page_id_t id;
+        node_t* root = _take_page(&reserve, &id);
+        root->is_leaf = false;
+        root->num_keys = 1;
+        _set_key(&c, root, 0, split_key);
+        _children(&c, root)[0] = c.meta->root;
+        _children(&c, root)[1] = split_id;
+        pager_release(pager, id, true);
+        c.meta->root = id;
+    }
+    c.meta->size++;
+    pager_mark_meta_dirty(pager);
+    return true;
+}
+
+static bool _del(pager_t* pager, const uint64_t value)
+{
+    core_t c = _core(pager);
+    bool underflow;
+    if (c.meta->root == 0 || !_remove(&c, c.meta->root, value, &underflow))
+        return false;
+    c.meta->size--;
+    pager_mark_meta_dirty(pager);
+
+    page_id_t root_id = c.meta->root;
+    node_t* root = pager_get(pager, root_id);
+    if (root != nullptr && root->num_keys == 0) { // Root ran empty, the tree shrinks by one level
+        c.meta->root = root->is_leaf ? 0 : _children(&c, root)[0];
+        pager_free(pager, root_id);
+    } else if (root != nullptr) {
+        pager_release(pager, root_id, false);
+    }
+    return true;
+}
+
+static bool _contains(pager_t* pager, const uint64_t value)
+{
+    core_t c = _core(pager);
+    node_t* leaf;
+    page_id_t id = _find_leaf(&c, value, &leaf);
+    if (id == 0)
+        return false;
+    uint32_t idx = _lower_bound_idx(&c, leaf, value);
+    bool found = idx < leaf->num_keys && _key(&c, leaf, idx) == value;
+    pager_release(pager, id, false);
+    return found;
+}
+
+/**
+ * @brief Calls consume for every key in [lo, hi] in ascending order, following the leaf chain
+ */
+static size_t _range(
+    pager_t* pager,
+    const uint64_t lo,
+    const uint64_t hi,
+    void (*consume)(uint64_t value, void* ctx),
+    void* ctx)
+{
+    core_t c = _core(pager);
+    size_t count = 0;
+    node_t* leaf;
+    page_id_t id = _find_leaf(&c, lo, &leaf);
+    if (id == 0 || hi < lo) {
+        if (id != 0)
+            pager_release(pager, id, false);
+        return 0;
+    }
+
+    uint32_t idx = _lower_bound_idx(&c, leaf, lo);
+    while (true) {
+        for (; idx < leaf->num_keys; idx++) {
+            uint64_t key = _key(&c, leaf, idx);
+            if (key > hi) {
+                pager_release(pager, id, false);
+                return count;
+            }
+            consume(key, ctx);
+            count++;
+        }
+        page_id_t next = leaf->next;
+        pager_release(pager, id, false);
+        if (next == 0 || (leaf = pager_get(pager, next)) == nullptr)
+            return count;
+        id = next;
+        idx = 0;
+    }
+}
+
+//--------------------------------------------------
+
+/**
+ * @brief Defines the typed functions of DBPT_DECLARE on top of the key size independent helpers
+ */
+#define DBPT_DEFINE(type)                                                                          \
+    /**                                                                                            \
+     * @brief Opens the tree stored at path, creating the file if it doesn't exist                 \
+     *                                                                                             \
+     * @param memory_budget Bytes the buffer pool may take                                         \
+     *                                                                                             \
+     * @return false if the file can't be opened or holds no tree of this key type                 \
+     */                                                                                            \
+    bool dbpt_open_##type(DBPT(type) * tree, const char* path, const size_t memory_budget)         \
+    {                                                                                              \
+        return _open(&tree->pager, path, memory_budget, sizeof(type));                            \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Adds value to the tree. Returns false if it's already present or on I/O errors       \
+     */                                                                                            \
+    bool dbpt_add_value_##type(DBPT(type) * tree, const type value)                                \
+    {                                                                                              \
+        return _add(&tree->pager, value);                                                          \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Deletes value from the tree. Returns false if it's not present or on I/O errors      \
+     */                                                                                            \
+    bool dbpt_del_value_##type(DBPT(type) * tree, const type value)                                \
+    {                                                                                              \
+        return _del(&tree->pager, value);                                                          \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Checks whether value is in the tree                                                  \
+     */                                                                                            \
+    bool dbpt_contains_##type(DBPT(type) * tree, const type value)                                 \
+    {                                                                                              \
+        return _contains(&tree->pager, value);                                                     \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Checks whether tree is empty                                                         \
+     */                                                                                            \
+    bool dbpt_is_empty_##type(DBPT(type) * tree)                                                   \
+    {                                                                                              \
+        return dbpt_size_##type(tree) == 0;                                                        \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Returns the number of keys in the tree                                               \
+     */                                                                                            \
+    size_t dbpt_size_##type(DBPT(type) * tree)                                                     \
+    {                                                                                              \
+        return ((meta_t*)pager_user_meta(&tree->pager))->size;                                     \
+    }                                                                                              \
+                                                                                                   \
+    typedef struct range_ctx_##type {                                                              \
+        void (*consume)(type value, void* ctx);                                                    \
+        void* ctx;                                                                                 \
+    } range_ctx_##type;                                                                            \
+                                                                                                   \
+    static void _consume_##type(uint64_t value, void* ctx)                                         \
+    {                                                                                              \
+        range_ctx_##type* range = ctx;                                                             \
+        range->consume((type)value, range->ctx);                                                   \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Calls consume for every key in [lo, hi] in ascending order                           \
+     *                                                                                             \
+     * @return Number of consumed keys                                                             \
+     */                                                                                            \
+    size_t dbpt_range_##type(                                                                      \
+        DBPT(type) * tree,                                                                         \
+        const type lo,                                                                             \
+        const type hi,                                                                             \
+        void (*consume)(type value, void* ctx),                                                    \
+        void* ctx)                                                                                 \
+    {                                                                                              \
+        range_ctx_##type range = { .consume = consume, .ctx = ctx };                               \
+        return _range(&tree->pager, lo, hi, _consume_##type, &range);                              \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Writes all changes back to the file                                                  \
+     */                                                                                            \
+    bool dbpt_flush_##type(DBPT(type) * tree)                                                      \
+    {                                                                                              \
+        return pager_flush(&tree->pager);                                                          \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Writes all changes back and closes the file. Returns whether writing succeeded       \
+     */                                                                                            \
+    bool dbpt_close_##type(DBPT(type) * tree)                                                      \
+    {                                                                                              \
+        return pager_close(&tree->pager);                                                          \
+    }
+
+DBPT_DEFINE(uint32_t)
+DBPT_DEFINE(uint64_t)
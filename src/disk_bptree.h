@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "utils/pager.h"
+
+/**
+ * @file disk_bptree.h
+ *
+ * Disk-backed B+ tree: the layout of bptree.h, with every node stored in a page of a file.
+ *
+ * Nodes are PAGER_PAGE_SIZE pages that reference their children by page id, and are accessed
+ * through the LRU buffer pool of a pager_t. Only the pages in the buffer pool take memory, so the
+ * memory budget given to dbpt_open bounds the memory use however many keys the file holds. A leaf
+ * holds about a thousand 4-byte keys, an inner node about five hundred children, so three levels
+ * already hold hundreds of millions of keys and the upper levels stay cached.
+ *
+ * Keys are unique: adding a key that is already present returns false. Changes are written back
+ * when pages are evicted, by dbpt_flush and by dbpt_close. The file is only consistent after one
+ * of the latter two.
+ */
+
+/**
+ * @brief Bytes at the start of every node page in front of the keys
+ */
+#define DBPT_PAGE_HEADER 16
+
+#define DBPT(type) dbpt_##type
+
+#define DBPT_DECLARE(type)                                                                         \
+    typedef struct DBPT(type) {                                                                    \
+        pager_t pager;                                                                             \
+    } DBPT(type);                                                                                  \
+    bool dbpt_open_##type(DBPT(type) * tree, const char* path, const size_t memory_budget);        \
+    bool dbpt_add_value_##type(DBPT(type) * tree, const type value);                               \
+    bool dbpt_del_value_##type(DBPT(type) * tree, const type value);                               \
+    bool dbpt_contains_##type(DBPT(type) * tree, const type value);                                \
+    bool dbpt_is_empty_##type(DBPT(type) * tree);                                                  \
+    size_t dbpt_size_##type(DBPT(type) * tree);                                                    \
+    size_t dbpt_range_##type(                                                                      \
+        DBPT(type) * tree,                                                                         \
+        const type lo,                                                                             \
+        const type hi,                                                                             \
+        void (*consume)(type value, void* ctx),                                                    \
+        void* ctx);                                                                                \
+    bool dbpt_flush_##type(DBPT(type) * tree);                                                     \
+    bool dbpt_close_##type(DBPT(type) * tree);
+
+DBPT_DECLARE(uint32_t);
+DBPT_DECLARE(uint64_t);
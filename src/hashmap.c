@@ -0,0 +1,544 @@
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "hashmap.h"
+
+/**
+ * @brief Control byte of a slot that never held a value. Ends probe sequences
+ */
+#define CTRL_EMPTY ((uint8_t)0x80)
+
+/**
+ * @brief Control byte of a slot whose value was erased. Probe sequences continue past it
+ */
+#define CTRL_DELETED ((uint8_t)0xFE)
+
+/**
+ * @brief Capacity of the first allocation of a table
+ */
+#define MIN_CAPACITY HASH_GROUP_WIDTH
+
+static_assert(offsetof(hm_entry_uint32_t_uint32_t, key) == 0, "Entries should start with a key");
+
+//--------------------------------------------------
+// Helper functions
+
+/**
+ * @brief Mixes all bits of the uint32_t key into all bits of the hash (the splitmix64 finalizer)
+ */
+static inline uint64_t _hash(const uint32_t key)
+{
+    uint64_t h = key + 0x9e3779b97f4a7c15ull;
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+    return h ^ (h >> 31);
+}
+
+/**
+ * @brief The 7 hash bits stored in the control byte. The low bits select the first group
+ */
+static inline uint8_t _h2(const uint64_t hash)
+{
+    return hash >> 57;
+}
+
+/**
+ * @brief Whether the control byte belongs to a slot holding a value
+ */
+static inline bool _is_full(const uint8_t ctrl)
+{
+    return (ctrl & 0x80) == 0;
+}
+
+/**
+ * @brief Bit i is set if control byte i of the group equals byte
+ */
+static inline uint32_t _match_byte(const uint8_t* group, const uint8_t byte)
+{
+#if defined(__SSE2__)
+    __m128i ctrl = _mm_load_si128((const __m128i*)group);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)byte)));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < HASH_GROUP_WIDTH; i++)
+        mask |= (uint32_t)(group[i] == byte) << i;
+    return mask;
+#endif
+}
+
+/**
+ * @brief Bit i is set if slot i of the group is empty or deleted, which both have the high bit set
+ */
+static inline uint32_t _match_free(const uint8_t* group)
+{
+#if defined(__SSE2__)
+    return _mm_movemask_epi8(_mm_load_si128((const __m128i*)group));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < HASH_GROUP_WIDTH; i++)
+        mask |= (uint32_t)(group[i] >> 7) << i;
+    return mask;
+#endif
+}
+
+/**
+ * @brief Finds the slot holding key. Returns capacity if there is none
+ *
+ * @details Groups are probed triangularly, which visits every group once as the number of groups
+ *          is a power of two. Slots are slot_size bytes apart and start with their uint32_t key,
+ *          which is all that sets and maps of this file store keys as.
+ */
+static inline size_t _find_slot(
+    const uint8_t* ctrl,
+    const size_t capacity,
+    const void* slots,
+    const size_t slot_size,
+    const uint32_t key,
+    const uint64_t hash)
+{
+    if (capacity == 0)
+        return capacity;
+
+    const size_t group_mask = capacity / HASH_GROUP_WIDTH - 1;
+    const uint8_t h2 = _h2(hash);
+    size_t group = hash & group_mask;
+
+    for (size_t step = 1; step <= group_mask + 1; step++) {
+        const uint8_t* group_ctrl = &ctrl[group * HASH_GROUP_WIDTH];
+        for (uint32_t match = _match_byte(group_ctrl, h2); match != 0; match &= match - 1) {
+            size_t idx = group * HASH_GROUP_WIDTH + __builtin_ctz(match);
+            if (*(const uint32_t*)((const char*)slots + idx * slot_size) == key)
+                return idx;
+        }
+        if (_match_byte(group_ctrl, CTRL_EMPTY) != 0)
+            return capacity;
+        group = (group + step) & group_mask;
+    }
+    return capacity;
+}
+
+/**
+ * @brief Finds the first empty or deleted slot along the probe sequence of hash
+ *
+ * @details The table never fills up completely, so there always is one.
+ */
+static inline size_t _find_free_slot(
+    const uint8_t* ctrl, const size_t capacity, const uint64_t hash)
+{
+    const size_t group_mask = capacity / HASH_GROUP_WIDTH - 1;
+    size_t group = hash & group_mask;
+
+    for (size_t step = 1;; step++) {
+        uint32_t match = _match_free(&ctrl[group * HASH_GROUP_WIDTH]);
+        if (match != 0)
+            return group * HASH_GROUP_WIDTH + __builtin_ctz(match);
+        group = (group + step) & group_mask;
+    }
+}
+
+/**
+ * @brief Marks the slot at idx as free again
+ *
+ * @details If the group of the slot still has an empty slot, no probe sequence ever continued past
+ *          this group, so the slot can become empty instead of deleted.
+ *
+ * @return Whether the slot became empty and can be used for growth again
+ */
+static bool _release_slot(uint8_t* ctrl, const size_t idx)
+{
+    const uint8_t* group_ctrl = &ctrl[idx / HASH_GROUP_WIDTH * HASH_GROUP_WIDTH];
+    bool empty = _match_byte(group_ctrl, CTRL_EMPTY) != 0;
+    ctrl[idx] = empty ? CTRL_EMPTY : CTRL_DELETED;
+    return empty;
+}
+
+/**
+ * @brief Number of values a table of capacity slots holds before it rehashes
+ */
+static size_t _max_load(const size_t capacity)
+{
+    return capacity - capacity / 8;
+}
+
+/**
+ * @brief Smallest capacity, but at least capacity, that holds count values
+ */
+static size_t _capacity_for(const size_t count, size_t capacity)
+{
+    if (capacity < MIN_CAPACITY)
+        capacity = MIN_CAPACITY;
+    while (_max_load(capacity) < count)
+        capacity *= 2;
+    return capacity;
+}
+
+/**
+ * @brief Capacity to rehash into once the table ran out of growth
+ *
+ * @details If at most half of the max load are values, the rest are deleted slots and rehashing at
+ *          the same capacity clears them.
+ */
+static size_t _next_capacity(const size_t size, const size_t capacity)
+{
+    if (capacity == 0)
+        return MIN_CAPACITY;
+    if (size <= _max_load(capacity) / 2)
+        return capacity;
+    return 2 * capacity;
+}
+
+/**
+ * @brief Allocates the control bytes of capacity slots, all of them empty
+ */
+static uint8_t* _new_ctrl(const size_t capacity)
+{
+    uint8_t* ctrl = aligned_alloc(HASH_GROUP_WIDTH, capacity);
+    if (ctrl != nullptr)
+        memset(ctrl, CTRL_EMPTY, capacity);
+    return ctrl;
+}
+
+/**
+ * @brief Moves all values of the set into a table of capacity slots
+ */
+static bool _hs_rehash(hs_uint32_t* set, const size_t capacity)
+{
+    uint8_t* ctrl = _new_ctrl(capacity);
+    uint32_t* values = malloc(capacity * sizeof(uint32_t));
+    if (ctrl == nullptr || values == nullptr) {
+        free(ctrl);
+        free(values);
+        return false;
+    }
+
+    for (size_t i = 0; i < set->capacity; i++) {
+        if (!_is_full(set->ctrl[i]))
+            continue;
+        uint64_t hash = _hash(set->values[i]);
+        size_t idx = _find_free_slot(ctrl, capacity, hash);
+        ctrl[idx] = _h2(hash);
+        values[idx] = set->values[i];
+    }
+
+    free(set->ctrl);
+    free(set->values);
+    set->ctrl = ctrl;
+    set->values = values;
+    set->capacity = capacity;
+    set->growth_left = _max_load(capacity) - set->size;
+    return true;
+}
+
+/**
+ * @brief Moves all entries of the map into a table of capacity slots
+ */
+static bool _hm_rehash(hm_uint32_t_uint32_t* map, const size_t capacity)
+{
+    uint8_t* ctrl = _new_ctrl(capacity);
+    hm_entry_uint32_t_uint32_t* entries = malloc(capacity * sizeof(hm_entry_uint32_t_uint32_t));
+    if (ctrl == nullptr || entries == nullptr) {
+        free(ctrl);
+        free(entries);
+        return false;
+    }
+
+    for (size_t i = 0; i < map->capacity; i++) {
+        if (!_is_full(map->ctrl[i]))
+            continue;
+        uint64_t hash = _hash(map->entries[i].key);
+        size_t idx = _find_free_slot(ctrl, capacity, hash);
+        ctrl[idx] = _h2(hash);
+        entries[idx] = map->entries[i];
+    }
+
+    free(map->ctrl);
+    free(map->entries);
+    map->ctrl = ctrl;
+    map->entries = entries;
+    map->capacity = capacity;
+    map->growth_left = _max_load(capacity) - map->size;
+    return true;
+}
+
+//--------------------------------------------------
+// Hash set
+
+/**
+ * @brief: A new set doesn't allocate until the first value is inserted
+ */
+hs_uint32_t hs_new_uint32_t()
+{
+    return (hs_uint32_t) {
+        .ctrl = nullptr,
+        .values = nullptr,
+        .size = 0,
+        .capacity = 0,
+        .growth_left = 0,
+    };
+}
+
+/**
+ * @brief: Inserts value into the set
+ *
+ * @return false if the value already is in the set or the table couldn't grow
+ */
+bool hs_insert_uint32_t(hs_uint32_t* set, const uint32_t value)
+{
+    uint64_t hash = _hash(value);
+    if (_find_slot(set->ctrl, set->capacity, set->values, sizeof(uint32_t), value, hash)
+        != set->capacity) {
+        return false;
+    }
+    if (set->growth_left == 0 && !_hs_rehash(set, _next_capacity(set->size, set->capacity))) {
+        return false;
+    }
+
+    size_t idx = _find_free_slot(set->ctrl, set->capacity, hash);
+    set->growth_left -= (set->ctrl[idx] == CTRL_EMPTY);
+    set->ctrl[idx] = _h2(hash);
+    set->values[idx] = value;
+    set->size++;
+    return true;
+}
+
+/**
+ * @brief: Checks whether value is in the set
+ */
+bool hs_contains_uint32_t(hs_uint32_t* set, const uint32_t value)
+{
+    return _find_slot(set->ctrl, set->capacity, set->values, sizeof(uint32_t), value, _hash(value))
+        != set->capacity;
+}
+
+/**
+ * @brief: Erases value from the set. Returns false if it wasn't in the set
+ */
+bool hs_erase_uint32_t(hs_uint32_t* set, const uint32_t value)
+{
+    size_t idx
+        = _find_slot(set->ctrl, set->capacity, set->values, sizeof(uint32_t), value, _hash(value));
+    if (idx == set->capacity) {
+        return false;
+    }
+    set->growth_left += _release_slot(set->ctrl, idx);
+    set->size--;
+    return true;
+}
+
+/**
+ * @brief: Makes sure the set can hold count values without rehashing
+ */
+bool hs_reserve_uint32_t(hs_uint32_t* set, const size_t count)
+{
+    if (count <= set->size + set->growth_left) {
+        return true;
+    }
+    return _hs_rehash(set, _capacity_for(count, set->capacity));
+}
+
+/**
+ * @brief: Removes all values and releases the memory
+ */
+bool hs_clear_uint32_t(hs_uint32_t* set)
+{
+    free(set->ctrl);
+    free(set->values);
+    *set = hs_new_uint32_t();
+    return true;
+}
+
+/**
+ * @brief: Returns whether or not the set is empty
+ */
+bool hs_is_empty_uint32_t(hs_uint32_t* set)
+{
+    return set->size == 0;
+}
+
+/**
+ * @brief: Returns the number of values in the set
+ */
+size_t hs_size_uint32_t(hs_uint32_t* set)
+{
+    return set->size;
+}
+
+/**
+ * @brief: Prints the set in slot order
+ */
+void hs_print_uint32_t(hs_uint32_t* set)
+{
+    size_t printed = 0;
+    printf("{");
+    for (size_t i = 0; i < set->capacity; i++) {
+        if (!_is_full(set->ctrl[i]))
+            continue;
+        printf("%u", set->values[i]);
+        if (++printed < set->size)
+            printf(", ");
+    }
+    printf("}\n");
+}
+
+//--------------------------------------------------
+// Hash map
+
+/**
+ * @brief: A new map doesn't allocate until the first entry is inserted
+ */
+hm_uint32_t_uint32_t hm_new_uint32_t_uint32_t()
+{
+    return (hm_uint32_t_uint32_t) {
+        .ctrl = nullptr,
+        .entries = nullptr,
+        .size = 0,
+        .capacity = 0,
+        .growth_left = 0,
+    };
+}
+
+/**
+ * @brief: Inserts key with value, or overwrites the value if key already is in the map
+ *
+ * @return false if the table couldn't grow
+ */
+bool hm_insert_uint32_t_uint32_t(
+    hm_uint32_t_uint32_t* map, const uint32_t key, const uint32_t value)
+{
+    uint64_t hash = _hash(key);
+    size_t idx = _find_slot(
+        map->ctrl, map->capacity, map->entries, sizeof(hm_entry_uint32_t_uint32_t), key, hash);
+    if (idx != map->capacity) {
+        map->entries[idx].value = value;
+        return true;
+    }
+    if (map->growth_left == 0 && !_hm_rehash(map, _next_capacity(map->size, map->capacity))) {
+        return false;
+    }
+
+    idx = _find_free_slot(map->ctrl, map->capacity, hash);
+    map->growth_left -= (map->ctrl[idx] == CTRL_EMPTY);
+    map->ctrl[idx] = _h2(hash);
+    map->entries[idx] = (hm_entry_uint32_t_uint32_t) { .key = key, .value = value };
+    map->size++;
+    return true;
+}
+
+/**
+ * @brief: Returns a pointer to the value of key, or nullptr if key isn't in the map
+ *
+ * @details The pointer stays valid until the next insertion or rehash.
+ */
+uint32_t* hm_find_uint32_t_uint32_t(hm_uint32_t_uint32_t* map, const uint32_t key)
+{
+    size_t idx = _find_slot(
+        map->ctrl,
+        map->capacity,
+        map->entries,
+        sizeof(hm_entry_uint32_t_uint32_t),
+        key,
+        _hash(key));
+    return (idx == map->capacity) ? nullptr : &map->entries[idx].value;
+}
+
+/**
+ * @brief: Gets the value of key
+ */
+Result_uint32_t hm_get_uint32_t_uint32_t(hm_uint32_t_uint32_t* map, const uint32_t key)
+{
+    uint32_t* value = hm_find_uint32_t_uint32_t(map, key);
+    if (value == nullptr) {
+        return Result_uint32_t_Err("Key not found");
+    }
+    return Result_uint32_t_Ok(*value);
+}
+
+/**
+ * @brief: Checks whether key is in the map
+ */
+bool hm_contains_uint32_t_uint32_t(hm_uint32_t_uint32_t* map, const uint32_t key)
+{
+    return hm_find_uint32_t_uint32_t(map, key) != nullptr;
+}
+
+/**
+ * @brief: Erases key and its value from the map. Returns false if key wasn't in the map
+ */
+bool hm_erase_uint32_t_uint32_t(hm_uint32_t_uint32_t* map, const uint32_t key)
+{
+    size_t idx = _find_slot(
+        map->ctrl,
+        map->capacity,
+        map->entries,
+        sizeof(hm_entry_uint32_t_uint32_t),
+        key,
+        _hash(key));
+    if (idx == map->capacity) {
+        return false;
+    }
+    map->growth_left += _release_slot(map->ctrl, idx);
+    map->size--;
+    return true;
+}
+
+/**
+ * @brief: Makes sure the map can hold count entries without rehashing
+ */
+bool hm_reserve_uint32_t_uint32_t(hm_uint32_t_uint32_t* map, const size_t count)
+{
+    if (count <= map->size + map->growth_left) {
+        return true;
+    }
+    return _hm_rehash(map, _capacity_for(count, map->capacity));
+}
+
+/**
+ * @brief: Removes all entries and releases the memory
+ */
+bool hm_clear_uint32_t_uint32_t(hm_uint32_t_uint32_t* map)
+{
+    free(map->ctrl);
+    free(map->entries);
+    *map = hm_new_uint32_t_uint32_t();
+    return true;
+}
+
+/**
+ * @brief: Returns whether or not the map is empty
+ */
+bool hm_is_empty_uint32_t_uint32_t(hm_uint32_t_uint32_t* map)
+{
+    return map->size == 0;
+}
+
+/**
+ * @brief: Returns the number of entries in the map
+ */
+size_t hm_size_uint32_t_uint32_t(hm_uint32_t_uint32_t* map)
+{
+    return map->size;
+}
+
+/**
+ * @brief: Prints the map in slot order
+ */
+void hm_print_uint32_t_uint32_t(hm_uint32_t_uint32_t* map)
+{
+    size_t printed = 0;
+    printf("{");
+    for (size_t i = 0; i < map->capacity; i++) {
+        if (!_is_full(map->ctrl[i]))
+            continue;
+        printf("%u: %u", map->entries[i].key, map->entries[i].value);
+        if (++printed < map->size)
+            printf(", ");
+    }
+    printf("}\n");
+}
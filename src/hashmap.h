@@ -0,0 +1,90 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "utils/result_types.h"
+
+/**
+ * @file hashmap.h
+ *
+ * Open-addressing hash set and hash map in the style of Swiss tables.
+ *
+ * Next to the slots the table keeps one control byte per slot. A control byte either marks the
+ * slot as empty or deleted, or holds 7 bits of the hash of the value stored in it. Slots are
+ * probed in aligned groups of 16, whose control bytes are compared against the hash bits at once
+ * with SSE2, or with a scalar loop if the compiler doesn't target SSE2. Only slots whose control
+ * byte matches are compared against the key, so a lookup usually touches one group of control
+ * bytes and one slot. A probe sequence ends at the first group with an empty slot.
+ *
+ * Tables hold at most 7/8 of their capacity, counting deleted slots. Once that is reached the
+ * table is rehashed, growing it unless most of the used slots are deleted ones.
+ *
+ * Only uint32_t keys are supported: hs_uint32_t is a set of uint32_t values and
+ * hm_uint32_t_uint32_t maps uint32_t keys to uint32_t values. Hashing and key comparison in
+ * hashmap.c are written for uint32_t, so HASHSET_DECLARE and HASHMAP_DECLARE have no DEFINE
+ * counterpart and declaring other types gives functions without an implementation.
+ */
+
+/**
+ * @brief Number of slots probed at once
+ */
+#define HASH_GROUP_WIDTH 16
+
+#define HASHSET(type) hs_##type
+
+#define HASHSET_DECLARE(type)                                                                      \
+    typedef struct HASHSET(type) {                                                                 \
+        uint8_t* ctrl;                                                                             \
+        type* values;                                                                              \
+        size_t size;                                                                               \
+        size_t capacity;                                                                           \
+        size_t growth_left;                                                                        \
+    } HASHSET(type);                                                                               \
+    HASHSET(type) hs_new_##type();                                                                 \
+    bool hs_insert_##type(HASHSET(type) * set, const type value);                                  \
+    bool hs_contains_##type(HASHSET(type) * set, const type value);                                \
+    bool hs_erase_##type(HASHSET(type) * set, const type value);                                   \
+    bool hs_reserve_##type(HASHSET(type) * set, const size_t count);                               \
+    bool hs_clear_##type(HASHSET(type) * set);                                                     \
+    bool hs_is_empty_##type(HASHSET(type) * set);                                                  \
+    size_t hs_size_##type(HASHSET(type) * set);                                                    \
+    void hs_print_##type(HASHSET(type) * set);
+
+HASHSET_DECLARE(uint32_t);
+
+#define HASHMAP(key_type, value_type) hm_##key_type##_##value_type
+
+#define HASHMAP_ENTRY(key_type, value_type) hm_entry_##key_type##_##value_type
+
+#define HASHMAP_DECLARE(key_type, value_type)                                                      \
+    typedef struct HASHMAP_ENTRY(key_type, value_type) {                                           \
+        key_type key;                                                                              \
+        value_type value;                                                                          \
+    } HASHMAP_ENTRY(key_type, value_type);                                                         \
+    typedef struct HASHMAP(key_type, value_type) {                                                 \
+        uint8_t* ctrl;                                                                             \
+        HASHMAP_ENTRY(key_type, value_type) * entries;                                             \
+        size_t size;                                                                               \
+        size_t capacity;                                                                           \
+        size_t growth_left;                                                                        \
+    } HASHMAP(key_type, value_type);                                                               \
+    HASHMAP(key_type, value_type) hm_new_##key_type##_##value_type();                              \
+    bool hm_insert_##key_type##_##value_type(                                                      \
+        HASHMAP(key_type, value_type) * map, const key_type key, const value_type value);          \
+    value_type* hm_find_##key_type##_##value_type(                                                 \
+        HASHMAP(key_type, value_type) * map, const key_type key);                                  \
+    RESULT(value_type)                                                                             \
+    hm_get_##key_type##_##value_type(HASHMAP(key_type, value_type) * map, const key_type key);     \
+    bool hm_contains_##key_type##_##value_type(                                                    \
+        HASHMAP(key_type, value_type) * map, const key_type key);                                  \
+    bool hm_erase_##key_type##_##value_type(                                                       \
+        HASHMAP(key_type, value_type) * map, const key_type key);                                  \
+    bool hm_reserve_##key_type##_##value_type(                                                     \
+        HASHMAP(key_type, value_type) * map, const size_t count);                                  \
+    bool hm_clear_##key_type##_##value_type(HASHMAP(key_type, value_type) * map);                  \
+    bool hm_is_empty_##key_type##_##value_type(HASHMAP(key_type, value_type) * map);               \
+    size_t hm_size_##key_type##_##value_type(HASHMAP(key_type, value_type) * map);                 \
+    void hm_print_##key_type##_##value_type(HASHMAP(key_type, value_type) * map);
+
+HASHMAP_DECLARE(uint32_t, uint32_t);
@@ -0,0 +1,442 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "heap.h"
+
+/**
+ * @brief Slots in front of the root, so that the children of every node start an aligned group
+ */
+#define PADDING (HEAP_ARITY - 1)
+
+//--------------------------------------------------
+// Helper functions
+
+/**
+ * @brief Allocates room for capacity elements of the given size after the padding, aligned to
+ *        HEAP_ALIGNMENT
+ */
+static void* _alloc_slots(const size_t capacity, const size_t size)
+{
+    size_t bytes = (capacity + PADDING) * size;
+    bytes = (bytes + HEAP_ALIGNMENT - 1) / HEAP_ALIGNMENT * HEAP_ALIGNMENT;
+    return aligned_alloc(HEAP_ALIGNMENT, bytes);
+}
+
+/**
+ * @brief Whether a belongs closer to the root than b
+ */
+static inline bool _before(const bool is_max, const uint32_t a, const uint32_t b)
+{
+    return is_max ? a > b : a < b;
+}
+
+/**
+ * @brief Makes room for at least one more value, doubling the capacity if needed
+ *
+ * @details aligned_alloc has no realloc counterpart, so the values are copied over by hand
+ */
+static bool _grow(heap_uint32_t* heap)
+{
+    if (heap->length < heap->capacity)
+        return true;
+    size_t capacity = (heap->capacity < HEAP_MIN_CAPACITY) ? HEAP_MIN_CAPACITY : 2 * heap->capacity;
+    uint32_t* data = _alloc_slots(capacity, sizeof(uint32_t));
+    if (data == nullptr) {
+        return false;
+    }
+    if (heap->data != nullptr)
+        memcpy(&data[PADDING], &heap->data[PADDING], heap->length * sizeof(uint32_t));
+    free(heap->data);
+    heap->data = data;
+    heap->capacity = capacity;
+    return true;
+}
+
+/**
+ * @brief Moves the value at position i up until its parent comes before it
+ */
+static void _sift_up(heap_uint32_t* heap, size_t i)
+{
+    uint32_t* slots = &heap->data[PADDING];
+    const uint32_t value = slots[i];
+    while (i > 0) {
+        size_t parent = (i - 1) / HEAP_ARITY;
+        if (!_before(heap->is_max, value, slots[parent]))
+            break;
+        slots[i] = slots[parent];
+        i = parent;
+    }
+    slots[i] = value;
+}
+
+/**
+ * @brief Moves the value at position i down until it comes before all of its children
+ *
+ * @details The value is only written once at its final position, every level just moves the
+ *          child that comes first up into the hole
+ */
+static void _sift_down(heap_uint32_t* heap, size_t i)
+{
+    uint32_t* slots = &heap->data[PADDING];
+    const size_t length = heap->length;
+    const uint32_t value = slots[i];
+    while (true) {
+        size_t first = HEAP_ARITY * i + 1;
+        if (first >= length)
+            break;
+        size_t last = (first + HEAP_ARITY < length) ? first + HEAP_ARITY : length;
+        size_t best = first;
+        for (size_t child = first + 1; child < last; child++) {
+            if (_before(heap->is_max, slots[child], slots[best]))
+                best = child;
+        }
+        if (!_before(heap->is_max, slots[best], value))
+            break;
+        slots[i] = slots[best];
+        i = best;
+    }
+    slots[i] = value;
+}
+
+/**
+ * @brief Allocates the buffers of an indexed heap with capacity ids, all of them absent
+ */
+static bool _iheap_alloc(iheap_uint32_t* heap, const size_t capacity)
+{
+    heap->data = _alloc_slots(capacity, sizeof(iheap_entry_uint32_t));
+    heap->slots = malloc(capacity * sizeof(size_t));
+    if (heap->data == nullptr || heap->slots == nullptr) {
+        free(heap->data);
+        free(heap->slots);
+        heap->data = nullptr;
+        heap->slots = nullptr;
+        return false;
+    }
+    for (size_t id = 0; id < capacity; id++)
+        heap->slots[id] = SIZE_MAX;
+    return true;
+}
+
+/**
+ * @brief Same as _sift_up, also updating the slot of every entry that moves
+ */
+static void _iheap_sift_up(iheap_uint32_t* heap, size_t i)
+{
+    iheap_entry_uint32_t* entries = &heap->data[PADDING];
+    const iheap_entry_uint32_t entry = entries[i];
+    while (i > 0) {
+        size_t parent = (i - 1) / HEAP_ARITY;
+        if (!_before(heap->is_max, entry.key, entries[parent].key))
+            break;
+        entries[i] = entries[parent];
+        heap->slots[entries[i].id] = i;
+        i = parent;
+    }
+    entries[i] = entry;
+    heap->slots[entry.id] = i;
+}
+
+/**
+ * @brief Same as _sift_down, also updating the slot of every entry that moves
+ */
+static void _iheap_sift_down(iheap_uint32_t* heap, size_t i)
+{
+    iheap_entry_uint32_t* entries = &heap->data[PADDING];
+    const size_t length = heap->length;
+    const iheap_entry_uint32_t entry = entries[i];
+    while (true) {
+        size_t first = HEAP_ARITY * i + 1;
+        if (first >= length)
+            break;
+        size_t last = (first + HEAP_ARITY < length) ? first + HEAP_ARITY : length;
+        size_t best = first;
+        for (size_t child = first + 1; child < last; child++) {
+            if (_before(heap->is_max, entries[child].key, entries[best].key))
+                best = child;
+        }
+        if (!_before(heap->is_max, entries[best].key, entry.key))
+            break;
+        entries[i] = entries[best];
+        heap->slots[entries[i].id] = i;
+        i = best;
+    }
+    entries[i] = entry;
+    heap->slots[entry.id] = i;
+}
+
+//--------------------------------------------------
+
+/**
+ * @brief: A new heap doesn't allocate until the first value is pushed
+ *
+ * @param is_max Whether the largest value is on top instead of the smallest
+ */
+heap_uint32_t heap_new_uint32_t(const bool is_max)
+{
+    return (heap_uint32_t) {
+        .data = nullptr,
+        .length = 0,
+        .capacity = 0,
+        .is_max = is_max,
+    };
+}
+
+/**
+ * @brief: Builds a heap of a copy of the values in O(n) by sifting down every inner node, from the
+ *         last one up to the root
+ *
+ * @return An empty heap if count is 0 or out of memory
+ */
+heap_uint32_t heap_from_array_uint32_t(
+    const uint32_t* values,
+    const size_t count,
+    const bool is_max)
+{
+    heap_uint32_t heap = heap_new_uint32_t(is_max);
+    if (count == 0) {
+        return heap;
+    }
+    heap.data = _alloc_slots(count, sizeof(uint32_t));
+    if (heap.data == nullptr) {
+        return heap;
+    }
+    memcpy(&heap.data[PADDING], values, count * sizeof(uint32_t));
+    heap.length = count;
+    heap.capacity = count;
+    for (size_t i = (count + HEAP_ARITY - 2) / HEAP_ARITY; i-- > 0;)
+        _sift_down(&heap, i);
+    return heap;
+}
+
+/**
+ * @brief: Adds the value to the heap in O(log n)
+ */
+bool heap_push_uint32_t(heap_uint32_t* heap, const uint32_t value)
+{
+    if (!_grow(heap)) {
+        return false;
+    }
+    heap->data[PADDING + heap->length] = value;
+    _sift_up(heap, heap->length++);
+    return true;
+}
+
+/**
+ * @brief: Removes the top value and returns it
+ */
+Result_uint32_t heap_pop_uint32_t(heap_uint32_t* heap)
+{
+    if (heap->length == 0) {
+        return Result_uint32_t_Err("Trying to pop from empty heap");
+    }
+    uint32_t* slots = &heap->data[PADDING];
+    uint32_t top = slots[0];
+    slots[0] = slots[--heap->length];
+    if (heap->length > 0)
+        _sift_down(heap, 0);
+    return Result_uint32_t_Ok(top);
+}
+
+/**
+ * @brief: Returns the top value without removing it
+ */
+Result_uint32_t heap_peek_uint32_t(heap_uint32_t* heap)
+{
+    if (heap->length == 0) {
+        return Result_uint32_t_Err("Trying to peek into empty heap");
+    }
+    return Result_uint32_t_Ok(heap->data[PADDING]);
+}
+
+/**
+ * @brief: Returns whether or not the heap is empty
+ */
+bool heap_is_empty_uint32_t(heap_uint32_t* heap)
+{
+    return heap->length == 0;
+}
+
+/**
+ * @brief: Returns the number of values in the heap
+ */
+size_t heap_size_uint32_t(heap_uint32_t* heap)
+{
+    return heap->length;
+}
+
+/**
+ * @brief: Removes all values and releases the memory
+ */
+bool heap_clear_uint32_t(heap_uint32_t* heap)
+{
+    free(heap->data);
+    heap->data = nullptr;
+    heap->length = 0;
+    heap->capacity = 0;
+    return true;
+}
+
+/**
+ * @brief: Prints the values in heap order, level by level
+ */
+void heap_print_uint32_t(heap_uint32_t* heap)
+{
+    printf("[");
+    for (size_t i = 0; i < heap->length; i++) {
+        printf("%u", heap->data[PADDING + i]);
+        if (i + 1 < heap->length)
+            printf(", ");
+    }
+    printf("]\n");
+}
+
+/**
+ * @brief: A new indexed heap for the ids [0, capacity)
+ *
+ * @details Unlike heap_uint32_t it never grows, so both buffers are allocated up front. The
+ *          capacity is 0 if that fails.
+ */
+iheap_uint32_t iheap_new_uint32_t(const size_t capacity, const bool is_max)
+{
+    iheap_uint32_t heap = {
+        .data = nullptr,
+        .slots = nullptr,
+        .length = 0,
+        .capacity = 0,
+        .is_max = is_max,
+    };
+    if (capacity > 0 && _iheap_alloc(&heap, capacity))
+        heap.capacity = capacity;
+    return heap;
+}
+
+/**
+ * @brief: Adds the id with the given key
+ *
+ * @return false if the id is out of range or already in the heap
+ */
+bool iheap_push_uint32_t(iheap_uint32_t* heap, const uint32_t id, const uint32_t key)
+{
+    if (id >= heap->capacity || heap->slots[id] != SIZE_MAX) {
+        return false;
+    }
+    heap->data[PADDING + heap->length] = (iheap_entry_uint32_t) { .key = key, .id = id };
+    _iheap_sift_up(heap, heap->length++);
+    return true;
+}
+
+/**
+ * @brief: Changes the key of an id in the heap in O(log n). A key that moves the id closer to the
+ *         top, the decrease-key of a min heap, only ever sifts up.
+ *
+ * @return false if the id is not in the heap
+ */
+bool iheap_update_key_uint32_t(iheap_uint32_t* heap, const uint32_t id, const uint32_t key)
+{
+    if (!iheap_contains_uint32_t(heap, id)) {
+        return false;
+    }
+    size_t i = heap->slots[id];
+    iheap_entry_uint32_t* entry = &heap->data[PADDING + i];
+    bool up = _before(heap->is_max, key, entry->key);
+    entry->key = key;
+    if (up)
+        _iheap_sift_up(heap, i);
+    else
+        _iheap_sift_down(heap, i);
+    return true;
+}
+
+/**
+ * @brief: Removes the id with the top key and returns it
+ */
+Result_uint32_t iheap_pop_uint32_t(iheap_uint32_t* heap)
+{
+    if (heap->length == 0) {
+        return Result_uint32_t_Err("Trying to pop from empty heap");
+    }
+    iheap_entry_uint32_t* entries = &heap->data[PADDING];
+    uint32_t top = entries[0].id;
+    heap->slots[top] = SIZE_MAX;
+    entries[0] = entries[--heap->length];
+    if (heap->length > 0)
+        _iheap_sift_down(heap, 0);
+    return Result_uint32_t_Ok(top);
+}
+
+/**
+ * @brief: Returns the id with the top key without removing it
+ */
+Result_uint32_t iheap_peek_uint32_t(iheap_uint32_t* heap)
+{
+    if (heap->length == 0) {
+        return Result_uint32_t_Err("Trying to peek into empty heap");
+    }
+    return Result_uint32_t_Ok(heap->data[PADDING].id);
+}
+
+/**
+ * @brief: Returns the key of an id in the heap
+ */
+Result_uint32_t iheap_key_uint32_t(iheap_uint32_t* heap, const uint32_t id)
+{
+    if (!iheap_contains_uint32_t(heap, id)) {
+        return Result_uint32_t_Err("Id is not in the heap");
+    }
+    return Result_uint32_t_Ok(heap->data[PADDING + heap->slots[id]].key);
+}
+
+/**
+ * @brief: Returns whether the id is in the heap
+ */
+bool iheap_contains_uint32_t(iheap_uint32_t* heap, const uint32_t id)
+{
+    return id < heap->capacity && heap->slots[id] != SIZE_MAX;
+}
+
+/**
+ * @brief: Returns whether or not the heap is empty
+ */
+bool iheap_is_empty_uint32_t(iheap_uint32_t* heap)
+{
+    return heap->length == 0;
+}
+
+/**
+ * @brief: Returns the number of ids in the heap
+ */
+size_t iheap_size_uint32_t(iheap_uint32_t* heap)
+{
+    return heap->length;
+}
+
+/**
+ * @brief: Removes all ids and releases the memory. The heap has no capacity afterwards.
+ */
+bool iheap_clear_uint32_t(iheap_uint32_t* heap)
+{
+    free(heap->data);
+    free(heap->slots);
+    heap->data = nullptr;
+    heap->slots = nullptr;
+    heap->length = 0;
+    heap->capacity = 0;
+    return true;
+}
+
+/**
+ * @brief: Prints the id: key pairs in heap order
+ */
+void iheap_print_uint32_t(iheap_uint32_t* heap)
+{
+    printf("[");
+    for (size_t i = 0; i < heap->length; i++) {
+        iheap_entry_uint32_t entry = heap->data[PADDING + i];
+        printf("%u: %u", entry.id, entry.key);
+        if (i + 1 < heap->length)
+            printf(", ");
+    }
+    printf("]\n");
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "utils/result_types.h"
+
+/**
+ * @file heap.h
+ *
+ * Array-backed d-ary heaps, ordered as a min heap or a max heap.
+ *
+ * Every node has HEAP_ARITY children. The root is stored at slot HEAP_ARITY - 1 of a buffer
+ * aligned to HEAP_ALIGNMENT, which puts the children of every node into one aligned group of
+ * HEAP_ARITY slots. With 4 children of 4 to 8 bytes a group is at most 32 bytes, so each level a
+ * value is sifted through touches a single cache line, and the tree is half as deep as a binary
+ * heap.
+ *
+ * heap_uint32_t is a plain priority queue of values. iheap_uint32_t keeps a key for each id in
+ * [0, capacity) and remembers where every id sits in the heap, so the key of an id that is
+ * already queued can be changed in O(log n), e.g. the decrease-key of Dijkstra or Prim.
+ */
+
+/**
+ * @brief Number of children per node
+ */
+#define HEAP_ARITY 4
+
+/**
+ * @brief Alignment of the heap buffers, one cache line
+ */
+#define HEAP_ALIGNMENT 64
+
+/**
+ * @brief Capacity of the first allocation of a heap
+ */
+#define HEAP_MIN_CAPACITY 16
+
+#define HEAP(type) heap_##type
+
+#define HEAP_DECLARE(type)                                                                         \
+    typedef struct HEAP(type) {                                                                    \
+        type* data;                                                                                \
+        size_t length;                                                                             \
+        size_t capacity;                                                                           \
+        bool is_max;                                                                               \
+    } HEAP(type);                                                                                  \
+    HEAP(type) heap_new_##type(const bool is_max);                                                 \
+    HEAP(type) heap_from_array_##type(const type* values, const size_t count, const bool is_max);  \
+    bool heap_push_##type(HEAP(type) * heap, const type value);                                    \
+    RESULT(type) heap_pop_##type(HEAP(type) * heap);                                               \
+    RESULT(type) heap_peek_##type(HEAP(type) * heap);                                              \
+    bool heap_is_empty_##type(HEAP(type) * heap);                                                  \
+    size_t heap_size_##type(HEAP(type) * heap);                                                    \
+    bool heap_clear_##type(HEAP(type) * heap);                                                     \
+    void heap_print_##type(HEAP(type) * heap);
+
+#define IHEAP(type) iheap_##type
+
+#define IHEAP_ENTRY(type) iheap_entry_##type
+
+#define IHEAP_DECLARE(type)                                                                        \
+    typedef struct IHEAP_ENTRY(type) {                                                             \
+        type key;                                                                                  \
+        uint32_t id;                                                                               \
+    } IHEAP_ENTRY(type);                                                                           \
+    typedef struct IHEAP(type) {                                                                   \
+        IHEAP_ENTRY(type) * data;                                                                  \
+        /**                                                                                        \
+         * @brief Slot of every id in data, or SIZE_MAX if the id is not in the heap               \
+         */                                                                                        \
+        size_t* slots;                                                                             \
+        size_t length;                                                                             \
+        size_t capacity;                                                                           \
+        bool is_max;                                                                               \
+    } IHEAP(type);                                                                                 \
+    IHEAP(type) iheap_new_##type(const size_t capacity, const bool is_max);                        \
+    bool iheap_push_##type(IHEAP(type) * heap, const uint32_t id, const type key);                 \
+    bool iheap_update_key_##type(IHEAP(type) * heap, const uint32_t id, const type key);           \
+    RESULT(uint32_t) iheap_pop_##type(IHEAP(type) * heap);                                         \
+    RESULT(uint32_t) iheap_peek_##type(IHEAP(type) * heap);                                        \
+    RESULT(type) iheap_key_##type(IHEAP(type) * heap, const uint32_t id);                          \
+    bool iheap_contains_##type(IHEAP(type) * heap, const uint32_t id);                             \
+    bool iheap_is_empty_##type(IHEAP(type) * heap);                                                \
+    size_t iheap_size_##type(IHEAP(type) * heap);                                                  \
+    bool iheap_clear_##type(IHEAP(type) * heap);                                                   \
+    void iheap_print_##type(IHEAP(type) * heap);
+
+HEAP_DECLARE(uint32_t);
+IHEAP_DECLARE(uint32_t);
@@ -0,0 +1,402 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tree.h"
+
+/**
+ * @brief Number of slots an index can address, slot IB_TREE_NIL included
+ */
+#define MAX_SLOTS ((size_t)UINT32_MAX + 1)
+
+/**
+ * @brief Levels of the traversal stack kept on the call stack, enough for any balanced tree
+ */
+#define TRAVERSE_STACK_SIZE 64
+
+static_assert(sizeof(ibt_node_uint32_t) == 12, "Nodes of 4-byte values should take 12 bytes");
+
+//--------------------------------------------------
+// Helper functions
+
+/**
+ * @brief Reallocates the nodes to exactly capacity slots, which must not be fewer than are used
+ *
+ * @details The first allocation hands out slot IB_TREE_NIL, which stays unused
+ */
+static bool _resize(ibt_uint32_t* tree, const size_t capacity)
+{
+    if (capacity > MAX_SLOTS)
+        return false;
+    ibt_node_uint32_t* nodes = realloc(tree->nodes, capacity * sizeof(ibt_node_uint32_t));
+    if (nodes == nullptr) {
+        return false;
+    }
+    tree->nodes = nodes;
+    tree->capacity = capacity;
+    if (tree->length == 0)
+        tree->length = 1;
+    return true;
+}
+
+/**
+ * @brief Makes room for one more slot, doubling the capacity
+ */
+static bool _grow(ibt_uint32_t* tree)
+{
+    if (tree->length < tree->capacity)
+        return true;
+    if (tree->capacity == MAX_SLOTS)
+        return false;
+    size_t capacity = (tree->capacity < IB_TREE_MIN_CAPACITY) ? IB_TREE_MIN_CAPACITY
+                                                             : 2 * tree->capacity;
+    return _resize(tree, (capacity < MAX_SLOTS) ? capacity : MAX_SLOTS);
+}
+
+/**
+ * @brief Hands out a recycled slot, or the next unused one. Returns IB_TREE_NIL if out of memory
+ */
+static uint32_t _alloc_slot(ibt_uint32_t* tree)
+{
+    if (tree->free != IB_TREE_NIL) {
+        uint32_t index = tree->free;
+        tree->free = tree->nodes[index].left;
+        return index;
+    }
+    if (!_grow(tree))
+        return IB_TREE_NIL;
+    return (uint32_t)tree->length++;
+}
+
+/**
+ * @brief Puts the slot at the front of the chain of freed slots
+ */
+static void _free_slot(ibt_uint32_t* tree, const uint32_t index)
+{
+    tree->nodes[index].left = tree->free;
+    tree->free = index;
+}
+
+/**
+ * @brief Links the slots [lo, hi) holding ascending values into a perfectly balanced subtree and
+ *        returns the index of its root
+ */
+static uint32_t _link_sorted(ibt_node_uint32_t* nodes, const size_t lo, const size_t hi)
+{
+    if (lo >= hi)
+        return IB_TREE_NIL;
+    size_t mid = lo + (hi - lo) / 2;
+    nodes[mid].left = _link_sorted(nodes, lo, mid);
+    nodes[mid].right = _link_sorted(nodes, mid + 1, hi);
+    return (uint32_t)mid;
+}
+
+/**
+ * @brief Doubles the traversal stack, moving it off the call stack the first time
+ */
+static bool _grow_stack(uint32_t** stack, size_t* capacity, uint32_t* local)
+{
+    size_t bytes = 2 * *capacity * sizeof(uint32_t);
+    uint32_t* grown = (*stack == local) ? malloc(bytes) : realloc(*stack, bytes);
+    if (grown == nullptr) {
+        return false;
+    }
+    if (*stack == local)
+        memcpy(grown, local, *capacity * sizeof(uint32_t));
+    *stack = grown;
+    *capacity *= 2;
+    return true;
+}
+
+//--------------------------------------------------
+
+/**
+ * @brief Creates a new tree. Nothing is allocated before the first value is added
+ */
+ibt_uint32_t ibt_new_uint32_t()
+{
+    return (ibt_uint32_t) {
+        .nodes = nullptr,
+        .length = 0,
+        .capacity = 0,
+        .size = 0,
+        .root = IB_TREE_NIL,
+        .free = IB_TREE_NIL,
+    };
+}
+
+/**
+ * @brief Creates a perfectly balanced tree out of length ascending values
+ *
+ * @details Values are stored in the slots in ascending order, so an in-order walk reads the array
+ *          front to back. Costs a single allocation of exactly length + 1 slots. If it fails the
+ *          tree stays empty.
+ */
+ibt_uint32_t ibt_build_from_sorted_uint32_t(const uint32_t* values, const size_t length)
+{
+    ibt_uint32_t tree = ibt_new_uint32_t();
+    if (length == 0 || !_resize(&tree, length + 1))
+        return tree;
+
+    for (size_t i = 0; i < length; i++)
+        tree.nodes[i + 1] = (ibt_node_uint32_t) { .value = values[i] };
+    tree.length = length + 1;
+    tree.size = length;
+    tree.root = _link_sorted(tree.nodes, 1, length + 1);
+    return tree;
+}
+
+/**
+ * @brief Makes room for capacity values, so that adding them doesn't reallocate
+ */
+bool ibt_reserve_uint32_t(ibt_uint32_t* tree, const size_t capacity)
+{
+    if (capacity + 1 <= tree->capacity)
+        return true;
+    return _resize(tree, capacity + 1);
+}
+
+/**
+ * @brief Adds value to the tree. Equal values go to the right, like in bt_uint32_t
+ */
+bool ibt_add_value_uint32_t(ibt_uint32_t* tree, const uint32_t value)
+{
+    uint32_t index = _alloc_slot(tree);
+    if (index == IB_TREE_NIL) {
+        return false;
+    }
+    // Allocating may move the nodes, so the links are only looked up afterwards
+    ibt_node_uint32_t* nodes = tree->nodes;
+    nodes[index] = (ibt_node_uint32_t) {
+        .value = value,
+        .left = IB_TREE_NIL,
+        .right = IB_TREE_NIL,
+    };
+
+    uint32_t* link = &tree->root;
+    while (*link != IB_TREE_NIL) {
+        ibt_node_uint32_t* node = &nodes[*link];
+        link = (value < node->value) ? &node->left : &node->right;
+    }
+    *link = index;
+    tree->size++;
+    return true;
+}
+
+/**
+ * @brief Deletes the first appearance of value
+ *
+ * @details Without parent links the search keeps the link that points to the current node. A node
+ *          with two children takes the value of its in-order successor, whose slot is freed.
+ */
+bool ibt_del_value_uint32_t(ibt_uint32_t* tree, const uint32_t value)
+{
+    ibt_node_uint32_t* nodes = tree->nodes;
+    uint32_t* link = &tree->root;
+    while (*link != IB_TREE_NIL && nodes[*link].value != value)
+        link = (value < nodes[*link].value) ? &nodes[*link].left : &nodes[*link].right;
+    if (*link == IB_TREE_NIL) {
+        return false;
+    }
+
+    uint32_t index = *link;
+    ibt_node_uint32_t* node = &nodes[index];
+    if (node->left == IB_TREE_NIL) {
+        *link = node->right;
+    } else if (node->right == IB_TREE_NIL) {
+        *link = node->left;
+    } else {
+        uint32_t* successor_link = &node->right;
+        while (nodes[*successor_link].left != IB_TREE_NIL)
+            successor_link = &nodes[*successor_link].left;
+        index = *successor_link;
+        node->value = nodes[index].value;
+        *successor_link = nodes[index].right;
+    }
+
+    _free_slot(tree, index);
+    tree->size--;
+    return true;
+}
+
+/**
+ * @brief Checks whether value is in the tree
+ */
+bool ibt_contains_uint32_t(ibt_uint32_t* tree, const uint32_t value)
+{
+    const ibt_node_uint32_t* nodes = tree->nodes;
+    uint32_t cur = tree->root;
+
+    while (cur != IB_TREE_NIL) {
+        if (nodes[cur].value == value)
+            return true;
+        cur = (value < nodes[cur].value) ? nodes[cur].left : nodes[cur].right;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Returns the smallest value of the tree
+ */
+RESULT(uint32_t) ibt_min_uint32_t(ibt_uint32_t* tree)
+{
+    if (tree->root == IB_TREE_NIL) {
+        return RESULT_ERR(uint32_t)("Empty tree");
+    }
+    uint32_t cur = tree->root;
+    while (tree->nodes[cur].left != IB_TREE_NIL)
+        cur = tree->nodes[cur].left;
+    return RESULT_OK(uint32_t)(tree->nodes[cur].value);
+}
+
+/**
+ * @brief Returns the largest value of the tree
+ */
+RESULT(uint32_t) ibt_max_uint32_t(ibt_uint32_t* tree)
+{
+    if (tree->root == IB_TREE_NIL) {
+        return RESULT_ERR(uint32_t)("Empty tree");
+    }
+    uint32_t cur = tree->root;
+    while (tree->nodes[cur].right != IB_TREE_NIL)
+        cur = tree->nodes[cur].right;
+    return RESULT_OK(uint32_t)(tree->nodes[cur].value);
+}
+
+/**
+ * @brief Returns the smallest value that is not less than value
+ */
+RESULT(uint32_t) ibt_lower_bound_uint32_t(ibt_uint32_t* tree, const uint32_t value)
+{
+    const ibt_node_uint32_t* nodes = tree->nodes;
+    uint32_t cur = tree->root, bound = IB_TREE_NIL;
+
+    while (cur != IB_TREE_NIL) {
+        if (nodes[cur].value >= value) {
+            bound = cur;
+            cur = nodes[cur].left;
+        } else {
+            cur = nodes[cur].right;
+        }
+    }
+
+    if (bound == IB_TREE_NIL) {
+        return RESULT_ERR(uint32_t)("No such value");
+    }
+    return RESULT_OK(uint32_t)(nodes[bound].value);
+}
+
+/**
+ * @brief Hands every value to consume in ascending order and returns the number of values
+ *
+ * @details Without parent links the walk keeps the path to the current node on a stack of indices.
+ *          The first TRAVERSE_STACK_SIZE levels live on the call stack, deeper trees move the stack
+ *          to the heap. The tree is only read, so consume may look values up in it, but must not
+ *          modify it. If the stack can't grow the walk stops early, and returns fewer values than
+ *          ibt_size.
+ */
+size_t ibt_traverse_uint32_t(
+    ibt_uint32_t* tree,
+    void (*consume)(uint32_t value, void* ctx),
+    void* ctx)
+{
+    const ibt_node_uint32_t* nodes = tree->nodes;
+    uint32_t local[TRAVERSE_STACK_SIZE];
+    uint32_t* stack = local;
+    size_t depth = 0, capacity = TRAVERSE_STACK_SIZE, count = 0;
+    uint32_t cur = tree->root;
+
+    while (cur != IB_TREE_NIL || depth > 0) {
+        while (cur != IB_TREE_NIL) {
+            if (depth == capacity && !_grow_stack(&stack, &capacity, local))
+                goto out;
+            stack[depth++] = cur;
+            cur = nodes[cur].left;
+        }
+        cur = stack[--depth];
+        consume(nodes[cur].value, ctx);
+        count++;
+        cur = nodes[cur].right;
+    }
+
+out:
+    if (stack != local)
+        free(stack);
+    return count;
+}
+
+/**
+ * @brief Checks whether tree is empty
+ */
+bool ibt_is_empty_uint32_t(ibt_uint32_t* tree)
+{
+    return tree->root == IB_TREE_NIL;
+}
+
+/**
+ * @brief Clears tree, releasing the node array in one go
+ */
+bool ibt_clear_uint32_t(ibt_uint32_t* tree)
+{
+    free(tree->nodes);
+    *tree = ibt_new_uint32_t();
+    return true;
+}
+
+/**
+ * @brief Returns the number of values in the tree
+ */
+size_t ibt_size_uint32_t(ibt_uint32_t* tree)
+{
+    return tree->size;
+}
+
+/**
+ * @brief Returns the bytes allocated for the nodes, including unused and freed slots
+ */
+size_t ibt_memory_uint32_t(ibt_uint32_t* tree)
+{
+    return tree->capacity * sizeof(ibt_node_uint32_t);
+}
+
+/**
+ * @brief Prints index tree
+ */
+static void _print_node_inorder(ibt_node_uint32_t* nodes, const uint32_t index)
+{
+    if (index == IB_TREE_NIL)
+        return;
+    _print_node_inorder(nodes, nodes[index].left);
+    printf("%u ", nodes[index].value);
+    _print_node_inorder(nodes, nodes[index].right);
+}
+static void _print_tree_traverse(
+    ibt_node_uint32_t* nodes, const uint32_t index, const int depth, bool left_child)
+{
+    for (int i = 0; i < depth - 1; i++) {
+        printf("    ");
+    }
+    if (depth > 0) {
+        printf("%s─%s ", left_child ? "├" : "└", left_child ? "L" : "R");
+    }
+    if (index == IB_TREE_NIL) {
+        printf("nil\n");
+        return;
+    }
+    printf("%u (#%u)\n", nodes[index].value, index);
+    _print_tree_traverse(nodes, nodes[index].left, depth + 1, true);
+    _print_tree_traverse(nodes, nodes[index].right, depth + 1, false);
+}
+void ibt_print_uint32_t(ibt_uint32_t* tree)
+{
+    printf("------------------------------\n");
+    printf("As list:\n");
+    printf("[");
+    _print_node_inorder(tree->nodes, tree->root);
+    printf("]\n");
+    printf("As tree:\n");
+    _print_tree_traverse(tree->nodes, tree->root, 0, true);
+    printf("------------------------------\n");
+}
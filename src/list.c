@@ -1,114 +1,133 @@
 #include "list.h"
 
+#include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 //--------------------------------------------------
-// Helper functions
+// Singly linked list
+
+static void _print_uint32_t(const uint32_t value)
+{
+    printf("%u", value);
+}
+
+LL_DEFINE(uint32_t, LL_DEFAULT_EQUALS, _print_uint32_t)
+
+//--------------------------------------------------
+// Doubly linked list
 
 /**
- * @brief Gets linked list node by index
- *
- * @details The lookback value is important since we use a single-linked list. If the lookback is 0,
- *          then the node returned is exactly of index idx. If it's 1, then it actually only returns
- *          the index idx-1. If idx-lookback < 0, then return nullptr.
+ * @brief Gets doubly linked list node by index, walking from the closer end
  *
- * @param head Head of the linked list
- * @param idx Index of node we want to get
- * @param lookback Number of nodes to look back.
+ * @return nullptr if idx is out of range
  */
-static ll_node_uint32_t* _get_node_by_idx(ll_node_uint32_t* head, size_t idx, const size_t lookback)
+static dll_node_uint32_t* _dll_get_node_by_idx(dll_uint32_t* list, const size_t idx)
 {
-    if (idx - lookback < 0) {
+    dll_node_uint32_t* cur;
+    if (idx >= list->length) {
         return nullptr;
+    } else if (idx < list->length / 2) {
+        cur = list->head;
+        for (size_t i = 0; i < idx; i++)
+            cur = cur->next;
+    } else {
+        cur = list->tail;
+        for (size_t i = list->length - 1; i > idx; i--)
+            cur = cur->prev;
     }
-    idx = idx - lookback;
-    ll_node_uint32_t* cur = head;
-    size_t cnt = 0;
-    while (cur != nullptr) {
-        if (cnt == idx)
-            return cur;
-        cur = cur->next;
-        cnt++;
-    }
-    return nullptr;
+    return cur;
 }
 
 /**
- * @brief Gets linked list node by first node appearance
- *
- * @details The lookback value is important since we use a single-linked list. If the lookback is 0,
- *          then the node returned is exactly of the first appearance of value. If it's 1, then it
- *          actually only returns the lookback-th node before the first appearance of value.
- *
- * @param head Head of the linked list
- * @param idx Index of node we want to get
- * @param lookback Number of nodes to look back.
+ * @brief Unlinks node from the list and frees it
  */
-static ll_node_uint32_t* _find_node_by_value(
-    ll_node_uint32_t* head, const uint32_t value, size_t lookback)
+static void _dll_remove_node(dll_uint32_t* list, dll_node_uint32_t* node)
 {
-    ll_node_uint32_t* cur = head;
-    ll_node_uint32_t* lookback_node = head;
-    size_t cnt = 0; // Counter to count lookback
-    while (cur != nullptr) {
-        if (cur->value == value && cnt < lookback)
-            return nullptr;
-        else if (cur->value == value)
-            return lookback_node;
-
-        cur = cur->next;
-        if (cnt < lookback) {
-            cnt++;
-        } else {
-            lookback_node = lookback_node->next;
-        }
+    if (node->prev != nullptr) {
+        node->prev->next = node->next;
+    } else {
+        list->head = node->next;
     }
-    return nullptr;
+    if (node->next != nullptr) {
+        node->next->prev = node->prev;
+    } else {
+        list->tail = node->prev;
+    }
+    free(node);
+    list->length--;
 }
-//--------------------------------------------------
 
 /**
  * @brief: A new list is just the nullptr pointer
  */
-ll_uint32_t ll_new_list_uint32_t()
+dll_uint32_t dll_new_list_uint32_t()
 {
-    return (ll_uint32_t) {
+    return (dll_uint32_t) {
         .head = nullptr,
         .tail = nullptr,
+        .length = 0,
     };
 }
 
 /**
  * @brief: Appends the value to the end of the list
  */
-bool ll_add_value_uint32_t(ll_uint32_t* list, const int value)
+bool dll_add_value_uint32_t(dll_uint32_t* list, const uint32_t value)
 {
-    ll_node_uint32_t* new_node = malloc(sizeof(ll_node_uint32_t));
-    *new_node = (ll_node_uint32_t) {
+    dll_node_uint32_t* new_node = malloc(sizeof(dll_node_uint32_t));
+    if (new_node == nullptr) {
+        return false;
+    }
+    *new_node = (dll_node_uint32_t) {
         .value = value,
+        .prev = list->tail,
         .next = nullptr,
     };
 
-    if (list->head == nullptr) {
+    if (list->tail == nullptr) {
         list->head = new_node;
-        list->tail = new_node;
-        return true;
     } else {
-        ll_node_uint32_t* last_node = list->tail;
-        last_node->next = new_node;
+        list->tail->next = new_node;
+    }
+    list->tail = new_node;
+    list->length++;
+    return true;
+}
+
+/**
+ * @brief: Prepends the value to the start of the list
+ */
+bool dll_push_front_uint32_t(dll_uint32_t* list, const uint32_t value)
+{
+    dll_node_uint32_t* new_node = malloc(sizeof(dll_node_uint32_t));
+    if (new_node == nullptr) {
+        return false;
+    }
+    *new_node = (dll_node_uint32_t) {
+        .value = value,
+        .prev = nullptr,
+        .next = list->head,
+    };
+
+    if (list->head == nullptr) {
         list->tail = new_node;
-        return true;
+    } else {
+        list->head->prev = new_node;
     }
+    list->head = new_node;
+    list->length++;
+    return true;
 }
 
 /**
  * @brief: Delete the entire list
  */
-bool ll_clear_list_uint32_t(ll_uint32_t* list)
+bool dll_clear_list_uint32_t(dll_uint32_t* list)
 {
-    ll_node_uint32_t* cur = list->head;
-    ll_node_uint32_t* next;
+    dll_node_uint32_t* cur = list->head;
+    dll_node_uint32_t* next;
     while (cur != nullptr) {
         next = cur->next;
         free(cur);
@@ -116,70 +135,46 @@ bool ll_clear_list_uint32_t(ll_uint32_t* list)
     }
     list->head = nullptr;
     list->tail = nullptr;
+    list->length = 0;
     return true;
 }
 
 /**
  * @brief: Deletes the first appearance of the value
  */
-bool ll_del_value_uint32_t(ll_uint32_t* list, const int value)
+bool dll_del_value_uint32_t(dll_uint32_t* list, const uint32_t value)
 {
-    if (list->head == nullptr) {
-        return false;
-    } else if (list->head->value == value) {
-        uint32_t tmp = list->head->value;
-        free(list->head);
-        list->head = nullptr;
-        return true;
-    }
-
-    ll_node_uint32_t* node = _find_node_by_value(list->head, value, 1);
-    if (node == nullptr) {
-        return false;
-    } else if (node->next == nullptr) { // this case shouldn't occur
-        return false;
+    for (dll_node_uint32_t* cur = list->head; cur != nullptr; cur = cur->next) {
+        if (cur->value == value) {
+            _dll_remove_node(list, cur);
+            return true;
+        }
     }
-
-    ll_node_uint32_t* after = node->next->next;
-    free(node->next);
-    node->next = after;
-
-    return true;
+    return false;
 }
 
 /**
  * @brief: Returns whether or not the list is empty
  */
-bool ll_is_empty_uint32_t(ll_uint32_t* list)
+bool dll_is_empty_uint32_t(dll_uint32_t* list)
 {
-    return list->head == nullptr || list->tail == nullptr;
+    return list->length == 0;
 }
 
 /**
  * @brief: Returns length of the list
  */
-size_t ll_length_uint32_t(ll_uint32_t* list)
+size_t dll_length_uint32_t(dll_uint32_t* list)
 {
-    ll_node_uint32_t* cur = list->head;
-    size_t cnt = 0;
-    while (cur != nullptr) {
-        cur = cur->next;
-        cnt++;
-    }
-    return cnt;
+    return list->length;
 }
 
 /**
  * @brief: Sets the value at index idx to value
  */
-bool ll_set_uint32_t(ll_uint32_t* list, const int idx, const int value)
+bool dll_set_uint32_t(dll_uint32_t* list, const size_t idx, const uint32_t value)
 {
-    size_t len = ll_length_uint32_t(list);
-    if (idx < 0 || idx >= len) {
-        return false;
-    }
-
-    ll_node_uint32_t* node = _get_node_by_idx(list->head, idx, 0);
+    dll_node_uint32_t* node = _dll_get_node_by_idx(list, idx);
     if (node == nullptr) {
         return false;
     }
@@ -191,58 +186,49 @@ bool ll_set_uint32_t(ll_uint32_t* list, const int idx, const int value)
 /**
  * @brief: Gets value at index idx
  */
-Result_uint32_t ll_get_uint32_t(ll_uint32_t* list, const int idx)
+Result_uint32_t dll_get_uint32_t(dll_uint32_t* list, const size_t idx)
 {
-    size_t len = ll_length_uint32_t(list);
-    if (idx < 0 || idx >= len) {
+    dll_node_uint32_t* node = _dll_get_node_by_idx(list, idx);
+    if (node == nullptr) {
         return Result_uint32_t_Err("Out of range");
     }
+    return Result_uint32_t_Ok(node->value);
+}
 
-    ll_node_uint32_t* node = _get_node_by_idx(list->head, idx, 0);
-
-    if (node == nullptr) {
-        return Result_uint32_t_Err("Some error occured");
-    } else {
-        return Result_uint32_t_Ok(node->value);
+/**
+ * @brief: Pops the last node and returns its value
+ */
+Result_uint32_t dll_pop_value_uint32_t(dll_uint32_t* list)
+{
+    if (list->tail == nullptr) {
+        return Result_uint32_t_Err("Trying to pop from empty list");
     }
+    uint32_t value = list->tail->value;
+    _dll_remove_node(list, list->tail);
+    return Result_uint32_t_Ok(value);
 }
 
 /**
- * @brief: Pops the last node and returns its value
+ * @brief: Pops the first node and returns its value
  */
-Result_uint32_t ll_pop_value_uint32_t(ll_uint32_t* list)
+Result_uint32_t dll_pop_front_uint32_t(dll_uint32_t* list)
 {
-    if (list->head == nullptr || list->tail == nullptr) { // Empty
+    if (list->head == nullptr) {
         return Result_uint32_t_Err("Trying to pop from empty list");
-    } else if (list->head == list->tail || list->head->next == nullptr) { // Only one element
-        uint32_t value = list->head->value;
-        free(list->head);
-        list->head = nullptr;
-        list->tail = nullptr;
-        return Result_uint32_t_Ok(value);
-    } else { // More than one element
-        ll_node_uint32_t* cur = list->head;
-        ll_node_uint32_t* next = list->head->next;
-        while (next->next != nullptr) {
-            cur = cur->next;
-            next = next->next;
-        }
-        uint32_t value = next->value;
-        free(next);
-        cur->next = nullptr;
-        list->tail = cur;
-        return Result_uint32_t_Ok(value);
     }
+    uint32_t value = list->head->value;
+    _dll_remove_node(list, list->head);
+    return Result_uint32_t_Ok(value);
 }
 
 /**
- * @brief: Gets value at index idx
+ * @brief: Prints the list
  */
-void ll_print_uint32_t(ll_uint32_t* list)
+void dll_print_uint32_t(dll_uint32_t* list)
 {
     printf("[");
 
-    ll_node_uint32_t* cur = list->head;
+    dll_node_uint32_t* cur = list->head;
     while (cur != nullptr) {
         printf("%i", cur->value);
         if (cur->next != nullptr)
@@ -252,3 +238,234 @@ void ll_print_uint32_t(ll_uint32_t* list)
 
     printf("]\n");
 }
+
+//--------------------------------------------------
+// Unrolled linked list
+
+#define UNROLLED_LL_CAPACITY UNROLLED_LL_NODE_CAPACITY(uint32_t)
+
+/**
+ * @brief Allocates an empty node aligned to a cache line
+ */
+static ull_node_uint32_t* _ull_new_node()
+{
+    static_assert(
+        sizeof(ull_node_uint32_t) == UNROLLED_LL_NODE_SIZE, "Node should fill one cache line");
+    ull_node_uint32_t* node = aligned_alloc(UNROLLED_LL_NODE_SIZE, sizeof(ull_node_uint32_t));
+    if (node == nullptr)
+        return nullptr;
+    node->next = nullptr;
+    node->prev = nullptr;
+    node->count = 0;
+    return node;
+}
+
+/**
+ * @brief Gets the node holding index idx
+ *
+ * @param offset Is set to the position of idx inside the returned node
+ * @return nullptr if idx is out of range
+ */
+static ull_node_uint32_t* _ull_get_node_by_idx(ull_uint32_t* list, size_t idx, uint32_t* offset)
+{
+    if (idx >= list->length)
+        return nullptr;
+
+    ull_node_uint32_t* cur = list->head;
+    while (idx >= cur->count) {
+        idx -= cur->count;
+        cur = cur->next;
+    }
+    *offset = idx;
+    return cur;
+}
+
+/**
+ * @brief Unlinks node from its neighbours and frees it
+ */
+static void _ull_remove_node(ull_uint32_t* list, ull_node_uint32_t* node)
+{
+    if (node->prev == nullptr) {
+        list->head = node->next;
+    } else {
+        node->prev->next = node->next;
+    }
+    if (node->next == nullptr) {
+        list->tail = node->prev;
+    } else {
+        node->next->prev = node->prev;
+    }
+    free(node);
+}
+
+/**
+ * @brief: A new list is just the nullptr pointer
+ */
+ull_uint32_t ull_new_list_uint32_t()
+{
+    return (ull_uint32_t) {
+        .head = nullptr,
+        .tail = nullptr,
+        .length = 0,
+    };
+}
+
+/**
+ * @brief: Appends the value to the end of the list
+ */
+bool ull_add_value_uint32_t(ull_uint32_t* list, const uint32_t value)
+{
+    if (list->tail == nullptr || list->tail->count == UNROLLED_LL_CAPACITY) {
+        ull_node_uint32_t* new_node = _ull_new_node();
+        if (new_node == nullptr) {
+            return false;
+        }
+        if (list->tail == nullptr) {
+            list->head = new_node;
+        } else {
+            list->tail->next = new_node;
+            new_node->prev = list->tail;
+        }
+        list->tail = new_node;
+    }
+
+    list->tail->values[list->tail->count++] = value;
+    list->length++;
+    return true;
+}
+
+/**
+ * @brief: Delete the entire list
+ */
+bool ull_clear_list_uint32_t(ull_uint32_t* list)
+{
+    ull_node_uint32_t* cur = list->head;
+    ull_node_uint32_t* next;
+    while (cur != nullptr) {
+        next = cur->next;
+        free(cur);
+        cur = next;
+    }
+    list->head = nullptr;
+    list->tail = nullptr;
+    list->length = 0;
+    return true;
+}
+
+/**
+ * @brief: Deletes the first appearance of the value
+ *
+ * @details Nodes that run empty are freed and a node is merged into a neighbour as soon as both
+ *          fit into one node, which keeps the nodes from fragmenting under deletions.
+ */
+bool ull_del_value_uint32_t(ull_uint32_t* list, const uint32_t value)
+{
+    for (ull_node_uint32_t* cur = list->head; cur != nullptr; cur = cur->next) {
+        for (uint32_t i = 0; i < cur->count; i++) {
+            if (cur->values[i] != value)
+                continue;
+
+            memmove(&cur->values[i], &cur->values[i + 1], (cur->count - i - 1) * sizeof(uint32_t));
+            cur->count--;
+            list->length--;
+
+            ull_node_uint32_t* prev = cur->prev;
+            ull_node_uint32_t* next = cur->next;
+            if (cur->count == 0) {
+                _ull_remove_node(list, cur);
+            } else if (prev != nullptr && prev->count + cur->count <= UNROLLED_LL_CAPACITY) {
+                memcpy(&prev->values[prev->count], cur->values, cur->count * sizeof(uint32_t));
+                prev->count += cur->count;
+                _ull_remove_node(list, cur);
+            } else if (next != nullptr && cur->count + next->count <= UNROLLED_LL_CAPACITY) {
+                memcpy(&cur->values[cur->count], next->values, next->count * sizeof(uint32_t));
+                cur->count += next->count;
+                _ull_remove_node(list, next);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief: Returns whether or not the list is empty
+ */
+bool ull_is_empty_uint32_t(ull_uint32_t* list)
+{
+    return list->length == 0;
+}
+
+/**
+ * @brief: Returns length of the list
+ */
+size_t ull_length_uint32_t(ull_uint32_t* list)
+{
+    return list->length;
+}
+
+/**
+ * @brief: Sets the value at index idx to value
+ */
+bool ull_set_uint32_t(ull_uint32_t* list, const size_t idx, const uint32_t value)
+{
+    uint32_t offset;
+    ull_node_uint32_t* node = _ull_get_node_by_idx(list, idx, &offset);
+    if (node == nullptr) {
+        return false;
+    }
+
+    node->values[offset] = value;
+    return true;
+}
+
+/**
+ * @brief: Gets value at index idx
+ */
+Result_uint32_t ull_get_uint32_t(ull_uint32_t* list, const size_t idx)
+{
+    uint32_t offset;
+    ull_node_uint32_t* node = _ull_get_node_by_idx(list, idx, &offset);
+    if (node == nullptr) {
+        return Result_uint32_t_Err("Out of range");
+    }
+    return Result_uint32_t_Ok(node->values[offset]);
+}
+
+/**
+ * @brief: Pops the last value and returns it
+ *
+ * @details A tail node that runs empty is unlinked through its prev link, so popping is O(1).
+ */
+Result_uint32_t ull_pop_value_uint32_t(ull_uint32_t* list)
+{
+    if (list->tail == nullptr) {
+        return Result_uint32_t_Err("Trying to pop from empty list");
+    }
+
+    ull_node_uint32_t* tail = list->tail;
+    uint32_t value = tail->values[--tail->count];
+    list->length--;
+
+    if (tail->count == 0)
+        _ull_remove_node(list, tail);
+    return Result_uint32_t_Ok(value);
+}
+
+/**
+ * @brief: Prints the list
+ */
+void ull_print_uint32_t(ull_uint32_t* list)
+{
+    printf("[");
+
+    for (ull_node_uint32_t* cur = list->head; cur != nullptr; cur = cur->next) {
+        for (uint32_t i = 0; i < cur->count; i++) {
+            printf("%i", cur->values[i]);
+            if (cur->next != nullptr || i + 1 < cur->count)
+                printf(", ");
+        }
+    }
+
+    printf("]\n");
+}
@@ -1,6 +1,12 @@
+#pragma once
+
 #include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
 
+#include "utils/pool.h"
 #include "utils/result_types.h"
+#include "utils/stats.h"
 
 #define LL(type) ll_##type
 
@@ -14,16 +20,453 @@
     typedef struct LL(type) {                                                                      \
         LL_NODE(type) * head;                                                                      \
         LL_NODE(type) * tail;                                                                      \
+        pool_t pool;                                                                               \
+        DS_STATS_MEMBER                                                                            \
     } LL(type);                                                                                    \
     LL(type) ll_new_list_##type();                                                                 \
-    bool ll_add_value_##type(LL(type) * list, const int value);                                    \
+    LL(type) ll_new_pooled_list_##type();                                                          \
+    bool ll_add_value_##type(LL(type) * list, const type value);                                   \
     bool ll_clear_list_##type(LL(type) * list);                                                    \
-    bool ll_del_value_##type(LL(type) * list, const int value);                                    \
+    bool ll_del_value_##type(LL(type) * list, const type value);                                   \
     bool ll_is_empty_##type(LL(type) * list);                                                      \
     size_t ll_length_##type(LL(type) * list);                                                      \
-    bool ll_set_##type(LL(type) * list, const int idx, const int value);                           \
-    RESULT(type) ll_get_##type(LL(type) * list, const int idx);                                    \
+    bool ll_set_##type(LL(type) * list, const size_t idx, const type value);                       \
+    RESULT(type) ll_get_##type(LL(type) * list, const size_t idx);                                 \
     RESULT(type) ll_pop_value_##type(LL(type) * list);                                             \
+    ds_stats_t ll_stats_##type(LL(type) * list);                                                   \
+    void ll_stats_reset_##type(LL(type) * list);                                                   \
     void ll_print_##type(LL(type) * list);
 
+/**
+ * @brief Equality hook for LL_DEFINE comparing values with ==
+ */
+#define LL_DEFAULT_EQUALS(a, b) ((a) == (b))
+
+/**
+ * @brief Defines all the functions declared by LL_DECLARE for the given type
+ * @details Expand this once in a single translation unit. The hooks may be macros or functions and
+ *          are expanded in place, so the compiler can inline them into every operation.
+ *
+ * @param type Type of the values
+ * @param equals Hook called as equals(a, b) that returns whether two values are equal
+ * @param print_value Hook called as print_value(value) that prints a single value to stdout
+ */
+#define LL_DEFINE(type, equals, print_value)                                                       \
+    /**                                                                                            \
+     * @brief The equals hook, counted as a comparison of list if DS_STATS is defined              \
+     */                                                                                            \
+    static inline bool _ll_equals_##type(LL(type) * list, const type a, const type b)              \
+    {                                                                                              \
+        DS_STATS_ADD(&list->stats, comparisons, 1);                                                \
+        return equals(a, b);                                                                       \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Gets linked list node by index                                                       \
+     *                                                                                             \
+     * @details The lookback value is important since we use a single-linked list. If the lookback \
+     *          is 0, then the node returned is exactly of index idx. If it's 1, then it actually  \
+     *          only returns the index idx-1. If lookback > idx, then return nullptr.              \
+     *                                                                                             \
+     * @param list The linked list                                                                 \
+     * @param idx Index of node we want to get                                                     \
+     * @param lookback Number of nodes to look back.                                               \
+     */                                                                                            \
+    static LL_NODE(type) * _ll_get_node_by_idx_##type(                                             \
+        LL(type) * list, size_t idx, const size_t lookback)                                        \
+    {                                                                                              \
+        if (lookback > idx) {                                                                      \
+            return nullptr;                                                                        \
+        }                                                                                          \
+        idx = idx - lookback;                                                                      \
+        LL_NODE(type) * cur = list->head;                                                          \
+        size_t cnt = 0;                                                                            \
+        while (cur != nullptr) {                                                                   \
+            DS_STATS_ADD(&list->stats, node_visits, 1);                                            \
+            if (cnt == idx)                                                                        \
+                return cur;                                                                        \
+            cur = cur->next;                                                                       \
+            cnt++;                                                                                 \
+        }                                                                                          \
+        return nullptr;                                                                            \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Gets linked list node by first node appearance                                       \
+     *                                                                                             \
+     * @details The lookback value is important since we use a single-linked list. If the lookback \
+     *          is 0, then the node returned is exactly of the first appearance of value. If it's  \
+     *          1, then it actually only returns the lookback-th node before the first appearance  \
+     *          of value.                                                                          \
+     *                                                                                             \
+     * @param list The linked list                                                                 \
+     * @param idx Index of node we want to get                                                     \
+     * @param lookback Number of nodes to look back.                                               \
+     */                                                                                            \
+    static LL_NODE(type) * _ll_find_node_by_value_##type(                                          \
+        LL(type) * list, const type value, size_t lookback)                                        \
+    {                                                                                              \
+        LL_NODE(type) * cur = list->head;                                                          \
+        LL_NODE(type) * lookback_node = list->head;                                                \
+        size_t cnt = 0; /* Counter to count lookback */                                            \
+        while (cur != nullptr) {                                                                   \
+            DS_STATS_ADD(&list->stats, node_visits, 1);                                            \
+            if (_ll_equals_##type(list, cur->value, value) && cnt < lookback)                      \
+                return nullptr;                                                                    \
+            else if (_ll_equals_##type(list, cur->value, value))                                   \
+                return lookback_node;                                                              \
+                                                                                                   \
+            cur = cur->next;                                                                       \
+            if (cnt < lookback) {                                                                  \
+                cnt++;                                                                             \
+            } else {                                                                               \
+                lookback_node = lookback_node->next;                                               \
+            }                                                                                      \
+        }                                                                                          \
+        return nullptr;                                                                            \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Allocates a node from the pool of the list, or with malloc if the list is not pooled \
+     */                                                                                            \
+    static LL_NODE(type) * _ll_alloc_node_##type(LL(type) * list)                                  \
+    {                                                                                              \
+        LL_NODE(type) * node;                                                                      \
+        if (pool_is_active(&list->pool)) {                                                         \
+            node = pool_alloc(&list->pool);                                                        \
+        } else {                                                                                   \
+            node = malloc(sizeof(LL_NODE(type)));                                                  \
+        }                                                                                          \
+        if (node != nullptr)                                                                       \
+            DS_STATS_ALLOC(&list->stats, sizeof(LL_NODE(type)));                                   \
+        return node;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Releases a node allocated with _ll_alloc_node                                        \
+     */                                                                                            \
+    static void _ll_free_node_##type(LL(type) * list, LL_NODE(type) * node)                        \
+    {                                                                                              \
+        DS_STATS_FREE(&list->stats, sizeof(LL_NODE(type)));                                        \
+        if (pool_is_active(&list->pool)) {                                                         \
+            pool_free(&list->pool, node);                                                          \
+        } else {                                                                                   \
+            free(node);                                                                            \
+        }                                                                                          \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief: A new list is just the nullptr pointer                                              \
+     */                                                                                            \
+    LL(type) ll_new_list_##type()                                                                  \
+    {                                                                                              \
+        return (LL(type)) {                                                                        \
+            .head = nullptr,                                                                       \
+            .tail = nullptr,                                                                       \
+            .pool = { 0 },                                                                         \
+        };                                                                                         \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief: A new list that allocates its nodes from a node pool                                \
+     *                                                                                             \
+     * @details Nodes are bump-allocated from contiguous slabs, deleted nodes are recycled and     \
+     *          clearing the list releases whole slabs without walking the nodes.                  \
+     */                                                                                            \
+    LL(type) ll_new_pooled_list_##type()                                                           \
+    {                                                                                              \
+        return (LL(type)) {                                                                        \
+            .head = nullptr,                                                                       \
+            .tail = nullptr,                                                                       \
+            .pool = pool_new(sizeof(LL_NODE(type)), 0),                                            \
+        };                                                                                         \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief: Appends the value to the end of the list                                            \
+     */                                                                                            \
+    bool ll_add_value_##type(LL(type) * list, const type value)                                    \
+    {                                                                                              \
+        LL_NODE(type) * new_node = _ll_alloc_node_##type(list);                                    \
+        if (new_node == nullptr) {                                                                 \
+            return false;                                                                          \
+        }                                                                                          \
+        *new_node = (LL_NODE(type)) {                                                              \
+            .value = value,                                                                        \
+            .next = nullptr,                                                                       \
+        };                                                                                         \
+                                                                                                   \
+        if (list->head == nullptr) {                                                               \
+            list->head = new_node;                                                                 \
+            list->tail = new_node;                                                                 \
+            return true;                                                                           \
+        } else {                                                                                   \
+            LL_NODE(type) * last_node = list->tail;                                                \
+            last_node->next = new_node;                                                            \
+            list->tail = new_node;                                                                 \
+            return true;                                                                           \
+        }                                                                                          \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief: Delete the entire list                                                              \
+     */                                                                                            \
+    bool ll_clear_list_##type(LL(type) * list)                                                     \
+    {                                                                                              \
+        if (pool_is_active(&list->pool)) {                                                         \
+            pool_clear(&list->pool);                                                               \
+        } else {                                                                                   \
+            LL_NODE(type) * cur = list->head;                                                      \
+            LL_NODE(type) * next;                                                                  \
+            while (cur != nullptr) {                                                               \
+                next = cur->next;                                                                  \
+                free(cur);                                                                         \
+                cur = next;                                                                        \
+            }                                                                                      \
+        }                                                                                          \
+        DS_STATS_FREE_ALL(&list->stats, sizeof(LL_NODE(type)));                                    \
+        list->head = nullptr;                                                                      \
+        list->tail = nullptr;                                                                      \
+        return true;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief: Deletes the first appearance of the value                                           \
+     */                                                                                            \
+    bool ll_del_value_##type(LL(type) * list, const type value)                                    \
+    {                                                                                              \
+        DS_STATS_ADD(&list->stats, searches, 1);                                                   \
+        if (list->head == nullptr) {                                                               \
+            return false;                                                                          \
+        } else if (_ll_equals_##type(list, list->head->value, value)) {                            \
+            LL_NODE(type) * next = list->head->next;                                               \
+            _ll_free_node_##type(list, list->head);                                                \
+            list->head = next;                                                                     \
+            if (next == nullptr)                                                                   \
+                list->tail = nullptr;                                                              \
+            return true;                                                                           \
+        }                                                                                          \
+                                                                                                   \
+        LL_NODE(type) * node = _ll_find_node_by_value_##type(list, value, 1);                      \
+        if (node == nullptr) {                                                                     \
+            return false;                                                                          \
+        } else if (node->next == nullptr) { /* this case shouldn't occur */                        \
+            return false;                                                                          \
+        }                                                                                          \
+                                                                                                   \
+        LL_NODE(type) * after = node->next->next;                                                  \
+        if (node->next == list->tail)                                                              \
+            list->tail = node;                                                                     \
+        _ll_free_node_##type(list, node->next);                                                    \
+        node->next = after;                                                                        \
+                                                                                                   \
+        return true;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief: Returns whether or not the list is empty                                            \
+     */                                                                                            \
+    bool ll_is_empty_##type(LL(type) * list)                                                       \
+    {                                                                                              \
+        return list->head == nullptr || list->tail == nullptr;                                     \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief: Returns length of the list                                                          \
+     */                                                                                            \
+    size_t ll_length_##type(LL(type) * list)                                                       \
+    {                                                                                              \
+        LL_NODE(type) * cur = list->head;                                                          \
+        size_t cnt = 0;                                                                            \
+        while (cur != nullptr) {                                                                   \
+            cur = cur->next;                                                                       \
+            cnt++;                                                                                 \
+        }                                                                                          \
+        DS_STATS_ADD(&list->stats, node_visits, cnt);                                              \
+        return cnt;                                                                                \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief: Sets the value at index idx to value                                                \
+     */                                                                                            \
+    bool ll_set_##type(LL(type) * list, const size_t idx, const type value)                        \
+    {                                                                                              \
+        size_t len = ll_length_##type(list);                                                       \
+        if (idx >= len) {                                                                          \
+            return false;                                                                          \
+        }                                                                                          \
+                                                                                                   \
+        DS_STATS_ADD(&list->stats, searches, 1);                                                   \
+        LL_NODE(type) * node = _ll_get_node_by_idx_##type(list, idx, 0);                           \
+        if (node == nullptr) {                                                                     \
+            return false;                                                                          \
+        }                                                                                          \
+                                                                                                   \
+        node->value = value;                                                                       \
+        return true;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief: Gets value at index idx                                                             \
+     */                                                                                            \
+    RESULT(type) ll_get_##type(LL(type) * list, const size_t idx)                                  \
+    {                                                                                              \
+        size_t len = ll_length_##type(list);                                                       \
+        if (idx >= len) {                                                                          \
+            return RESULT_ERR(type)("Out of range");                                               \
+        }                                                                                          \
+                                                                                                   \
+        DS_STATS_ADD(&list->stats, searches, 1);                                                   \
+        LL_NODE(type) * node = _ll_get_node_by_idx_##type(list, idx, 0);                           \
+                                                                                                   \
+        if (node == nullptr) {                                                                     \
+            return RESULT_ERR(type)("Some error occured");                                         \
+        } else {                                                                                   \
+            return RESULT_OK(type)(node->value);                                                   \
+        }                                                                                          \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief: Pops the last node and returns its value                                            \
+     */                                                                                            \
+    RESULT(type) ll_pop_value_##type(LL(type) * list)                                              \
+    {                                                                                              \
+        if (list->head == nullptr || list->tail == nullptr) { /* Empty */                          \
+            return RESULT_ERR(type)("Trying to pop from empty list");                              \
+        } else if (list->head == list->tail || list->head->next == nullptr) { /* One element */    \
+            type value = list->head->value;                                                        \
+            _ll_free_node_##type(list, list->head);                                                \
+            list->head = nullptr;                                                                  \
+            list->tail = nullptr;                                                                  \
+            return RESULT_OK(type)(value);                                                         \
+        } else { /* More than one element */                                                       \
+            LL_NODE(type) * cur = list->head;                                                      \
+            LL_NODE(type) * next = list->head->next;                                               \
+            while (next->next != nullptr) {                                                        \
+                DS_STATS_ADD(&list->stats, node_visits, 1);                                        \
+                cur = cur->next;                                                                   \
+                next = next->next;                                                                 \
+            }                                                                                      \
+            type value = next->value;                                                              \
+            _ll_free_node_##type(list, next);                                                      \
+            cur->next = nullptr;                                                                   \
+            list->tail = cur;                                                                      \
+            return RESULT_OK(type)(value);                                                         \
+        }                                                                                          \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief: Returns the operation counters of the list, all zero unless DS_STATS is defined     \
+     */                                                                                            \
+    ds_stats_t ll_stats_##type(LL(type) * list)                                                    \
+    {                                                                                              \
+        return DS_STATS_GET(&list->stats);                                                         \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief: Zeroes the operation counters of the list                                           \
+     */                                                                                            \
+    void ll_stats_reset_##type(LL(type) * list)                                                    \
+    {                                                                                              \
+        DS_STATS_RESET(&list->stats);                                                              \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief: Prints the list                                                                     \
+     */                                                                                            \
+    void ll_print_##type(LL(type) * list)                                                          \
+    {                                                                                              \
+        printf("[");                                                                               \
+                                                                                                   \
+        LL_NODE(type) * cur = list->head;                                                          \
+        while (cur != nullptr) {                                                                   \
+            print_value(cur->value);                                                               \
+            if (cur->next != nullptr)                                                              \
+                printf(", ");                                                                      \
+            cur = cur->next;                                                                       \
+        }                                                                                          \
+                                                                                                   \
+        printf("]\n");                                                                             \
+    }
+
 LL_DECLARE(uint32_t);
+
+/**
+ * @brief Doubly linked list
+ *
+ * @details Nodes link to both neighbours and the list keeps its length, so pushing and popping at
+ *          either end as well as querying the length are O(1). Index lookups walk from whichever
+ *          end is closer to the index.
+ */
+#define DLL(type) dll_##type
+
+#define DLL_NODE(type) dll_node_##type
+
+#define DLL_DECLARE(type)                                                                          \
+    typedef struct DLL_NODE(type) {                                                                \
+        type value;                                                                                \
+        struct DLL_NODE(type) * prev;                                                              \
+        struct DLL_NODE(type) * next;                                                              \
+    } DLL_NODE(type);                                                                              \
+    typedef struct DLL(type) {                                                                     \
+        DLL_NODE(type) * head;                                                                     \
+        DLL_NODE(type) * tail;                                                                     \
+        size_t length;                                                                             \
+    } DLL(type);                                                                                   \
+    DLL(type) dll_new_list_##type();                                                               \
+    bool dll_add_value_##type(DLL(type) * list, const type value);                                 \
+    bool dll_push_front_##type(DLL(type) * list, const type value);                                \
+    bool dll_clear_list_##type(DLL(type) * list);                                                  \
+    bool dll_del_value_##type(DLL(type) * list, const type value);                                 \
+    bool dll_is_empty_##type(DLL(type) * list);                                                    \
+    size_t dll_length_##type(DLL(type) * list);                                                    \
+    bool dll_set_##type(DLL(type) * list, const size_t idx, const type value);                     \
+    RESULT(type) dll_get_##type(DLL(type) * list, const size_t idx);                               \
+    RESULT(type) dll_pop_value_##type(DLL(type) * list);                                           \
+    RESULT(type) dll_pop_front_##type(DLL(type) * list);                                           \
+    void dll_print_##type(DLL(type) * list);
+
+DLL_DECLARE(uint32_t);
+
+/**
+ * @brief Unrolled linked list
+ *
+ * @details Every node packs up to UNROLLED_LL_NODE_CAPACITY(type) values into an array next to a
+ *          fill count, so a node spans exactly one 64-byte cache line for 4-byte values. Scans and
+ *          index lookups stride through contiguous memory and hop to the next node only every few
+ *          values.
+ *          The nodes are linked in both directions, so popping never walks the list.
+ */
+#define UNROLLED_LL(type) ull_##type
+
+#define UNROLLED_LL_NODE(type) ull_node_##type
+
+#define UNROLLED_LL_NODE_SIZE 64
+
+#define UNROLLED_LL_NODE_CAPACITY(type)                                                            \
+    ((UNROLLED_LL_NODE_SIZE - 2 * sizeof(void*) - sizeof(uint32_t)) / sizeof(type))
+
+#define UNROLLED_LL_DECLARE(type)                                                                  \
+    typedef struct UNROLLED_LL_NODE(type) {                                                        \
+        struct UNROLLED_LL_NODE(type) * next;                                                      \
+        struct UNROLLED_LL_NODE(type) * prev;                                                      \
+        uint32_t count;                                                                            \
+        type values[UNROLLED_LL_NODE_CAPACITY(type)];                                              \
+    } UNROLLED_LL_NODE(type);                                                                      \
+    typedef struct UNROLLED_LL(type) {                                                             \
+        UNROLLED_LL_NODE(type) * head;                                                             \
+        UNROLLED_LL_NODE(type) * tail;                                                             \
+        size_t length;                                                                             \
+    } UNROLLED_LL(type);                                                                           \
+    UNROLLED_LL(type) ull_new_list_##type();                                                       \
+    bool ull_add_value_##type(UNROLLED_LL(type) * list, const type value);                         \
+    bool ull_clear_list_##type(UNROLLED_LL(type) * list);                                          \
+    bool ull_del_value_##type(UNROLLED_LL(type) * list, const type value);                         \
+    bool ull_is_empty_##type(UNROLLED_LL(type) * list);                                            \
+    size_t ull_length_##type(UNROLLED_LL(type) * list);                                            \
+    bool ull_set_##type(UNROLLED_LL(type) * list, const size_t idx, const type value);             \
+    RESULT(type) ull_get_##type(UNROLLED_LL(type) * list, const size_t idx);                       \
+    RESULT(type) ull_pop_value_##type(UNROLLED_LL(type) * list);                                   \
+    void ull_print_##type(UNROLLED_LL(type) * list);
+
+UNROLLED_LL_DECLARE(uint32_t);
@@ -0,0 +1,458 @@
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "lsm.h"
+
+#define RUN_PATH_FORMAT "%s/run_%010u.snap"
+
+/**
+ * @brief Cursor over the sorted values of a run or the memtable that are still to be merged
+ */
+typedef struct cursor {
+    const uint32_t* values;
+    size_t pos;
+    size_t end;
+} cursor_t;
+
+//--------------------------------------------------
+// Helper functions
+
+/**
+ * @brief Mixes all bits of the value into all bits of the hash (the splitmix64 finalizer)
+ */
+static inline uint64_t _hash(const uint32_t value)
+{
+    uint64_t h = value + 0x9e3779b97f4a7c15ull;
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+    return h ^ (h >> 31);
+}
+
+/**
+ * @brief Tests the Bloom filter bits of value, picked by double hashing: bit i is h1 + i * h2
+ */
+static bool _bloom_test(const lsm_run_t* run, const uint32_t value)
+{
+    uint64_t hash = _hash(value);
+    size_t h1 = (uint32_t)hash, h2 = (hash >> 32) | 1;
+    for (size_t i = 0; i < LSM_BLOOM_HASHES; i++) {
+        size_t bit = (h1 + i * h2) & run->bloom_mask;
+        if (!(run->bloom[bit / 64] & (1ull << (bit % 64))))
+            return false;
+    }
+    return true;
+}
+
+static void _bloom_set(lsm_run_t* run, const uint32_t value)
+{
+    uint64_t hash = _hash(value);
+    size_t h1 = (uint32_t)hash, h2 = (hash >> 32) | 1;
+    for (size_t i = 0; i < LSM_BLOOM_HASHES; i++) {
+        size_t bit = (h1 + i * h2) & run->bloom_mask;
+        run->bloom[bit / 64] |= 1ull << (bit % 64);
+    }
+}
+
+static char* _run_path(const char* dir, const uint32_t seq)
+{
+    size_t length = snprintf(nullptr, 0, RUN_PATH_FORMAT, dir, seq) + 1;
+    char* path = malloc(length);
+    if (path != nullptr)
+        snprintf(path, length, RUN_PATH_FORMAT, dir, seq);
+    return path;
+}
+
+/**
+ * @brief Maps the run with sequence number seq and builds its Bloom filter in one pass over it
+ */
+static bool _run_open(lsm_run_t* run, const char* dir, const uint32_t seq)
+{
+    char* path = _run_path(dir, seq);
+    if (path == nullptr) {
+        return false;
+    }
+    bool opened = snapshot_open(&run->snapshot, path);
+    free(path);
+    if (!opened || run->snapshot.kind != SNAPSHOT_TREE) {
+        if (opened)
+            snapshot_close(&run->snapshot);
+        return false;
+    }
+
+    size_t bits = 64;
+    while (bits < run->snapshot.count * LSM_BLOOM_BITS_PER_KEY)
+        bits *= 2;
+    run->seq = seq;
+    run->bloom_mask = bits - 1;
+    run->bloom = calloc(bits / 64, sizeof(uint64_t));
+    if (run->bloom == nullptr) {
+        snapshot_close(&run->snapshot);
+        return false;
+    }
+    for (size_t i = 0; i < run->snapshot.count; i++)
+        _bloom_set(run, run->snapshot.values[i]);
+    return true;
+}
+
+static void _run_close(lsm_run_t* run)
+{
+    snapshot_close(&run->snapshot);
+    free(run->bloom);
+    run->bloom = nullptr;
+}
+
+/**
+ * @brief Opens the run with sequence number seq as the newest run of the set
+ */
+static bool _push_run(lsm_set_t* set, const uint32_t seq)
+{
+    if (set->run_count == set->run_capacity) {
+        size_t capacity = (set->run_capacity == 0) ? 8 : 2 * set->run_capacity;
+        lsm_run_t* runs = realloc(set->runs, capacity * sizeof(lsm_run_t));
+        if (runs == nullptr) {
+            return false;
+        }
+        set->runs = runs;
+        set->run_capacity = capacity;
+    }
+    if (!_run_open(&set->runs[set->run_count], set->dir, seq)) {
+        return false;
+    }
+    set->run_count++;
+    return true;
+}
+
+static int _compare_seq(const void* a, const void* b)
+{
+    uint32_t lhs = ((const lsm_run_t*)a)->seq, rhs = ((const lsm_run_t*)b)->seq;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+/**
+ * @brief Index of the first value in a sorted block that is not smaller than value, or count
+ */
+static size_t _lower_bound_idx(const uint32_t* values, const size_t count, const uint32_t value)
+{
+    size_t lo = 0, hi = count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (values[mid] < value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief Takes the smallest value among the heads of the cursors
+ *
+ * @details Every cursor whose head equals that value is advanced past it, which drops duplicates
+ *          within and across the cursors.
+ *
+ * @return false once all cursors are exhausted
+ */
+static bool _merge_next(cursor_t* cursors, const size_t count, uint32_t* value)
+{
+    bool found = false;
+    uint32_t min = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (cursors[i].pos == cursors[i].end)
+            continue;
+        uint32_t head = cursors[i].values[cursors[i].pos];
+        if (!found || head < min) {
+            min = head;
+            found = true;
+        }
+    }
+    if (!found) {
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        while (cursors[i].pos < cursors[i].end && cursors[i].values[cursors[i].pos] == min)
+            cursors[i].pos++;
+    }
+    *value = min;
+    return true;
+}
+
+static void _write_value(uint32_t value, void* ctx)
+{
+    snapshot_writer_add(ctx, value);
+}
+
+static void _collect_value(uint32_t value, void* ctx)
+{
+    cursor_t* cursor = ctx;
+    ((uint32_t*)cursor->values)[cursor->end++] = value;
+}
+
+/**
+ * @brief Merges the runs from index from on into one new run that replaces them
+ *
+ * @details snapshot_writer_close syncs the merged run and the directory before it returns, so the
+ *          merged run is durable before any run it replaces is removed. A crash in between, even
+ *          of the system, leaves values in two runs but loses none.
+ */
+static bool _merge_runs(lsm_set_t* set, const size_t from)
+{
+    size_t count = set->run_count - from;
+    cursor_t* cursors = malloc(count * sizeof(cursor_t));
+    char* path = (cursors != nullptr) ? _run_path(set->dir, set->next_seq) : nullptr;
+    snapshot_writer_t* writer = (path != nullptr) ? snapshot_writer_open(path) : nullptr;
+    if (writer == nullptr) {
+        free(cursors);
+        free(path);
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        snapshot_t* snapshot = &set->runs[from + i].snapshot;
+        cursors[i] = (cursor_t) { .values = snapshot->values, .pos = 0, .end = snapshot->count };
+    }
+    uint32_t value;
+    while (_merge_next(cursors, count, &value))
+        snapshot_writer_add(writer, value);
+    free(cursors);
+    bool written = snapshot_writer_close(writer);
+    free(path);
+    lsm_run_t merged;
+    if (!written || !_run_open(&merged, set->dir, set->next_seq)) {
+        return false;
+    }
+    set->next_seq++;
+
+    // Only now that the merged run is durable may the runs it replaces go
+    for (size_t i = from; i < set->run_count; i++) {
+        char* old_path = _run_path(set->dir, set->runs[i].seq);
+        _run_close(&set->runs[i]);
+        if (old_path != nullptr)
+            remove(old_path);
+        free(old_path);
+    }
+    set->runs[from] = merged;
+    set->run_count = from + 1;
+    return true;
+}
+
+/**
+ * @brief Merges the newest runs while the run before them isn't larger than them together
+ */
+static bool _merge_newest(lsm_set_t* set)
+{
+    size_t from = set->run_count - 1;
+    size_t merged = set->runs[from].snapshot.count;
+    while (from > 0 && set->runs[from - 1].snapshot.count <= merged) {
+        from--;
+        merged += set->runs[from].snapshot.count;
+    }
+    return from == set->run_count - 1 || _merge_runs(set, from);
+}
+
+//--------------------------------------------------
+
+/**
+ * @brief: Opens the set stored in directory dir, creating the directory if it doesn't exist
+ *
+ * @details All runs in dir are mapped and get their Bloom filters built, which reads every run
+ *          once.
+ *
+ * @param memtable_limit Number of values buffered in memory before they are written as a run
+ *
+ * @return false if dir can't be created or read or one of its runs is invalid
+ */
+bool lsm_open(lsm_set_t* set, const char* dir, const size_t memtable_limit)
+{
+    *set = (lsm_set_t) {
+        .memtable = bpt_new_uint32_t(),
+        .memtable_limit = (memtable_limit == 0) ? 1 : memtable_limit,
+        .runs = nullptr,
+        .run_count = 0,
+        .run_capacity = 0,
+        .next_seq = 0,
+    };
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+        return false;
+    }
+    DIR* handle = opendir(dir);
+    set->dir = malloc(strlen(dir) + 1);
+    if (handle == nullptr || set->dir == nullptr) {
+        if (handle != nullptr)
+            closedir(handle);
+        free(set->dir);
+        return false;
+    }
+    strcpy(set->dir, dir);
+
+    bool ok = true;
+    for (struct dirent* entry = readdir(handle); ok && entry != nullptr; entry = readdir(handle)) {
+        uint32_t seq;
+        int end = 0;
+        // Leftover temporary files of interrupted writes don't match and are skipped
+        if (sscanf(entry->d_name, "run_%10u.snap%n", &seq, &end) != 1 || entry->d_name[end] != 0)
+            continue;
+        ok = _push_run(set, seq);
+        if (seq >= set->next_seq)
+            set->next_seq = seq + 1;
+    }
+    closedir(handle);
+    if (!ok) {
+        lsm_close(set);
+        return false;
+    }
+    qsort(set->runs, set->run_count, sizeof(lsm_run_t), _compare_seq);
+    return true;
+}
+
+/**
+ * @brief: Adds value to the memtable and flushes it once it's full
+ *
+ * @return false if memory ran out, value isn't in the set then. Also false if the flush failed,
+ *         see lsm_flush. If writing the run failed the values stay in the memtable and the next
+ *         add retries. If only merging failed the memtable has already been written as a run and
+ *         emptied, and the next flush or lsm_compact merges the runs
+ */
+bool lsm_add(lsm_set_t* set, const uint32_t value)
+{
+    // The memtable rejects duplicates and allocation failures alike, only the latter is an error
+    if (!bpt_add_value_uint32_t(&set->memtable, value)
+        && !bpt_contains_uint32_t(&set->memtable, value)) {
+        return false;
+    }
+    if (bpt_size_uint32_t(&set->memtable) < set->memtable_limit) {
+        return true;
+    }
+    return lsm_flush(set);
+}
+
+/**
+ * @brief: Checks whether value is in the set, searching the memtable and then the runs from newest
+ *         to oldest whose Bloom filters let value through
+ */
+bool lsm_contains(lsm_set_t* set, const uint32_t value)
+{
+    if (bpt_contains_uint32_t(&set->memtable, value)) {
+        return true;
+    }
+    for (size_t i = set->run_count; i-- > 0;) {
+        if (_bloom_test(&set->runs[i], value) && snapshot_contains(&set->runs[i].snapshot, value))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief: Calls consume once for every value in [lo, hi] in ascending order, merging the memtable
+ *         and all runs on the fly
+ *
+ * @return The number of values consumed
+ */
+size_t lsm_range(
+    lsm_set_t* set,
+    const uint32_t lo,
+    const uint32_t hi,
+    void (*consume)(uint32_t value, void* ctx),
+    void* ctx)
+{
+    // The memtable values of the range are copied out, so that they are merged like a run
+    size_t count = set->run_count;
+    cursor_t* cursors = malloc((count + 1) * sizeof(cursor_t));
+    uint32_t* memtable = malloc((bpt_size_uint32_t(&set->memtable) + 1) * sizeof(uint32_t));
+    if (cursors == nullptr || memtable == nullptr) {
+        free(cursors);
+        free(memtable);
+        return 0;
+    }
+    for (size_t i = 0; i < count; i++) {
+        snapshot_t* snapshot = &set->runs[i].snapshot;
+        cursors[i] = (cursor_t) {
+            .values = snapshot->values,
+            .pos = _lower_bound_idx(snapshot->values, snapshot->count, lo),
+            .end = snapshot->count,
+        };
+    }
+    cursors[count] = (cursor_t) { .values = memtable, .pos = 0, .end = 0 };
+    bpt_range_uint32_t(&set->memtable, lo, hi, _collect_value, &cursors[count]);
+
+    size_t consumed = 0;
+    uint32_t value;
+    while (_merge_next(cursors, count + 1, &value) && value <= hi) {
+        consume(value, ctx);
+        consumed++;
+    }
+    free(cursors);
+    free(memtable);
+    return consumed;
+}
+
+/**
+ * @brief: Returns the number of runs on disk
+ */
+size_t lsm_run_count(lsm_set_t* set)
+{
+    return set->run_count;
+}
+
+/**
+ * @brief: Writes the memtable as the newest run, empties it and merges the newest runs
+ *
+ * @return false if writing or merging failed. The memtable is only emptied once its run is written,
+ *         so after a failed merge it's already empty. No value is lost either way, the runs that
+ *         weren't merged stay in the set and are merged by the next flush or lsm_compact
+ */
+bool lsm_flush(lsm_set_t* set)
+{
+    if (bpt_size_uint32_t(&set->memtable) == 0) {
+        return true;
+    }
+    char* path = _run_path(set->dir, set->next_seq);
+    snapshot_writer_t* writer = (path != nullptr) ? snapshot_writer_open(path) : nullptr;
+    if (writer == nullptr) {
+        free(path);
+        return false;
+    }
+    bpt_range_uint32_t(&set->memtable, 0, UINT32_MAX, _write_value, writer);
+    // A successful close has synced the run and the directory, only then may the memtable go
+    bool written = snapshot_writer_close(writer);
+    free(path);
+    if (!written || !_push_run(set, set->next_seq)) {
+        return false;
+    }
+    set->next_seq++;
+    bpt_clear_uint32_t(&set->memtable);
+    return _merge_newest(set);
+}
+
+/**
+ * @brief: Flushes the memtable and merges all runs into one
+ */
+bool lsm_compact(lsm_set_t* set)
+{
+    if (!lsm_flush(set)) {
+        return false;
+    }
+    return set->run_count <= 1 || _merge_runs(set, 0);
+}
+
+/**
+ * @brief: Flushes the memtable, unmaps all runs and releases the set
+ *
+ * @return Whether the flush succeeded. The set is closed either way
+ */
+bool lsm_close(lsm_set_t* set)
+{
+    bool ok = set->dir == nullptr || lsm_flush(set);
+    for (size_t i = 0; i < set->run_count; i++)
+        _run_close(&set->runs[i]);
+    free(set->runs);
+    free(set->dir);
+    bpt_clear_uint32_t(&set->memtable);
+    *set = (lsm_set_t) { .dir = nullptr, .runs = nullptr, .run_count = 0 };
+    return ok;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bptree.h"
+#include "snapshot.h"
+
+/**
+ * @file lsm.h
+ *
+ * Log-structured merge set of uint32_t values for write-heavy ingestion.
+ *
+ * Values are added to an in-memory bpt_uint32_t, the memtable, which stays balanced and free of
+ * duplicates whatever the order of the values is. Once it holds memtable_limit values it is written
+ * out in ascending order as an immutable run, a tree snapshot file in the directory of the set, and
+ * starts over empty. Writing a run is one sequential pass, so sustained inserts cost sequential I/O
+ * instead of random writes into one ever growing tree.
+ *
+ * Runs are kept from oldest to newest. After every flush the newest runs are merged into one
+ * while the run before them holds at most as many values as they do together, like the carries of
+ * a binary counter. The number of runs stays logarithmic in the number of values and every value
+ * is rewritten a logarithmic number of times. lsm_compact merges all runs into one on demand.
+ *
+ * Every run has a Bloom filter, built while the run is opened, so lsm_contains only searches the
+ * runs that may hold the value. The set has no deletes. A value that is added again while it is in
+ * a run is stored in several runs until they are merged, which drops the duplicates.
+ */
+
+/**
+ * @brief Bloom filter bits per value of a run. With LSM_BLOOM_HASHES about 1% false positives
+ */
+#define LSM_BLOOM_BITS_PER_KEY 10
+#define LSM_BLOOM_HASHES 7
+
+typedef struct lsm_run {
+    snapshot_t snapshot;
+    /**
+     * @brief Sequence number of the run, it's stored in run_<seq>.snap. Newer runs have larger ones
+     */
+    uint32_t seq;
+    uint64_t* bloom;
+    /**
+     * @brief Number of bits of the Bloom filter minus one, the filter has a power of two bits
+     */
+    size_t bloom_mask;
+} lsm_run_t;
+
+typedef struct lsm_set {
+    char* dir;
+    bpt_uint32_t memtable;
+    size_t memtable_limit;
+    lsm_run_t* runs;
+    size_t run_count;
+    size_t run_capacity;
+    uint32_t next_seq;
+} lsm_set_t;
+
+bool lsm_open(lsm_set_t* set, const char* dir, const size_t memtable_limit);
+bool lsm_add(lsm_set_t* set, const uint32_t value);
+bool lsm_contains(lsm_set_t* set, const uint32_t value);
+size_t lsm_range(
+    lsm_set_t* set,
+    const uint32_t lo,
+    const uint32_t hi,
+    void (*consume)(uint32_t value, void* ctx),
+    void* ctx);
+size_t lsm_run_count(lsm_set_t* set);
+bool lsm_flush(lsm_set_t* set);
+bool lsm_compact(lsm_set_t* set);
+bool lsm_close(lsm_set_t* set);
@@ -0,0 +1,256 @@
+#include "queue.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Smallest capacity, a single cell can't tell a full ring from an empty one
+ */
+#define MPMC_MIN_CAPACITY 2
+
+//--------------------------------------------------
+// Helper functions
+
+/**
+ * @brief Signed distance from b to a, correct across wraparound of the positions
+ */
+static intptr_t _distance(const size_t a, const size_t b)
+{
+    return (intptr_t)(a - b);
+}
+
+/**
+ * @brief Counts up to count cells from pos on whose sequence is their position plus offset
+ *
+ * @details An offset of 0 counts cells free for producers, an offset of 1 cells published to
+ *          consumers. Never counts more than one round of cells.
+ */
+static size_t _count_cells(
+    mpmc_uint32_t* queue, const size_t pos, const size_t count, const size_t offset)
+{
+    size_t cells = 0;
+    while (cells < count && cells <= queue->mask) {
+        mpmc_cell_uint32_t* cell = &queue->cells[(pos + cells) & queue->mask];
+        if (atomic_load_explicit(&cell->sequence, memory_order_acquire) != pos + cells + offset)
+            break;
+        cells++;
+    }
+    return cells;
+}
+
+//--------------------------------------------------
+
+/**
+ * @brief: Creates a queue holding at least capacity values
+ *
+ * @details The capacity is rounded up to a power of two. If out of memory the queue has no cells
+ *          and behaves as if it was both full and empty.
+ */
+mpmc_uint32_t mpmc_new_uint32_t(const size_t capacity)
+{
+    size_t rounded = MPMC_MIN_CAPACITY;
+    while (rounded < capacity)
+        rounded *= 2;
+
+    // aligned_alloc needs a multiple of the alignment
+    size_t bytes = rounded * sizeof(mpmc_cell_uint32_t);
+    bytes = (bytes + MPMC_CACHE_LINE - 1) / MPMC_CACHE_LINE * MPMC_CACHE_LINE;
+
+    mpmc_uint32_t queue;
+    queue.cells = aligned_alloc(MPMC_CACHE_LINE, bytes);
+    queue.mask = (queue.cells == nullptr) ? 0 : rounded - 1;
+    atomic_init(&queue.enqueue_pos, 0);
+    atomic_init(&queue.dequeue_pos, 0);
+    memset(queue.padding, 0, sizeof(queue.padding));
+    for (size_t i = 0; queue.cells != nullptr && i < rounded; i++)
+        atomic_init(&queue.cells[i].sequence, i);
+    return queue;
+}
+
+/**
+ * @brief: Appends the value unless the queue is full
+ */
+bool mpmc_try_push_uint32_t(mpmc_uint32_t* queue, const uint32_t value)
+{
+    if (queue->cells == nullptr)
+        return false;
+
+    mpmc_cell_uint32_t* cell;
+    size_t pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+    while (true) {
+        cell = &queue->cells[pos & queue->mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = _distance(sequence, pos);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(
+                    &queue->enqueue_pos, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            // The consumer of the previous round hasn't freed the cell yet
+            return false;
+        } else {
+            // Another producer claimed pos
+            pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    cell->value = value;
+    atomic_store_explicit(&cell->sequence, pos + 1, memory_order_release);
+    return true;
+}
+
+/**
+ * @brief: Removes the oldest value unless the queue is empty
+ */
+Result_uint32_t mpmc_try_pop_uint32_t(mpmc_uint32_t* queue)
+{
+    if (queue->cells == nullptr)
+        return Result_uint32_t_Err("Trying to pop from empty queue");
+
+    mpmc_cell_uint32_t* cell;
+    size_t pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+    while (true) {
+        cell = &queue->cells[pos & queue->mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = _distance(sequence, pos + 1);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(
+                    &queue->dequeue_pos, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            // The producer of this round hasn't published the cell yet
+            return Result_uint32_t_Err("Trying to pop from empty queue");
+        } else {
+            // Another consumer claimed pos
+            pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+        }
+    }
+
+    uint32_t value = cell->value;
+    atomic_store_explicit(&cell->sequence, pos + queue->mask + 1, memory_order_release);
+    return Result_uint32_t_Ok(value);
+}
+
+/**
+ * @brief: Appends up to count values in order with a single CAS
+ *
+ * @details Counts how many cells from the enqueue position on are free for this round and claims
+ *          all of them at once. Only the producer that claims a free cell can change it, so the
+ *          cells stay free between counting and claiming if the CAS succeeds.
+ *
+ * @return Number of values pushed, which is only smaller than count if the queue got full
+ */
+size_t mpmc_push_batch_uint32_t(mpmc_uint32_t* queue, const uint32_t* values, const size_t count)
+{
+    if (queue->cells == nullptr || count == 0)
+        return 0;
+
+    size_t pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+    size_t claimed;
+    while (true) {
+        claimed = _count_cells(queue, pos, count, 0);
+        if (claimed > 0) {
+            if (atomic_compare_exchange_weak_explicit(
+                    &queue->enqueue_pos,
+                    &pos,
+                    pos + claimed,
+                    memory_order_relaxed,
+                    memory_order_relaxed))
+                break;
+            continue;
+        }
+        mpmc_cell_uint32_t* cell = &queue->cells[pos & queue->mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        if (_distance(sequence, pos) < 0)
+            return 0;
+        // pos is stale
+        pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+    }
+
+    for (size_t i = 0; i < claimed; i++) {
+        mpmc_cell_uint32_t* cell = &queue->cells[(pos + i) & queue->mask];
+        cell->value = values[i];
+        atomic_store_explicit(&cell->sequence, pos + i + 1, memory_order_release);
+    }
+    return claimed;
+}
+
+/**
+ * @brief: Removes up to count of the oldest values in order with a single CAS
+ *
+ * @details Counts how many cells from the dequeue position on are published and claims all of
+ *          them at once, like mpmc_push_batch does for free cells.
+ *
+ * @return Number of values popped into values, which is only smaller than count if the queue got
+ *         empty
+ */
+size_t mpmc_pop_batch_uint32_t(mpmc_uint32_t* queue, uint32_t* values, const size_t count)
+{
+    if (queue->cells == nullptr || count == 0)
+        return 0;
+
+    size_t pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+    size_t claimed;
+    while (true) {
+        claimed = _count_cells(queue, pos, count, 1);
+        if (claimed > 0) {
+            if (atomic_compare_exchange_weak_explicit(
+                    &queue->dequeue_pos,
+                    &pos,
+                    pos + claimed,
+                    memory_order_relaxed,
+                    memory_order_relaxed))
+                break;
+            continue;
+        }
+        mpmc_cell_uint32_t* cell = &queue->cells[pos & queue->mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        if (_distance(sequence, pos + 1) < 0)
+            return 0;
+        // pos is stale
+        pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+    }
+
+    for (size_t i = 0; i < claimed; i++) {
+        mpmc_cell_uint32_t* cell = &queue->cells[(pos + i) & queue->mask];
+        values[i] = cell->value;
+        atomic_store_explicit(&cell->sequence, pos + i + queue->mask + 1, memory_order_release);
+    }
+    return claimed;
+}
+
+bool mpmc_is_empty_uint32_t(mpmc_uint32_t* queue)
+{
+    return mpmc_size_uint32_t(queue) == 0;
+}
+
+/**
+ * @brief: Number of values claimed by producers but not yet by consumers
+ *
+ * @details Only exact if no other thread uses the queue at the same time.
+ */
+size_t mpmc_size_uint32_t(mpmc_uint32_t* queue)
+{
+    size_t dequeue_pos = atomic_load(&queue->dequeue_pos);
+    size_t enqueue_pos = atomic_load(&queue->enqueue_pos);
+    intptr_t size = _distance(enqueue_pos, dequeue_pos);
+    return (size < 0) ? 0 : (size_t)size;
+}
+
+size_t mpmc_capacity_uint32_t(mpmc_uint32_t* queue)
+{
+    return (queue->cells == nullptr) ? 0 : queue->mask + 1;
+}
+
+/**
+ * @brief: Frees the cells. The queue must not be used by any other thread anymore
+ */
+bool mpmc_clear_uint32_t(mpmc_uint32_t* queue)
+{
+    free(queue->cells);
+    queue->cells = nullptr;
+    queue->mask = 0;
+    atomic_store(&queue->enqueue_pos, 0);
+    atomic_store(&queue->dequeue_pos, 0);
+    return true;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "utils/result_types.h"
+
+/**
+ * @file queue.h
+ *
+ * Bounded multi-producer multi-consumer queue (Vyukov).
+ *
+ * The queue is a ring of cells, each carrying a sequence number next to its value. A producer
+ * claims position pos by advancing the enqueue position once the cell at pos holds sequence pos,
+ * writes the value and publishes it by setting the sequence to pos + 1. A consumer claims pos once
+ * the cell holds pos + 1 and hands the cell to the next round by setting it to pos + capacity.
+ * Each operation therefore takes a single CAS on a shared position and never allocates.
+ *
+ * The enqueue and dequeue positions live on cache lines of their own, so producers and consumers
+ * don't invalidate each other's line on every operation.
+ */
+
+/**
+ * @brief Size of a cache line, assumed to be 64 bytes like on all common x86 and ARM cores
+ */
+#define MPMC_CACHE_LINE 64
+
+#define MPMC(type) mpmc_##type
+
+#define MPMC_CELL(type) mpmc_cell_##type
+
+#define MPMC_DECLARE(type)                                                                         \
+    typedef struct MPMC_CELL(type) {                                                               \
+        _Atomic(size_t) sequence;                                                                  \
+        type value;                                                                                \
+    } MPMC_CELL(type);                                                                             \
+    typedef struct MPMC(type) {                                                                    \
+        MPMC_CELL(type) * cells;                                                                   \
+        size_t mask;                                                                               \
+        alignas(MPMC_CACHE_LINE) _Atomic(size_t) enqueue_pos;                                      \
+        alignas(MPMC_CACHE_LINE) _Atomic(size_t) dequeue_pos;                                      \
+        char padding[MPMC_CACHE_LINE - sizeof(size_t)];                                            \
+    } MPMC(type);                                                                                  \
+    MPMC(type) mpmc_new_##type(const size_t capacity);                                             \
+    bool mpmc_try_push_##type(MPMC(type) * queue, const type value);                               \
+    RESULT(type) mpmc_try_pop_##type(MPMC(type) * queue);                                          \
+    size_t mpmc_push_batch_##type(MPMC(type) * queue, const type* values, const size_t count);     \
+    size_t mpmc_pop_batch_##type(MPMC(type) * queue, type* values, const size_t count);            \
+    bool mpmc_is_empty_##type(MPMC(type) * queue);                                                 \
+    size_t mpmc_size_##type(MPMC(type) * queue);                                                   \
+    size_t mpmc_capacity_##type(MPMC(type) * queue);                                               \
+    bool mpmc_clear_##type(MPMC(type) * queue);
+
+MPMC_DECLARE(uint32_t);
@@ -0,0 +1,381 @@
+#include "skiplist.h"
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "utils/panic.h"
+
+//--------------------------------------------------
+// Helper functions
+
+/**
+ * @brief Allocates a node linked into levels levels, not yet marked nor linked
+ */
+static csl_node_uint32_t* _csl_new_node(const uint32_t value, const uint32_t levels)
+{
+    csl_node_uint32_t* node
+        = malloc(sizeof(csl_node_uint32_t) + levels * sizeof(_Atomic(csl_node_uint32_t*)));
+    if (node == nullptr)
+        return nullptr;
+    node->value = value;
+    node->levels = levels;
+    atomic_init(&node->marked, false);
+    atomic_init(&node->fully_linked, false);
+    pthread_mutex_init(&node->lock, nullptr);
+    for (uint32_t level = 0; level < levels; level++)
+        atomic_init(&node->next[level], nullptr);
+    return node;
+}
+
+static void _csl_free_node(void* node)
+{
+    pthread_mutex_destroy(&((csl_node_uint32_t*)node)->lock);
+    free(node);
+}
+
+/**
+ * @brief Draws the number of levels of a new node, each further level with probability 1/4
+ */
+static uint32_t _csl_random_levels()
+{
+    // Every thread draws from its own xorshift state, seeded by the address of that state
+    static _Thread_local uint64_t state = 0;
+    if (state == 0)
+        state = (uint64_t)(uintptr_t)&state * 0x9e3779b97f4a7c15ull | 1;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    uint32_t levels = 1;
+    uint64_t bits = state;
+    while (levels < CSL_MAX_LEVEL && (bits & 3) == 0) {
+        levels++;
+        bits >>= 2;
+    }
+    return levels;
+}
+
+/**
+ * @brief Finds the predecessors and successors of value on every level
+ *
+ * @details preds[level] is the last node with a smaller value, succs[level] the node after it or
+ *          nullptr. Must be called inside of a critical section.
+ *
+ * @return Highest level on which a node holding value was found, or -1
+ */
+static int _csl_find(
+    csl_uint32_t* list,
+    const uint32_t value,
+    csl_node_uint32_t** preds,
+    csl_node_uint32_t** succs)
+{
+    int found = -1;
+    csl_node_uint32_t* pred = list->head;
+    for (int level = CSL_MAX_LEVEL - 1; level >= 0; level--) {
+        csl_node_uint32_t* cur = atomic_load_explicit(&pred->next[level], memory_order_acquire);
+        while (cur != nullptr && cur->value < value) {
+            pred = cur;
+            cur = atomic_load_explicit(&pred->next[level], memory_order_acquire);
+        }
+        if (found == -1 && cur != nullptr && cur->value == value)
+            found = level;
+        preds[level] = pred;
+        succs[level] = cur;
+    }
+    return found;
+}
+
+/**
+ * @brief Unlocks the distinct predecessors locked on levels 0 up to highest
+ */
+static void _csl_unlock_preds(csl_node_uint32_t** preds, const int highest)
+{
+    for (int level = 0; level <= highest; level++) {
+        if (level == 0 || preds[level] != preds[level - 1])
+            pthread_mutex_unlock(&preds[level]->lock);
+    }
+}
+
+/**
+ * @brief Locks the predecessors on levels 0 up to levels - 1 and validates them
+ *
+ * @details A predecessor is valid if it is not marked and still links to the successor on that
+ *          level. Nodes appear on consecutive levels, so each distinct predecessor is locked once.
+ *
+ * @param succs Expected successors, or nullptr to validate against a single node for every level
+ * @param victim The single expected successor if succs is nullptr
+ * @return Whether all predecessors are valid. On failure they are unlocked again
+ */
+static bool _csl_lock_preds(
+    csl_node_uint32_t** preds,
+    csl_node_uint32_t** succs,
+    csl_node_uint32_t* victim,
+    const uint32_t levels)
+{
+    int highest = -1;
+    bool valid = true;
+    for (int level = 0; valid && level < (int)levels; level++) {
+        csl_node_uint32_t* pred = preds[level];
+        csl_node_uint32_t* succ = (succs != nullptr) ? succs[level] : victim;
+        if (level == 0 || pred != preds[level - 1])
+            pthread_mutex_lock(&pred->lock);
+        highest = level;
+        valid = !atomic_load(&pred->marked)
+            && (succ == nullptr || succs == nullptr || !atomic_load(&succ->marked))
+            && atomic_load(&pred->next[level]) == succ;
+    }
+    if (!valid)
+        _csl_unlock_preds(preds, highest);
+    return valid;
+}
+
+/**
+ * @brief Returns the first unmarked node with a value not smaller than value, or nullptr
+ */
+static csl_node_uint32_t* _csl_lower_bound_node(csl_uint32_t* list, const uint32_t value)
+{
+    csl_node_uint32_t* pred = list->head;
+    csl_node_uint32_t* cur = nullptr;
+    for (int level = CSL_MAX_LEVEL - 1; level >= 0; level--) {
+        cur = atomic_load_explicit(&pred->next[level], memory_order_acquire);
+        while (cur != nullptr && cur->value < value) {
+            pred = cur;
+            cur = atomic_load_explicit(&pred->next[level], memory_order_acquire);
+        }
+    }
+    while (cur != nullptr && (atomic_load(&cur->marked) || !atomic_load(&cur->fully_linked)))
+        cur = atomic_load_explicit(&cur->next[0], memory_order_acquire);
+    return cur;
+}
+
+//--------------------------------------------------
+
+/**
+ * @brief: A new skip list only consists of its head, linked into every level
+ */
+csl_uint32_t csl_new_uint32_t()
+{
+    csl_uint32_t list;
+    list.head = _csl_new_node(0, CSL_MAX_LEVEL);
+    if (list.head == nullptr)
+        panic("Out of memory while creating a skip list");
+    atomic_init(&list.head->fully_linked, true);
+    atomic_init(&list.size, 0);
+    list.ebr = ebr_new();
+    return list;
+}
+
+/**
+ * @brief: Adds the value to the set
+ *
+ * @return false if the value is already in the set or out of memory
+ */
+bool csl_add_value_uint32_t(csl_uint32_t* list, ebr_thread_t* thread, const uint32_t value)
+{
+    csl_node_uint32_t* preds[CSL_MAX_LEVEL];
+    csl_node_uint32_t* succs[CSL_MAX_LEVEL];
+    uint32_t levels = _csl_random_levels();
+    csl_node_uint32_t* node = _csl_new_node(value, levels);
+    if (node == nullptr)
+        return false;
+    bool added = false;
+
+    ebr_enter(thread);
+    while (true) {
+        int found = _csl_find(list, value, preds, succs);
+        if (found != -1) {
+            csl_node_uint32_t* existing = succs[found];
+            if (atomic_load(&existing->marked))
+                continue; // Being deleted, retry until it is unlinked
+            // Wait for the concurrent add to finish, so we don't report a value not yet in the set
+            while (!atomic_load(&existing->fully_linked))
+                sched_yield();
+            break;
+        }
+
+        if (!_csl_lock_preds(preds, succs, nullptr, levels))
+            continue;
+        for (uint32_t level = 0; level < levels; level++)
+            atomic_store_explicit(&node->next[level], succs[level], memory_order_relaxed);
+        for (uint32_t level = 0; level < levels; level++)
+            atomic_store_explicit(&preds[level]->next[level], node, memory_order_release);
+        atomic_store(&node->fully_linked, true);
+        _csl_unlock_preds(preds, levels - 1);
+        atomic_fetch_add(&list->size, 1);
+        added = true;
+        break;
+    }
+    ebr_exit(thread);
+
+    if (!added)
+        _csl_free_node(node);
+    return added;
+}
+
+/**
+ * @brief: Deletes the value from the set
+ *
+ * @details Marking the node while holding its lock is the linearization point. The node is then
+ *          unlinked from the top level down and retired.
+ *
+ * @return Whether this call deleted the value
+ */
+bool csl_del_value_uint32_t(csl_uint32_t* list, ebr_thread_t* thread, const uint32_t value)
+{
+    csl_node_uint32_t* preds[CSL_MAX_LEVEL];
+    csl_node_uint32_t* succs[CSL_MAX_LEVEL];
+    csl_node_uint32_t* victim = nullptr;
+    bool deleted = false;
+
+    ebr_enter(thread);
+    while (true) {
+        int found = _csl_find(list, value, preds, succs);
+        if (victim == nullptr) {
+            // Only delete nodes that are fully linked and were found on their top level
+            if (found == -1)
+                break;
+            csl_node_uint32_t* node = succs[found];
+            if (!atomic_load(&node->fully_linked) || node->levels - 1 != (uint32_t)found
+                || atomic_load(&node->marked))
+                break;
+            pthread_mutex_lock(&node->lock);
+            if (atomic_load(&node->marked)) {
+                pthread_mutex_unlock(&node->lock);
+                break;
+            }
+            atomic_store(&node->marked, true);
+            victim = node;
+        }
+
+        if (!_csl_lock_preds(preds, nullptr, victim, victim->levels))
+            continue;
+        for (int level = victim->levels - 1; level >= 0; level--) {
+            atomic_store_explicit(
+                &preds[level]->next[level],
+                atomic_load(&victim->next[level]),
+                memory_order_release);
+        }
+        pthread_mutex_unlock(&victim->lock);
+        _csl_unlock_preds(preds, victim->levels - 1);
+        ebr_retire(thread, victim, _csl_free_node);
+        atomic_fetch_sub(&list->size, 1);
+        deleted = true;
+        break;
+    }
+    ebr_exit(thread);
+    return deleted;
+}
+
+/**
+ * @brief: Checks whether the value is in the set without locking or writing anything
+ */
+bool csl_contains_uint32_t(csl_uint32_t* list, ebr_thread_t* thread, const uint32_t value)
+{
+    csl_node_uint32_t* preds[CSL_MAX_LEVEL];
+    csl_node_uint32_t* succs[CSL_MAX_LEVEL];
+    ebr_enter(thread);
+    int found = _csl_find(list, value, preds, succs);
+    bool contains = found != -1 && atomic_load(&succs[found]->fully_linked)
+        && !atomic_load(&succs[found]->marked);
+    ebr_exit(thread);
+    return contains;
+}
+
+bool csl_is_empty_uint32_t(csl_uint32_t* list)
+{
+    return csl_size_uint32_t(list) == 0;
+}
+
+/**
+ * @brief: Number of values, counted by every successful add and del
+ */
+size_t csl_size_uint32_t(csl_uint32_t* list)
+{
+    return atomic_load(&list->size);
+}
+
+/**
+ * @brief: Get the smallest value of the set
+ */
+Result_uint32_t csl_min_uint32_t(csl_uint32_t* list, ebr_thread_t* thread)
+{
+    return csl_lower_bound_uint32_t(list, thread, 0);
+}
+
+/**
+ * @brief: Get the smallest value greater or equal to value
+ */
+Result_uint32_t csl_lower_bound_uint32_t(
+    csl_uint32_t* list, ebr_thread_t* thread, const uint32_t value)
+{
+    ebr_enter(thread);
+    csl_node_uint32_t* node = _csl_lower_bound_node(list, value);
+    Result_uint32_t result = (node == nullptr)
+        ? Result_uint32_t_Err("No value greater or equal to the value")
+        : Result_uint32_t_Ok(node->value);
+    ebr_exit(thread);
+    return result;
+}
+
+/**
+ * @brief: Calls consume for every value in [lo, hi] in ascending order
+ *
+ * @details The scan walks the bottom level without locking. Values added or deleted during the
+ *          scan may or may not be reported, all others are reported exactly once. consume runs
+ *          inside of a critical section, so it must not call into the list with the same thread.
+ *
+ * @return Number of values consumed
+ */
+size_t csl_range_uint32_t(
+    csl_uint32_t* list,
+    ebr_thread_t* thread,
+    const uint32_t lo,
+    const uint32_t hi,
+    void (*consume)(uint32_t value, void* ctx),
+    void* ctx)
+{
+    size_t count = 0;
+    ebr_enter(thread);
+    csl_node_uint32_t* cur = _csl_lower_bound_node(list, lo);
+    while (cur != nullptr && cur->value <= hi) {
+        if (!atomic_load(&cur->marked) && atomic_load(&cur->fully_linked)) {
+            consume(cur->value, ctx);
+            count++;
+        }
+        cur = atomic_load_explicit(&cur->next[0], memory_order_acquire);
+    }
+    ebr_exit(thread);
+    return count;
+}
+
+/**
+ * @brief: Delete the entire list, including the head, all retired nodes and thread handles
+ */
+bool csl_clear_uint32_t(csl_uint32_t* list)
+{
+    csl_node_uint32_t* cur = list->head;
+    csl_node_uint32_t* next;
+    while (cur != nullptr) {
+        next = atomic_load(&cur->next[0]);
+        _csl_free_node(cur);
+        cur = next;
+    }
+    list->head = nullptr;
+    atomic_store(&list->size, 0);
+    ebr_clear(&list->ebr);
+    return true;
+}
+
+void csl_print_uint32_t(csl_uint32_t* list)
+{
+    printf("[");
+    csl_node_uint32_t* cur = atomic_load(&list->head->next[0]);
+    while (cur != nullptr) {
+        printf("%u", cur->value);
+        cur = atomic_load(&cur->next[0]);
+        if (cur != nullptr)
+            printf(", ");
+    }
+    printf("]\n");
+}
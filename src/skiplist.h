@@ -0,0 +1,69 @@
+#pragma once
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "utils/ebr.h"
+#include "utils/result_types.h"
+
+/**
+ * @file skiplist.h
+ *
+ * Concurrent skip list holding an ordered set (lazy skip list, Herlihy et al.).
+ *
+ * Every node is linked into a random number of levels, each level a sorted list skipping over
+ * roughly 3 out of 4 nodes of the level below, so searches take O(log n) steps. Searches, range
+ * scans and contains never lock or write anything. Writers search without locks as well, lock
+ * only the predecessors they are about to change and validate that those are still unmarked and
+ * linked to the expected successor, retrying otherwise. A node is in the set once it is fully
+ * linked and until it is marked, which makes add and del linearizable.
+ *
+ * Deleted nodes are freed through epoch-based reclamation, so every thread registers with the
+ * domain of the list, ebr_register(&list->ebr), and passes its handle to the operations.
+ * Creating, clearing and printing the list must not run concurrently with anything else.
+ */
+
+/**
+ * @brief Maximum number of levels, enough for about 4^16 values
+ */
+#define CSL_MAX_LEVEL 16
+
+#define CSL(type) csl_##type
+
+#define CSL_NODE(type) csl_node_##type
+
+#define CSL_DECLARE(type)                                                                          \
+    typedef struct CSL_NODE(type) {                                                                \
+        type value;                                                                                \
+        uint32_t levels;                                                                           \
+        atomic_bool marked;                                                                        \
+        atomic_bool fully_linked;                                                                  \
+        pthread_mutex_t lock;                                                                      \
+        _Atomic(struct CSL_NODE(type)*) next[];                                                    \
+    } CSL_NODE(type);                                                                              \
+    typedef struct CSL(type) {                                                                     \
+        CSL_NODE(type) * head;                                                                     \
+        atomic_size_t size;                                                                        \
+        ebr_domain_t ebr;                                                                          \
+    } CSL(type);                                                                                   \
+    CSL(type) csl_new_##type();                                                                    \
+    bool csl_add_value_##type(CSL(type) * list, ebr_thread_t* thread, const type value);           \
+    bool csl_del_value_##type(CSL(type) * list, ebr_thread_t* thread, const type value);           \
+    bool csl_contains_##type(CSL(type) * list, ebr_thread_t* thread, const type value);            \
+    bool csl_is_empty_##type(CSL(type) * list);                                                    \
+    size_t csl_size_##type(CSL(type) * list);                                                      \
+    RESULT(type) csl_min_##type(CSL(type) * list, ebr_thread_t* thread);                           \
+    RESULT(type) csl_lower_bound_##type(CSL(type) * list, ebr_thread_t* thread, const type value); \
+    size_t csl_range_##type(                                                                       \
+        CSL(type) * list,                                                                          \
+        ebr_thread_t* thread,                                                                      \
+        const type lo,                                                                             \
+        const type hi,                                                                             \
+        void (*consume)(type value, void* ctx),                                                    \
+        void* ctx);                                                                                \
+    bool csl_clear_##type(CSL(type) * list);                                                       \
+    void csl_print_##type(CSL(type) * list);
+
+CSL_DECLARE(uint32_t);
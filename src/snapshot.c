@@ -0,0 +1,433 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "snapshot.h"
+
+/**
+ * @brief Number of values buffered before they are written to the file
+ */
+#define WRITE_CHUNK 4096
+
+#define FNV_OFFSET 14695981039346656037ull
+#define FNV_PRIME 1099511628211ull
+
+//--------------------------------------------------
+// Helper functions
+
+/**
+ * @brief Folds values into an FNV-1a checksum, one 32-bit word per step instead of one byte
+ */
+static uint64_t _checksum(uint64_t hash, const uint32_t* values, const size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        hash ^= values[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * @brief Snapshot file that is being written
+ *
+ * @details Values are written to a temporary file next to the target and buffered in chunks. Only
+ *          a complete file with its final header is renamed to the target. The file is synced
+ *          before the rename and the directory after it, so neither a crash of the process nor
+ *          one of the system leaves a truncated snapshot behind under the target name.
+ */
+struct snapshot_writer {
+    FILE* file;
+    /**
+     * @brief Target the snapshot is moved to once it's complete, and the temporary file next to it
+     */
+    char* path;
+    char* tmp_path;
+    uint32_t chunk[WRITE_CHUNK];
+    size_t buffered;
+    snapshot_header_t header;
+    /**
+     * @brief Value added last, the values of a tree snapshot must not fall below it
+     */
+    uint32_t last;
+    bool ok;
+};
+
+static snapshot_writer_t* _writer_open(const char* path, const snapshot_kind_t kind)
+{
+    snapshot_writer_t* writer = malloc(sizeof(snapshot_writer_t));
+    if (writer == nullptr) {
+        return nullptr;
+    }
+    writer->path = strdup(path);
+    writer->tmp_path = malloc(strlen(path) + sizeof(".tmp"));
+    if (writer->path == nullptr || writer->tmp_path == nullptr) {
+        free(writer->path);
+        free(writer->tmp_path);
+        free(writer);
+        return nullptr;
+    }
+    sprintf(writer->tmp_path, "%s.tmp", path);
+    writer->file = fopen(writer->tmp_path, "wb");
+    if (writer->file == nullptr) {
+        free(writer->path);
+        free(writer->tmp_path);
+        free(writer);
+        return nullptr;
+    }
+    writer->buffered = 0;
+    writer->last = 0;
+    writer->header = (snapshot_header_t) {
+        .version = SNAPSHOT_VERSION,
+        .kind = kind,
+        .count = 0,
+        .checksum = FNV_OFFSET,
+    };
+    memcpy(writer->header.magic, SNAPSHOT_MAGIC, sizeof(writer->header.magic));
+    // The header is rewritten with the final count and checksum once all values are known
+    writer->ok = fwrite(&writer->header, sizeof(snapshot_header_t), 1, writer->file) == 1;
+    return writer;
+}
+
+static void _writer_flush(snapshot_writer_t* writer)
+{
+    if (writer->buffered == 0)
+        return;
+    writer->header.checksum = _checksum(writer->header.checksum, writer->chunk, writer->buffered);
+    writer->ok &= fwrite(writer->chunk, sizeof(uint32_t), writer->buffered, writer->file)
+        == writer->buffered;
+    writer->buffered = 0;
+}
+
+/**
+ * @brief Buffers value. A tree value out of ascending order fails the writer, so that close fails
+ */
+static void _writer_add(snapshot_writer_t* writer, const uint32_t value)
+{
+    if (writer->header.kind == SNAPSHOT_TREE && value < writer->last)
+        writer->ok = false;
+    writer->last = value;
+    writer->chunk[writer->buffered++] = value;
+    writer->header.count++;
+    if (writer->buffered == WRITE_CHUNK)
+        _writer_flush(writer);
+}
+
+/**
+ * @brief Syncs the directory that holds path, which makes a rename into it durable
+ */
+static bool _sync_parent_dir(const char* path)
+{
+    const char* slash = strrchr(path, '/');
+    char* dir;
+    if (slash == nullptr) {
+        dir = strdup(".");
+    } else if (slash == path) {
+        dir = strdup("/");
+    } else {
+        dir = strndup(path, (size_t)(slash - path));
+    }
+    if (dir == nullptr) {
+        return false;
+    }
+
+    int fd = open(dir, O_RDONLY | O_DIRECTORY);
+    free(dir);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = fsync(fd) == 0;
+    ok &= close(fd) == 0;
+    return ok;
+}
+
+/**
+ * @brief Writes the final header, syncs and closes the file and moves it to the target path. Frees
+ *        the writer
+ *
+ * @return Whether the snapshot was written completely and durably
+ */
+static bool _writer_close(snapshot_writer_t* writer)
+{
+    _writer_flush(writer);
+    writer->ok &= fseek(writer->file, 0, SEEK_SET) == 0;
+    writer->ok &= fwrite(&writer->header, sizeof(snapshot_header_t), 1, writer->file) == 1;
+    // The data has to be on disk before the rename is, or the target could end up truncated
+    writer->ok &= fflush(writer->file) == 0;
+    writer->ok &= fsync(fileno(writer->file)) == 0;
+    writer->ok &= fclose(writer->file) == 0;
+    if (writer->ok)
+        writer->ok = rename(writer->tmp_path, writer->path) == 0;
+    if (writer->ok) {
+        writer->ok = _sync_parent_dir(writer->path);
+    } else {
+        remove(writer->tmp_path);
+    }
+
+    bool ok = writer->ok;
+    free(writer->path);
+    free(writer->tmp_path);
+    free(writer);
+    return ok;
+}
+
+/**
+ * @brief Whether the values never decrease, which the searches on a tree snapshot rely on
+ */
+static bool _is_ascending(const uint32_t* values, const size_t count)
+{
+    for (size_t i = 1; i < count; i++) {
+        if (values[i] < values[i - 1])
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Index of the first value in a sorted block that is not smaller than value, or count
+ */
+static size_t _lower_bound_idx(const uint32_t* values, const size_t count, const uint32_t value)
+{
+    size_t lo = 0, hi = count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (values[mid] < value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+//--------------------------------------------------
+
+/**
+ * @brief: Saves the values of the tree in ascending order, walking it once with an iterator
+ *
+ * @return Whether the file was written. An existing file at path is only replaced on success
+ */
+bool snapshot_save_bt(bt_uint32_t* tree, const char* path)
+{
+    snapshot_writer_t* writer = _writer_open(path, SNAPSHOT_TREE);
+    if (writer == nullptr) {
+        return false;
+    }
+    for (bt_iter_uint32_t it = bt_iter_begin_uint32_t(tree); bt_iter_valid_uint32_t(&it);
+         bt_iter_next_uint32_t(&it)) {
+        _writer_add(writer, it.node->value);
+    }
+    return _writer_close(writer);
+}
+
+/**
+ * @brief: Saves the values of the list in list order
+ *
+ * @return Whether the file was written. An existing file at path is only replaced on success
+ */
+bool snapshot_save_ll(ll_uint32_t* list, const char* path)
+{
+    snapshot_writer_t* writer = _writer_open(path, SNAPSHOT_LIST);
+    if (writer == nullptr) {
+        return false;
+    }
+    for (ll_node_uint32_t* node = list->head; node != nullptr; node = node->next)
+        _writer_add(writer, node->value);
+    return _writer_close(writer);
+}
+
+/**
+ * @brief: Starts a tree snapshot at path whose values are streamed in one by one, for producers
+ *         that have no bt_uint32_t at hand. The values must be added in ascending order
+ *
+ * @return nullptr if the temporary file can't be created
+ */
+snapshot_writer_t* snapshot_writer_open(const char* path)
+{
+    return _writer_open(path, SNAPSHOT_TREE);
+}
+
+/**
+ * @brief: Appends value to the snapshot, buffered into chunks of WRITE_CHUNK values
+ *
+ * @details A value smaller than the one added before fails the snapshot, snapshot_writer_close
+ *          then returns false and writes nothing.
+ */
+void snapshot_writer_add(snapshot_writer_t* writer, const uint32_t value)
+{
+    _writer_add(writer, value);
+}
+
+/**
+ * @brief: Completes the snapshot and moves it to the path it was opened with. Frees the writer
+ *
+ * @return Whether the file was written. An existing file at the path is only replaced on success
+ */
+bool snapshot_writer_close(snapshot_writer_t* writer)
+{
+    return _writer_close(writer);
+}
+
+/**
+ * @brief: Maps the snapshot at path read-only
+ *
+ * @details The magic, version, kind, file size and checksum, and the order of the values of a tree
+ *          snapshot, are validated before the snapshot is handed out. Validating reads the whole
+ *          file once.
+ *
+ * @return false if the file can't be mapped or is no valid snapshot. The snapshot stays untouched
+ */
+bool snapshot_open(snapshot_t* snapshot, const char* path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(snapshot_header_t)) {
+        close(fd);
+        return false;
+    }
+    size_t map_size = (size_t)st.st_size;
+    void* map = mmap(nullptr, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid after the descriptor is closed
+    close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+
+    const snapshot_header_t* header = map;
+    const uint32_t* values = (const uint32_t*)(header + 1);
+    bool valid = memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) == 0
+        && header->version == SNAPSHOT_VERSION
+        && (header->kind == SNAPSHOT_TREE || header->kind == SNAPSHOT_LIST)
+        && header->count == (map_size - sizeof(snapshot_header_t)) / sizeof(uint32_t)
+        && (map_size - sizeof(snapshot_header_t)) % sizeof(uint32_t) == 0
+        && _checksum(FNV_OFFSET, values, header->count) == header->checksum
+        && (header->kind != SNAPSHOT_TREE || _is_ascending(values, header->count));
+    if (!valid) {
+        munmap(map, map_size);
+        return false;
+    }
+
+    *snapshot = (snapshot_t) {
+        .map = map,
+        .map_size = map_size,
+        .kind = header->kind,
+        .values = values,
+        .count = header->count,
+    };
+    return true;
+}
+
+/**
+ * @brief: Unmaps the snapshot
+ */
+void snapshot_close(snapshot_t* snapshot)
+{
+    if (snapshot->map != nullptr)
+        munmap(snapshot->map, snapshot->map_size);
+    *snapshot = (snapshot_t) { .map = nullptr, .map_size = 0, .values = nullptr, .count = 0 };
+}
+
+/**
+ * @brief: Returns the number of values in the snapshot
+ */
+size_t snapshot_size(snapshot_t* snapshot)
+{
+    return snapshot->count;
+}
+
+/**
+ * @brief: Checks whether value is in the snapshot, by binary search for trees and by a linear scan
+ *         for lists
+ */
+bool snapshot_contains(snapshot_t* snapshot, const uint32_t value)
+{
+    if (snapshot->kind == SNAPSHOT_TREE) {
+        size_t idx = _lower_bound_idx(snapshot->values, snapshot->count, value);
+        return idx < snapshot->count && snapshot->values[idx] == value;
+    }
+    for (size_t i = 0; i < snapshot->count; i++) {
+        if (snapshot->values[i] == value)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief: Returns the value at position idx, which is the idx-th node of a list and the idx-th
+ *         smallest value of a tree
+ */
+Result_uint32_t snapshot_get(snapshot_t* snapshot, const size_t idx)
+{
+    if (idx >= snapshot->count) {
+        return Result_uint32_t_Err("Out of range");
+    }
+    return Result_uint32_t_Ok(snapshot->values[idx]);
+}
+
+/**
+ * @brief: Returns the smallest value that is not smaller than value. Only tree snapshots are sorted
+ */
+Result_uint32_t snapshot_lower_bound(snapshot_t* snapshot, const uint32_t value)
+{
+    if (snapshot->kind != SNAPSHOT_TREE) {
+        return Result_uint32_t_Err("Snapshot is not sorted");
+    }
+    size_t idx = _lower_bound_idx(snapshot->values, snapshot->count, value);
+    if (idx == snapshot->count) {
+        return Result_uint32_t_Err("No such value");
+    }
+    return Result_uint32_t_Ok(snapshot->values[idx]);
+}
+
+/**
+ * @brief: Calls consume for every value in [lo, hi], in ascending order for trees and in list
+ *         order for lists
+ *
+ * @return The number of values consumed
+ */
+size_t snapshot_range(
+    snapshot_t* snapshot,
+    const uint32_t lo,
+    const uint32_t hi,
+    void (*consume)(uint32_t value, void* ctx),
+    void* ctx)
+{
+    size_t consumed = 0;
+    if (snapshot->kind == SNAPSHOT_TREE) {
+        for (size_t i = _lower_bound_idx(snapshot->values, snapshot->count, lo);
+             i < snapshot->count && snapshot->values[i] <= hi;
+             i++) {
+            consume(snapshot->values[i], ctx);
+            consumed++;
+        }
+        return consumed;
+    }
+    for (size_t i = 0; i < snapshot->count; i++) {
+        if (snapshot->values[i] >= lo && snapshot->values[i] <= hi) {
+            consume(snapshot->values[i], ctx);
+            consumed++;
+        }
+    }
+    return consumed;
+}
+
+/**
+ * @brief: Rebuilds a balanced tree out of a tree snapshot with bt_build_from_sorted, in O(n) and a
+ *         single allocation
+ *
+ * @return false for list snapshots and if out of memory, which leaves the tree empty
+ */
+bool snapshot_to_bt(snapshot_t* snapshot, bt_uint32_t* tree)
+{
+    if (snapshot->kind != SNAPSHOT_TREE) {
+        *tree = bt_new_uint32_t();
+        return false;
+    }
+    return bt_build_from_sorted_uint32_t(tree, snapshot->values, snapshot->count);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "list.h"
+#include "tree.h"
+#include "utils/result_types.h"
+
+/**
+ * @file snapshot.h
+ *
+ * Binary snapshots of bt_uint32_t and ll_uint32_t that are queried straight from a memory mapping.
+ *
+ * A snapshot file is a fixed header followed by a block of values and contains no pointers:
+ *
+ *   | magic | version | kind | count | checksum | values[count] |
+ *
+ * A tree is stored as its values in ascending order, which is all a search needs. A list is stored
+ * as its values in list order, position i of the block being the i-th node. The checksum covers
+ * the value block, all fields are in the byte order of the machine that wrote the file.
+ *
+ * snapshot_open maps a file read-only and validates it. The queries then work on the mapping
+ * directly, so opening a snapshot allocates nothing per value and the kernel only pages in the
+ * parts that are read.
+ */
+
+/**
+ * @brief Format version, bumped whenever the layout of the file changes
+ */
+#define SNAPSHOT_VERSION 1
+
+/**
+ * @brief First bytes of every snapshot file
+ */
+#define SNAPSHOT_MAGIC "DSSNAP\0"
+
+typedef enum snapshot_kind {
+    SNAPSHOT_TREE = 1,
+    SNAPSHOT_LIST = 2,
+} snapshot_kind_t;
+
+typedef struct snapshot_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t kind;
+    uint64_t count;
+    uint64_t checksum;
+} snapshot_header_t;
+
+/**
+ * @brief Tree snapshot that is being written value by value, see snapshot_writer_open
+ */
+typedef struct snapshot_writer snapshot_writer_t;
+
+typedef struct snapshot {
+    void* map;
+    size_t map_size;
+    snapshot_kind_t kind;
+    const uint32_t* values;
+    size_t count;
+} snapshot_t;
+
+bool snapshot_save_bt(bt_uint32_t* tree, const char* path);
+bool snapshot_save_ll(ll_uint32_t* list, const char* path);
+snapshot_writer_t* snapshot_writer_open(const char* path);
+void snapshot_writer_add(snapshot_writer_t* writer, const uint32_t value);
+bool snapshot_writer_close(snapshot_writer_t* writer);
+bool snapshot_open(snapshot_t* snapshot, const char* path);
+void snapshot_close(snapshot_t* snapshot);
+size_t snapshot_size(snapshot_t* snapshot);
+bool snapshot_contains(snapshot_t* snapshot, const uint32_t value);
+Result_uint32_t snapshot_get(snapshot_t* snapshot, const size_t idx);
+Result_uint32_t snapshot_lower_bound(snapshot_t* snapshot, const uint32_t value);
+size_t snapshot_range(
+    snapshot_t* snapshot,
+    const uint32_t lo,
+    const uint32_t hi,
+    void (*consume)(uint32_t value, void* ctx),
+    void* ctx);
+bool snapshot_to_bt(snapshot_t* snapshot, bt_uint32_t* tree);
@@ -1,5 +1,13 @@
+#pragma once
+
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "utils/pool.h"
+#include "utils/result_types.h"
+#include "utils/stats.h"
 
 /**
  * @file tree.h
@@ -10,28 +18,1426 @@
 
 /**
  * @brief B-Tree (Binary Tree)
+ *
+ * @details Every node counts the nodes of its subtree, which makes the size O(1) and rank and
+ *          select O(height). The count fits the padding behind a 4-byte value, so a tree holds at
+ *          most UINT32_MAX values.
  */
 #define B_TREE(type) bt_##type
 
 #define B_TREE_NODE(type) bt_node_##type
 
+/**
+ * @brief In-order iterator over a B-Tree
+ *
+ * @details The iterator walks along the parent links, so stepping needs no extra memory and no
+ *          recursion. A node of nullptr marks the position past the last value. Adding or deleting
+ *          values invalidates iterators pointing to the affected nodes.
+ */
+#define B_TREE_ITER(type) bt_iter_##type
+
+/**
+ * @brief Read-only search index over the values of a B-Tree in Eytzinger layout
+ *
+ * @details keys[1] is the root and keys[2k] and keys[2k + 1] are the children of keys[k], i.e. the
+ *          values are stored in breadth-first order of a complete binary search tree. A search
+ *          walks down one array without chasing pointers, and since the nodes of a level are next
+ *          to each other, the descendants a few levels below a node share a cache line that is
+ *          prefetched long before the search gets there. The index takes sizeof(type) bytes per
+ *          value and doesn't follow later changes of the tree it was frozen from.
+ */
+#define B_TREE_FROZEN(type) bt_frozen_##type
+
+/**
+ * @brief Alignment of the keys of a frozen index, one cache line
+ */
+#define B_TREE_CACHE_LINE 64
+
+/**
+ * @brief Number of keys per cache line, which is how many descendants a search prefetches
+ */
+#define B_TREE_FROZEN_PREFETCH(type)                                                               \
+    ((sizeof(type) < B_TREE_CACHE_LINE) ? B_TREE_CACHE_LINE / sizeof(type) : 1)
+
+/**
+ * @brief Number of lookups a batched operation advances in lockstep
+ *
+ * @details About as many cache misses as a core can have in flight at once
+ */
+#define B_TREE_BATCH_WIDTH 16
+
 #define B_TREE_DECLARE(type)                                                                       \
     typedef struct B_TREE_NODE(type) {                                                             \
         type value;                                                                                \
+        uint32_t count;                                                                            \
         struct B_TREE_NODE(type) * parent;                                                         \
         struct B_TREE_NODE(type) * left;                                                           \
         struct B_TREE_NODE(type) * right;                                                          \
     } B_TREE_NODE(type);                                                                           \
     typedef struct B_TREE(type) {                                                                  \
         B_TREE_NODE(type) * root;                                                                  \
+        pool_t pool;                                                                               \
+        DS_STATS_MEMBER                                                                            \
     } B_TREE(type);                                                                                \
+    typedef struct B_TREE_ITER(type) {                                                             \
+        B_TREE(type) * tree;                                                                       \
+        B_TREE_NODE(type) * node;                                                                  \
+    } B_TREE_ITER(type);                                                                           \
+    typedef struct B_TREE_FROZEN(type) {                                                           \
+        type* keys;                                                                                \
+        size_t length;                                                                             \
+    } B_TREE_FROZEN(type);                                                                         \
     B_TREE(type) bt_new_##type();                                                                  \
-    bool bt_add_value_##type(B_TREE(type) * tree, const int value);                                \
-    bool bt_del_value_##type(B_TREE(type) * tree, const int value);                                \
-    bool bt_contains_##type(B_TREE(type) * tree, const int value);                                 \
+    B_TREE(type) bt_new_pooled_##type();                                                           \
+    bool bt_build_from_sorted_##type(                                                              \
+        B_TREE(type) * tree,                                                                       \
+        const type* values,                                                                        \
+        const size_t length);                                                                      \
+    void bt_rebalance_##type(B_TREE(type) * tree);                                                 \
+    bool bt_add_value_##type(B_TREE(type) * tree, const type value);                               \
+    bool bt_del_value_##type(B_TREE(type) * tree, const type value);                               \
+    bool bt_contains_##type(B_TREE(type) * tree, const type value);                                \
+    void bt_contains_batch_##type(                                                                 \
+        B_TREE(type) * tree,                                                                       \
+        const type* values,                                                                        \
+        const size_t count,                                                                        \
+        bool* out);                                                                                \
     bool bt_is_empty_##type(B_TREE(type) * tree);                                                  \
     bool bt_clear_##type(B_TREE(type) * tree);                                                     \
     size_t bt_size_##type(B_TREE(type) * tree);                                                    \
-    void bt_print_##type(B_TREE(type) * tree);
+    size_t bt_height_##type(B_TREE(type) * tree);                                                  \
+    size_t bt_depth_histogram_##type(B_TREE(type) * tree, size_t* histogram, const size_t length); \
+    ds_stats_t bt_stats_##type(B_TREE(type) * tree);                                               \
+    void bt_stats_reset_##type(B_TREE(type) * tree);                                               \
+    bool bt_stats_write_json_##type(B_TREE(type) * tree, FILE* file);                              \
+    size_t bt_rank_##type(B_TREE(type) * tree, const type value);                                  \
+    RESULT(type) bt_select_##type(B_TREE(type) * tree, const size_t k);                            \
+    RESULT(type) bt_min_##type(B_TREE(type) * tree);                                               \
+    RESULT(type) bt_max_##type(B_TREE(type) * tree);                                               \
+    RESULT(type) bt_lower_bound_##type(B_TREE(type) * tree, const type value);                     \
+    void bt_lower_bound_batch_##type(                                                              \
+        B_TREE(type) * tree,                                                                       \
+        const type* values,                                                                        \
+        const size_t count,                                                                        \
+        RESULT(type) * out);                                                                       \
+    RESULT(type) bt_upper_bound_##type(B_TREE(type) * tree, const type value);                     \
+    RESULT(type) bt_floor_##type(B_TREE(type) * tree, const type value);                           \
+    RESULT(type) bt_ceiling_##type(B_TREE(type) * tree, const type value);                         \
+    RESULT(type) bt_predecessor_##type(B_TREE(type) * tree, const type value);                     \
+    size_t bt_range_##type(                                                                        \
+        B_TREE(type) * tree,                                                                       \
+        const type lo,                                                                             \
+        const type hi,                                                                             \
+        void (*consume)(type value, void* ctx),                                                    \
+        void* ctx);                                                                                \
+    void bt_print_##type(B_TREE(type) * tree);                                                     \
+    B_TREE_ITER(type) bt_iter_begin_##type(B_TREE(type) * tree);                                   \
+    B_TREE_ITER(type) bt_iter_last_##type(B_TREE(type) * tree);                                    \
+    B_TREE_ITER(type) bt_iter_lower_bound_##type(B_TREE(type) * tree, const type value);           \
+    bool bt_iter_valid_##type(B_TREE_ITER(type) * iter);                                           \
+    bool bt_iter_next_##type(B_TREE_ITER(type) * iter);                                            \
+    bool bt_iter_prev_##type(B_TREE_ITER(type) * iter);                                            \
+    B_TREE_FROZEN(type) bt_freeze_##type(B_TREE(type) * tree);                                     \
+    bool bt_frozen_contains_##type(B_TREE_FROZEN(type) * frozen, const type value);                \
+    RESULT(type) bt_frozen_lower_bound_##type(B_TREE_FROZEN(type) * frozen, const type value);     \
+    size_t bt_frozen_size_##type(B_TREE_FROZEN(type) * frozen);                                    \
+    void bt_frozen_clear_##type(B_TREE_FROZEN(type) * frozen);
+
+/**
+ * @brief Ordering hook for B_TREE_DEFINE comparing values with <
+ */
+#define B_TREE_DEFAULT_LESS(a, b) ((a) < (b))
+
+/**
+ * @brief Defines all the functions declared by B_TREE_DECLARE for the given type
+ * @details Expand this once in a single translation unit. The hooks may be macros or functions and
+ *          are expanded in place, so the compiler can inline them into every operation. Two values
+ *          are considered equal if neither is less than the other.
+ *
+ * @param type Type of the values
+ * @param less Hook called as less(a, b) that returns whether a is ordered before b
+ * @param print_value Hook called as print_value(value) that prints a single value to stdout
+ */
+#define B_TREE_DEFINE(type, less, print_value)                                                     \
+    /**                                                                                            \
+     * @brief Allocates a node from the pool of the tree, or with malloc if the tree is not pooled \
+     */                                                                                            \
+    static B_TREE_NODE(type) * _bt_alloc_node_##type(B_TREE(type) * tree)                          \
+    {                                                                                              \
+        B_TREE_NODE(type) * node;                                                                  \
+        if (pool_is_active(&tree->pool)) {                                                         \
+            node = pool_alloc(&tree->pool);                                                        \
+        } else {                                                                                   \
+            node = malloc(sizeof(B_TREE_NODE(type)));                                              \
+        }                                                                                          \
+        if (node != nullptr)                                                                       \
+            DS_STATS_ALLOC(&tree->stats, sizeof(B_TREE_NODE(type)));                               \
+        return node;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Releases a node allocated with _bt_alloc_node                                        \
+     */                                                                                            \
+    static void _bt_free_node_##type(B_TREE(type) * tree, B_TREE_NODE(type) * node)                \
+    {                                                                                              \
+        DS_STATS_FREE(&tree->stats, sizeof(B_TREE_NODE(type)));                                    \
+        if (pool_is_active(&tree->pool)) {                                                         \
+            pool_free(&tree->pool, node);                                                          \
+        } else {                                                                                   \
+            free(node);                                                                            \
+        }                                                                                          \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief The less hook, counted as a comparison of tree if DS_STATS is defined                \
+     */                                                                                            \
+    static inline bool _bt_less_##type(B_TREE(type) * tree, const type a, const type b)            \
+    {                                                                                              \
+        DS_STATS_ADD(&tree->stats, comparisons, 1);                                                \
+        return less(a, b);                                                                         \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Replaces the subtree rooted at node with the subtree rooted at replacement           \
+     *                                                                                             \
+     * @details Only the link from the parent of node is updated, node itself keeps its children.  \
+     */                                                                                            \
+    static void _bt_transplant_##type(                                                             \
+        B_TREE(type) * tree, B_TREE_NODE(type) * node, B_TREE_NODE(type) * replacement)            \
+    {                                                                                              \
+        if (node->parent == nullptr) {                                                             \
+            tree->root = replacement;                                                              \
+        } else if (node->parent->left == node) {                                                   \
+            node->parent->left = replacement;                                                      \
+        } else {                                                                                   \
+            node->parent->right = replacement;                                                     \
+        }                                                                                          \
+        if (replacement != nullptr)                                                                \
+            replacement->parent = node->parent;                                                    \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Number of nodes in the subtree of node. The empty subtree has 0 nodes                \
+     */                                                                                            \
+    static size_t _bt_subtree_count_##type(B_TREE_NODE(type) * node)                               \
+    {                                                                                              \
+        return (node == nullptr) ? 0 : node->count;                                                \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Rotates the left child of node up into its place                                     \
+     */                                                                                            \
+    static void _bt_rotate_right_##type(B_TREE(type) * tree, B_TREE_NODE(type) * node)             \
+    {                                                                                              \
+        B_TREE_NODE(type) * left = node->left;                                                     \
+                                                                                                   \
+        _bt_transplant_##type(tree, node, left);                                                   \
+        node->left = left->right;                                                                  \
+        if (node->left != nullptr)                                                                 \
+            node->left->parent = node;                                                             \
+        left->right = node;                                                                        \
+        node->parent = left;                                                                       \
+                                                                                                   \
+        left->count = node->count;                                                                 \
+        node->count =                                                                              \
+            1 + _bt_subtree_count_##type(node->left) + _bt_subtree_count_##type(node->right);      \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Rotates the right child of node up into its place                                    \
+     */                                                                                            \
+    static void _bt_rotate_left_##type(B_TREE(type) * tree, B_TREE_NODE(type) * node)              \
+    {                                                                                              \
+        B_TREE_NODE(type) * right = node->right;                                                   \
+                                                                                                   \
+        _bt_transplant_##type(tree, node, right);                                                  \
+        node->right = right->left;                                                                 \
+        if (node->right != nullptr)                                                                \
+            node->right->parent = node;                                                            \
+        right->left = node;                                                                        \
+        node->parent = right;                                                                      \
+                                                                                                   \
+        right->count = node->count;                                                                \
+        node->count =                                                                              \
+            1 + _bt_subtree_count_##type(node->left) + _bt_subtree_count_##type(node->right);      \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Left rotates every second node along the right spine below top, times many times     \
+     *                                                                                             \
+     * @details This is the compression step of the Day-Stout-Warren algorithm.                    \
+     */                                                                                            \
+    static void _bt_compress_spine_##type(                                                         \
+        B_TREE(type) * tree, B_TREE_NODE(type) * top, size_t times)                                \
+    {                                                                                              \
+        for (B_TREE_NODE(type) * cur = top; times > 0; times--) {                                  \
+            _bt_rotate_left_##type(tree, cur->right);                                              \
+            cur = cur->right;                                                                      \
+        }                                                                                          \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Builds a perfectly balanced subtree out of length sorted values                      \
+     */                                                                                            \
+    static B_TREE_NODE(type) * _bt_build_subtree_##type(                                           \
+        B_TREE(type) * tree, const type* values, const size_t length, B_TREE_NODE(type) * parent)  \
+    {                                                                                              \
+        if (length == 0)                                                                           \
+            return nullptr;                                                                        \
+                                                                                                   \
+        B_TREE_NODE(type) * node = _bt_alloc_node_##type(tree);                                    \
+        if (node == nullptr)                                                                       \
+            return nullptr;                                                                        \
+                                                                                                   \
+        size_t mid = length / 2;                                                                   \
+        *node = (B_TREE_NODE(type)) {                                                              \
+            .value = values[mid],                                                                  \
+            .count = length,                                                                       \
+            .parent = parent,                                                                      \
+        };                                                                                         \
+        node->left = _bt_build_subtree_##type(tree, values, mid, node);                            \
+        node->right = _bt_build_subtree_##type(tree, values + mid + 1, length - mid - 1, node);    \
+        return node;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Find max node from node                                                              \
+     */                                                                                            \
+    static B_TREE_NODE(type) * _bt_find_max_node_##type(B_TREE_NODE(type) * node)                  \
+    {                                                                                              \
+        if (node == nullptr)                                                                       \
+            return node;                                                                           \
+        while (node->right != nullptr)                                                             \
+            node = node->right;                                                                    \
+        return node;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Find min node from node                                                              \
+     */                                                                                            \
+    static B_TREE_NODE(type) * _bt_find_min_node_##type(B_TREE_NODE(type) * node)                  \
+    {                                                                                              \
+        if (node == nullptr)                                                                       \
+            return node;                                                                           \
+        while (node->left != nullptr)                                                              \
+            node = node->left;                                                                     \
+        return node;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Find node that is directly next to the given value                                   \
+     */                                                                                            \
+    static B_TREE_NODE(type) * _bt_find_next_node_##type(B_TREE(type) * tree, const type value)    \
+    {                                                                                              \
+        B_TREE_NODE(type) *cur = tree->root, *parent;                                              \
+                                                                                                   \
+        if (cur == nullptr) {                                                                      \
+            return nullptr;                                                                        \
+        }                                                                                          \
+                                                                                                   \
+        parent = cur->parent;                                                                      \
+        DS_STATS_ADD(&tree->stats, searches, 1);                                                   \
+        while (cur != nullptr) {                                                                   \
+            DS_STATS_ADD(&tree->stats, node_visits, 1);                                            \
+            parent = cur;                                                                          \
+            cur = _bt_less_##type(tree, value, cur->value) ? cur->left : cur->right;               \
+        }                                                                                          \
+                                                                                                   \
+        return parent;                                                                             \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Find node that is directly matches to the given value. Return nullptr otherwise      \
+     */                                                                                            \
+    static B_TREE_NODE(type) * _bt_find_matching_node_##type(                                      \
+        B_TREE(type) * tree, const type value)                                                     \
+    {                                                                                              \
+        B_TREE_NODE(type) * cur = tree->root;                                                      \
+                                                                                                   \
+        DS_STATS_ADD(&tree->stats, searches, 1);                                                   \
+        while (cur != nullptr) {                                                                   \
+            DS_STATS_ADD(&tree->stats, node_visits, 1);                                            \
+            if (_bt_less_##type(tree, value, cur->value)) {                                        \
+                cur = cur->left;                                                                   \
+            } else if (_bt_less_##type(tree, cur->value, value)) {                                 \
+                cur = cur->right;                                                                  \
+            } else {                                                                               \
+                return cur;                                                                        \
+            }                                                                                      \
+        }                                                                                          \
+                                                                                                   \
+        return nullptr;                                                                            \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Find the in-order successor of node. Returns nullptr if node holds the max value     \
+     */                                                                                            \
+    static B_TREE_NODE(type) * _bt_next_node_##type(B_TREE_NODE(type) * node)                      \
+    {                                                                                              \
+        if (node->right != nullptr)                                                                \
+            return _bt_find_min_node_##type(node->right);                                          \
+        while (node->parent != nullptr && node->parent->right == node)                             \
+            node = node->parent;                                                                   \
+        return node->parent;                                                                       \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Find the in-order predecessor of node. Returns nullptr if node holds the min value   \
+     */                                                                                            \
+    static B_TREE_NODE(type) * _bt_prev_node_##type(B_TREE_NODE(type) * node)                      \
+    {                                                                                              \
+        if (node->left != nullptr)                                                                 \
+            return _bt_find_max_node_##type(node->left);                                           \
+        while (node->parent != nullptr && node->parent->left == node)                              \
+            node = node->parent;                                                                   \
+        return node->parent;                                                                       \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Find the first node in order whose value is not smaller than value                   \
+     */                                                                                            \
+    static B_TREE_NODE(type) * _bt_find_lower_bound_node_##type(                                   \
+        B_TREE(type) * tree, const type value)                                                     \
+    {                                                                                              \
+        B_TREE_NODE(type) *cur = tree->root, *bound = nullptr;                                     \
+                                                                                                   \
+        DS_STATS_ADD(&tree->stats, searches, 1);                                                   \
+        while (cur != nullptr) {                                                                   \
+            DS_STATS_ADD(&tree->stats, node_visits, 1);                                            \
+            if (!_bt_less_##type(tree, cur->value, value)) {                                       \
+                bound = cur;                                                                       \
+                cur = cur->left;                                                                   \
+            } else {                                                                               \
+                cur = cur->right;                                                                  \
+            }                                                                                      \
+        }                                                                                          \
+                                                                                                   \
+        return bound;                                                                              \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Find the first node in order whose value is bigger than value                        \
+     */                                                                                            \
+    static B_TREE_NODE(type) * _bt_find_upper_bound_node_##type(                                   \
+        B_TREE(type) * tree, const type value)                                                     \
+    {                                                                                              \
+        B_TREE_NODE(type) *cur = tree->root, *bound = nullptr;                                     \
+                                                                                                   \
+        DS_STATS_ADD(&tree->stats, searches, 1);                                                   \
+        while (cur != nullptr) {                                                                   \
+            DS_STATS_ADD(&tree->stats, node_visits, 1);                                            \
+            if (_bt_less_##type(tree, value, cur->value)) {                                        \
+                bound = cur;                                                                       \
+                cur = cur->left;                                                                   \
+            } else {                                                                               \
+                cur = cur->right;                                                                  \
+            }                                                                                      \
+        }                                                                                          \
+                                                                                                   \
+        return bound;                                                                              \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Find the last node in order whose value is not bigger than value                     \
+     */                                                                                            \
+    static B_TREE_NODE(type) * _bt_find_floor_node_##type(B_TREE(type) * tree, const type value)   \
+    {                                                                                              \
+        B_TREE_NODE(type) *cur = tree->root, *bound = nullptr;                                     \
+                                                                                                   \
+        DS_STATS_ADD(&tree->stats, searches, 1);                                                   \
+        while (cur != nullptr) {                                                                   \
+            DS_STATS_ADD(&tree->stats, node_visits, 1);                                            \
+            if (!_bt_less_##type(tree, value, cur->value)) {                                       \
+                bound = cur;                                                                       \
+                cur = cur->right;                                                                  \
+            } else {                                                                               \
+                cur = cur->left;                                                                   \
+            }                                                                                      \
+        }                                                                                          \
+                                                                                                   \
+        return bound;                                                                              \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Find the last node in order whose value is smaller than value                        \
+     */                                                                                            \
+    static B_TREE_NODE(type) * _bt_find_predecessor_node_##type(                                   \
+        B_TREE(type) * tree, const type value)                                                     \
+    {                                                                                              \
+        B_TREE_NODE(type) *cur = tree->root, *bound = nullptr;                                     \
+                                                                                                   \
+        DS_STATS_ADD(&tree->stats, searches, 1);                                                   \
+        while (cur != nullptr) {                                                                   \
+            DS_STATS_ADD(&tree->stats, node_visits, 1);                                            \
+            if (_bt_less_##type(tree, cur->value, value)) {                                        \
+                bound = cur;                                                                       \
+                cur = cur->right;                                                                  \
+            } else {                                                                               \
+                cur = cur->left;                                                                   \
+            }                                                                                      \
+        }                                                                                          \
+                                                                                                   \
+        return bound;                                                                              \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Finds the lower bound nodes of up to B_TREE_BATCH_WIDTH values at once               \
+     *                                                                                             \
+     * @details Independent lookups miss the cache independently, but a single lookup can't load   \
+     *          a child before its parent arrived. Every round therefore takes one step down in    \
+     *          each of the lookups and prefetches the child it stepped to, so up to width misses  \
+     *          are in flight at the same time instead of one after the other.                     \
+     *                                                                                             \
+     * @param bounds Filled with the lower bound node of every value, or nullptr if there is none  \
+     */                                                                                            \
+    static void _bt_find_lower_bound_nodes_##type(                                                 \
+        B_TREE(type) * tree,                                                                       \
+        const type* values,                                                                        \
+        const size_t width,                                                                        \
+        B_TREE_NODE(type) * *bounds)                                                               \
+    {                                                                                              \
+        B_TREE_NODE(type) * cur[B_TREE_BATCH_WIDTH];                                               \
+        for (size_t lane = 0; lane < width; lane++) {                                              \
+            cur[lane] = tree->root;                                                                \
+            bounds[lane] = nullptr;                                                                \
+        }                                                                                          \
+                                                                                                   \
+        size_t active = (tree->root != nullptr) ? width : 0;                                       \
+        DS_STATS_ADD(&tree->stats, searches, active);                                              \
+        while (active > 0) {                                                                       \
+            active = 0;                                                                            \
+            for (size_t lane = 0; lane < width; lane++) {                                          \
+                B_TREE_NODE(type) * node = cur[lane];                                              \
+                if (node == nullptr)                                                               \
+                    continue;                                                                      \
+                DS_STATS_ADD(&tree->stats, node_visits, 1);                                        \
+                if (!_bt_less_##type(tree, node->value, values[lane])) {                           \
+                    bounds[lane] = node;                                                           \
+                    node = node->left;                                                             \
+                } else {                                                                           \
+                    node = node->right;                                                            \
+                }                                                                                  \
+                if (node != nullptr) {                                                             \
+                    __builtin_prefetch(node);                                                      \
+                    active++;                                                                      \
+                }                                                                                  \
+                cur[lane] = node;                                                                  \
+            }                                                                                      \
+        }                                                                                          \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Wraps the value of node into a result, which is an error if node is nullptr          \
+     */                                                                                            \
+    static RESULT(type) _bt_node_result_##type(B_TREE_NODE(type) * node)                           \
+    {                                                                                              \
+        if (node == nullptr) {                                                                     \
+            return RESULT_ERR(type)("No such value");                                              \
+        }                                                                                          \
+        return RESULT_OK(type)(node->value);                                                       \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Traverse the tree                                                                    \
+     *                                                                                             \
+     * @detail This supports the pre, in and post traversal variant, each consume callback is      \
+     *         called at the respective point of the walk and may be nullptr. Instead of           \
+     *         recursing, the walk climbs back up along the parent links, so it needs O(1) extra   \
+     *         memory. The next step is determined before consume_post is called, so it may free   \
+     *         the node.                                                                           \
+     *                                                                                             \
+     * @param root Root of the subtree to be traversed                                             \
+     * @param consume_pre Callback to consume node before its children                             \
+     * @param consume_in Callback to consume node between its children                             \
+     * @param consume_post Callback to consume node after its children                             \
+     * @param ctx User context passed to the callbacks                                             \
+     */                                                                                            \
+    static void _bt_traverse_tree_##type(                                                          \
+        B_TREE_NODE(type) * root,                                                                  \
+        void (*consume_pre)(B_TREE_NODE(type)*, void*),                                            \
+        void (*consume_in)(B_TREE_NODE(type)*, void*),                                             \
+        void (*consume_post)(B_TREE_NODE(type)*, void*),                                           \
+        void* ctx)                                                                                 \
+    {                                                                                              \
+        enum { FROM_PARENT, FROM_LEFT, FROM_RIGHT } from = FROM_PARENT;                            \
+        B_TREE_NODE(type) *cur = root, *next;                                                      \
+                                                                                                   \
+        while (cur != nullptr) {                                                                   \
+            if (from == FROM_PARENT) {                                                             \
+                if (consume_pre != nullptr)                                                        \
+                    consume_pre(cur, ctx);                                                         \
+                if (cur->left != nullptr) {                                                        \
+                    cur = cur->left;                                                               \
+                    continue;                                                                      \
+                }                                                                                  \
+                from = FROM_LEFT;                                                                  \
+            }                                                                                      \
+            if (from == FROM_LEFT) {                                                               \
+                if (consume_in != nullptr)                                                         \
+                    consume_in(cur, ctx);                                                          \
+                if (cur->right != nullptr) {                                                       \
+                    cur = cur->right;                                                              \
+                    from = FROM_PARENT;                                                            \
+                    continue;                                                                      \
+                }                                                                                  \
+            }                                                                                      \
+            next = (cur == root) ? nullptr : cur->parent;                                          \
+            from = (next != nullptr && next->left == cur) ? FROM_LEFT : FROM_RIGHT;                \
+            if (consume_post != nullptr)                                                           \
+                consume_post(cur, ctx);                                                            \
+            cur = next;                                                                            \
+        }                                                                                          \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Position that follows k in an in-order walk of an Eytzinger array of length keys, or \
+     *        0 after the last one                                                                 \
+     */                                                                                            \
+    static size_t _bt_eytzinger_next_##type(size_t k, const size_t length)                         \
+    {                                                                                              \
+        if (2 * k + 1 <= length) {                                                                 \
+            k = 2 * k + 1;                                                                         \
+            while (2 * k <= length)                                                                \
+                k = 2 * k;                                                                         \
+            return k;                                                                              \
+        }                                                                                          \
+        /* Climb up as long as k is a right child, then once more from the left child */           \
+        while (k & 1)                                                                              \
+            k >>= 1;                                                                               \
+        return k >> 1;                                                                             \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Position of the first key in a frozen index that is not smaller than value, or 0     \
+     *                                                                                             \
+     * @details Every level takes the same steps and the comparison only decides whether the       \
+     *          right child is taken, so there is no branch to mispredict. The search always runs  \
+     *          down to a leaf and the bits of k record its turns. The lower bound is where it     \
+     *          turned left for the last time, found by stripping the trailing right turns and     \
+     *          that left turn off k.                                                              \
+     */                                                                                            \
+    static size_t _bt_frozen_lower_bound_idx_##type(                                               \
+        B_TREE_FROZEN(type) * frozen,                                                              \
+        const type value)                                                                          \
+    {                                                                                              \
+        const type* keys = frozen->keys;                                                           \
+        size_t k = 1;                                                                              \
+        while (k <= frozen->length) {                                                              \
+            __builtin_prefetch(keys + k * B_TREE_FROZEN_PREFETCH(type));                           \
+            k = 2 * k + (less(keys[k], value) ? 1 : 0);                                            \
+        }                                                                                          \
+        return k >> __builtin_ffsll(~(long long)k);                                                \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Creates a new tree                                                                   \
+     */                                                                                            \
+    B_TREE(type) bt_new_##type()                                                                   \
+    {                                                                                              \
+        return (B_TREE(type)) { .root = nullptr, .pool = { 0 } };                                  \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Creates a new tree that allocates its nodes from a node pool                         \
+     *                                                                                             \
+     * @details Nodes are bump-allocated from contiguous slabs, deleted nodes are recycled and     \
+     *          clearing the tree releases whole slabs without traversing it.                      \
+     */                                                                                            \
+    B_TREE(type) bt_new_pooled_##type()                                                            \
+    {                                                                                              \
+        return (B_TREE(type)) { .root = nullptr, .pool = pool_new(sizeof(B_TREE_NODE(type)), 0) }; \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Creates a perfectly balanced pooled tree out of length ascending values              \
+     *                                                                                             \
+     * @details The values are linked in a single pass without any comparisons. All nodes come     \
+     *          from one slab sized to hold exactly length nodes, so the tree costs a single       \
+     *          allocation. Either that allocation fails, or every node is allocated.              \
+     *                                                                                             \
+     * @return false if the allocation failed or more than UINT32_MAX values don't fit the         \
+     *         counts. The tree is empty then, but usable                                          \
+     */                                                                                            \
+    bool bt_build_from_sorted_##type(B_TREE(type) * tree, const type* values, const size_t length) \
+    {                                                                                              \
+        *tree = bt_new_pooled_##type();                                                            \
+        if (length > UINT32_MAX)                                                                   \
+            return false;                                                                          \
+                                                                                                   \
+        pool_set_slab_nodes(&tree->pool, length);                                                  \
+        tree->root = _bt_build_subtree_##type(tree, values, length, nullptr);                      \
+        /* Later insertions shouldn't reserve a slab as big as the whole tree */                   \
+        pool_set_slab_nodes(&tree->pool, POOL_DEFAULT_SLAB_NODES);                                 \
+        return length == 0 || tree->root != nullptr;                                               \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Restores a minimal height of the tree in place with the Day-Stout-Warren algorithm   \
+     *                                                                                             \
+     * @details Right rotations first turn the tree into a vine, a sorted chain of right children. \
+     *          Rounds of left rotations then fold the vine back into a balanced tree whose levels \
+     *          are full except for the last one. This takes O(n) time and no extra memory.        \
+     */                                                                                            \
+    void bt_rebalance_##type(B_TREE(type) * tree)                                                  \
+    {                                                                                              \
+        if (tree->root == nullptr)                                                                 \
+            return;                                                                                \
+                                                                                                   \
+        /* A pseudo root above the real one lets rotations treat the root like any other node */   \
+        B_TREE_NODE(type) pseudo_root = { .count = 0, .right = tree->root };                       \
+        tree->root->parent = &pseudo_root;                                                         \
+        size_t size = tree->root->count;                                                           \
+                                                                                                   \
+        B_TREE_NODE(type) * cur = pseudo_root.right;                                               \
+        while (cur != nullptr) {                                                                   \
+            if (cur->left != nullptr) {                                                            \
+                _bt_rotate_right_##type(tree, cur);                                                \
+                cur = cur->parent;                                                                 \
+            } else {                                                                               \
+                cur = cur->right;                                                                  \
+            }                                                                                      \
+        }                                                                                          \
+                                                                                                   \
+        /* Number of nodes in the full levels of the balanced tree */                              \
+        size_t full = 1;                                                                           \
+        while (2 * full + 1 <= size)                                                               \
+            full = 2 * full + 1;                                                                   \
+                                                                                                   \
+        _bt_compress_spine_##type(tree, &pseudo_root, size - full);                                \
+        for (size_t times = full / 2; times > 0; times /= 2)                                       \
+            _bt_compress_spine_##type(tree, &pseudo_root, times);                                  \
+                                                                                                   \
+        tree->root = pseudo_root.right;                                                            \
+        tree->root->parent = nullptr;                                                              \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Adds value to the binary tree                                                        \
+     *                                                                                             \
+     * @return false if the tree already holds UINT32_MAX values or out of memory                  \
+     */                                                                                            \
+    bool bt_add_value_##type(B_TREE(type) * tree, const type value)                                \
+    {                                                                                              \
+        if (tree->root != nullptr && tree->root->count == UINT32_MAX)                              \
+            return false;                                                                          \
+        B_TREE_NODE(type) * new_node = _bt_alloc_node_##type(tree);                                \
+        if (new_node == nullptr) {                                                                 \
+            return false;                                                                          \
+        }                                                                                          \
+        *new_node = (B_TREE_NODE(type)) {                                                          \
+            .value = value,                                                                        \
+            .count = 1,                                                                            \
+            .parent = nullptr,                                                                     \
+            .left = nullptr,                                                                       \
+            .right = nullptr,                                                                      \
+        };                                                                                         \
+                                                                                                   \
+        if (tree->root == nullptr) {                                                               \
+            tree->root = new_node;                                                                 \
+            return true;                                                                           \
+        } else {                                                                                   \
+            B_TREE_NODE(type) * parent_node = _bt_find_next_node_##type(tree, value);              \
+            if (_bt_less_##type(tree, value, parent_node->value)) {                                \
+                parent_node->left = new_node;                                                      \
+            } else {                                                                               \
+                parent_node->right = new_node;                                                     \
+            }                                                                                      \
+            new_node->parent = parent_node;                                                        \
+            for (B_TREE_NODE(type) * cur = parent_node; cur != nullptr; cur = cur->parent)         \
+                cur->count++;                                                                      \
+            return true;                                                                           \
+        }                                                                                          \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Deletes the first appearance of of value.                                            \
+     *                                                                                             \
+     * @details A node with at most one child is replaced by that child. Otherwise its in-order    \
+     *          successor (the min node of the right subtree) is unlinked and takes its place. The \
+     *          subtree counts are decremented from the lowest node that lost a descendant up to   \
+     *          the root.                                                                          \
+     */                                                                                            \
+    bool bt_del_value_##type(B_TREE(type) * tree, const type value)                                \
+    {                                                                                              \
+        B_TREE_NODE(type) * todelete = _bt_find_matching_node_##type(tree, value);                 \
+        B_TREE_NODE(type) * shrunk;                                                                \
+                                                                                                   \
+        if (todelete == nullptr) {                                                                 \
+            return false;                                                                          \
+        } else if (todelete->left == nullptr) {                                                    \
+            shrunk = todelete->parent;                                                             \
+            _bt_transplant_##type(tree, todelete, todelete->right);                                \
+        } else if (todelete->right == nullptr) {                                                   \
+            shrunk = todelete->parent;                                                             \
+            _bt_transplant_##type(tree, todelete, todelete->left);                                 \
+        } else {                                                                                   \
+            B_TREE_NODE(type) * successor = _bt_find_min_node_##type(todelete->right);             \
+            shrunk = (successor->parent == todelete) ? successor : successor->parent;              \
+            if (successor->parent != todelete) {                                                   \
+                _bt_transplant_##type(tree, successor, successor->right);                          \
+                successor->right = todelete->right;                                                \
+                successor->right->parent = successor;                                              \
+            }                                                                                      \
+            _bt_transplant_##type(tree, todelete, successor);                                      \
+            successor->left = todelete->left;                                                      \
+            successor->left->parent = successor;                                                   \
+            successor->count = todelete->count;                                                    \
+        }                                                                                          \
+                                                                                                   \
+        for (; shrunk != nullptr; shrunk = shrunk->parent)                                         \
+            shrunk->count--;                                                                       \
+        _bt_free_node_##type(tree, todelete);                                                      \
+        return true;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Checks whether value is in the tree                                                  \
+     */                                                                                            \
+    bool bt_contains_##type(B_TREE(type) * tree, const type value)                                 \
+    {                                                                                              \
+        B_TREE_NODE(type) * node = _bt_find_matching_node_##type(tree, value);                     \
+        return node != nullptr;                                                                    \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Checks for count values whether they are in the tree, interleaving the lookups       \
+     *                                                                                             \
+     * @param out Receives count flags, out[i] tells whether values[i] is in the tree              \
+     */                                                                                            \
+    void bt_contains_batch_##type(                                                                 \
+        B_TREE(type) * tree,                                                                       \
+        const type* values,                                                                        \
+        const size_t count,                                                                        \
+        bool* out)                                                                                 \
+    {                                                                                              \
+        B_TREE_NODE(type) * bounds[B_TREE_BATCH_WIDTH];                                            \
+        for (size_t begin = 0; begin < count; begin += B_TREE_BATCH_WIDTH) {                       \
+            size_t width = count - begin;                                                          \
+            if (width > B_TREE_BATCH_WIDTH)                                                        \
+                width = B_TREE_BATCH_WIDTH;                                                        \
+            _bt_find_lower_bound_nodes_##type(tree, &values[begin], width, bounds);                \
+            for (size_t lane = 0; lane < width; lane++) {                                          \
+                out[begin + lane] = bounds[lane] != nullptr                                        \
+                    && !_bt_less_##type(tree, values[begin + lane], bounds[lane]->value);          \
+            }                                                                                      \
+        }                                                                                          \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Checks whether tree is empty                                                         \
+     */                                                                                            \
+    bool bt_is_empty_##type(B_TREE(type) * tree)                                                   \
+    {                                                                                              \
+        return tree->root == nullptr;                                                              \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Clears tree                                                                          \
+     */                                                                                            \
+    static void _bt_free_unpooled_node_##type(B_TREE_NODE(type) * node, void* ctx)                 \
+    {                                                                                              \
+        free(node);                                                                                \
+    }                                                                                              \
+    bool bt_clear_##type(B_TREE(type) * tree)                                                      \
+    {                                                                                              \
+        if (pool_is_active(&tree->pool)) {                                                         \
+            pool_clear(&tree->pool);                                                               \
+        } else {                                                                                   \
+            _bt_traverse_tree_##type(                                                              \
+                tree->root, nullptr, nullptr, _bt_free_unpooled_node_##type, nullptr);             \
+        }                                                                                          \
+        DS_STATS_FREE_ALL(&tree->stats, sizeof(B_TREE_NODE(type)));                                \
+        tree->root = nullptr;                                                                      \
+        return true;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Returns the number of values in the tree, which the root node keeps track of         \
+     */                                                                                            \
+    size_t bt_size_##type(B_TREE(type) * tree)                                                     \
+    {                                                                                              \
+        return (tree->root == nullptr) ? 0 : tree->root->count;                                    \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Walks the tree and counts its nodes per depth, the root being at depth 0             \
+     *                                                                                             \
+     * @details Like _bt_traverse_tree, the walk climbs back up along the parent links and needs   \
+     *          O(1) extra memory. Nodes deeper than length - 1 are counted in the last bucket.    \
+     *                                                                                             \
+     * @return Height of the tree, the number of nodes on its longest path down from the root      \
+     */                                                                                            \
+    static size_t _bt_walk_depths_##type(                                                          \
+        B_TREE(type) * tree, size_t* histogram, const size_t length)                               \
+    {                                                                                              \
+        B_TREE_NODE(type) *cur = tree->root, *prev = nullptr, *next;                               \
+        size_t depth = 0, height = 0;                                                              \
+                                                                                                   \
+        while (cur != nullptr) {                                                                   \
+            if (prev == cur->parent) { /* First visit, coming down from the parent */              \
+                if (depth + 1 > height)                                                            \
+                    height = depth + 1;                                                            \
+                if (length > 0)                                                                    \
+                    histogram[(depth < length) ? depth : length - 1]++;                            \
+                next = (cur->left != nullptr) ? cur->left : cur->right;                            \
+            } else if (prev == cur->left) {                                                        \
+                next = cur->right;                                                                 \
+            } else {                                                                               \
+                next = nullptr;                                                                    \
+            }                                                                                      \
+                                                                                                   \
+            prev = cur;                                                                            \
+            if (next != nullptr) {                                                                 \
+                cur = next;                                                                        \
+                depth++;                                                                           \
+            } else {                                                                               \
+                cur = cur->parent;                                                                 \
+                depth--;                                                                           \
+            }                                                                                      \
+        }                                                                                          \
+                                                                                                   \
+        return height;                                                                             \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Returns the height of the tree, 0 for the empty tree. Walks the whole tree           \
+     */                                                                                            \
+    size_t bt_height_##type(B_TREE(type) * tree)                                                   \
+    {                                                                                              \
+        return _bt_walk_depths_##type(tree, nullptr, 0);                                           \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Counts the nodes of the tree per depth                                               \
+     *                                                                                             \
+     * @param histogram Receives length counts, histogram[d] is the number of nodes at depth d     \
+     *                  below the root. The last one also counts all deeper nodes                  \
+     *                                                                                             \
+     * @return Height of the tree                                                                  \
+     */                                                                                            \
+    size_t bt_depth_histogram_##type(B_TREE(type) * tree, size_t* histogram, const size_t length)  \
+    {                                                                                              \
+        for (size_t d = 0; d < length; d++)                                                        \
+            histogram[d] = 0;                                                                      \
+        return _bt_walk_depths_##type(tree, histogram, length);                                    \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Returns the operation counters of the tree, all zero unless DS_STATS is defined      \
+     */                                                                                            \
+    ds_stats_t bt_stats_##type(B_TREE(type) * tree)                                                \
+    {                                                                                              \
+        return DS_STATS_GET(&tree->stats);                                                         \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Zeroes the operation counters of the tree, e.g. before the phase to be measured      \
+     */                                                                                            \
+    void bt_stats_reset_##type(B_TREE(type) * tree)                                                \
+    {                                                                                              \
+        DS_STATS_RESET(&tree->stats);                                                              \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Writes the shape and the counters of the tree as one line of JSON                    \
+     *                                                                                             \
+     * @details avg_depth is the mean number of nodes on the path from the root to a node, i.e.    \
+     *          the number of nodes a successful lookup visits on average.                         \
+     *                                                                                             \
+     * @return false if writing failed or out of memory                                            \
+     */                                                                                            \
+    bool bt_stats_write_json_##type(B_TREE(type) * tree, FILE* file)                               \
+    {                                                                                              \
+        size_t height = bt_height_##type(tree);                                                    \
+        size_t* histogram = calloc(height + 1, sizeof(size_t));                                    \
+        if (histogram == nullptr) {                                                                \
+            return false;                                                                          \
+        }                                                                                          \
+        _bt_walk_depths_##type(tree, histogram, height);                                           \
+                                                                                                   \
+        size_t size = bt_size_##type(tree), path_nodes = 0;                                        \
+        bool ok = fprintf(                                                                         \
+                      file,                                                                        \
+                      "{\"size\": %zu, \"height\": %zu, \"node_bytes\": %zu, \"depths\": [",       \
+                      size,                                                                        \
+                      height,                                                                      \
+                      sizeof(B_TREE_NODE(type)))                                                   \
+            >= 0;                                                                                  \
+        for (size_t d = 0; d < height; d++) {                                                      \
+            path_nodes += (d + 1) * histogram[d];                                                  \
+            ok &= fprintf(file, "%s%zu", (d == 0) ? "" : ", ", histogram[d]) >= 0;                 \
+        }                                                                                          \
+        double avg_depth = (size == 0) ? 0.0 : (double)path_nodes / size;                          \
+        ok &= fprintf(file, "], \"avg_depth\": %.3f, \"stats\": ", avg_depth) >= 0;                \
+        ds_stats_t stats = bt_stats_##type(tree);                                                  \
+        ok &= ds_stats_write_json(&stats, file);                                                   \
+        const char* enabled = DS_STATS_ENABLED ? "true" : "false";                                 \
+        ok &= fprintf(file, ", \"stats_enabled\": %s}\n", enabled) >= 0;                           \
+        free(histogram);                                                                           \
+        return ok;                                                                                 \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Returns the number of values that are smaller than value                             \
+     */                                                                                            \
+    size_t bt_rank_##type(B_TREE(type) * tree, const type value)                                   \
+    {                                                                                              \
+        B_TREE_NODE(type) * cur = tree->root;                                                      \
+        size_t rank = 0;                                                                           \
+                                                                                                   \
+        DS_STATS_ADD(&tree->stats, searches, 1);                                                   \
+        while (cur != nullptr) {                                                                   \
+            DS_STATS_ADD(&tree->stats, node_visits, 1);                                            \
+            if (_bt_less_##type(tree, cur->value, value)) {                                        \
+                rank += _bt_subtree_count_##type(cur->left) + 1;                                   \
+                cur = cur->right;                                                                  \
+            } else {                                                                               \
+                cur = cur->left;                                                                   \
+            }                                                                                      \
+        }                                                                                          \
+                                                                                                   \
+        return rank;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Returns the k-th smallest value, counting from 0                                     \
+     */                                                                                            \
+    RESULT(type) bt_select_##type(B_TREE(type) * tree, const size_t k)                             \
+    {                                                                                              \
+        B_TREE_NODE(type) * cur = tree->root;                                                      \
+        size_t idx = k;                                                                            \
+                                                                                                   \
+        while (cur != nullptr) {                                                                   \
+            size_t left_count = _bt_subtree_count_##type(cur->left);                               \
+            if (idx < left_count) {                                                                \
+                cur = cur->left;                                                                   \
+            } else if (idx == left_count) {                                                        \
+                return RESULT_OK(type)(cur->value);                                                \
+            } else {                                                                               \
+                idx -= left_count + 1;                                                             \
+                cur = cur->right;                                                                  \
+            }                                                                                      \
+        }                                                                                          \
+                                                                                                   \
+        return RESULT_ERR(type)("Out of range");                                                   \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Returns the smallest value                                                           \
+     */                                                                                            \
+    RESULT(type) bt_min_##type(B_TREE(type) * tree)                                                \
+    {                                                                                              \
+        return _bt_node_result_##type(_bt_find_min_node_##type(tree->root));                       \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Returns the biggest value                                                            \
+     */                                                                                            \
+    RESULT(type) bt_max_##type(B_TREE(type) * tree)                                                \
+    {                                                                                              \
+        return _bt_node_result_##type(_bt_find_max_node_##type(tree->root));                       \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Returns the smallest value that is not smaller than value                            \
+     */                                                                                            \
+    RESULT(type) bt_lower_bound_##type(B_TREE(type) * tree, const type value)                      \
+    {                                                                                              \
+        return _bt_node_result_##type(_bt_find_lower_bound_node_##type(tree, value));              \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Looks up the lower bounds of count values, interleaving the lookups                  \
+     *                                                                                             \
+     * @param out Receives count results, out[i] is the lower bound of values[i]                   \
+     */                                                                                            \
+    void bt_lower_bound_batch_##type(                                                              \
+        B_TREE(type) * tree,                                                                       \
+        const type* values,                                                                        \
+        const size_t count,                                                                        \
+        RESULT(type) * out)                                                                        \
+    {                                                                                              \
+        B_TREE_NODE(type) * bounds[B_TREE_BATCH_WIDTH];                                            \
+        for (size_t begin = 0; begin < count; begin += B_TREE_BATCH_WIDTH) {                       \
+            size_t width = count - begin;                                                          \
+            if (width > B_TREE_BATCH_WIDTH)                                                        \
+                width = B_TREE_BATCH_WIDTH;                                                        \
+            _bt_find_lower_bound_nodes_##type(tree, &values[begin], width, bounds);                \
+            for (size_t lane = 0; lane < width; lane++)                                            \
+                out[begin + lane] = _bt_node_result_##type(bounds[lane]);                          \
+        }                                                                                          \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Returns the smallest value that is bigger than value, i.e. its successor             \
+     */                                                                                            \
+    RESULT(type) bt_upper_bound_##type(B_TREE(type) * tree, const type value)                      \
+    {                                                                                              \
+        return _bt_node_result_##type(_bt_find_upper_bound_node_##type(tree, value));              \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Returns the biggest value that is not bigger than value                              \
+     */                                                                                            \
+    RESULT(type) bt_floor_##type(B_TREE(type) * tree, const type value)                            \
+    {                                                                                              \
+        return _bt_node_result_##type(_bt_find_floor_node_##type(tree, value));                    \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Returns the smallest value that is not smaller than value. Same as bt_lower_bound    \
+     */                                                                                            \
+    RESULT(type) bt_ceiling_##type(B_TREE(type) * tree, const type value)                          \
+    {                                                                                              \
+        return bt_lower_bound_##type(tree, value);                                                 \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Returns the biggest value that is smaller than value                                 \
+     */                                                                                            \
+    RESULT(type) bt_predecessor_##type(B_TREE(type) * tree, const type value)                      \
+    {                                                                                              \
+        return _bt_node_result_##type(_bt_find_predecessor_node_##type(tree, value));              \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Calls consume for every value in [lo, hi] in ascending order                         \
+     *                                                                                             \
+     * @details Descends once to the lower bound of lo and then steps through the successors until \
+     *          a value exceeds hi, so subtrees outside the interval are never visited. This is    \
+     *          O(height + k) for k values in the interval.                                        \
+     *                                                                                             \
+     * @return Number of consumed values                                                           \
+     */                                                                                            \
+    size_t bt_range_##type(                                                                        \
+        B_TREE(type) * tree,                                                                       \
+        const type lo,                                                                             \
+        const type hi,                                                                             \
+        void (*consume)(type value, void* ctx),                                                    \
+        void* ctx)                                                                                 \
+    {                                                                                              \
+        size_t count = 0;                                                                          \
+                                                                                                   \
+        for (B_TREE_NODE(type) * cur = _bt_find_lower_bound_node_##type(tree, lo);                 \
+             cur != nullptr && !_bt_less_##type(tree, hi, cur->value);                             \
+             cur = _bt_next_node_##type(cur)) {                                                    \
+            consume(cur->value, ctx);                                                              \
+            count++;                                                                               \
+        }                                                                                          \
+                                                                                                   \
+        return count;                                                                              \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Prints binary tree                                                                   \
+     *                                                                                             \
+     * @details Every node is drawn on its own line below its parent, missing children are drawn   \
+     *          as nil. The indentation of a line is derived from the path to the root.            \
+     */                                                                                            \
+    static void _bt_print_node_##type(B_TREE_NODE(type) * node, void* ctx)                         \
+    {                                                                                              \
+        print_value(node->value);                                                                  \
+        printf(" ");                                                                               \
+    }                                                                                              \
+    static bool _bt_is_left_child_##type(B_TREE_NODE(type) * node)                                 \
+    {                                                                                              \
+        return node->parent == nullptr || node->parent->left == node;                              \
+    }                                                                                              \
+    static void _bt_print_tree_line_##type(                                                        \
+        B_TREE_NODE(type) * node, const int depth, const int ldepth, bool left_child)              \
+    {                                                                                              \
+        for (int i = 0; i < depth - 1; i++) {                                                      \
+            printf("%s   ", (i < (depth - ldepth)) ? " " : "│");                                   \
+        }                                                                                          \
+        if (depth > 0) {                                                                           \
+            printf("%s─%s ", left_child ? "├" : "└", left_child ? "L" : "R");                      \
+        }                                                                                          \
+        if (node == nullptr) {                                                                     \
+            printf("nil\n");                                                                       \
+        } else {                                                                                   \
+            print_value(node->value);                                                              \
+            printf("\n");                                                                          \
+        }                                                                                          \
+    }                                                                                              \
+    /**                                                                                            \
+     * @brief Prints the line of node or of one of its missing children                            \
+     *                                                                                             \
+     * @param child 0 for node itself, 1 for its missing left and 2 for its missing right child    \
+     */                                                                                            \
+    static void _bt_print_tree_lines_##type(B_TREE_NODE(type) * node, int child)                   \
+    {                                                                                              \
+        int depth = 0, ldepth = 0;                                                                 \
+        for (B_TREE_NODE(type) * cur = node->parent; cur != nullptr; cur = cur->parent) {          \
+            depth++;                                                                               \
+            ldepth += _bt_is_left_child_##type(cur);                                               \
+        }                                                                                          \
+        if (child == 0) {                                                                          \
+            _bt_print_tree_line_##type(node, depth, ldepth, _bt_is_left_child_##type(node));       \
+        } else {                                                                                   \
+            _bt_print_tree_line_##type(                                                            \
+                nullptr, depth + 1, ldepth + _bt_is_left_child_##type(node), child == 1);          \
+        }                                                                                          \
+    }                                                                                              \
+    static void _bt_print_tree_pre_##type(B_TREE_NODE(type) * node, void* ctx)                     \
+    {                                                                                              \
+        _bt_print_tree_lines_##type(node, 0);                                                      \
+        if (node->left == nullptr)                                                                 \
+            _bt_print_tree_lines_##type(node, 1);                                                  \
+    }                                                                                              \
+    static void _bt_print_tree_in_##type(B_TREE_NODE(type) * node, void* ctx)                      \
+    {                                                                                              \
+        if (node->right == nullptr)                                                                \
+            _bt_print_tree_lines_##type(node, 2);                                                  \
+    }                                                                                              \
+    void bt_print_##type(B_TREE(type) * tree)                                                      \
+    {                                                                                              \
+        printf("------------------------------\n");                                                \
+        printf("As list:\n");                                                                      \
+        printf("[");                                                                               \
+        _bt_traverse_tree_##type(tree->root, nullptr, _bt_print_node_##type, nullptr, nullptr);    \
+        printf("]\n");                                                                             \
+        printf("As tree:\n");                                                                      \
+        if (tree->root == nullptr) {                                                               \
+            _bt_print_tree_line_##type(nullptr, 0, 0, true);                                       \
+        } else {                                                                                   \
+            _bt_traverse_tree_##type(                                                              \
+                tree->root,                                                                        \
+                _bt_print_tree_pre_##type,                                                         \
+                _bt_print_tree_in_##type,                                                          \
+                nullptr,                                                                           \
+                nullptr);                                                                          \
+        }                                                                                          \
+        printf("------------------------------\n");                                                \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Iterator at the min value, or past the end if the tree is empty                      \
+     */                                                                                            \
+    B_TREE_ITER(type) bt_iter_begin_##type(B_TREE(type) * tree)                                    \
+    {                                                                                              \
+        return (B_TREE_ITER(type)) { .tree = tree, .node = _bt_find_min_node_##type(tree->root) }; \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Iterator at the max value, or past the end if the tree is empty                      \
+     */                                                                                            \
+    B_TREE_ITER(type) bt_iter_last_##type(B_TREE(type) * tree)                                     \
+    {                                                                                              \
+        return (B_TREE_ITER(type)) { .tree = tree, .node = _bt_find_max_node_##type(tree->root) }; \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Iterator at the first value that is not smaller than value, or past the end          \
+     */                                                                                            \
+    B_TREE_ITER(type) bt_iter_lower_bound_##type(B_TREE(type) * tree, const type value)            \
+    {                                                                                              \
+        return (B_TREE_ITER(type)) {                                                               \
+            .tree = tree,                                                                          \
+            .node = _bt_find_lower_bound_node_##type(tree, value),                                 \
+        };                                                                                         \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Checks whether the iterator points to a value                                        \
+     */                                                                                            \
+    bool bt_iter_valid_##type(B_TREE_ITER(type) * iter)                                            \
+    {                                                                                              \
+        return iter->node != nullptr;                                                              \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Steps to the next bigger value. Returns false once the iterator moved past the end   \
+     */                                                                                            \
+    bool bt_iter_next_##type(B_TREE_ITER(type) * iter)                                             \
+    {                                                                                              \
+        if (iter->node == nullptr)                                                                 \
+            return false;                                                                          \
+        iter->node = _bt_next_node_##type(iter->node);                                             \
+        return iter->node != nullptr;                                                              \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Steps to the next smaller value. Past the end it steps back to the max value         \
+     *                                                                                             \
+     * @return false if there is no smaller value. The iterator is then past the end               \
+     */                                                                                            \
+    bool bt_iter_prev_##type(B_TREE_ITER(type) * iter)                                             \
+    {                                                                                              \
+        if (iter->node == nullptr) {                                                               \
+            iter->node = _bt_find_max_node_##type(iter->tree->root);                               \
+        } else {                                                                                   \
+            iter->node = _bt_prev_node_##type(iter->node);                                         \
+        }                                                                                          \
+        return iter->node != nullptr;                                                              \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Exports the values of the tree into a new read-only index in Eytzinger layout        \
+     *                                                                                             \
+     * @details The tree is walked in order once and every value is written straight to its slot.  \
+     *          The index owns a copy of the values, so the tree may change or be cleared after.   \
+     *                                                                                             \
+     * @return An empty index if the tree is empty or out of memory                                \
+     */                                                                                            \
+    B_TREE_FROZEN(type) bt_freeze_##type(B_TREE(type) * tree)                                      \
+    {                                                                                              \
+        B_TREE_FROZEN(type) frozen = { .keys = nullptr, .length = 0 };                             \
+        size_t length = bt_size_##type(tree);                                                      \
+        if (length == 0)                                                                           \
+            return frozen;                                                                         \
+        /* keys[0] is unused, which keeps the descendants of every node cache line aligned */      \
+        size_t bytes = (length + 1) * sizeof(type);                                                \
+        bytes = (bytes + B_TREE_CACHE_LINE - 1) / B_TREE_CACHE_LINE * B_TREE_CACHE_LINE;           \
+        frozen.keys = aligned_alloc(B_TREE_CACHE_LINE, bytes);                                     \
+        if (frozen.keys == nullptr)                                                                \
+            return frozen;                                                                         \
+        frozen.length = length;                                                                    \
+                                                                                                   \
+        size_t k = 1;                                                                              \
+        while (2 * k <= length)                                                                    \
+            k = 2 * k;                                                                             \
+        for (B_TREE_NODE(type) * node = _bt_find_min_node_##type(tree->root); node != nullptr;     \
+             node = _bt_next_node_##type(node)) {                                                  \
+            frozen.keys[k] = node->value;                                                          \
+            k = _bt_eytzinger_next_##type(k, length);                                              \
+        }                                                                                          \
+        return frozen;                                                                             \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Checks whether value is in the frozen index                                          \
+     */                                                                                            \
+    bool bt_frozen_contains_##type(B_TREE_FROZEN(type) * frozen, const type value)                 \
+    {                                                                                              \
+        size_t k = _bt_frozen_lower_bound_idx_##type(frozen, value);                               \
+        return k != 0 && !less(value, frozen->keys[k]);                                            \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Returns the smallest value in the frozen index that is not smaller than value        \
+     */                                                                                            \
+    RESULT(type) bt_frozen_lower_bound_##type(B_TREE_FROZEN(type) * frozen, const type value)      \
+    {                                                                                              \
+        size_t k = _bt_frozen_lower_bound_idx_##type(frozen, value);                               \
+        if (k == 0) {                                                                              \
+            return RESULT_ERR(type)("No such value");                                              \
+        }                                                                                          \
+        return RESULT_OK(type)(frozen->keys[k]);                                                   \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Returns the number of values in the frozen index                                     \
+     */                                                                                            \
+    size_t bt_frozen_size_##type(B_TREE_FROZEN(type) * frozen)                                     \
+    {                                                                                              \
+        return frozen->length;                                                                     \
+    }                                                                                              \
+                                                                                                   \
+    /**                                                                                            \
+     * @brief Releases the frozen index                                                            \
+     */                                                                                            \
+    void bt_frozen_clear_##type(B_TREE_FROZEN(type) * frozen)                                      \
+    {                                                                                              \
+        free(frozen->keys);                                                                        \
+        frozen->keys = nullptr;                                                                    \
+        frozen->length = 0;                                                                        \
+    }
 
 B_TREE_DECLARE(uint32_t);
+
+/**
+ * @brief AVL Tree (height-balanced binary search tree)
+ *
+ * @details Every node stores the height of its subtree and the tree is rebalanced with rotations
+ *          after each insertion and deletion, so lookups are O(log n) regardless of key order.
+ */
+#define AVL_TREE(type) avl_##type
+
+#define AVL_TREE_NODE(type) avl_node_##type
+
+#define AVL_TREE_DECLARE(type)                                                                     \
+    typedef struct AVL_TREE_NODE(type) {                                                           \
+        type value;                                                                                \
+        int height;                                                                                \
+        struct AVL_TREE_NODE(type) * left;                                                         \
+        struct AVL_TREE_NODE(type) * right;                                                        \
+    } AVL_TREE_NODE(type);                                                                         \
+    typedef struct AVL_TREE(type) {                                                                \
+        AVL_TREE_NODE(type) * root;                                                                \
+        size_t size;                                                                               \
+    } AVL_TREE(type);                                                                              \
+    AVL_TREE(type) avl_new_##type();                                                               \
+    bool avl_add_value_##type(AVL_TREE(type) * tree, const type value);                            \
+    bool avl_del_value_##type(AVL_TREE(type) * tree, const type value);                            \
+    bool avl_contains_##type(AVL_TREE(type) * tree, const type value);                             \
+    bool avl_is_empty_##type(AVL_TREE(type) * tree);                                               \
+    bool avl_clear_##type(AVL_TREE(type) * tree);                                                  \
+    size_t avl_size_##type(AVL_TREE(type) * tree);                                                 \
+    void avl_print_##type(AVL_TREE(type) * tree);
+
+AVL_TREE_DECLARE(uint32_t);
+
+/**
+ * @brief Index B-Tree (binary tree of array indices)
+ *
+ * @details A binary tree with the same ordering as B_TREE, whose nodes are kept in one growable
+ *          array and link their children by uint32_t indices into it. Without a parent link and a
+ *          subtree count, a node of 4-byte values takes 12 bytes instead of the 32 of a B_TREE
+ *          node, so five nodes share a cache line. Growing the array moves the nodes but keeps
+ *          their indices. Slot IB_TREE_NIL is never used, so a tree holds at most UINT32_MAX
+ *          values. Deleted slots are recycled before the array grows.
+ */
+#define IB_TREE(type) ibt_##type
+
+#define IB_TREE_NODE(type) ibt_node_##type
+
+/**
+ * @brief Index of the missing child
+ */
+#define IB_TREE_NIL 0
+
+/**
+ * @brief Number of slots of the first allocation of a tree
+ */
+#define IB_TREE_MIN_CAPACITY 64
+
+#define IB_TREE_DECLARE(type)                                                                      \
+    typedef struct IB_TREE_NODE(type) {                                                            \
+        type value;                                                                                \
+        uint32_t left;                                                                             \
+        uint32_t right;                                                                            \
+    } IB_TREE_NODE(type);                                                                          \
+    typedef struct IB_TREE(type) {                                                                 \
+        IB_TREE_NODE(type) * nodes;                                                                \
+        /**                                                                                        \
+         * @brief Number of slots handed out so far, including slot IB_TREE_NIL and freed slots    \
+         */                                                                                        \
+        size_t length;                                                                             \
+        size_t capacity;                                                                           \
+        size_t size;                                                                               \
+        uint32_t root;                                                                             \
+        /**                                                                                        \
+         * @brief First freed slot, the freed slots are chained through their left index           \
+         */                                                                                        \
+        uint32_t free;                                                                             \
+    } IB_TREE(type);                                                                               \
+    IB_TREE(type) ibt_new_##type();                                                                \
+    IB_TREE(type) ibt_build_from_sorted_##type(const type* values, const size_t length);           \
+    bool ibt_reserve_##type(IB_TREE(type) * tree, const size_t capacity);                          \
+    bool ibt_add_value_##type(IB_TREE(type) * tree, const type value);                             \
+    bool ibt_del_value_##type(IB_TREE(type) * tree, const type value);                             \
+    bool ibt_contains_##type(IB_TREE(type) * tree, const type value);                              \
+    RESULT(type) ibt_min_##type(IB_TREE(type) * tree);                                             \
+    RESULT(type) ibt_max_##type(IB_TREE(type) * tree);                                             \
+    RESULT(type) ibt_lower_bound_##type(IB_TREE(type) * tree, const type value);                   \
+    size_t ibt_traverse_##type(                                                                    \
+        IB_TREE(type) * tree,                                                                      \
+        void (*consume)(type value, void* ctx),                                                    \
+        void* ctx);                                                                                \
+    bool ibt_is_empty_##type(IB_TREE(type) * tree);                                                \
+    bool ibt_clear_##type(IB_TREE(type) * tree);                                                   \
+    size_t ibt_size_##type(IB_TREE(type) * tree);                                                  \
+    size_t ibt_memory_##type(IB_TREE(type) * tree);                                                \
+    void ibt_print_##type(IB_TREE(type) * tree);
+
+IB_TREE_DECLARE(uint32_t);
@@ -0,0 +1,148 @@
+#include <stdlib.h>
+
+#include "ebr.h"
+#include "panic.h"
+
+/**
+ * @brief Bit of the thread state marking it as inside of a critical section
+ */
+#define EBR_ACTIVE 1ull
+
+//--------------------------------------------------
+// Helper functions
+
+/**
+ * @brief Destroys all objects in the bag and empties it, keeping its buffer
+ */
+static void _destroy_bag(ebr_bag_t* bag)
+{
+    for (size_t i = 0; i < bag->size; i++)
+        bag->items[i].destroy(bag->items[i].ptr);
+    bag->size = 0;
+}
+
+/**
+ * @brief Advances the global epoch if every active thread has seen the current one
+ */
+static void _try_advance(ebr_domain_t* domain)
+{
+    uint64_t epoch = atomic_load(&domain->epoch);
+    for (ebr_thread_t* cur = atomic_load(&domain->threads); cur != nullptr; cur = cur->next) {
+        uint64_t state = atomic_load(&cur->state);
+        if ((state & EBR_ACTIVE) && (state >> 1) != epoch)
+            return;
+    }
+    // Fails if another thread advanced it in the meantime, which is just as good
+    atomic_compare_exchange_strong(&domain->epoch, &epoch, epoch + 1);
+}
+
+//--------------------------------------------------
+
+ebr_domain_t ebr_new()
+{
+    ebr_domain_t domain;
+    atomic_init(&domain.epoch, 0);
+    atomic_init(&domain.threads, nullptr);
+    return domain;
+}
+
+ebr_thread_t* ebr_register(ebr_domain_t* domain)
+{
+    for (ebr_thread_t* cur = atomic_load(&domain->threads); cur != nullptr; cur = cur->next) {
+        bool expected = false;
+        if (!atomic_load(&cur->in_use)
+            && atomic_compare_exchange_strong(&cur->in_use, &expected, true))
+            return cur;
+    }
+
+    ebr_thread_t* thread = calloc(1, sizeof(ebr_thread_t));
+    if (thread == nullptr)
+        return nullptr;
+    atomic_init(&thread->state, 0);
+    atomic_init(&thread->in_use, true);
+    thread->domain = domain;
+
+    // Handles are only ever prepended and never unlinked, so traversals need no protection
+    ebr_thread_t* head = atomic_load(&domain->threads);
+    do {
+        thread->next = head;
+    } while (!atomic_compare_exchange_weak(&domain->threads, &head, thread));
+    return thread;
+}
+
+void ebr_unregister(ebr_thread_t* thread)
+{
+    atomic_store(&thread->state, 0);
+    atomic_store(&thread->in_use, false);
+}
+
+void ebr_enter(ebr_thread_t* thread)
+{
+    uint64_t epoch = atomic_load(&thread->domain->epoch);
+    while (true) {
+        // The exchange is a full barrier, so no read of the structure moves before the announcement
+        atomic_exchange(&thread->state, (epoch << 1) | EBR_ACTIVE);
+        // The epoch may have advanced twice while we were inactive, announcing a stale one would
+        // let us read nodes that are already being destroyed
+        uint64_t current = atomic_load(&thread->domain->epoch);
+        if (current == epoch)
+            break;
+        epoch = current;
+    }
+
+    for (int i = 0; i < 3; i++) {
+        ebr_bag_t* bag = &thread->bags[i];
+        if (bag->size > 0 && bag->epoch + 2 <= epoch)
+            _destroy_bag(bag);
+    }
+}
+
+void ebr_exit(ebr_thread_t* thread)
+{
+    atomic_store_explicit(&thread->state, 0, memory_order_release);
+}
+
+void ebr_retire(ebr_thread_t* thread, void* ptr, void (*destroy)(void* ptr))
+{
+    // The global epoch may be one ahead of ours. Threads that entered in it might have read the
+    // object before it was unlinked, so it is only safe two epochs after the global one
+    uint64_t epoch = atomic_load(&thread->domain->epoch);
+    ebr_bag_t* bag = &thread->bags[epoch % 3];
+    if (bag->epoch != epoch) {
+        // The bag is at least three epochs old, so nobody can read its objects anymore
+        _destroy_bag(bag);
+        bag->epoch = epoch;
+    }
+
+    if (bag->size == bag->capacity) {
+        size_t capacity = (bag->capacity == 0) ? EBR_ADVANCE_INTERVAL : 2 * bag->capacity;
+        ebr_retired_t* items = realloc(bag->items, capacity * sizeof(ebr_retired_t));
+        if (items == nullptr)
+            panic("Out of memory while retiring an object");
+        bag->items = items;
+        bag->capacity = capacity;
+    }
+    bag->items[bag->size++] = (ebr_retired_t) { .ptr = ptr, .destroy = destroy };
+
+    if (++thread->retired_since_advance >= EBR_ADVANCE_INTERVAL) {
+        thread->retired_since_advance = 0;
+        _try_advance(thread->domain);
+    }
+}
+
+void ebr_clear(ebr_domain_t* domain)
+{
+    ebr_thread_t* cur = atomic_load(&domain->threads);
+    ebr_thread_t* next;
+    while (cur != nullptr) {
+        next = cur->next;
+        for (int i = 0; i < 3; i++) {
+            _destroy_bag(&cur->bags[i]);
+            free(cur->bags[i].items);
+        }
+        free(cur);
+        cur = next;
+    }
+    atomic_store(&domain->threads, nullptr);
+    atomic_store(&domain->epoch, 0);
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file ebr.h
+ *
+ * Epoch-based reclamation for lock-free structures.
+ *
+ * Threads access shared nodes only between ebr_enter and ebr_exit. A node unlinked from a structure
+ * may still be read by threads that entered before it was unlinked, so instead of freeing it the
+ * unlinking thread retires it. The domain keeps a global epoch that only advances once every thread
+ * inside a critical section has seen the current epoch. A node retired in epoch e is therefore
+ * unreachable for everyone once the global epoch reaches e + 2, and is destroyed then.
+ *
+ * Every thread registers once with a domain and passes the returned handle to all operations.
+ * Handles are not thread safe themselves and critical sections must not be nested.
+ */
+
+/**
+ * @brief Number of retired objects after which a thread tries to advance the global epoch
+ */
+#define EBR_ADVANCE_INTERVAL 64
+
+typedef struct ebr_retired {
+    void* ptr;
+    void (*destroy)(void* ptr);
+} ebr_retired_t;
+
+/**
+ * @brief Objects retired by one thread in one epoch
+ */
+typedef struct ebr_bag {
+    uint64_t epoch;
+    ebr_retired_t* items;
+    size_t size;
+    size_t capacity;
+} ebr_bag_t;
+
+typedef struct ebr_thread {
+    /**
+     * @brief Epoch the thread entered with shifted left by one, the lowest bit marks it as active
+     */
+    _Atomic(uint64_t) state;
+    atomic_bool in_use;
+    struct ebr_domain* domain;
+    struct ebr_thread* next;
+    ebr_bag_t bags[3];
+    size_t retired_since_advance;
+} ebr_thread_t;
+
+typedef struct ebr_domain {
+    _Atomic(uint64_t) epoch;
+    _Atomic(ebr_thread_t*) threads;
+} ebr_domain_t;
+
+/**
+ * @brief Creates a new domain without any registered threads
+ */
+ebr_domain_t ebr_new();
+
+/**
+ * @brief Registers the calling thread, reusing the handle of an unregistered thread if possible
+ *
+ * @return Handle of the thread, or nullptr if out of memory
+ */
+ebr_thread_t* ebr_register(ebr_domain_t* domain);
+
+/**
+ * @brief Gives up the handle. Objects it retired are destroyed by whoever registers with it next
+ */
+void ebr_unregister(ebr_thread_t* thread);
+
+/**
+ * @brief Starts a critical section and destroys objects the thread retired that became safe
+ */
+void ebr_enter(ebr_thread_t* thread);
+
+/**
+ * @brief Ends a critical section. Nodes read inside of it must not be used anymore afterwards
+ */
+void ebr_exit(ebr_thread_t* thread);
+
+/**
+ * @brief Hands an unlinked object over to be destroyed once no thread can read it anymore
+ * @details Must be called inside of a critical section. Panics if out of memory, since the object
+ *          could neither be freed nor kept track of.
+ *
+ * @param ptr The unlinked object
+ * @param destroy Called as destroy(ptr) to release the object
+ */
+void ebr_retire(ebr_thread_t* thread, void* ptr, void (*destroy)(void* ptr));
+
+/**
+ * @brief Destroys all retired objects and frees all handles
+ * @details No thread may use the domain anymore, so every retired object is safe to destroy.
+ */
+void ebr_clear(ebr_domain_t* domain);
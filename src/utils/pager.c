@@ -0,0 +1,292 @@
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "pager.h"
+
+#define PAGER_MAGIC "DSPAGER"
+#define PAGER_VERSION 1
+
+//--------------------------------------------------
+// Helper functions
+
+static pager_frame_t* _find_frame(pager_t* pager, const page_id_t id)
+{
+    pager_frame_t* frame = pager->buckets[id & pager->bucket_mask];
+    while (frame != nullptr && frame->id != id)
+        frame = frame->bucket_next;
+    return frame;
+}
+
+static void _bucket_insert(pager_t* pager, pager_frame_t* frame)
+{
+    pager_frame_t** bucket = &pager->buckets[frame->id & pager->bucket_mask];
+    frame->bucket_next = *bucket;
+    *bucket = frame;
+}
+
+static void _bucket_remove(pager_t* pager, pager_frame_t* frame)
+{
+    pager_frame_t** link = &pager->buckets[frame->id & pager->bucket_mask];
+    while (*link != frame)
+        link = &(*link)->bucket_next;
+    *link = frame->bucket_next;
+}
+
+static void _lru_remove(pager_t* pager, pager_frame_t* frame)
+{
+    if (frame->lru_prev != nullptr)
+        frame->lru_prev->lru_next = frame->lru_next;
+    else
+        pager->lru_head = frame->lru_next;
+    if (frame->lru_next != nullptr)
+        frame->lru_next->lru_prev = frame->lru_prev;
+    else
+        pager->lru_tail = frame->lru_prev;
+}
+
+static void _lru_push_back(pager_t* pager, pager_frame_t* frame)
+{
+    frame->lru_prev = pager->lru_tail;
+    frame->lru_next = nullptr;
+    if (pager->lru_tail != nullptr)
+        pager->lru_tail->lru_next = frame;
+    else
+        pager->lru_head = frame;
+    pager->lru_tail = frame;
+}
+
+static bool _write_page(pager_t* pager, const page_id_t id, const void* data)
+{
+    pager->writes++;
+    return pwrite(pager->fd, data, PAGER_PAGE_SIZE, (off_t)id * PAGER_PAGE_SIZE) == PAGER_PAGE_SIZE;
+}
+
+static bool _write_header(pager_t* pager)
+{
+    unsigned char page[PAGER_PAGE_SIZE] = { 0 };
+    memcpy(page, &pager->header, sizeof(pager_header_t));
+    return _write_page(pager, 0, page);
+}
+
+/**
+ * @brief Takes a frame that holds no page, evicting the least recently used page if needed
+ *
+ * @return nullptr if every frame is pinned or writing back the evicted page failed
+ */
+static pager_frame_t* _take_frame(pager_t* pager)
+{
+    pager_frame_t* frame = pager->free_frames;
+    if (frame != nullptr) {
+        pager->free_frames = frame->lru_next;
+        return frame;
+    }
+
+    frame = pager->lru_head;
+    if (frame == nullptr) {
+        return nullptr;
+    }
+    if (frame->dirty) {
+        if (!_write_page(pager, frame->id, frame->data))
+            return nullptr;
+        frame->dirty = false;
+    }
+    _lru_remove(pager, frame);
+    _bucket_remove(pager, frame);
+    return frame;
+}
+
+static void _give_back_frame(pager_t* pager, pager_frame_t* frame)
+{
+    frame->lru_next = pager->free_frames;
+    pager->free_frames = frame;
+}
+
+/**
+ * @brief Puts a page into a taken frame and pins it
+ */
+static void _install(pager_t* pager, pager_frame_t* frame, const page_id_t id, const bool dirty)
+{
+    frame->id = id;
+    frame->pins = 1;
+    frame->dirty = dirty;
+    _bucket_insert(pager, frame);
+}
+
+//--------------------------------------------------
+
+bool pager_open(pager_t* pager, const char* path, size_t memory_budget)
+{
+    *pager = (pager_t) { .fd = -1 };
+    pager->fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (pager->fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(pager->fd, &st) != 0) {
+        close(pager->fd);
+        return false;
+    }
+    if (st.st_size == 0) {
+        memcpy(pager->header.magic, PAGER_MAGIC, sizeof(pager->header.magic));
+        pager->header.version = PAGER_VERSION;
+        pager->header.page_size = PAGER_PAGE_SIZE;
+        pager->header.page_count = 1;
+        pager->header.free_head = 0;
+        pager->header_dirty = true;
+        pager->created = true;
+    } else {
+        bool valid = pread(pager->fd, &pager->header, sizeof(pager_header_t), 0)
+                == sizeof(pager_header_t)
+            && memcmp(pager->header.magic, PAGER_MAGIC, sizeof(pager->header.magic)) == 0
+            && pager->header.version == PAGER_VERSION
+            && pager->header.page_size == PAGER_PAGE_SIZE;
+        if (!valid) {
+            close(pager->fd);
+            return false;
+        }
+    }
+
+    pager->frame_count = memory_budget / PAGER_PAGE_SIZE;
+    if (pager->frame_count < PAGER_MIN_FRAMES)
+        pager->frame_count = PAGER_MIN_FRAMES;
+    size_t buckets = 1;
+    while (buckets < 2 * pager->frame_count)
+        buckets *= 2;
+    pager->bucket_mask = buckets - 1;
+    pager->frames = calloc(pager->frame_count, sizeof(pager_frame_t));
+    pager->buckets = calloc(buckets, sizeof(pager_frame_t*));
+    pager->frame_data = aligned_alloc(PAGER_PAGE_SIZE, pager->frame_count * PAGER_PAGE_SIZE);
+    if (pager->frames == nullptr || pager->buckets == nullptr || pager->frame_data == nullptr) {
+        free(pager->frames);
+        free(pager->buckets);
+        free(pager->frame_data);
+        close(pager->fd);
+        return false;
+    }
+    for (size_t i = pager->frame_count; i-- > 0;) {
+        pager->frames[i].data = &pager->frame_data[i * PAGER_PAGE_SIZE];
+        _give_back_frame(pager, &pager->frames[i]);
+    }
+    return true;
+}
+
+bool pager_is_new(const pager_t* pager)
+{
+    return pager->created;
+}
+
+void* pager_user_meta(pager_t* pager)
+{
+    return pager->header.user;
+}
+
+void pager_mark_meta_dirty(pager_t* pager)
+{
+    pager->header_dirty = true;
+}
+
+void* pager_get(pager_t* pager, page_id_t id)
+{
+    if (id == 0 || id >= pager->header.page_count) {
+        return nullptr;
+    }
+    pager_frame_t* frame = _find_frame(pager, id);
+    if (frame != nullptr) {
+        if (frame->pins++ == 0)
+            _lru_remove(pager, frame);
+        return frame->data;
+    }
+
+    frame = _take_frame(pager);
+    if (frame == nullptr) {
+        return nullptr;
+    }
+    pager->reads++;
+    ssize_t bytes = pread(pager->fd, frame->data, PAGER_PAGE_SIZE, (off_t)id * PAGER_PAGE_SIZE);
+    if (bytes < 0) {
+        _give_back_frame(pager, frame);
+        return nullptr;
+    }
+    // A page that was allocated but never written back before a crash reads as zeros
+    memset(frame->data + bytes, 0, PAGER_PAGE_SIZE - (size_t)bytes);
+    _install(pager, frame, id, false);
+    return frame->data;
+}
+
+void* pager_allocate(pager_t* pager, page_id_t* id)
+{
+    if (pager->header.free_head != 0) {
+        page_id_t reused = pager->header.free_head;
+        unsigned char* data = pager_get(pager, reused);
+        if (data == nullptr) {
+            return nullptr;
+        }
+        memcpy(&pager->header.free_head, data, sizeof(page_id_t));
+        memset(data, 0, PAGER_PAGE_SIZE);
+        _find_frame(pager, reused)->dirty = true;
+        pager->header_dirty = true;
+        *id = reused;
+        return data;
+    }
+
+    pager_frame_t* frame = _take_frame(pager);
+    if (frame == nullptr) {
+        return nullptr;
+    }
+    memset(frame->data, 0, PAGER_PAGE_SIZE);
+    *id = pager->header.page_count++;
+    pager->header_dirty = true;
+    // Dirty right away, so that the file grows once the page is evicted or flushed
+    _install(pager, frame, *id, true);
+    return frame->data;
+}
+
+void pager_release(pager_t* pager, page_id_t id, bool dirty)
+{
+    pager_frame_t* frame = _find_frame(pager, id);
+    frame->dirty |= dirty;
+    if (--frame->pins == 0)
+        _lru_push_back(pager, frame);
+}
+
+void pager_free(pager_t* pager, page_id_t id)
+{
+    pager_frame_t* frame = _find_frame(pager, id);
+    memcpy(frame->data, &pager->header.free_head, sizeof(page_id_t));
+    pager->header.free_head = id;
+    pager->header_dirty = true;
+    pager_release(pager, id, true);
+}
+
+bool pager_flush(pager_t* pager)
+{
+    bool ok = true;
+    for (size_t i = 0; i < pager->frame_count; i++) {
+        pager_frame_t* frame = &pager->frames[i];
+        if (frame->id != 0 && frame->dirty) {
+            bool written = _write_page(pager, frame->id, frame->data);
+            frame->dirty = !written;
+            ok &= written;
+        }
+    }
+    if (pager->header_dirty) {
+        pager->header_dirty = !_write_header(pager);
+        ok &= !pager->header_dirty;
+    }
+    return ok && fsync(pager->fd) == 0;
+}
+
+bool pager_close(pager_t* pager)
+{
+    bool ok = pager_flush(pager);
+    close(pager->fd);
+    free(pager->frames);
+    free(pager->buckets);
+    free(pager->frame_data);
+    *pager = (pager_t) { .fd = -1 };
+    return ok;
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file pager.h
+ *
+ * Fixed-size pages in a single file, cached by an LRU buffer pool.
+ *
+ * Pages are read with pread into one of a fixed number of frames and written back with pwrite
+ * when their frame is evicted or the pager is flushed. The number of frames follows from the
+ * memory budget given to pager_open, so the memory use stays bounded whatever the file size is.
+ *
+ * A page handed out by pager_get or pager_allocate is pinned: its frame isn't evicted until the
+ * page is released again. Unpinned frames are kept in least recently used order and the oldest
+ * one is reused first.
+ *
+ * Page 0 holds the header of the pager itself, including PAGER_USER_META bytes that the owner of
+ * the pager can use for its own metadata. Freed pages are chained into a freelist through their
+ * first bytes and handed out again before the file grows. Nothing is written in place of a
+ * journal, so a file is only consistent after pager_flush or pager_close.
+ */
+
+/**
+ * @brief Size of a page in bytes
+ */
+#define PAGER_PAGE_SIZE 4096
+
+/**
+ * @brief Min number of frames, whatever the budget is. Enough for the pages a B+ tree pins at once
+ */
+#define PAGER_MIN_FRAMES 16
+
+/**
+ * @brief Number of header bytes left to the owner of the pager
+ */
+#define PAGER_USER_META 64
+
+/**
+ * @brief Id of a page, its offset in the file in pages. 0 is the header and never handed out
+ */
+typedef uint32_t page_id_t;
+
+typedef struct pager_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t page_size;
+    uint32_t page_count;
+    page_id_t free_head;
+    unsigned char user[PAGER_USER_META];
+} pager_header_t;
+
+typedef struct pager_frame {
+    page_id_t id;
+    uint32_t pins;
+    bool dirty;
+    /**
+     * @brief Neighbours in the LRU list. Only unpinned frames are in the list
+     */
+    struct pager_frame* lru_prev;
+    struct pager_frame* lru_next;
+    /**
+     * @brief Next frame in the same bucket of the page table
+     */
+    struct pager_frame* bucket_next;
+    unsigned char* data;
+} pager_frame_t;
+
+typedef struct pager {
+    int fd;
+    pager_header_t header;
+    bool header_dirty;
+    bool created;
+    pager_frame_t* frames;
+    size_t frame_count;
+    /**
+     * @brief Frames that hold no page, chained through lru_next
+     */
+    pager_frame_t* free_frames;
+    pager_frame_t** buckets;
+    size_t bucket_mask;
+    /**
+     * @brief Least recently released frame, evicted first
+     */
+    pager_frame_t* lru_head;
+    pager_frame_t* lru_tail;
+    /**
+     * @brief Memory of all frames in one allocation
+     */
+    unsigned char* frame_data;
+    size_t reads;
+    size_t writes;
+} pager_t;
+
+/**
+ * @brief Opens the paged file at path, creating it if it doesn't exist
+ *
+ * @param memory_budget Bytes the frames may take, at least PAGER_MIN_FRAMES pages are used
+ *
+ * @return false if the file can't be opened, isn't a paged file or memory ran out
+ */
+bool pager_open(pager_t* pager, const char* path, size_t memory_budget);
+
+/**
+ * @brief Whether the file was just created, i.e. the user metadata is still zeroed
+ */
+bool pager_is_new(const pager_t* pager);
+
+/**
+ * @brief The PAGER_USER_META bytes of metadata of the owner, stored in the header page
+ *
+ * @details Call pager_mark_meta_dirty after changing them
+ */
+void* pager_user_meta(pager_t* pager);
+
+/**
+ * @brief Schedules the header page for the next flush
+ */
+void pager_mark_meta_dirty(pager_t* pager);
+
+/**
+ * @brief Pins the page and returns its data. Reads it from the file unless it's cached
+ *
+ * @return nullptr if the page doesn't exist, every frame is pinned or the read failed
+ */
+void* pager_get(pager_t* pager, page_id_t id);
+
+/**
+ * @brief Pins a zeroed page, reusing a freed page before the file grows
+ *
+ * @param id Receives the id of the page
+ *
+ * @return nullptr if every frame is pinned or an I/O error occurred
+ */
+void* pager_allocate(pager_t* pager, page_id_t* id);
+
+/**
+ * @brief Unpins a page returned by pager_get or pager_allocate
+ *
+ * @param dirty Whether the page was changed and has to be written back
+ */
+void pager_release(pager_t* pager, page_id_t id, bool dirty);
+
+/**
+ * @brief Adds a pinned page to the freelist and unpins it. Its data must not be used any more
+ */
+void pager_free(pager_t* pager, page_id_t id);
+
+/**
+ * @brief Writes back all dirty pages and the header and syncs the file
+ */
+bool pager_flush(pager_t* pager);
+
+/**
+ * @brief Flushes the pager, closes the file and releases the frames
+ *
+ * @return Whether the flush succeeded. The pager is closed either way
+ */
+bool pager_close(pager_t* pager);
@@ -1,3 +1,5 @@
+#pragma once
+
 /**
  * @file panic.h
  * Copied from https://codereview.stackexchange.com/questions/140231/rust-like-result-in-c-nicer-error-handling
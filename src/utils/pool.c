@@ -0,0 +1,81 @@
+#include <stdalign.h>
+#include <stdlib.h>
+
+#include "pool.h"
+
+/**
+ * @brief Offset of the first node inside a slab, keeping nodes maximally aligned
+ */
+#define SLAB_HEADER_SIZE                                                                           \
+    ((sizeof(pool_slab_t) + alignof(max_align_t) - 1) / alignof(max_align_t) * alignof(max_align_t))
+
+pool_t pool_new(size_t node_size, size_t slab_nodes)
+{
+    // Freed nodes store the freelist link in place, so they need to fit a pointer
+    if (node_size < sizeof(void*))
+        node_size = sizeof(void*);
+    node_size = (node_size + alignof(void*) - 1) / alignof(void*) * alignof(void*);
+
+    return (pool_t) {
+        .node_size = node_size,
+        .slab_nodes = (slab_nodes == 0) ? POOL_DEFAULT_SLAB_NODES : slab_nodes,
+        .slabs = nullptr,
+        .bump = nullptr,
+        .bump_end = nullptr,
+        .freelist = nullptr,
+    };
+}
+
+void pool_set_slab_nodes(pool_t* pool, size_t slab_nodes)
+{
+    pool->slab_nodes = (slab_nodes == 0) ? POOL_DEFAULT_SLAB_NODES : slab_nodes;
+}
+
+bool pool_is_active(const pool_t* pool)
+{
+    return pool->node_size != 0;
+}
+
+void* pool_alloc(pool_t* pool)
+{
+    if (pool->freelist != nullptr) {
+        void* node = pool->freelist;
+        pool->freelist = *(void**)node;
+        return node;
+    }
+
+    if (pool->bump == pool->bump_end) {
+        pool_slab_t* slab = malloc(SLAB_HEADER_SIZE + pool->node_size * pool->slab_nodes);
+        if (slab == nullptr)
+            return nullptr;
+        slab->next = pool->slabs;
+        pool->slabs = slab;
+        pool->bump = (char*)slab + SLAB_HEADER_SIZE;
+        pool->bump_end = pool->bump + pool->node_size * pool->slab_nodes;
+    }
+
+    void* node = pool->bump;
+    pool->bump += pool->node_size;
+    return node;
+}
+
+void pool_free(pool_t* pool, void* node)
+{
+    *(void**)node = pool->freelist;
+    pool->freelist = node;
+}
+
+void pool_clear(pool_t* pool)
+{
+    pool_slab_t* slab = pool->slabs;
+    pool_slab_t* next;
+    while (slab != nullptr) {
+        next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    pool->slabs = nullptr;
+    pool->bump = nullptr;
+    pool->bump_end = nullptr;
+    pool->freelist = nullptr;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @file pool.h
+ *
+ * Fixed-size node pool (slab allocator).
+ *
+ * Nodes are carved out of large slabs by bumping a pointer. Freed nodes are kept in an intrusive
+ * freelist and handed out again before the bump pointer advances. Clearing the pool releases all
+ * slabs at once, so a structure owning a pool can drop all of its nodes without visiting them.
+ *
+ * A zero-initialized pool (node_size == 0) is inactive; structures use this to fall back to
+ * malloc/free.
+ */
+
+/**
+ * @brief Number of nodes per slab if none is given
+ */
+#define POOL_DEFAULT_SLAB_NODES 1024
+
+typedef struct pool_slab {
+    struct pool_slab* next;
+} pool_slab_t;
+
+typedef struct pool {
+    size_t node_size;
+    size_t slab_nodes;
+    pool_slab_t* slabs;
+    char* bump;
+    char* bump_end;
+    void* freelist;
+} pool_t;
+
+/**
+ * @brief Creates a new pool handing out nodes of node_size bytes
+ *
+ * @param node_size Size of a single node. Rounded up so that every node is pointer aligned
+ * @param slab_nodes Number of nodes allocated at once. 0 selects POOL_DEFAULT_SLAB_NODES
+ */
+pool_t pool_new(size_t node_size, size_t slab_nodes);
+
+/**
+ * @brief Changes how many nodes the slabs allocated from now on hold. 0 selects
+ *        POOL_DEFAULT_SLAB_NODES. Nodes already handed out and the current slab stay as they are
+ */
+void pool_set_slab_nodes(pool_t* pool, size_t slab_nodes);
+
+/**
+ * @brief Returns whether the pool was created by pool_new
+ */
+bool pool_is_active(const pool_t* pool);
+
+/**
+ * @brief Allocates a node, reusing freed nodes first. Returns nullptr if out of memory
+ */
+void* pool_alloc(pool_t* pool);
+
+/**
+ * @brief Returns a node to the freelist of the pool it was allocated from
+ */
+void pool_free(pool_t* pool, void* node);
+
+/**
+ * @brief Releases all slabs. Every node handed out by the pool becomes invalid
+ */
+void pool_clear(pool_t* pool);
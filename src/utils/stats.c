@@ -0,0 +1,19 @@
+#include <inttypes.h>
+
+#include "stats.h"
+
+bool ds_stats_write_json(const ds_stats_t* stats, FILE* file)
+{
+    int written = fprintf(
+        file,
+        "{\"searches\": %" PRIu64 ", \"node_visits\": %" PRIu64 ", \"comparisons\": %" PRIu64
+        ", \"allocs\": %" PRIu64 ", \"frees\": %" PRIu64 ", \"bytes\": %zu, \"peak_bytes\": %zu}",
+        stats->searches,
+        stats->node_visits,
+        stats->comparisons,
+        stats->allocs,
+        stats->frees,
+        stats->bytes,
+        stats->peak_bytes);
+    return written >= 0;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @file stats.h
+ *
+ * Opt-in operation counters and memory accounting of lists and trees.
+ *
+ * Building with DS_STATS defined (the DS_STATS option of CMake) embeds a ds_stats_t into every
+ * list and tree, which its operations keep up to date. Without it the member doesn't exist and
+ * all DS_STATS_* macros expand to nothing, so the structures keep their size and the operations
+ * their code. The getters then return zeroed counters.
+ *
+ * Node allocations are counted whether they come from malloc or from a node pool. bytes counts
+ * the nodes that are alive, not the slack of pool slabs or of malloc.
+ *
+ * The counters are plain integers and not thread-safe. Read-only operations like lookups update
+ * them too, so a structure that is read concurrently, e.g. under the read side of a rwlock,
+ * races on its counters and reports wrong values. Build without DS_STATS to measure concurrent
+ * workloads.
+ */
+
+#ifdef DS_STATS
+#define DS_STATS_ENABLED true
+#else
+#define DS_STATS_ENABLED false
+#endif
+
+typedef struct ds_stats {
+    /**
+     * @brief Searches started from the root of a tree or the head of a list
+     */
+    uint64_t searches;
+    uint64_t node_visits;
+    uint64_t comparisons;
+    uint64_t allocs;
+    uint64_t frees;
+    /**
+     * @brief Bytes of the nodes that are currently allocated
+     */
+    size_t bytes;
+    size_t peak_bytes;
+} ds_stats_t;
+
+static inline void ds_stats_on_alloc(ds_stats_t* stats, const size_t bytes)
+{
+    stats->allocs++;
+    stats->bytes += bytes;
+    if (stats->bytes > stats->peak_bytes)
+        stats->peak_bytes = stats->bytes;
+}
+
+static inline void ds_stats_on_free(ds_stats_t* stats, const size_t bytes)
+{
+    stats->frees++;
+    stats->bytes -= bytes;
+}
+
+/**
+ * @brief Accounts for all nodes being released at once, e.g. by clearing a node pool
+ */
+static inline void ds_stats_on_free_all(ds_stats_t* stats, const size_t node_bytes)
+{
+    stats->frees += stats->bytes / node_bytes;
+    stats->bytes = 0;
+}
+
+/**
+ * @brief Zeroes the counters. The live bytes are kept and become the new peak
+ */
+static inline void ds_stats_reset(ds_stats_t* stats)
+{
+    *stats = (ds_stats_t) { .bytes = stats->bytes, .peak_bytes = stats->bytes };
+}
+
+#ifdef DS_STATS
+#define DS_STATS_MEMBER ds_stats_t stats;
+#define DS_STATS_ADD(stats, field, n) ((stats)->field += (n))
+#define DS_STATS_ALLOC(stats, bytes) ds_stats_on_alloc((stats), (bytes))
+#define DS_STATS_FREE(stats, bytes) ds_stats_on_free((stats), (bytes))
+#define DS_STATS_FREE_ALL(stats, node_bytes) ds_stats_on_free_all((stats), (node_bytes))
+#define DS_STATS_RESET(stats) ds_stats_reset(stats)
+#define DS_STATS_GET(stats) (*(stats))
+#else
+#define DS_STATS_MEMBER
+#define DS_STATS_ADD(stats, field, n) ((void)0)
+#define DS_STATS_ALLOC(stats, bytes) ((void)0)
+#define DS_STATS_FREE(stats, bytes) ((void)0)
+#define DS_STATS_FREE_ALL(stats, node_bytes) ((void)0)
+#define DS_STATS_RESET(stats) ((void)0)
+#define DS_STATS_GET(stats) ((ds_stats_t) { 0 })
+#endif
+
+/**
+ * @brief Writes the counters as one JSON object, without a trailing newline
+ *
+ * @return false if writing failed
+ */
+bool ds_stats_write_json(const ds_stats_t* stats, FILE* file);
@@ -0,0 +1,302 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "vector.h"
+
+//--------------------------------------------------
+// Helper functions
+
+/**
+ * @brief Reallocates the data of vec to hold exactly capacity values
+ */
+static bool _resize(vec_uint32_t* vec, const size_t capacity)
+{
+    if (capacity == 0) {
+        free(vec->data);
+        vec->data = nullptr;
+        vec->capacity = 0;
+        return true;
+    }
+
+    uint32_t* data = realloc(vec->data, capacity * sizeof(uint32_t));
+    if (data == nullptr) {
+        return false;
+    }
+    vec->data = data;
+    vec->capacity = capacity;
+    return true;
+}
+
+/**
+ * @brief Makes room for at least one more value, doubling the capacity if needed
+ */
+static bool _grow(vec_uint32_t* vec)
+{
+    if (vec->length < vec->capacity)
+        return true;
+    size_t capacity = (vec->capacity < VEC_MIN_CAPACITY) ? VEC_MIN_CAPACITY : 2 * vec->capacity;
+    return _resize(vec, capacity);
+}
+
+/**
+ * @brief Index of the first appearance of value in data, or length if there is none
+ */
+static size_t _find_idx(const uint32_t* data, const size_t length, const uint32_t value)
+{
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256i needle = _mm256_set1_epi32((int)value);
+    for (; i + 8 <= length; i += 8) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)&data[i]);
+        __m256i equal = _mm256_cmpeq_epi32(block, needle);
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(equal));
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+    }
+#elif defined(__SSE2__)
+    const __m128i needle = _mm_set1_epi32((int)value);
+    for (; i + 4 <= length; i += 4) {
+        __m128i block = _mm_loadu_si128((const __m128i*)&data[i]);
+        __m128i equal = _mm_cmpeq_epi32(block, needle);
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(equal));
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+    }
+#endif
+
+    for (; i < length; i++) {
+        if (data[i] == value)
+            return i;
+    }
+    return length;
+}
+
+/**
+ * @brief Number of appearances of value in data
+ *
+ * @details The vectorized loops subtract the all-ones compare masks from per lane counters. The
+ *          counters are folded into the total every UINT32_MAX blocks so that they can't overflow.
+ */
+static size_t _count(const uint32_t* data, const size_t length, const uint32_t value)
+{
+    size_t i = 0;
+    size_t count = 0;
+
+#if defined(__AVX2__)
+    const __m256i needle = _mm256_set1_epi32((int)value);
+    while (i + 8 <= length) {
+        size_t blocks = (length - i) / 8;
+        if (blocks > UINT32_MAX)
+            blocks = UINT32_MAX;
+        __m256i counters = _mm256_setzero_si256();
+        for (size_t end = i + 8 * blocks; i < end; i += 8) {
+            __m256i block = _mm256_loadu_si256((const __m256i*)&data[i]);
+            counters = _mm256_sub_epi32(counters, _mm256_cmpeq_epi32(block, needle));
+        }
+        uint32_t lanes[8];
+        _mm256_storeu_si256((__m256i*)lanes, counters);
+        for (int lane = 0; lane < 8; lane++)
+            count += lanes[lane];
+    }
+#elif defined(__SSE2__)
+    const __m128i needle = _mm_set1_epi32((int)value);
+    while (i + 4 <= length) {
+        size_t blocks = (length - i) / 4;
+        if (blocks > UINT32_MAX)
+            blocks = UINT32_MAX;
+        __m128i counters = _mm_setzero_si128();
+        for (size_t end = i + 4 * blocks; i < end; i += 4) {
+            __m128i block = _mm_loadu_si128((const __m128i*)&data[i]);
+            counters = _mm_sub_epi32(counters, _mm_cmpeq_epi32(block, needle));
+        }
+        uint32_t lanes[4];
+        _mm_storeu_si128((__m128i*)lanes, counters);
+        for (int lane = 0; lane < 4; lane++)
+            count += lanes[lane];
+    }
+#endif
+
+    for (; i < length; i++) {
+        count += (data[i] == value);
+    }
+    return count;
+}
+
+//--------------------------------------------------
+
+/**
+ * @brief: A new vector doesn't allocate until the first value is added
+ */
+vec_uint32_t vec_new_uint32_t()
+{
+    return (vec_uint32_t) {
+        .data = nullptr,
+        .length = 0,
+        .capacity = 0,
+    };
+}
+
+/**
+ * @brief: Appends the value to the end of the vector
+ */
+bool vec_push_uint32_t(vec_uint32_t* vec, const uint32_t value)
+{
+    if (!_grow(vec)) {
+        return false;
+    }
+    vec->data[vec->length++] = value;
+    return true;
+}
+
+/**
+ * @brief: Removes the last value and returns it
+ */
+Result_uint32_t vec_pop_uint32_t(vec_uint32_t* vec)
+{
+    if (vec->length == 0) {
+        return Result_uint32_t_Err("Trying to pop from empty vector");
+    }
+    return Result_uint32_t_Ok(vec->data[--vec->length]);
+}
+
+/**
+ * @brief: Gets value at index idx
+ */
+Result_uint32_t vec_get_uint32_t(vec_uint32_t* vec, const size_t idx)
+{
+    if (idx >= vec->length) {
+        return Result_uint32_t_Err("Out of range");
+    }
+    return Result_uint32_t_Ok(vec->data[idx]);
+}
+
+/**
+ * @brief: Sets the value at index idx to value
+ */
+bool vec_set_uint32_t(vec_uint32_t* vec, const size_t idx, const uint32_t value)
+{
+    if (idx >= vec->length) {
+        return false;
+    }
+    vec->data[idx] = value;
+    return true;
+}
+
+/**
+ * @brief: Inserts value before index idx. idx may be the length to append
+ */
+bool vec_insert_uint32_t(vec_uint32_t* vec, const size_t idx, const uint32_t value)
+{
+    if (idx > vec->length || !_grow(vec)) {
+        return false;
+    }
+    memmove(&vec->data[idx + 1], &vec->data[idx], (vec->length - idx) * sizeof(uint32_t));
+    vec->data[idx] = value;
+    vec->length++;
+    return true;
+}
+
+/**
+ * @brief: Removes the value at index idx, shifting all following values to the front
+ */
+bool vec_erase_uint32_t(vec_uint32_t* vec, const size_t idx)
+{
+    if (idx >= vec->length) {
+        return false;
+    }
+    memmove(&vec->data[idx], &vec->data[idx + 1], (vec->length - idx - 1) * sizeof(uint32_t));
+    vec->length--;
+    return true;
+}
+
+/**
+ * @brief: Makes sure the vector can hold capacity values without reallocating
+ */
+bool vec_reserve_uint32_t(vec_uint32_t* vec, const size_t capacity)
+{
+    if (capacity <= vec->capacity) {
+        return true;
+    }
+    return _resize(vec, capacity);
+}
+
+/**
+ * @brief: Releases all capacity that is not used by values
+ */
+bool vec_shrink_uint32_t(vec_uint32_t* vec)
+{
+    if (vec->length == vec->capacity) {
+        return true;
+    }
+    return _resize(vec, vec->length);
+}
+
+/**
+ * @brief: Removes all values and releases the memory
+ */
+bool vec_clear_uint32_t(vec_uint32_t* vec)
+{
+    free(vec->data);
+    vec->data = nullptr;
+    vec->length = 0;
+    vec->capacity = 0;
+    return true;
+}
+
+/**
+ * @brief: Returns whether or not the vector is empty
+ */
+bool vec_is_empty_uint32_t(vec_uint32_t* vec)
+{
+    return vec->length == 0;
+}
+
+/**
+ * @brief: Returns length of the vector
+ */
+size_t vec_length_uint32_t(vec_uint32_t* vec)
+{
+    return vec->length;
+}
+
+/**
+ * @brief: Returns the index of the first appearance of value
+ */
+Result_uint64_t vec_find_uint32_t(vec_uint32_t* vec, const uint32_t value)
+{
+    size_t idx = _find_idx(vec->data, vec->length, value);
+    if (idx == vec->length) {
+        return Result_uint64_t_Err("Value not found");
+    }
+    return Result_uint64_t_Ok(idx);
+}
+
+/**
+ * @brief: Returns the number of appearances of value
+ */
+size_t vec_count_uint32_t(vec_uint32_t* vec, const uint32_t value)
+{
+    return _count(vec->data, vec->length, value);
+}
+
+/**
+ * @brief: Prints the vector
+ */
+void vec_print_uint32_t(vec_uint32_t* vec)
+{
+    printf("[");
+    for (size_t i = 0; i < vec->length; i++) {
+        printf("%i", vec->data[i]);
+        if (i + 1 < vec->length)
+            printf(", ");
+    }
+    printf("]\n");
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "utils/result_types.h"
+
+/**
+ * @file vector.h
+ *
+ * Growable contiguous array.
+ *
+ * Appending grows the capacity geometrically, so push is amortized O(1). Linear searches over
+ * integer vectors are vectorized with AVX2 or SSE2 if the compiler targets them and fall back to a
+ * scalar loop otherwise.
+ */
+
+/**
+ * @brief Capacity of the first allocation of a vector
+ */
+#define VEC_MIN_CAPACITY 8
+
+#define VEC(type) vec_##type
+
+#define VEC_DECLARE(type)                                                                          \
+    typedef struct VEC(type) {                                                                     \
+        type* data;                                                                                \
+        size_t length;                                                                             \
+        size_t capacity;                                                                           \
+    } VEC(type);                                                                                   \
+    VEC(type) vec_new_##type();                                                                    \
+    bool vec_push_##type(VEC(type) * vec, const type value);                                       \
+    RESULT(type) vec_pop_##type(VEC(type) * vec);                                                  \
+    RESULT(type) vec_get_##type(VEC(type) * vec, const size_t idx);                                \
+    bool vec_set_##type(VEC(type) * vec, const size_t idx, const type value);                      \
+    bool vec_insert_##type(VEC(type) * vec, const size_t idx, const type value);                   \
+    bool vec_erase_##type(VEC(type) * vec, const size_t idx);                                      \
+    bool vec_reserve_##type(VEC(type) * vec, const size_t capacity);                               \
+    bool vec_shrink_##type(VEC(type) * vec);                                                       \
+    bool vec_clear_##type(VEC(type) * vec);                                                        \
+    bool vec_is_empty_##type(VEC(type) * vec);                                                     \
+    size_t vec_length_##type(VEC(type) * vec);                                                     \
+    RESULT(uint64_t) vec_find_##type(VEC(type) * vec, const type value);                           \
+    size_t vec_count_##type(VEC(type) * vec, const type value);                                    \
+    void vec_print_##type(VEC(type) * vec);
+
+VEC_DECLARE(uint32_t);
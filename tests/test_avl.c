@@ -0,0 +1,201 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tree.h"
+#include "utils/asserts.h"
+
+/* Checks ordering, stored heights and balance of every node. Returns the subtree height */
+static int check_avl_node(avl_node_uint32_t* node, size_t* count)
+{
+    if (node == nullptr)
+        return 0;
+
+    if (node->left != nullptr)
+        ASSERT(node->left->value <= node->value, "Left child is bigger than its parent");
+    if (node->right != nullptr)
+        ASSERT(node->right->value >= node->value, "Right child is smaller than its parent");
+
+    int lheight = check_avl_node(node->left, count);
+    int rheight = check_avl_node(node->right, count);
+    int height = 1 + ((lheight > rheight) ? lheight : rheight);
+    ASSERTF(
+        node->height == height,
+        "Stored height %d of node %u should be %d",
+        node->height,
+        node->value,
+        height);
+    ASSERTF(lheight - rheight <= 1 && rheight - lheight <= 1, "Node %u is unbalanced", node->value);
+    (*count)++;
+    return height;
+}
+
+static void check_avl(avl_uint32_t* tree)
+{
+    size_t count = 0;
+    check_avl_node(tree->root, &count);
+    ASSERTF(
+        count == avl_size_uint32_t(tree),
+        "Counted %zu nodes but size says %zu",
+        count,
+        avl_size_uint32_t(tree));
+}
+
+/* Testing Basic creation and usage*/
+void test_case_0(int argc, const char* argv[])
+{
+    printf("Starting test case 0\n");
+    avl_uint32_t tree;
+
+    // Basic initialization
+    tree = avl_new_uint32_t();
+    ASSERT(tree.root == nullptr, "Initialization failed");
+    avl_print_uint32_t(&tree);
+    ASSERT(avl_is_empty_uint32_t(&tree), "Is empty should say tree is empty");
+
+    // Adding values
+    avl_add_value_uint32_t(&tree, 3);
+    avl_add_value_uint32_t(&tree, 0);
+    avl_add_value_uint32_t(&tree, 132);
+    avl_add_value_uint32_t(&tree, 180);
+    avl_add_value_uint32_t(&tree, 99);
+    avl_print_uint32_t(&tree);
+    check_avl(&tree);
+    ASSERT(avl_size_uint32_t(&tree) == 5, "Size of tree at this point should be 5");
+
+    // Adding values again
+    avl_add_value_uint32_t(&tree, 132);
+    avl_add_value_uint32_t(&tree, 80);
+    avl_print_uint32_t(&tree);
+    check_avl(&tree);
+    ASSERT(avl_size_uint32_t(&tree) == 7, "Size of tree at this point should be 7");
+    ASSERT(avl_contains_uint32_t(&tree, 80), "Tree should contain 80");
+    ASSERT(!avl_contains_uint32_t(&tree, 81), "Tree should not contain 81");
+
+    // Removing values
+    avl_del_value_uint32_t(&tree, 99);
+    avl_print_uint32_t(&tree);
+    check_avl(&tree);
+    ASSERT(avl_size_uint32_t(&tree) == 6, "Size of tree at this point should be 6");
+    ASSERT(!avl_contains_uint32_t(&tree, 99), "Tree should not contain 99 anymore");
+
+    // Deleting
+    avl_clear_uint32_t(&tree);
+    ASSERT(avl_size_uint32_t(&tree) == 0, "Size of tree at this point should be 0");
+}
+
+/* Thorough deletion test case for all scenarios */
+void test_case_1(int argc, const char* argv[])
+{
+    printf("Starting test case 1\n");
+    avl_uint32_t tree;
+
+    // Basic initialization
+    tree = avl_new_uint32_t();
+    avl_add_value_uint32_t(&tree, 3);
+    ASSERT(!avl_is_empty_uint32_t(&tree), "Is empty should say tree is not empty");
+
+    // Deleting non-existent
+    ASSERT(!avl_del_value_uint32_t(&tree, 99), "Deleting 99 should not be possible at this point");
+
+    // Deleting root
+    avl_del_value_uint32_t(&tree, 3);
+    ASSERT(avl_is_empty_uint32_t(&tree), "Is empty should say tree is empty");
+
+    // Deleting with left-left rotation
+    printf("Deleting with left-left rotation\n");
+    avl_add_value_uint32_t(&tree, 50);
+    avl_add_value_uint32_t(&tree, 40);
+    avl_add_value_uint32_t(&tree, 60);
+    avl_add_value_uint32_t(&tree, 30);
+    avl_print_uint32_t(&tree);
+    ASSERT(avl_del_value_uint32_t(&tree, 60), "Removing 60 was not successfull");
+    avl_print_uint32_t(&tree);
+    check_avl(&tree);
+    ASSERT(tree.root->value == 40, "40 should have been rotated up to the root");
+    avl_clear_uint32_t(&tree);
+
+    // Deleting with right-left rotation
+    printf("Deleting with right-left rotation\n");
+    avl_add_value_uint32_t(&tree, 20);
+    avl_add_value_uint32_t(&tree, 10);
+    avl_add_value_uint32_t(&tree, 40);
+    avl_add_value_uint32_t(&tree, 30);
+    avl_print_uint32_t(&tree);
+    ASSERT(avl_del_value_uint32_t(&tree, 10), "Removing 10 was not successfull");
+    avl_print_uint32_t(&tree);
+    check_avl(&tree);
+    ASSERT(tree.root->value == 30, "30 should have been rotated up to the root");
+    avl_clear_uint32_t(&tree);
+
+    // Deleting with successor replacement
+    printf("Deleting with successor replacement\n");
+    const uint32_t values[] = { 50, 30, 90, 80, 85, 100, 99, 95, 101 };
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        avl_add_value_uint32_t(&tree, values[i]);
+    }
+    avl_print_uint32_t(&tree);
+    ASSERT(avl_del_value_uint32_t(&tree, 90), "Removing 90 was not successfull");
+    avl_print_uint32_t(&tree);
+    check_avl(&tree);
+    ASSERT(avl_size_uint32_t(&tree) == 8, "Size of tree at this point should be 8");
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        ASSERTF(
+            avl_contains_uint32_t(&tree, values[i]) == (values[i] != 90),
+            "Unexpected membership of %u",
+            values[i]);
+    }
+
+    // Deleting
+    avl_clear_uint32_t(&tree);
+    ASSERT(avl_size_uint32_t(&tree) == 0, "Size of tree at this point should be 0");
+}
+
+/* Testing with a lot of sorted numbers */
+void test_case_2(int argc, const char* argv[])
+{
+    printf("Starting test case 2\n");
+    const uint32_t N = 1000000;
+    avl_uint32_t tree = avl_new_uint32_t();
+
+    printf("Adding %u sorted numbers to tree\n", N);
+    for (uint32_t i = 0; i < N; i++) {
+        avl_add_value_uint32_t(&tree, i);
+    }
+    check_avl(&tree);
+    // An AVL tree with n nodes is at most 1.44 * log2(n) high
+    ASSERTF(tree.root->height <= 29, "Tree height %d is too big", tree.root->height);
+
+    printf("Deleting every even number\n");
+    for (uint32_t i = 0; i < N; i += 2) {
+        ASSERTF(avl_del_value_uint32_t(&tree, i), "Removing %u was not successfull", i);
+    }
+    check_avl(&tree);
+    ASSERTF(avl_size_uint32_t(&tree) == N / 2, "We should have a tree size of %u", N / 2);
+    for (uint32_t i = 0; i < N; i++) {
+        ASSERTF(avl_contains_uint32_t(&tree, i) == (i % 2 == 1), "Unexpected membership of %u", i);
+    }
+
+    printf("Clearing...\n");
+    avl_clear_uint32_t(&tree);
+    ASSERT(avl_is_empty_uint32_t(&tree), "Is empty should say tree is empty");
+}
+
+int main(int argc, const char* argv[])
+{
+    printf("Starting Test: AVLTreeTester\n");
+    ASSERT(argc > 1, "Test executable needs more than one argument");
+    int test_num = atoi(argv[1]);
+    switch (test_num) {
+    case 0:
+        test_case_0(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 1:
+        test_case_1(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 2:
+        test_case_2(argc, argv);
+        exit(EXIT_SUCCESS);
+    default:
+        ASSERTF(false, "Invalid test case number given %i", test_num);
+    }
+}
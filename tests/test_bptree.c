@@ -0,0 +1,234 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bptree.h"
+#include "utils/asserts.h"
+#include "utils/failing_alloc.h"
+
+/* Checks key order, node fill and that all leaves are on the same level. Returns the height */
+static int check_bpt_node(
+    bpt_node_uint32_t* node, bool is_root, bool has_lo, uint32_t lo, bool has_hi, uint32_t hi)
+{
+    ASSERT(node->num_keys <= BP_TREE_MAX_KEYS, "Node holds too many keys");
+    if (!is_root)
+        ASSERTF(node->num_keys >= BP_TREE_MIN_KEYS, "Node holds only %u keys", node->num_keys);
+    for (uint32_t i = 0; i < node->num_keys; i++) {
+        if (i > 0)
+            ASSERT(node->keys[i - 1] < node->keys[i], "Keys of a node are not sorted");
+        ASSERT(!has_lo || node->keys[i] >= lo, "Key is smaller than its separator");
+        ASSERT(!has_hi || node->keys[i] < hi, "Key is not smaller than its separator");
+    }
+    if (node->is_leaf)
+        return 1;
+
+    bpt_inner_uint32_t* inner = (bpt_inner_uint32_t*)node;
+    int height = 0;
+    for (uint32_t i = 0; i <= node->num_keys; i++) {
+        int child_height = check_bpt_node(
+            inner->children[i],
+            false,
+            (i > 0) || has_lo,
+            (i > 0) ? node->keys[i - 1] : lo,
+            (i < node->num_keys) || has_hi,
+            (i < node->num_keys) ? node->keys[i] : hi);
+        ASSERT(height == 0 || height == child_height, "Leaves are not on the same level");
+        height = child_height;
+    }
+    return height + 1;
+}
+
+static void collect_value(uint32_t value, void* ctx)
+{
+    uint32_t** out = ctx;
+    **out = value;
+    (*out)++;
+}
+
+/* Testing Basic creation and usage */
+void test_case_0(int argc, const char* argv[])
+{
+    printf("Starting test case 0\n");
+    bpt_uint32_t tree = bpt_new_uint32_t();
+    ASSERT(tree.root == nullptr, "Initialization failed");
+    ASSERT(bpt_is_empty_uint32_t(&tree), "Is empty should say tree is empty");
+    bpt_print_uint32_t(&tree);
+
+    // Adding values
+    bpt_add_value_uint32_t(&tree, 3);
+    bpt_add_value_uint32_t(&tree, 0);
+    bpt_add_value_uint32_t(&tree, 132);
+    bpt_add_value_uint32_t(&tree, 180);
+    bpt_add_value_uint32_t(&tree, 99);
+    bpt_print_uint32_t(&tree);
+    ASSERT(bpt_size_uint32_t(&tree) == 5, "Size of tree at this point should be 5");
+
+    // Adding values again
+    ASSERT(!bpt_add_value_uint32_t(&tree, 132), "Adding 132 twice should not be possible");
+    ASSERT(bpt_add_value_uint32_t(&tree, 80), "Adding 80 should be possible");
+    ASSERT(bpt_size_uint32_t(&tree) == 6, "Size of tree at this point should be 6");
+    ASSERT(bpt_contains_uint32_t(&tree, 80), "Tree should contain 80");
+    ASSERT(!bpt_contains_uint32_t(&tree, 81), "Tree should not contain 81");
+
+    // Removing values
+    ASSERT(bpt_del_value_uint32_t(&tree, 99), "Removing 99 was not successfull");
+    ASSERT(!bpt_del_value_uint32_t(&tree, 99), "Removing 99 twice should not be possible");
+    bpt_print_uint32_t(&tree);
+    ASSERT(bpt_size_uint32_t(&tree) == 5, "Size of tree at this point should be 5");
+
+    // Range scan
+    uint32_t values[5];
+    uint32_t* out = values;
+    size_t count = bpt_range_uint32_t(&tree, 1, 132, collect_value, &out);
+    ASSERTF(count == 3, "Range [1, 132] should hold 3 values, got %zu", count);
+    ASSERT(values[0] == 3 && values[1] == 80 && values[2] == 132, "Unexpected range values");
+
+    // Deleting
+    bpt_clear_uint32_t(&tree);
+    ASSERT(bpt_size_uint32_t(&tree) == 0, "Size of tree at this point should be 0");
+}
+
+/* Random insertions and deletions checked against a reference bitmap */
+void test_case_1(int argc, const char* argv[])
+{
+    printf("Starting test case 1\n");
+    const uint32_t N = 20000;
+    bool* reference = calloc(N, sizeof(bool));
+    size_t reference_size = 0;
+    bpt_uint32_t tree = bpt_new_uint32_t();
+
+    srand(42);
+    for (int round = 0; round < 300000; round++) {
+        uint32_t value = rand() % N;
+        // Bias towards insertions first and deletions later so the tree grows and shrinks
+        bool add = (rand() % 100) < ((round < 150000) ? 70 : 30);
+        if (add) {
+            ASSERTF(
+                bpt_add_value_uint32_t(&tree, value) == !reference[value],
+                "Unexpected add result for %u",
+                value);
+            reference_size += !reference[value];
+            reference[value] = true;
+        } else {
+            ASSERTF(
+                bpt_del_value_uint32_t(&tree, value) == reference[value],
+                "Unexpected del result for %u",
+                value);
+            reference_size -= reference[value];
+            reference[value] = false;
+        }
+        if (round % 10000 == 0 && tree.root != nullptr)
+            check_bpt_node(tree.root, true, false, 0, false, 0);
+    }
+
+    ASSERT(bpt_size_uint32_t(&tree) == reference_size, "Size does not match the reference");
+    for (uint32_t i = 0; i < N; i++) {
+        ASSERTF(bpt_contains_uint32_t(&tree, i) == reference[i], "Unexpected membership of %u", i);
+    }
+
+    printf("Deleting everything\n");
+    for (uint32_t i = 0; i < N; i++) {
+        bpt_del_value_uint32_t(&tree, i);
+    }
+    ASSERT(bpt_is_empty_uint32_t(&tree), "Is empty should say tree is empty");
+    bpt_clear_uint32_t(&tree);
+    free(reference);
+}
+
+/* Testing with a lot of sorted numbers */
+void test_case_2(int argc, const char* argv[])
+{
+    printf("Starting test case 2\n");
+    const uint32_t N = 1000000;
+    bpt_uint32_t tree = bpt_new_uint32_t();
+
+    printf("Adding %u sorted numbers to tree\n", N);
+    for (uint32_t i = 0; i < N; i++) {
+        bpt_add_value_uint32_t(&tree, 2 * i);
+    }
+    int height = check_bpt_node(tree.root, true, false, 0, false, 0);
+    ASSERTF(height <= 5, "Tree height %d is too big", height);
+    ASSERTF(bpt_size_uint32_t(&tree) == N, "Size of tree at this point should be %u", N);
+
+    printf("Scanning a range\n");
+    uint32_t* values = malloc(N * sizeof(uint32_t));
+    uint32_t* out = values;
+    size_t count = bpt_range_uint32_t(&tree, 1001, 400000, collect_value, &out);
+    ASSERTF(count == 199500, "Range should hold 199500 values, got %zu", count);
+    for (size_t i = 0; i < count; i++) {
+        ASSERT(values[i] == 1002 + 2 * i, "Unexpected range value");
+    }
+    free(values);
+
+    printf("Clearing...\n");
+    bpt_clear_uint32_t(&tree);
+    ASSERT(bpt_is_empty_uint32_t(&tree), "Is empty should say tree is empty");
+}
+
+/* Running out of memory while splitting nodes */
+void test_case_3(int argc, const char* argv[])
+{
+    printf("Starting test case 3\n");
+    const uint32_t N = 60000;
+    bpt_uint32_t tree = bpt_new_uint32_t();
+    uint32_t* values = malloc(N * sizeof(uint32_t));
+
+    // Every insertion is first tried with no memory and then with one more allocation each time,
+    // until it succeeds. Sorted values split the rightmost path up to the root
+    uint32_t most_allocations = 0;
+    for (uint32_t i = 0; i < N; i++) {
+        uint32_t allocations = 0;
+        while (true) {
+            failing_alloc_arm(allocations);
+            bool added = bpt_add_value_uint32_t(&tree, i);
+            failing_alloc_disarm();
+            if (added)
+                break;
+
+            ASSERTF(bpt_size_uint32_t(&tree) == i, "Failing to add %u changed the size", i);
+            ASSERTF(!bpt_contains_uint32_t(&tree, i), "Failing to add %u added it", i);
+            uint32_t* out = values;
+            ASSERTF(
+                bpt_range_uint32_t(&tree, 0, N, collect_value, &out) == i,
+                "Failing to add %u lost values",
+                i);
+            allocations++;
+        }
+        if (allocations > most_allocations)
+            most_allocations = allocations;
+    }
+    int height = check_bpt_node(tree.root, true, false, 0, false, 0);
+    ASSERTF(bpt_size_uint32_t(&tree) == N, "Size of tree at this point should be %u", N);
+    // The last root split took one node for every level
+    ASSERTF(height > 2 && most_allocations == (uint32_t)height, "Unexpected allocations");
+    uint32_t* out = values;
+    ASSERT(bpt_range_uint32_t(&tree, 0, N, collect_value, &out) == N, "Tree should hold it all");
+    for (uint32_t i = 0; i < N; i++)
+        ASSERTF(values[i] == i, "Expected value %u", i);
+    ASSERT(!bpt_add_value_uint32_t(&tree, 42), "Adding 42 twice should not be possible");
+
+    free(values);
+    bpt_clear_uint32_t(&tree);
+}
+
+int main(int argc, const char* argv[])
+{
+    printf("Starting Test: BPlusTreeTester\n");
+    ASSERT(argc > 1, "Test executable needs more than one argument");
+    int test_num = atoi(argv[1]);
+    switch (test_num) {
+    case 0:
+        test_case_0(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 1:
+        test_case_1(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 2:
+        test_case_2(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 3:
+        test_case_3(argc, argv);
+        exit(EXIT_SUCCESS);
+    default:
+        ASSERTF(false, "Invalid test case number given %i", test_num);
+    }
+}
@@ -1,8 +1,59 @@
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 #include "tree.h"
 #include "utils/asserts.h"
+#include "utils/failing_alloc.h"
+
+/* Trees of other value types, instantiated in this translation unit */
+static void print_uint64(const uint64_t value)
+{
+    printf("%" PRIu64, value);
+}
+
+B_TREE_DECLARE(uint64_t);
+B_TREE_DEFINE(uint64_t, B_TREE_DEFAULT_LESS, print_uint64)
+
+typedef struct entry {
+    uint32_t key;
+    uint32_t payload;
+} entry_t;
+
+static void print_entry(const entry_t entry)
+{
+    printf("%u:%u", entry.key, entry.payload);
+}
+
+/* Orders entries by descending key, ignoring the payload */
+static inline bool entry_less(const entry_t a, const entry_t b)
+{
+    return a.key > b.key;
+}
+
+RESULT_DECLARE(entry_t)
+RESULT_DEFINE(entry_t)
+B_TREE_DECLARE(entry_t);
+B_TREE_DEFINE(entry_t, entry_less, print_entry)
+
+/* Checks parent links and subtree counts of every node. Returns the subtree count */
+static size_t check_bt_node(bt_node_uint32_t* node)
+{
+    if (node == nullptr)
+        return 0;
+    if (node->left != nullptr)
+        ASSERT(node->left->parent == node, "Left child does not link back to its parent");
+    if (node->right != nullptr)
+        ASSERT(node->right->parent == node, "Right child does not link back to its parent");
+    size_t count = 1 + check_bt_node(node->left) + check_bt_node(node->right);
+    ASSERTF(
+        node->count == count,
+        "Node %u counts %u instead of %zu",
+        node->value,
+        node->count,
+        count);
+    return count;
+}
 
 /* Testing Basic creation and usage*/
 void test_case_0(int argc, const char* argv[])
@@ -126,6 +177,597 @@ void test_case_1(int argc, const char* argv[])
     ASSERT(bt_size_uint32_t(&tree) == 0, "Size of tree at this point should be 0");
 }
 
+/* Testing pooled node allocation */
+void test_case_2(int argc, const char* argv[])
+{
+    printf("Starting test case 2\n");
+    const uint32_t N = 10000;
+    bt_uint32_t tree = bt_new_pooled_uint32_t();
+    ASSERT(bt_is_empty_uint32_t(&tree), "Is empty should say tree is empty");
+
+    // Pseudo random insertion order keeps the unbalanced tree shallow
+    for (uint32_t i = 0; i < N; i++) {
+        bt_add_value_uint32_t(&tree, (i * 7919) % N);
+    }
+    ASSERTF(bt_size_uint32_t(&tree) == N, "Size of tree at this point should be %u", N);
+
+    for (uint32_t i = 0; i < N; i += 2) {
+        bt_del_value_uint32_t(&tree, i);
+    }
+    for (uint32_t i = 0; i < N; i += 2) {
+        bt_add_value_uint32_t(&tree, i);
+    }
+    ASSERTF(bt_size_uint32_t(&tree) == N, "Size of tree at this point should be %u", N);
+    for (uint32_t i = 0; i < N; i++) {
+        ASSERTF(bt_contains_uint32_t(&tree, i), "Tree should contain %u", i);
+    }
+
+    // Deleting
+    bt_clear_uint32_t(&tree);
+    ASSERT(bt_size_uint32_t(&tree) == 0, "Size of tree at this point should be 0");
+    bt_add_value_uint32_t(&tree, 1);
+    ASSERT(bt_size_uint32_t(&tree) == 1, "Size of tree at this point should be 1");
+    bt_clear_uint32_t(&tree);
+}
+
+/* Testing in-order iteration in both directions */
+void test_case_3(int argc, const char* argv[])
+{
+    printf("Starting test case 3\n");
+    const uint32_t N = 20000;
+    bt_uint32_t tree = bt_new_uint32_t();
+
+    // Empty tree
+    bt_iter_uint32_t iter = bt_iter_begin_uint32_t(&tree);
+    ASSERT(!bt_iter_valid_uint32_t(&iter), "Iterator of an empty tree should be past the end");
+    ASSERT(!bt_iter_prev_uint32_t(&iter), "Stepping back in an empty tree should fail");
+
+    // Sorted insertion degenerates the tree into a chain
+    for (uint32_t i = 0; i < N; i++) {
+        bt_add_value_uint32_t(&tree, 2 * i);
+    }
+    ASSERTF(bt_size_uint32_t(&tree) == N, "Size of tree at this point should be %u", N);
+
+    uint32_t expected = 0;
+    for (iter = bt_iter_begin_uint32_t(&tree); bt_iter_valid_uint32_t(&iter);
+         bt_iter_next_uint32_t(&iter)) {
+        ASSERTF(iter.node->value == expected, "Expected %u while iterating forward", expected);
+        expected += 2;
+    }
+    ASSERT(expected == 2 * N, "Forward iteration stopped early");
+    ASSERT(!bt_iter_next_uint32_t(&iter), "Stepping past the end should fail");
+
+    ASSERT(bt_iter_prev_uint32_t(&iter), "Stepping back from the end should be possible");
+    ASSERT(iter.node->value == 2 * (N - 1), "Stepping back from the end should reach the max");
+    for (iter = bt_iter_last_uint32_t(&tree); bt_iter_valid_uint32_t(&iter);
+         bt_iter_prev_uint32_t(&iter)) {
+        expected -= 2;
+        ASSERTF(iter.node->value == expected, "Expected %u while iterating backward", expected);
+    }
+    ASSERT(expected == 0, "Backward iteration stopped early");
+    bt_clear_uint32_t(&tree);
+
+    // Lower bound with duplicates in a shuffled tree
+    const uint32_t values[] = { 50, 30, 90, 80, 85, 100, 99, 95, 101, 85, 30 };
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        bt_add_value_uint32_t(&tree, values[i]);
+    }
+    iter = bt_iter_lower_bound_uint32_t(&tree, 84);
+    ASSERT(iter.node->value == 85, "Lower bound of 84 should be 85");
+    bt_iter_next_uint32_t(&iter);
+    ASSERT(iter.node->value == 85, "Duplicate 85 should follow the lower bound");
+    bt_iter_next_uint32_t(&iter);
+    ASSERT(iter.node->value == 90, "90 should follow the duplicates of 85");
+    iter = bt_iter_lower_bound_uint32_t(&tree, 30);
+    ASSERT(iter.node->value == 30, "Lower bound of 30 should be 30");
+    ASSERT(!bt_iter_prev_uint32_t(&iter), "There should be no value before the first 30");
+    iter = bt_iter_lower_bound_uint32_t(&tree, 102);
+    ASSERT(!bt_iter_valid_uint32_t(&iter), "Lower bound of 102 should be past the end");
+
+    bt_clear_uint32_t(&tree);
+    ASSERT(bt_size_uint32_t(&tree) == 0, "Size of tree at this point should be 0");
+}
+
+/* Testing rank and select on subtree counts against a reference */
+void test_case_4(int argc, const char* argv[])
+{
+    printf("Starting test case 4\n");
+    const uint32_t N = 500;
+    uint32_t reference[500] = { 0 }; // Number of appearances of each value
+    size_t reference_size = 0;
+    bt_uint32_t tree = bt_new_uint32_t();
+
+    Result_uint32_t value_result = bt_select_uint32_t(&tree, 0);
+    ASSERT(Result_uint32_t_is_err(&value_result), "Selecting in an empty tree should fail");
+    ASSERT(bt_rank_uint32_t(&tree, 10) == 0, "Rank in an empty tree should be 0");
+
+    srand(7);
+    for (int round = 0; round < 20000; round++) {
+        uint32_t value = rand() % N;
+        if (rand() % 100 < 60) {
+            bt_add_value_uint32_t(&tree, value);
+            reference[value]++;
+            reference_size++;
+        } else if (reference[value] > 0) {
+            ASSERT(bt_del_value_uint32_t(&tree, value), "Deleting a present value failed");
+            reference[value]--;
+            reference_size--;
+        } else {
+            ASSERT(!bt_del_value_uint32_t(&tree, value), "Deleting a missing value succeeded");
+        }
+
+        if (round % 1000 != 0)
+            continue;
+        ASSERT(check_bt_node(tree.root) == reference_size, "Counted nodes differ from reference");
+        ASSERT(bt_size_uint32_t(&tree) == reference_size, "Size differs from reference");
+
+        size_t below = 0;
+        for (uint32_t v = 0; v < N; v++) {
+            ASSERTF(bt_rank_uint32_t(&tree, v) == below, "Unexpected rank of %u", v);
+            for (uint32_t i = 0; i < reference[v]; i++) {
+                value_result = bt_select_uint32_t(&tree, below + i);
+                ASSERTF(Result_uint32_t_unwrap(&value_result) == v, "Expected to select %u", v);
+            }
+            below += reference[v];
+        }
+        value_result = bt_select_uint32_t(&tree, reference_size);
+        ASSERT(Result_uint32_t_is_err(&value_result), "Selecting behind the max should fail");
+    }
+
+    bt_clear_uint32_t(&tree);
+    ASSERT(bt_size_uint32_t(&tree) == 0, "Size of tree at this point should be 0");
+}
+
+/* Height of the subtree of node, the empty subtree has height 0 */
+static size_t bt_node_height(bt_node_uint32_t* node)
+{
+    if (node == nullptr)
+        return 0;
+    size_t left = bt_node_height(node->left);
+    size_t right = bt_node_height(node->right);
+    return 1 + ((left > right) ? left : right);
+}
+
+/* Smallest possible height of a tree holding size values */
+static size_t min_height(size_t size)
+{
+    size_t height = 0;
+    while (size > 0) {
+        size /= 2;
+        height++;
+    }
+    return height;
+}
+
+static void collect_value(uint32_t value, void* ctx)
+{
+    uint32_t** out = ctx;
+    **out = value;
+    (*out)++;
+}
+
+/* Testing ordered queries and range scans against a sorted reference */
+void test_case_5(int argc, const char* argv[])
+{
+    printf("Starting test case 5\n");
+    bt_uint32_t tree = bt_new_uint32_t();
+
+    Result_uint32_t value_result = bt_min_uint32_t(&tree);
+    ASSERT(Result_uint32_t_is_err(&value_result), "Min of an empty tree should fail");
+    value_result = bt_lower_bound_uint32_t(&tree, 0);
+    ASSERT(Result_uint32_t_is_err(&value_result), "Lower bound in an empty tree should fail");
+
+    // Multiples of 10 from 10 to 1000, with 500 twice
+    srand(11);
+    uint32_t values[100];
+    for (uint32_t i = 0; i < 100; i++) {
+        values[i] = 10 * (i + 1);
+    }
+    for (uint32_t i = 99; i > 0; i--) {
+        uint32_t j = rand() % (i + 1);
+        uint32_t tmp = values[i];
+        values[i] = values[j];
+        values[j] = tmp;
+    }
+    for (uint32_t i = 0; i < 100; i++) {
+        bt_add_value_uint32_t(&tree, values[i]);
+    }
+    bt_add_value_uint32_t(&tree, 500);
+
+    value_result = bt_min_uint32_t(&tree);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == 10, "Min should be 10");
+    value_result = bt_max_uint32_t(&tree);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == 1000, "Max should be 1000");
+
+    // Reference answers are clamped to the values in the tree, 0 meaning there is none
+    for (uint32_t v = 0; v <= 1010; v++) {
+        uint32_t down = (v > 1000) ? 1000 : v / 10 * 10;
+        uint32_t up = (v >= 1000) ? 0 : (v / 10 + 1) * 10;
+        uint32_t ceil = (v % 10 == 0 && v >= 10 && v <= 1000) ? v : up;
+        uint32_t pred = (v % 10 == 0 && v >= 10 && v <= 1000) ? v - 10 : down;
+        const struct {
+            const char* name;
+            Result_uint32_t result;
+            uint32_t expected;
+        } queries[] = {
+            { "Lower bound", bt_lower_bound_uint32_t(&tree, v), ceil },
+            { "Ceiling", bt_ceiling_uint32_t(&tree, v), ceil },
+            { "Upper bound", bt_upper_bound_uint32_t(&tree, v), up },
+            { "Floor", bt_floor_uint32_t(&tree, v), down },
+            { "Predecessor", bt_predecessor_uint32_t(&tree, v), pred },
+        };
+        for (size_t i = 0; i < sizeof(queries) / sizeof(queries[0]); i++) {
+            Result_uint32_t result = queries[i].result;
+            if (queries[i].expected == 0) {
+                ASSERTF(
+                    Result_uint32_t_is_err(&result), "%s of %u should fail", queries[i].name, v);
+            } else {
+                ASSERTF(
+                    Result_uint32_t_unwrap(&result) == queries[i].expected,
+                    "%s of %u should be %u",
+                    queries[i].name,
+                    v,
+                    queries[i].expected);
+            }
+        }
+    }
+
+    // Range scans, inclusive on both ends and with duplicates
+    uint32_t collected[101];
+    uint32_t* out = collected;
+    size_t count = bt_range_uint32_t(&tree, 480, 520, collect_value, &out);
+    ASSERTF(count == 6, "Range [480, 520] should hold 6 values, got %zu", count);
+    const uint32_t expected[] = { 480, 490, 500, 500, 510, 520 };
+    for (size_t i = 0; i < count; i++) {
+        ASSERTF(collected[i] == expected[i], "Unexpected value at %zu of range", i);
+    }
+    out = collected;
+    count = bt_range_uint32_t(&tree, 0, 2000, collect_value, &out);
+    ASSERTF(count == 101, "Whole range should hold 101 values, got %zu", count);
+    out = collected;
+    ASSERT(bt_range_uint32_t(&tree, 11, 19, collect_value, &out) == 0, "Range should be empty");
+    ASSERT(bt_range_uint32_t(&tree, 30, 20, collect_value, &out) == 0, "Range should be empty");
+
+    bt_clear_uint32_t(&tree);
+}
+
+/* Testing the bulk build from sorted values and rebalancing */
+void test_case_6(int argc, const char* argv[])
+{
+    printf("Starting test case 6\n");
+    const uint32_t N = 100000;
+
+    bt_uint32_t tree;
+    ASSERT(bt_build_from_sorted_uint32_t(&tree, nullptr, 0), "Building from no values failed");
+    ASSERT(bt_is_empty_uint32_t(&tree), "Building from no values should give an empty tree");
+    bt_rebalance_uint32_t(&tree);
+    ASSERT(bt_is_empty_uint32_t(&tree), "Rebalancing an empty tree should keep it empty");
+    bt_clear_uint32_t(&tree);
+
+    // Without memory for the slab the build fails, but leaves a usable empty tree
+    failing_alloc_arm(0);
+    bool built = bt_build_from_sorted_uint32_t(&tree, (const uint32_t[]) { 1, 2, 3 }, 3);
+    failing_alloc_disarm();
+    ASSERT(!built, "Building without memory should fail");
+    ASSERT(bt_is_empty_uint32_t(&tree), "A failed build should give an empty tree");
+    ASSERT(bt_add_value_uint32_t(&tree, 1), "Adding to the tree of a failed build should work");
+    bt_clear_uint32_t(&tree);
+
+    // Even numbers, every hundredth one twice
+    uint32_t* values = malloc((N + N / 100) * sizeof(uint32_t));
+    size_t length = 0;
+    for (uint32_t i = 0; i < N; i++) {
+        values[length++] = 2 * i;
+        if (i % 100 == 0)
+            values[length++] = 2 * i;
+    }
+
+    printf("Building tree out of %zu sorted values\n", length);
+    ASSERT(bt_build_from_sorted_uint32_t(&tree, values, length), "Building the tree failed");
+    ASSERT(check_bt_node(tree.root) == length, "Counted nodes differ from the input");
+    ASSERT(bt_node_height(tree.root) == min_height(length), "Built tree should be balanced");
+    size_t idx = 0;
+    for (bt_iter_uint32_t it = bt_iter_begin_uint32_t(&tree); bt_iter_valid_uint32_t(&it);
+         bt_iter_next_uint32_t(&it)) {
+        ASSERTF(it.node->value == values[idx], "Unexpected value at %zu", idx);
+        idx++;
+    }
+    ASSERT(bt_contains_uint32_t(&tree, 1000), "Tree should contain 1000");
+    ASSERT(bt_rank_uint32_t(&tree, 201) == 103, "Rank of 201 should be 103");
+
+    // The built tree is a regular pooled tree
+    ASSERT(bt_del_value_uint32_t(&tree, 0), "Deleting 0 should be possible");
+    ASSERT(bt_del_value_uint32_t(&tree, 0), "Deleting 0 twice should be possible");
+    ASSERT(!bt_del_value_uint32_t(&tree, 0), "Deleting 0 three times should not be possible");
+    ASSERT(bt_add_value_uint32_t(&tree, 1), "Adding 1 should be possible");
+    ASSERT(check_bt_node(tree.root) == length - 1, "Counted nodes differ after modifying");
+    bt_clear_uint32_t(&tree);
+
+    printf("Rebalancing a degenerated tree of %u sorted values\n", N / 10);
+    tree = bt_new_uint32_t();
+    for (uint32_t i = 0; i < N / 10; i++) {
+        bt_add_value_uint32_t(&tree, i);
+    }
+    ASSERT(bt_node_height(tree.root) == N / 10, "Sorted insertions should give a chain");
+    bt_rebalance_uint32_t(&tree);
+    ASSERT(check_bt_node(tree.root) == N / 10, "Counted nodes differ after rebalancing");
+    ASSERT(bt_node_height(tree.root) == min_height(N / 10), "Rebalanced tree should be balanced");
+    for (uint32_t i = 0; i < N / 10; i++) {
+        Result_uint32_t value_result = bt_select_uint32_t(&tree, i);
+        ASSERTF(Result_uint32_t_unwrap(&value_result) == i, "Expected to select %u", i);
+    }
+    bt_clear_uint32_t(&tree);
+
+    printf("Rebalancing random trees of all sizes up to 300\n");
+    srand(3);
+    for (size_t size = 1; size <= 300; size++) {
+        tree = bt_new_pooled_uint32_t();
+        for (size_t i = 0; i < size; i++) {
+            bt_add_value_uint32_t(&tree, rand() % 100);
+        }
+        bt_rebalance_uint32_t(&tree);
+        ASSERT(check_bt_node(tree.root) == size, "Counted nodes differ after rebalancing");
+        ASSERTF(bt_node_height(tree.root) == min_height(size), "Tree of %zu is unbalanced", size);
+        uint32_t prev = 0;
+        for (bt_iter_uint32_t it = bt_iter_begin_uint32_t(&tree); bt_iter_valid_uint32_t(&it);
+             bt_iter_next_uint32_t(&it)) {
+            ASSERT(it.node->value >= prev, "Values are out of order after rebalancing");
+            prev = it.node->value;
+        }
+        bt_clear_uint32_t(&tree);
+    }
+
+    free(values);
+}
+
+static void collect_uint64(uint64_t value, void* ctx)
+{
+    uint64_t** out = ctx;
+    **out = value;
+    (*out)++;
+}
+
+/* Testing trees instantiated for 64-bit values and for structs with an ordering hook */
+void test_case_7(int argc, const char* argv[])
+{
+    printf("Starting test case 7\n");
+
+    // Values that only differ above 32 bits must not collide
+    bt_uint64_t tree = bt_new_uint64_t();
+    const uint64_t big = (uint64_t)1 << 40;
+    for (uint64_t i = 0; i < 8; i++) {
+        bt_add_value_uint64_t(&tree, (i % 2) * big + i);
+    }
+    bt_print_uint64_t(&tree);
+    ASSERT(bt_contains_uint64_t(&tree, big + 1), "Tree should contain 2^40 + 1");
+    ASSERT(!bt_contains_uint64_t(&tree, 1), "Tree should not contain 1");
+    Result_uint64_t value_result = bt_select_uint64_t(&tree, 4);
+    ASSERT(Result_uint64_t_unwrap(&value_result) == big + 1, "Expected 2^40 + 1 at rank 4");
+    value_result = bt_lower_bound_uint64_t(&tree, 7);
+    ASSERT(Result_uint64_t_unwrap(&value_result) == big + 1, "Lower bound of 7 is 2^40 + 1");
+    uint64_t values[8];
+    uint64_t* out = values;
+    ASSERT(
+        bt_range_uint64_t(&tree, big, 2 * big, collect_uint64, &out) == 4,
+        "Four values should be at least 2^40");
+    ASSERT(values[0] == big + 1 && values[3] == big + 7, "Unexpected range values");
+    ASSERT(bt_del_value_uint64_t(&tree, big + 3), "Deleting 2^40 + 3 should be possible");
+    ASSERT(bt_size_uint64_t(&tree) == 7, "Size should be 7 after deleting");
+    bt_clear_uint64_t(&tree);
+
+    // Entries are ordered by descending key, the payload doesn't take part in comparisons
+    bt_entry_t entries = bt_new_pooled_entry_t();
+    for (uint32_t i = 0; i < 20; i++) {
+        uint32_t key = (i * 7) % 20;
+        bt_add_value_entry_t(&entries, (entry_t) { .key = key, .payload = 100 + key });
+    }
+    Result_entry_t entry_result = bt_min_entry_t(&entries);
+    ASSERT(Result_entry_t_unwrap(&entry_result).key == 19, "The first entry should have key 19");
+    uint32_t expected = 19;
+    for (bt_iter_entry_t it = bt_iter_begin_entry_t(&entries); bt_iter_valid_entry_t(&it);
+         bt_iter_next_entry_t(&it)) {
+        ASSERTF(it.node->value.key == expected, "Expected key %u", expected);
+        ASSERT(it.node->value.payload == 100 + expected, "Payload does not belong to its key");
+        expected--;
+    }
+    ASSERT(
+        bt_contains_entry_t(&entries, (entry_t) { .key = 5, .payload = 0 }),
+        "Lookups should only compare keys");
+    ASSERT(
+        bt_rank_entry_t(&entries, (entry_t) { .key = 15 }) == 4,
+        "Four entries should be ordered before key 15");
+    ASSERT(
+        bt_del_value_entry_t(&entries, (entry_t) { .key = 5 }),
+        "Deleting key 5 should be possible");
+    ASSERT(bt_size_entry_t(&entries) == 19, "Size should be 19 after deleting");
+    bt_clear_entry_t(&entries);
+}
+
+/* Frozen Eytzinger index against the tree it was frozen from */
+void test_case_8(int argc, const char* argv[])
+{
+    printf("Starting test case 8\n");
+
+    // Every shape of the complete tree up to 70 values, with gaps and duplicates
+    for (uint32_t length = 0; length <= 70; length++) {
+        bt_uint32_t tree = bt_new_uint32_t();
+        for (uint32_t i = 0; i < length; i++)
+            bt_add_value_uint32_t(&tree, (i * 37) % length * 2 + (i % 5 == 0));
+        bt_frozen_uint32_t frozen = bt_freeze_uint32_t(&tree);
+        ASSERTF(bt_frozen_size_uint32_t(&frozen) == length, "Frozen index should hold %u", length);
+        ASSERT(
+            (uintptr_t)frozen.keys % B_TREE_CACHE_LINE == 0,
+            "Frozen keys should be cache line aligned");
+        for (uint32_t value = 0; value <= 2 * length + 2; value++) {
+            ASSERTF(
+                bt_frozen_contains_uint32_t(&frozen, value) == bt_contains_uint32_t(&tree, value),
+                "Frozen index disagrees with the tree about %u",
+                value);
+            Result_uint32_t expected = bt_lower_bound_uint32_t(&tree, value);
+            Result_uint32_t actual = bt_frozen_lower_bound_uint32_t(&frozen, value);
+            ASSERTF(
+                Result_uint32_t_is_ok(&actual) == Result_uint32_t_is_ok(&expected),
+                "Frozen index disagrees about the existence of a lower bound of %u",
+                value);
+            if (Result_uint32_t_is_ok(&expected)) {
+                ASSERTF(
+                    Result_uint32_t_unwrap(&actual) == Result_uint32_t_unwrap(&expected),
+                    "Frozen index has a different lower bound of %u",
+                    value);
+            }
+        }
+        bt_frozen_clear_uint32_t(&frozen);
+        ASSERT(bt_frozen_size_uint32_t(&frozen) == 0, "Cleared frozen index should be empty");
+        bt_clear_uint32_t(&tree);
+    }
+
+    // The index is a copy that outlives the tree
+    bt_uint32_t tree = bt_new_pooled_uint32_t();
+    for (uint32_t i = 0; i < 100000; i++)
+        bt_add_value_uint32_t(&tree, (uint32_t)((uint64_t)i * 2654435761u % 100000) * 3);
+    bt_frozen_uint32_t frozen = bt_freeze_uint32_t(&tree);
+    bt_clear_uint32_t(&tree);
+    for (uint32_t value = 0; value < 300000; value++) {
+        ASSERTF(
+            bt_frozen_contains_uint32_t(&frozen, value) == (value % 3 == 0),
+            "Unexpected membership of %u",
+            value);
+    }
+    Result_uint32_t value_result = bt_frozen_lower_bound_uint32_t(&frozen, 299998);
+    ASSERT(Result_uint32_t_is_err(&value_result), "299998 should have no lower bound");
+    bt_frozen_clear_uint32_t(&frozen);
+
+    // Custom orderings carry over to the index
+    bt_entry_t entries = bt_new_entry_t();
+    for (uint32_t key = 0; key < 40; key += 2)
+        bt_add_value_entry_t(&entries, (entry_t) { .key = key, .payload = 100 + key });
+    bt_frozen_entry_t frozen_entries = bt_freeze_entry_t(&entries);
+    Result_entry_t entry_result
+        = bt_frozen_lower_bound_entry_t(&frozen_entries, (entry_t) { .key = 7 });
+    ASSERT(Result_entry_t_unwrap(&entry_result).key == 6, "Descending lower bound of 7 is 6");
+    ASSERT(Result_entry_t_unwrap(&entry_result).payload == 106, "Payload should be frozen too");
+    ASSERT(
+        bt_frozen_contains_entry_t(&frozen_entries, (entry_t) { .key = 38 }),
+        "Frozen entries should contain key 38");
+    bt_frozen_clear_entry_t(&frozen_entries);
+    bt_clear_entry_t(&entries);
+}
+
+/* Batched lookups against single lookups */
+void test_case_9(int argc, const char* argv[])
+{
+    printf("Starting test case 9\n");
+
+    // Batches that don't fill the last round, on an empty and on a degenerate tree
+    const size_t COUNT = 3 * B_TREE_BATCH_WIDTH + 5;
+    uint32_t values[3 * B_TREE_BATCH_WIDTH + 5];
+    bool found[3 * B_TREE_BATCH_WIDTH + 5];
+    Result_uint32_t bounds[3 * B_TREE_BATCH_WIDTH + 5];
+    for (size_t i = 0; i < COUNT; i++)
+        values[i] = (uint32_t)(COUNT - i);
+
+    bt_uint32_t tree = bt_new_uint32_t();
+    bt_contains_batch_uint32_t(&tree, values, COUNT, found);
+    bt_lower_bound_batch_uint32_t(&tree, values, COUNT, bounds);
+    for (size_t i = 0; i < COUNT; i++) {
+        ASSERT(!found[i], "An empty tree should contain nothing");
+        ASSERT(Result_uint32_t_is_err(&bounds[i]), "An empty tree should have no lower bounds");
+    }
+    for (uint32_t v = 0; v < 40; v += 2)
+        bt_add_value_uint32_t(&tree, v);
+    bt_contains_batch_uint32_t(&tree, values, COUNT, found);
+    bt_lower_bound_batch_uint32_t(&tree, values, COUNT, bounds);
+    for (size_t i = 0; i < COUNT; i++) {
+        ASSERTF(found[i] == (values[i] < 40 && values[i] % 2 == 0), "Wrong flag for %u", values[i]);
+        if (values[i] < 39) {
+            ASSERTF(
+                Result_uint32_t_unwrap(&bounds[i]) == (values[i] + 1) / 2 * 2,
+                "Wrong lower bound of %u",
+                values[i]);
+        } else {
+            ASSERTF(Result_uint32_t_is_err(&bounds[i]), "%u should have no lower bound", values[i]);
+        }
+    }
+    bt_contains_batch_uint32_t(&tree, values, 0, found);
+    bt_clear_uint32_t(&tree);
+
+    // Random tree with duplicates, checked against the single lookups
+    const size_t N = 50000;
+    uint32_t* keys = malloc(N * sizeof(uint32_t));
+    bool* batch_found = malloc(N * sizeof(bool));
+    Result_uint32_t* batch_bounds = malloc(N * sizeof(Result_uint32_t));
+    srand(77);
+    tree = bt_new_pooled_uint32_t();
+    for (size_t i = 0; i < N; i++)
+        bt_add_value_uint32_t(&tree, rand() % (2 * N));
+    for (size_t i = 0; i < N; i++)
+        keys[i] = rand() % (2 * N + 10);
+    bt_contains_batch_uint32_t(&tree, keys, N, batch_found);
+    bt_lower_bound_batch_uint32_t(&tree, keys, N, batch_bounds);
+    for (size_t i = 0; i < N; i++) {
+        ASSERTF(
+            batch_found[i] == bt_contains_uint32_t(&tree, keys[i]),
+            "Batched lookup disagrees about %u",
+            keys[i]);
+        Result_uint32_t expected = bt_lower_bound_uint32_t(&tree, keys[i]);
+        ASSERTF(
+            Result_uint32_t_is_ok(&batch_bounds[i]) == Result_uint32_t_is_ok(&expected),
+            "Batched lower bound disagrees about the existence of a bound of %u",
+            keys[i]);
+        if (Result_uint32_t_is_ok(&expected)) {
+            ASSERTF(
+                Result_uint32_t_unwrap(&batch_bounds[i]) == Result_uint32_t_unwrap(&expected),
+                "Batched lower bound of %u differs",
+                keys[i]);
+        }
+    }
+    free(keys);
+    free(batch_found);
+    free(batch_bounds);
+    bt_clear_uint32_t(&tree);
+
+    // Custom orderings
+    bt_entry_t entries = bt_new_entry_t();
+    for (uint32_t key = 0; key < 10; key += 2)
+        bt_add_value_entry_t(&entries, (entry_t) { .key = key, .payload = key });
+    entry_t queries[] = { { .key = 3 }, { .key = 4 }, { .key = 11 } };
+    bool entry_found[3];
+    bt_contains_batch_entry_t(&entries, queries, 3, entry_found);
+    ASSERT(!entry_found[0] && entry_found[1] && !entry_found[2], "Wrong entry flags");
+    bt_clear_entry_t(&entries);
+}
+
+/* The subtree counts limit a tree to UINT32_MAX values */
+void test_case_10(int argc, const char* argv[])
+{
+    printf("Starting test case 10\n");
+    bt_uint32_t tree = bt_new_uint32_t();
+    for (uint32_t v = 1; v <= 3; v++)
+        ASSERTF(bt_add_value_uint32_t(&tree, v), "Adding %u failed", v);
+
+    // Pretend the tree is full rather than adding four billion values
+    tree.root->count = UINT32_MAX;
+    ASSERT(!bt_add_value_uint32_t(&tree, 4), "Adding to a full tree should fail");
+    ASSERT(!bt_contains_uint32_t(&tree, 4), "Failing to add 4 added it");
+    ASSERT(bt_size_uint32_t(&tree) == UINT32_MAX, "Failing to add should keep the size");
+    ASSERT(bt_del_value_uint32_t(&tree, 2), "Deleting from a full tree should work");
+    ASSERT(bt_add_value_uint32_t(&tree, 4), "Adding after a delete should work again");
+    tree.root->count = 3;
+    ASSERT(bt_clear_uint32_t(&tree), "Clearing tree failed");
+
+    // The length is checked before the values are read, so one value stands in for all of them
+    if (SIZE_MAX > UINT32_MAX) {
+        const uint32_t value = 0;
+        bool built = bt_build_from_sorted_uint32_t(&tree, &value, (size_t)UINT32_MAX + 1);
+        ASSERT(!built, "Building too many values should fail");
+        ASSERT(bt_is_empty_uint32_t(&tree), "Building too many values should give an empty tree");
+        bt_clear_uint32_t(&tree);
+    }
+    ASSERT(bt_build_from_sorted_uint32_t(&tree, (const uint32_t[]) { 1, 2, 3 }, 3), "Build failed");
+    ASSERT(bt_size_uint32_t(&tree) == 3, "Building 3 values should give 3 values");
+    bt_clear_uint32_t(&tree);
+}
+
 int main(int argc, const char* argv[])
 {
     printf("Starting Test: BTreeTester\n");
@@ -138,6 +780,33 @@ int main(int argc, const char* argv[])
     case 1:
         test_case_1(argc, argv);
         exit(EXIT_SUCCESS);
+    case 2:
+        test_case_2(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 3:
+        test_case_3(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 4:
+        test_case_4(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 5:
+        test_case_5(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 6:
+        test_case_6(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 7:
+        test_case_7(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 8:
+        test_case_8(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 9:
+        test_case_9(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 10:
+        test_case_10(argc, argv);
+        exit(EXIT_SUCCESS);
     default:
         ASSERTF(false, "Invalid test case number given %i", test_num);
     }
@@ -0,0 +1,215 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "concurrent_list.h"
+#include "utils/asserts.h"
+#include "utils/ebr.h"
+
+#define THREADS 4
+
+typedef struct worker {
+    cll_uint32_t* list;
+    uint32_t id;
+    uint32_t count;
+    /**
+     * @brief Successful adds minus successful deletes per value, filled in by the contended workers
+     */
+    int* net;
+} worker_t;
+
+static atomic_size_t destroyed;
+
+static void count_destroy(void* ptr)
+{
+    atomic_fetch_add(&destroyed, 1);
+    free(ptr);
+}
+
+/* Testing Basic creation and usage */
+void test_case_0(int argc, const char* argv[])
+{
+    printf("Starting test case 0\n");
+
+    // Basic initialization
+    cll_uint32_t list = cll_new_list_uint32_t();
+    ebr_thread_t* thread = ebr_register(&list.ebr);
+    ASSERT(thread != nullptr, "Registering a thread failed");
+    ASSERT(cll_is_empty_uint32_t(&list, thread), "Is empty should say list is empty");
+    cll_print_uint32_t(&list);
+
+    // Adding keeps the values sorted and unique
+    ASSERT(cll_add_value_uint32_t(&list, thread, 3), "Adding 3 should be possible");
+    ASSERT(cll_add_value_uint32_t(&list, thread, 1), "Adding 1 should be possible");
+    ASSERT(cll_add_value_uint32_t(&list, thread, 2), "Adding 2 should be possible");
+    ASSERT(!cll_add_value_uint32_t(&list, thread, 2), "Adding 2 twice should not be possible");
+    cll_print_uint32_t(&list);
+    ASSERT(cll_length_uint32_t(&list, thread) == 3, "Length of list should be 3");
+    ASSERT(cll_contains_uint32_t(&list, thread, 1), "List should contain 1");
+    ASSERT(!cll_contains_uint32_t(&list, thread, 4), "List should not contain 4");
+
+    // Deleting
+    ASSERT(cll_del_value_uint32_t(&list, thread, 2), "Deleting 2 should be possible");
+    ASSERT(!cll_del_value_uint32_t(&list, thread, 2), "Deleting 2 twice should not be possible");
+    ASSERT(!cll_contains_uint32_t(&list, thread, 2), "List should not contain 2 anymore");
+    ASSERT(cll_length_uint32_t(&list, thread) == 2, "Length of list should be 2");
+
+    // Handles of unregistered threads are reused
+    ebr_unregister(thread);
+    ASSERT(ebr_register(&list.ebr) == thread, "The unregistered handle should be reused");
+
+    printf("Clearing list\n");
+    cll_clear_list_uint32_t(&list);
+    thread = ebr_register(&list.ebr);
+    ASSERT(cll_is_empty_uint32_t(&list, thread), "Is empty should say list is empty");
+    cll_clear_list_uint32_t(&list);
+
+    // Retired objects are destroyed while the domain is in use, not only when clearing it
+    ebr_domain_t domain = ebr_new();
+    thread = ebr_register(&domain);
+    for (int i = 0; i < 10 * EBR_ADVANCE_INTERVAL; i++) {
+        ebr_enter(thread);
+        ebr_retire(thread, malloc(sizeof(int)), count_destroy);
+        ebr_exit(thread);
+    }
+    ASSERT(atomic_load(&destroyed) > 0, "Retired objects should be destroyed over time");
+    ebr_clear(&domain);
+    ASSERT(atomic_load(&destroyed) == 10 * EBR_ADVANCE_INTERVAL, "Clearing should destroy all");
+}
+
+static void* disjoint_worker(void* arg)
+{
+    worker_t* worker = arg;
+    ebr_thread_t* thread = ebr_register(&worker->list->ebr);
+    for (uint32_t v = worker->id; v < worker->count; v += THREADS)
+        ASSERTF(cll_add_value_uint32_t(worker->list, thread, v), "Adding %u failed", v);
+    for (uint32_t v = worker->id; v < worker->count; v += THREADS) {
+        if (v % 2 == 1)
+            ASSERTF(cll_del_value_uint32_t(worker->list, thread, v), "Deleting %u failed", v);
+    }
+    for (uint32_t v = worker->id; v < worker->count; v += THREADS) {
+        ASSERTF(
+            cll_contains_uint32_t(worker->list, thread, v) == (v % 2 == 0),
+            "Unexpected membership of %u",
+            v);
+    }
+    ebr_unregister(thread);
+    return nullptr;
+}
+
+/* Threads adding and deleting interleaved values */
+void test_case_1(int argc, const char* argv[])
+{
+    printf("Starting test case 1\n");
+    const uint32_t N = 4000;
+    cll_uint32_t list = cll_new_list_uint32_t();
+    pthread_t threads[THREADS];
+    worker_t workers[THREADS];
+
+    for (uint32_t i = 0; i < THREADS; i++) {
+        workers[i] = (worker_t) { .list = &list, .id = i, .count = N, .net = nullptr };
+        pthread_create(&threads[i], nullptr, disjoint_worker, &workers[i]);
+    }
+    for (int i = 0; i < THREADS; i++)
+        pthread_join(threads[i], nullptr);
+
+    ebr_thread_t* thread = ebr_register(&list.ebr);
+    ASSERT(cll_length_uint32_t(&list, thread) == N / 2, "Only the even values should be left");
+    for (uint32_t v = 0; v < N; v++) {
+        ASSERTF(
+            cll_contains_uint32_t(&list, thread, v) == (v % 2 == 0),
+            "Unexpected membership of %u",
+            v);
+    }
+    cll_clear_list_uint32_t(&list);
+}
+
+static void* contended_worker(void* arg)
+{
+    worker_t* worker = arg;
+    ebr_thread_t* thread = ebr_register(&worker->list->ebr);
+    uint32_t state = worker->id + 1;
+    for (uint32_t i = 0; i < worker->count; i++) {
+        // xorshift, since rand is not thread safe
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        uint32_t value = state % 64;
+        switch ((state >> 8) % 3) {
+        case 0:
+            worker->net[value] += cll_add_value_uint32_t(worker->list, thread, value);
+            break;
+        case 1:
+            worker->net[value] -= cll_del_value_uint32_t(worker->list, thread, value);
+            break;
+        default:
+            cll_contains_uint32_t(worker->list, thread, value);
+        }
+    }
+    ebr_unregister(thread);
+    return nullptr;
+}
+
+/* Threads adding, deleting and searching the same few values */
+void test_case_2(int argc, const char* argv[])
+{
+    printf("Starting test case 2\n");
+    const uint32_t OPS = 50000;
+    cll_uint32_t list = cll_new_list_uint32_t();
+    pthread_t threads[THREADS];
+    worker_t workers[THREADS];
+
+    for (uint32_t i = 0; i < THREADS; i++) {
+        workers[i] = (worker_t) {
+            .list = &list,
+            .id = i,
+            .count = OPS,
+            .net = calloc(64, sizeof(int)),
+        };
+        pthread_create(&threads[i], nullptr, contended_worker, &workers[i]);
+    }
+    for (int i = 0; i < THREADS; i++)
+        pthread_join(threads[i], nullptr);
+
+    // Every value is in the list exactly if it was added once more than it was deleted
+    ebr_thread_t* thread = ebr_register(&list.ebr);
+    size_t expected_length = 0;
+    for (uint32_t v = 0; v < 64; v++) {
+        int net = 0;
+        for (int i = 0; i < THREADS; i++)
+            net += workers[i].net[v];
+        ASSERTF(net == 0 || net == 1, "Value %u was added %d times more than deleted", v, net);
+        ASSERTF(
+            cll_contains_uint32_t(&list, thread, v) == (net == 1),
+            "Unexpected membership of %u",
+            v);
+        expected_length += net;
+    }
+    ASSERT(cll_length_uint32_t(&list, thread) == expected_length, "Unexpected length of list");
+    cll_print_uint32_t(&list);
+
+    for (int i = 0; i < THREADS; i++)
+        free(workers[i].net);
+    cll_clear_list_uint32_t(&list);
+}
+
+int main(int argc, const char* argv[])
+{
+    printf("Starting Test: ConcurrentListTester\n");
+    ASSERT(argc > 1, "Test executable needs more than one argument");
+    int test_num = atoi(argv[1]);
+    switch (test_num) {
+    case 0:
+        test_case_0(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 1:
+        test_case_1(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 2:
+        test_case_2(argc, argv);
+        exit(EXIT_SUCCESS);
+    default:
+        ASSERTF(false, "Invalid test case number given %i", test_num);
+    }
+}
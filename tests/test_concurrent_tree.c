@@ -0,0 +1,225 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "concurrent_tree.h"
+#include "utils/asserts.h"
+
+#define THREADS 4
+
+typedef struct worker {
+    cbt_uint32_t* tree;
+    uint32_t id;
+    uint32_t count;
+    /**
+     * @brief Successful adds minus successful deletes per value, filled in by the contended workers
+     */
+    int* net;
+} worker_t;
+
+/**
+ * @brief Returns a permutation of [0, count) that builds a reasonably balanced tree
+ */
+static uint32_t scramble(const uint32_t i, const uint32_t count)
+{
+    return (uint32_t)((uint64_t)i * 2654435761u % count);
+}
+
+/* Testing Basic creation and usage */
+void test_case_0(int argc, const char* argv[])
+{
+    printf("Starting test case 0\n");
+
+    // Basic initialization
+    cbt_uint32_t tree;
+    cbt_init_uint32_t(&tree);
+    ASSERT(cbt_is_empty_uint32_t(&tree), "Is empty should say tree is empty");
+    ASSERT(!cbt_contains_uint32_t(&tree, 1), "An empty tree should not contain 1");
+    ASSERT(!cbt_del_value_uint32_t(&tree, 1), "Deleting from an empty tree should fail");
+
+    // Adding
+    const uint32_t values[] = { 50, 30, 70, 20, 40, 60, 80, 35, 45, 65 };
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+        ASSERTF(cbt_add_value_uint32_t(&tree, values[i]), "Adding %u failed", values[i]);
+    ASSERT(!cbt_add_value_uint32_t(&tree, 40), "Adding 40 twice should not be possible");
+    cbt_print_uint32_t(&tree);
+    ASSERT(cbt_size_uint32_t(&tree) == 10, "Size of tree should be 10");
+
+    // Deleting a leaf, a node with one child and nodes with two children, including the root
+    ASSERT(cbt_del_value_uint32_t(&tree, 20), "Deleting the leaf 20 should work");
+    ASSERT(cbt_del_value_uint32_t(&tree, 60), "Deleting 60 with one child should work");
+    ASSERT(cbt_del_value_uint32_t(&tree, 30), "Deleting 30 with two children should work");
+    ASSERT(cbt_del_value_uint32_t(&tree, 50), "Deleting the root 50 should work");
+    ASSERT(!cbt_del_value_uint32_t(&tree, 50), "Deleting 50 twice should not be possible");
+    cbt_print_uint32_t(&tree);
+    const uint32_t left[] = { 35, 40, 45, 65, 70, 80 };
+    for (size_t i = 0; i < sizeof(left) / sizeof(left[0]); i++)
+        ASSERTF(cbt_contains_uint32_t(&tree, left[i]), "Tree should still contain %u", left[i]);
+    const uint32_t gone[] = { 20, 30, 50, 60 };
+    for (size_t i = 0; i < sizeof(gone) / sizeof(gone[0]); i++)
+        ASSERTF(!cbt_contains_uint32_t(&tree, gone[i]), "Tree should not contain %u", gone[i]);
+    ASSERT(cbt_size_uint32_t(&tree) == 6, "Size of tree should be 6");
+
+    printf("Clearing tree\n");
+    cbt_clear_uint32_t(&tree);
+    ASSERT(cbt_is_empty_uint32_t(&tree), "Is empty should say tree is empty");
+}
+
+static void* disjoint_worker(void* arg)
+{
+    worker_t* worker = arg;
+    for (uint32_t i = worker->id; i < worker->count; i += THREADS) {
+        uint32_t v = scramble(i, worker->count);
+        ASSERTF(cbt_add_value_uint32_t(worker->tree, v), "Adding %u failed", v);
+    }
+    for (uint32_t i = worker->id; i < worker->count; i += THREADS) {
+        uint32_t v = scramble(i, worker->count);
+        if (v % 2 == 1)
+            ASSERTF(cbt_del_value_uint32_t(worker->tree, v), "Deleting %u failed", v);
+    }
+    for (uint32_t i = worker->id; i < worker->count; i += THREADS) {
+        uint32_t v = scramble(i, worker->count);
+        ASSERTF(cbt_contains_uint32_t(worker->tree, v) == (v % 2 == 0), "Unexpected %u", v);
+    }
+    return nullptr;
+}
+
+/* Threads adding and deleting interleaved values */
+void test_case_1(int argc, const char* argv[])
+{
+    printf("Starting test case 1\n");
+    const uint32_t N = 20000;
+    cbt_uint32_t tree;
+    cbt_init_uint32_t(&tree);
+    pthread_t threads[THREADS];
+    worker_t workers[THREADS];
+
+    for (uint32_t i = 0; i < THREADS; i++) {
+        workers[i] = (worker_t) { .tree = &tree, .id = i, .count = N, .net = nullptr };
+        pthread_create(&threads[i], nullptr, disjoint_worker, &workers[i]);
+    }
+    for (int i = 0; i < THREADS; i++)
+        pthread_join(threads[i], nullptr);
+
+    ASSERT(cbt_size_uint32_t(&tree) == N / 2, "Only the even values should be left");
+    for (uint32_t v = 0; v < N; v++)
+        ASSERTF(cbt_contains_uint32_t(&tree, v) == (v % 2 == 0), "Unexpected membership of %u", v);
+    cbt_clear_uint32_t(&tree);
+}
+
+static void* contended_worker(void* arg)
+{
+    worker_t* worker = arg;
+    uint32_t state = worker->id + 1;
+    for (uint32_t i = 0; i < worker->count; i++) {
+        // xorshift, since rand is not thread safe
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        uint32_t value = state % 256;
+        switch ((state >> 8) % 3) {
+        case 0:
+            worker->net[value] += cbt_add_value_uint32_t(worker->tree, value);
+            break;
+        case 1:
+            worker->net[value] -= cbt_del_value_uint32_t(worker->tree, value);
+            break;
+        default:
+            cbt_contains_uint32_t(worker->tree, value);
+        }
+    }
+    return nullptr;
+}
+
+/* Threads adding, deleting and searching the same few values */
+void test_case_2(int argc, const char* argv[])
+{
+    printf("Starting test case 2\n");
+    const uint32_t OPS = 40000;
+    cbt_uint32_t tree;
+    cbt_init_uint32_t(&tree);
+    pthread_t threads[THREADS];
+    worker_t workers[THREADS];
+
+    for (uint32_t i = 0; i < THREADS; i++) {
+        workers[i] = (worker_t) {
+            .tree = &tree,
+            .id = i,
+            .count = OPS,
+            .net = calloc(256, sizeof(int)),
+        };
+        pthread_create(&threads[i], nullptr, contended_worker, &workers[i]);
+    }
+    for (int i = 0; i < THREADS; i++)
+        pthread_join(threads[i], nullptr);
+
+    // Every value is in the tree exactly if it was added once more than it was deleted
+    size_t expected_size = 0;
+    for (uint32_t v = 0; v < 256; v++) {
+        int net = 0;
+        for (int i = 0; i < THREADS; i++)
+            net += workers[i].net[v];
+        ASSERTF(net == 0 || net == 1, "Value %u was added %d times more than deleted", v, net);
+        ASSERTF(cbt_contains_uint32_t(&tree, v) == (net == 1), "Unexpected membership of %u", v);
+        expected_size += net;
+    }
+    ASSERT(cbt_size_uint32_t(&tree) == expected_size, "Unexpected size of tree");
+    cbt_print_uint32_t(&tree);
+
+    for (int i = 0; i < THREADS; i++)
+        free(workers[i].net);
+    cbt_clear_uint32_t(&tree);
+}
+
+static void* print_and_clear(void* arg)
+{
+    cbt_print_uint32_t(arg);
+    cbt_clear_uint32_t(arg);
+    return nullptr;
+}
+
+/* Printing and clearing a degenerate tree on a small stack */
+void test_case_3(int argc, const char* argv[])
+{
+    printf("Starting test case 3\n");
+    const uint32_t count = 4000;
+    cbt_uint32_t tree;
+    cbt_init_uint32_t(&tree);
+    // Descending values chain every node to the left of its parent
+    for (uint32_t i = count; i > 0; i--)
+        ASSERTF(cbt_add_value_uint32_t(&tree, i), "Adding %u failed", i);
+
+    // Far too little stack to recurse once per node
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, 64 * 1024);
+    pthread_t thread;
+    ASSERT(pthread_create(&thread, &attr, print_and_clear, &tree) == 0, "Starting thread failed");
+    pthread_join(thread, nullptr);
+    pthread_attr_destroy(&attr);
+    ASSERT(cbt_is_empty_uint32_t(&tree), "Cleared tree should be empty");
+    ASSERT(!cbt_contains_uint32_t(&tree, 1), "Cleared tree should not contain 1");
+}
+
+int main(int argc, const char* argv[])
+{
+    printf("Starting Test: ConcurrentTreeTester\n");
+    ASSERT(argc > 1, "Test executable needs more than one argument");
+    int test_num = atoi(argv[1]);
+    switch (test_num) {
+    case 0:
+        test_case_0(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 1:
+        test_case_1(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 2:
+        test_case_2(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 3:
+        test_case_3(argc, argv);
+        exit(EXIT_SUCCESS);
+    default:
+        ASSERTF(false, "Invalid test case number given %i", test_num);
+    }
+}
@@ -0,0 +1,234 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "disk_bptree.h"
+#include "utils/asserts.h"
+
+#define SMALL_BUDGET (PAGER_MIN_FRAMES * PAGER_PAGE_SIZE)
+
+typedef struct collected {
+    uint64_t values[64];
+    size_t count;
+} collected_t;
+
+static void collect_uint64_t(uint64_t value, void* ctx)
+{
+    collected_t* collected = ctx;
+    if (collected->count < 64)
+        collected->values[collected->count] = value;
+    collected->count++;
+}
+
+static void check_sorted(uint32_t value, void* ctx)
+{
+    uint32_t* last = ctx;
+    ASSERTF(value > *last || *last == UINT32_MAX, "Range is out of order at %u", value);
+    *last = value;
+}
+
+/* Adding, deleting and reopening with a buffer pool much smaller than the file */
+void test_case_0(int argc, const char* argv[])
+{
+    printf("Starting test case 0\n");
+    const char* path = "dbpt_case_0.db";
+    remove(path);
+    const uint32_t n = 100000;
+    bool* present = calloc(n, sizeof(bool));
+
+    dbpt_uint32_t tree;
+    ASSERT(dbpt_open_uint32_t(&tree, path, SMALL_BUDGET), "Creating the tree failed");
+    ASSERT(dbpt_is_empty_uint32_t(&tree), "New tree should be empty");
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t value = (uint32_t)((uint64_t)i * 2654435761u % n);
+        ASSERTF(dbpt_add_value_uint32_t(&tree, value), "Adding %u failed", value);
+        present[value] = true;
+    }
+    ASSERT(dbpt_size_uint32_t(&tree) == n, "Tree should hold all values");
+    ASSERT(!dbpt_add_value_uint32_t(&tree, 42), "Duplicates should be rejected");
+    ASSERT(tree.pager.writes > 0, "Small buffer pool should have evicted pages");
+
+    for (uint32_t value = 0; value < n; value += 3) {
+        ASSERTF(dbpt_del_value_uint32_t(&tree, value), "Deleting %u failed", value);
+        present[value] = false;
+    }
+    ASSERT(!dbpt_del_value_uint32_t(&tree, 0), "Deleting a missing value should fail");
+    ASSERT(dbpt_close_uint32_t(&tree), "Closing the tree failed");
+
+    // Everything survives a reopen
+    ASSERT(dbpt_open_uint32_t(&tree, path, SMALL_BUDGET), "Reopening the tree failed");
+    ASSERT(dbpt_size_uint32_t(&tree) == n - (n + 2) / 3, "Size should survive the reopen");
+    for (uint32_t value = 0; value < n + 10; value++) {
+        ASSERTF(
+            dbpt_contains_uint32_t(&tree, value) == (value < n && present[value]),
+            "Tree disagrees about %u",
+            value);
+    }
+    uint32_t last = UINT32_MAX;
+    ASSERT(
+        dbpt_range_uint32_t(&tree, 0, UINT32_MAX, check_sorted, &last) == n - (n + 2) / 3,
+        "Full range should visit every value");
+    ASSERT(dbpt_close_uint32_t(&tree), "Closing the tree failed");
+
+    // A file of 4-byte keys is no tree of 8-byte keys
+    dbpt_uint64_t wide;
+    ASSERT(!dbpt_open_uint64_t(&wide, path, SMALL_BUDGET), "Key size mismatch should be rejected");
+    free(present);
+    remove(path);
+}
+
+/* 8-byte keys and ranges */
+void test_case_1(int argc, const char* argv[])
+{
+    printf("Starting test case 1\n");
+    const char* path = "dbpt_case_1.db";
+    remove(path);
+    const uint64_t base = 1ull << 40;
+
+    dbpt_uint64_t tree;
+    ASSERT(dbpt_open_uint64_t(&tree, path, 1 << 20), "Creating the tree failed");
+    for (uint64_t i = 0; i < 50000; i++)
+        ASSERT(dbpt_add_value_uint64_t(&tree, base + (i * 7919) % 50000 * 10), "Adding failed");
+    ASSERT(dbpt_contains_uint64_t(&tree, base + 499990), "Tree should contain the largest key");
+    ASSERT(!dbpt_contains_uint64_t(&tree, base + 5), "Tree should not contain base + 5");
+    ASSERT(!dbpt_contains_uint64_t(&tree, 120), "Narrowed keys should not match");
+    ASSERT(dbpt_flush_uint64_t(&tree), "Flushing the tree failed");
+
+    collected_t collected = { .count = 0 };
+    size_t count = dbpt_range_uint64_t(
+        &tree, base + 12345, base + 12345 + 200, collect_uint64_t, &collected);
+    ASSERT(count == 20, "Expected 20 values in the range");
+    for (size_t i = 0; i < 20; i++)
+        ASSERTF(collected.values[i] == base + 12350 + 10 * i, "Unexpected value at %zu", i);
+    ASSERT(
+        dbpt_range_uint64_t(&tree, base + 1, base + 9, collect_uint64_t, &collected) == 0,
+        "Range between keys should be empty");
+    ASSERT(
+        dbpt_range_uint64_t(&tree, 10, 5, collect_uint64_t, &collected) == 0,
+        "Reversed range should be empty");
+    ASSERT(dbpt_close_uint64_t(&tree), "Closing the tree failed");
+
+    // Files that aren't trees are rejected
+    FILE* file = fopen(path, "r+b");
+    fputc('X', file);
+    fclose(file);
+    ASSERT(!dbpt_open_uint64_t(&tree, path, 1 << 20), "A wrong magic should be rejected");
+    remove(path);
+}
+
+/* Deleting everything merges the tree down and freed pages are reused */
+void test_case_2(int argc, const char* argv[])
+{
+    printf("Starting test case 2\n");
+    const char* path = "dbpt_case_2.db";
+    remove(path);
+    const uint32_t n = 60000;
+
+    dbpt_uint32_t tree;
+    ASSERT(dbpt_open_uint32_t(&tree, path, SMALL_BUDGET), "Creating the tree failed");
+    for (uint32_t i = 0; i < n; i++)
+        dbpt_add_value_uint32_t(&tree, i);
+    uint32_t page_count = tree.pager.header.page_count;
+
+    // Deleting from both ends and the middle exercises borrowing and merging on both sides
+    for (uint32_t i = 0; i < n / 2; i++) {
+        uint32_t value = (i % 2 == 0) ? i / 2 : n - 1 - i / 2;
+        ASSERTF(dbpt_del_value_uint32_t(&tree, value), "Deleting %u failed", value);
+    }
+    for (uint32_t i = 0; i < n / 2; i++) {
+        uint32_t value = n / 4 + (uint32_t)((uint64_t)i * 2654435761u % (n / 2));
+        ASSERTF(dbpt_del_value_uint32_t(&tree, value), "Deleting %u failed", value);
+    }
+    ASSERT(dbpt_is_empty_uint32_t(&tree), "Tree should be empty");
+    ASSERT(!dbpt_contains_uint32_t(&tree, n / 2), "Empty tree should contain nothing");
+    ASSERT(dbpt_close_uint32_t(&tree), "Closing the tree failed");
+
+    ASSERT(dbpt_open_uint32_t(&tree, path, SMALL_BUDGET), "Reopening the tree failed");
+    ASSERT(dbpt_is_empty_uint32_t(&tree), "Tree should still be empty");
+    for (uint32_t i = n; i-- > 0;)
+        dbpt_add_value_uint32_t(&tree, i);
+    ASSERT(dbpt_size_uint32_t(&tree) == n, "Tree should hold all values again");
+    ASSERT(
+        tree.pager.header.page_count <= page_count + 1,
+        "Refilling the tree should reuse the freed pages");
+    for (uint32_t i = 0; i < n; i += 97)
+        ASSERTF(dbpt_contains_uint32_t(&tree, i), "Tree should contain %u", i);
+    ASSERT(dbpt_close_uint32_t(&tree), "Closing the tree failed");
+    remove(path);
+}
+
+/* Failing to write back an evicted page while splitting the root */
+void test_case_3(int argc, const char* argv[])
+{
+    printf("Starting test case 3\n");
+    const char* path = "dbpt_case_3.db";
+    remove(path);
+    const uint32_t leaf_max = (PAGER_PAGE_SIZE - DBPT_PAGE_HEADER) / sizeof(uint32_t);
+
+    dbpt_uint32_t tree;
+    ASSERT(dbpt_open_uint32_t(&tree, path, SMALL_BUDGET), "Creating the tree failed");
+    for (uint32_t i = 0; i < leaf_max; i++)
+        ASSERTF(dbpt_add_value_uint32_t(&tree, i), "Adding %u failed", i);
+    ASSERT(dbpt_flush_uint32_t(&tree), "Flushing the tree failed");
+
+    // The root leaf is full, so the next value splits it and needs a new root as well. All frames
+    // but one get a dirty page, so the second page of the split has to evict one of them, which
+    // fails on a descriptor that can't write
+    page_id_t dirty[PAGER_MIN_FRAMES - 2];
+    for (size_t p = 0; p < PAGER_MIN_FRAMES - 2; p++) {
+        ASSERT(pager_allocate(&tree.pager, &dirty[p]) != nullptr, "Allocating a page failed");
+        pager_release(&tree.pager, dirty[p], true);
+    }
+    int writable = tree.pager.fd;
+    tree.pager.fd = open(path, O_RDONLY);
+    ASSERT(tree.pager.fd >= 0, "Opening the file read-only failed");
+    ASSERT(!dbpt_add_value_uint32_t(&tree, leaf_max), "Splitting should run out of frames");
+    close(tree.pager.fd);
+    tree.pager.fd = writable;
+
+    ASSERT(dbpt_size_uint32_t(&tree) == leaf_max, "Failing to add changed the size");
+    ASSERT(!dbpt_contains_uint32_t(&tree, leaf_max), "Failing to add added the value");
+    uint32_t last = UINT32_MAX;
+    ASSERT(
+        dbpt_range_uint32_t(&tree, 0, UINT32_MAX, check_sorted, &last) == leaf_max,
+        "Failing to add lost values");
+    for (size_t p = 0; p < PAGER_MIN_FRAMES - 2; p++) {
+        ASSERT(pager_get(&tree.pager, dirty[p]) != nullptr, "Reading a page failed");
+        pager_free(&tree.pager, dirty[p]);
+    }
+
+    ASSERT(dbpt_add_value_uint32_t(&tree, leaf_max), "Adding to a writable file failed");
+    ASSERT(dbpt_close_uint32_t(&tree), "Closing the tree failed");
+    ASSERT(dbpt_open_uint32_t(&tree, path, SMALL_BUDGET), "Reopening the tree failed");
+    ASSERT(dbpt_size_uint32_t(&tree) == leaf_max + 1, "Size should count every value once");
+    last = UINT32_MAX;
+    ASSERT(
+        dbpt_range_uint32_t(&tree, 0, UINT32_MAX, check_sorted, &last) == leaf_max + 1,
+        "Full range should visit every value");
+    ASSERT(dbpt_close_uint32_t(&tree), "Closing the tree failed");
+    remove(path);
+}
+
+int main(int argc, const char* argv[])
+{
+    printf("Starting Test: DiskBPTreeTester\n");
+    ASSERT(argc > 1, "Test executable needs more than one argument");
+    int test_num = atoi(argv[1]);
+    switch (test_num) {
+    case 0:
+        test_case_0(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 1:
+        test_case_1(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 2:
+        test_case_2(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 3:
+        test_case_3(argc, argv);
+        exit(EXIT_SUCCESS);
+    default:
+        ASSERTF(false, "Invalid test case number given %i", test_num);
+    }
+}
@@ -0,0 +1,170 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hashmap.h"
+#include "utils/asserts.h"
+
+/* Testing Basic creation and usage of the set */
+void test_case_0(int argc, const char* argv[])
+{
+    printf("Starting test case 0\n");
+
+    // Basic initialization
+    hs_uint32_t set = hs_new_uint32_t();
+    ASSERT(set.ctrl == nullptr && set.capacity == 0, "Initialization failed");
+    ASSERT(hs_is_empty_uint32_t(&set), "Is empty should say set is empty");
+    ASSERT(!hs_contains_uint32_t(&set, 0), "An empty set should not contain 0");
+    ASSERT(!hs_erase_uint32_t(&set, 0), "Erasing from an empty set should fail");
+    hs_print_uint32_t(&set);
+
+    // Inserting
+    ASSERT(hs_insert_uint32_t(&set, 3), "Inserting 3 should be possible");
+    ASSERT(hs_insert_uint32_t(&set, 0), "Inserting 0 should be possible");
+    ASSERT(hs_insert_uint32_t(&set, UINT32_MAX), "Inserting UINT32_MAX should be possible");
+    ASSERT(!hs_insert_uint32_t(&set, 3), "Inserting 3 twice should not be possible");
+    hs_print_uint32_t(&set);
+    ASSERT(hs_size_uint32_t(&set) == 3, "Size of set at this point should be 3");
+    ASSERT(hs_contains_uint32_t(&set, UINT32_MAX), "Set should contain UINT32_MAX");
+    ASSERT(!hs_contains_uint32_t(&set, 4), "Set should not contain 4");
+
+    // Erasing
+    ASSERT(hs_erase_uint32_t(&set, 3), "Erasing 3 should be possible");
+    ASSERT(!hs_erase_uint32_t(&set, 3), "Erasing 3 twice should not be possible");
+    ASSERT(!hs_contains_uint32_t(&set, 3), "Set should not contain 3 anymore");
+    ASSERT(hs_size_uint32_t(&set) == 2, "Size of set at this point should be 2");
+
+    // Reserving keeps the values and avoids rehashing while inserting
+    ASSERT(hs_reserve_uint32_t(&set, 1000), "Reserving should be possible");
+    size_t capacity = set.capacity;
+    ASSERT(hs_contains_uint32_t(&set, 0), "Reserving should keep 0");
+    for (uint32_t i = 1; i < 999; i++) {
+        hs_insert_uint32_t(&set, i);
+    }
+    ASSERT(set.capacity == capacity, "Inserting reserved values should not rehash");
+    ASSERT(hs_size_uint32_t(&set) == 1000, "Size of set at this point should be 1000");
+
+    printf("Clearing set\n");
+    hs_clear_uint32_t(&set);
+    ASSERT(hs_is_empty_uint32_t(&set), "Is empty should say set is empty");
+}
+
+/* Random insertions and erasures checked against a reference bitmap */
+void test_case_1(int argc, const char* argv[])
+{
+    printf("Starting test case 1\n");
+    const uint32_t N = 50000;
+    bool* reference = calloc(N, sizeof(bool));
+    size_t reference_size = 0;
+    hs_uint32_t set = hs_new_uint32_t();
+
+    srand(42);
+    for (int round = 0; round < 1000000; round++) {
+        // Keys are spread over the whole range so they don't hash like small integers
+        uint32_t value = rand() % N;
+        uint32_t key = value * 2654435761u;
+        // Alternate between growing and shrinking phases, which leave many deleted slots behind
+        bool insert = (rand() % 100) < (((round / 100000) % 2 == 0) ? 70 : 30);
+        if (insert) {
+            ASSERTF(
+                hs_insert_uint32_t(&set, key) == !reference[value],
+                "Unexpected insert result for %u",
+                key);
+            reference_size += !reference[value];
+            reference[value] = true;
+        } else {
+            ASSERTF(
+                hs_erase_uint32_t(&set, key) == reference[value],
+                "Unexpected erase result for %u",
+                key);
+            reference_size -= reference[value];
+            reference[value] = false;
+        }
+    }
+
+    ASSERT(hs_size_uint32_t(&set) == reference_size, "Size does not match the reference");
+    for (uint32_t value = 0; value < N; value++) {
+        ASSERTF(
+            hs_contains_uint32_t(&set, value * 2654435761u) == reference[value],
+            "Unexpected membership of %u",
+            value);
+    }
+    ASSERT(set.size + set.growth_left <= set.capacity, "Table is fuller than its capacity");
+
+    hs_clear_uint32_t(&set);
+    free(reference);
+}
+
+/* Testing the map */
+void test_case_2(int argc, const char* argv[])
+{
+    printf("Starting test case 2\n");
+    const uint32_t N = 100000;
+    hm_uint32_t_uint32_t map = hm_new_uint32_t_uint32_t();
+
+    Result_uint32_t value_result = hm_get_uint32_t_uint32_t(&map, 1);
+    ASSERT(Result_uint32_t_is_err(&value_result), "Getting from an empty map should fail");
+    ASSERT(hm_find_uint32_t_uint32_t(&map, 1) == nullptr, "Finding in an empty map should fail");
+
+    hm_insert_uint32_t_uint32_t(&map, 1, 10);
+    hm_insert_uint32_t_uint32_t(&map, 2, 20);
+    hm_print_uint32_t_uint32_t(&map);
+    value_result = hm_get_uint32_t_uint32_t(&map, 2);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == 20, "Expected value 20 for key 2");
+
+    // Inserting an existing key overwrites its value
+    ASSERT(hm_insert_uint32_t_uint32_t(&map, 2, 21), "Overwriting should be possible");
+    ASSERT(hm_size_uint32_t_uint32_t(&map) == 2, "Overwriting should not add an entry");
+    value_result = hm_get_uint32_t_uint32_t(&map, 2);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == 21, "Expected value 21 for key 2");
+
+    // Values can be updated in place
+    uint32_t* value = hm_find_uint32_t_uint32_t(&map, 1);
+    ASSERT(value != nullptr && *value == 10, "Expected to find value 10 for key 1");
+    (*value)++;
+    value_result = hm_get_uint32_t_uint32_t(&map, 1);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == 11, "Expected value 11 for key 1");
+    hm_clear_uint32_t_uint32_t(&map);
+
+    printf("Adding %u entries to map\n", N);
+    ASSERT(hm_reserve_uint32_t_uint32_t(&map, N), "Reserving should be possible");
+    for (uint32_t i = 0; i < N; i++) {
+        hm_insert_uint32_t_uint32_t(&map, i, 3 * i);
+    }
+    for (uint32_t i = 0; i < N; i += 2) {
+        ASSERTF(hm_erase_uint32_t_uint32_t(&map, i), "Erasing %u should be possible", i);
+    }
+    ASSERT(hm_size_uint32_t_uint32_t(&map) == N / 2, "Half of the entries should be left");
+    for (uint32_t i = 0; i < N; i++) {
+        value_result = hm_get_uint32_t_uint32_t(&map, i);
+        if (i % 2 == 0) {
+            ASSERTF(Result_uint32_t_is_err(&value_result), "Key %u should be erased", i);
+        } else {
+            ASSERTF(Result_uint32_t_unwrap(&value_result) == 3 * i, "Unexpected value of %u", i);
+        }
+    }
+    ASSERT(hm_contains_uint32_t_uint32_t(&map, 1), "Map should contain key 1");
+
+    printf("Clearing...\n");
+    hm_clear_uint32_t_uint32_t(&map);
+    ASSERT(hm_is_empty_uint32_t_uint32_t(&map), "Is empty should say map is empty");
+}
+
+int main(int argc, const char* argv[])
+{
+    printf("Starting Test: HashMapTester\n");
+    ASSERT(argc > 1, "Test executable needs more than one argument");
+    int test_num = atoi(argv[1]);
+    switch (test_num) {
+    case 0:
+        test_case_0(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 1:
+        test_case_1(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 2:
+        test_case_2(argc, argv);
+        exit(EXIT_SUCCESS);
+    default:
+        ASSERTF(false, "Invalid test case number given %i", test_num);
+    }
+}
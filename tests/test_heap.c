@@ -0,0 +1,178 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "heap.h"
+#include "utils/asserts.h"
+
+/* Testing Basic creation and usage */
+void test_case_0(int argc, const char* argv[])
+{
+    printf("Starting test case 0\n");
+
+    // Basic initialization
+    heap_uint32_t heap = heap_new_uint32_t(false);
+    ASSERT(heap.data == nullptr && heap.capacity == 0, "Initialization failed");
+    ASSERT(heap_is_empty_uint32_t(&heap), "Is empty should say heap is empty");
+    Result_uint32_t value_result = heap_pop_uint32_t(&heap);
+    ASSERT(Result_uint32_t_is_err(&value_result), "Popping from an empty heap should fail");
+    value_result = heap_peek_uint32_t(&heap);
+    ASSERT(Result_uint32_t_is_err(&value_result), "Peeking into an empty heap should fail");
+
+    // Pushing, including duplicates
+    const uint32_t values[] = { 42, 7, 19, 7, 100, 3, 56, 23, 88, 1, 64 };
+    const size_t count = sizeof(values) / sizeof(values[0]);
+    for (size_t i = 0; i < count; i++)
+        ASSERTF(heap_push_uint32_t(&heap, values[i]), "Pushing %u failed", values[i]);
+    heap_print_uint32_t(&heap);
+    ASSERT(heap_size_uint32_t(&heap) == count, "Size of heap should be 11");
+    ASSERT((uintptr_t)heap.data % HEAP_ALIGNMENT == 0, "Heap should be cache line aligned");
+    value_result = heap_peek_uint32_t(&heap);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == 1, "Top of the min heap should be 1");
+
+    // Popping in ascending order
+    const uint32_t sorted[] = { 1, 3, 7, 7, 19, 23, 42, 56, 64, 88, 100 };
+    for (size_t i = 0; i < count; i++) {
+        value_result = heap_pop_uint32_t(&heap);
+        ASSERTF(Result_uint32_t_unwrap(&value_result) == sorted[i], "Expected %u", sorted[i]);
+    }
+    ASSERT(heap_is_empty_uint32_t(&heap), "Heap should be empty after popping everything");
+
+    // Max heap built from an array
+    heap_clear_uint32_t(&heap);
+    heap = heap_from_array_uint32_t(values, count, true);
+    ASSERT(heap_size_uint32_t(&heap) == count, "Heapified heap should hold all 11 values");
+    for (size_t i = count; i-- > 0;) {
+        value_result = heap_pop_uint32_t(&heap);
+        ASSERTF(Result_uint32_t_unwrap(&value_result) == sorted[i], "Expected %u", sorted[i]);
+    }
+    ASSERT(heap_push_uint32_t(&heap, 5), "Pushing after heapify should work");
+    value_result = heap_peek_uint32_t(&heap);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == 5, "Top should be 5");
+
+    printf("Clearing heap\n");
+    heap_clear_uint32_t(&heap);
+    ASSERT(heap_is_empty_uint32_t(&heap), "Is empty should say heap is empty");
+}
+
+/* Heap sort of many values, pushed one by one and heapified at once */
+void test_case_1(int argc, const char* argv[])
+{
+    printf("Starting test case 1\n");
+    const size_t N = 100000;
+    uint32_t* values = malloc(N * sizeof(uint32_t));
+    srand(1234);
+    for (size_t i = 0; i < N; i++)
+        values[i] = rand() % 5000;
+
+    for (int is_max = 0; is_max < 2; is_max++) {
+        heap_uint32_t pushed = heap_new_uint32_t(is_max);
+        for (size_t i = 0; i < N; i++)
+            heap_push_uint32_t(&pushed, values[i]);
+        heap_uint32_t heapified = heap_from_array_uint32_t(values, N, is_max);
+
+        uint32_t last = is_max ? UINT32_MAX : 0;
+        for (size_t i = 0; i < N; i++) {
+            Result_uint32_t a = heap_pop_uint32_t(&pushed);
+            Result_uint32_t b = heap_pop_uint32_t(&heapified);
+            uint32_t value = Result_uint32_t_unwrap(&a);
+            ASSERT(value == Result_uint32_t_unwrap(&b), "Both heaps should pop the same values");
+            ASSERTF(is_max ? value <= last : value >= last, "%u popped out of order", value);
+            last = value;
+        }
+        ASSERT(heap_is_empty_uint32_t(&pushed), "Pushed heap should be empty");
+        ASSERT(heap_is_empty_uint32_t(&heapified), "Heapified heap should be empty");
+        heap_clear_uint32_t(&pushed);
+        heap_clear_uint32_t(&heapified);
+    }
+
+    // Heapifying a single value
+    heap_uint32_t single = heap_from_array_uint32_t(values, 1, false);
+    Result_uint32_t value_result = heap_pop_uint32_t(&single);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == values[0], "Single value should be popped");
+    heap_clear_uint32_t(&single);
+    free(values);
+}
+
+/* Indexed heap with key updates */
+void test_case_2(int argc, const char* argv[])
+{
+    printf("Starting test case 2\n");
+
+    iheap_uint32_t heap = iheap_new_uint32_t(10, false);
+    ASSERT(heap.capacity == 10, "Capacity should be 10");
+    ASSERT(iheap_is_empty_uint32_t(&heap), "Is empty should say heap is empty");
+    Result_uint32_t value_result = iheap_pop_uint32_t(&heap);
+    ASSERT(Result_uint32_t_is_err(&value_result), "Popping from an empty heap should fail");
+
+    for (uint32_t id = 0; id < 10; id++)
+        ASSERTF(iheap_push_uint32_t(&heap, id, 100 + id * 10), "Pushing %u failed", id);
+    ASSERT(!iheap_push_uint32_t(&heap, 3, 1), "Pushing id 3 twice should not be possible");
+    ASSERT(!iheap_push_uint32_t(&heap, 10, 1), "Pushing id 10 should be out of range");
+    iheap_print_uint32_t(&heap);
+
+    // Decrease and increase keys
+    ASSERT(iheap_update_key_uint32_t(&heap, 7, 5), "Decreasing the key of 7 should work");
+    value_result = iheap_peek_uint32_t(&heap);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == 7, "Id 7 should be on top");
+    ASSERT(iheap_update_key_uint32_t(&heap, 0, 500), "Increasing the key of 0 should work");
+    value_result = iheap_key_uint32_t(&heap, 0);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == 500, "Key of 0 should be 500");
+
+    const uint32_t order[] = { 7, 1, 2, 3, 4, 5, 6, 8, 9, 0 };
+    for (size_t i = 0; i < 10; i++) {
+        value_result = iheap_pop_uint32_t(&heap);
+        ASSERTF(Result_uint32_t_unwrap(&value_result) == order[i], "Expected id %u", order[i]);
+        ASSERTF(!iheap_contains_uint32_t(&heap, order[i]), "Id %u was popped", order[i]);
+    }
+    ASSERT(!iheap_update_key_uint32_t(&heap, 7, 1), "Updating a popped id should fail");
+    value_result = iheap_key_uint32_t(&heap, 7);
+    ASSERT(Result_uint32_t_is_err(&value_result), "Popped id should have no key");
+    ASSERT(iheap_push_uint32_t(&heap, 7, 1), "Pushing a popped id again should work");
+    iheap_clear_uint32_t(&heap);
+
+    // Random updates on a max heap, checked against the keys kept on the side
+    const uint32_t N = 5000;
+    uint32_t* keys = malloc(N * sizeof(uint32_t));
+    heap = iheap_new_uint32_t(N, true);
+    srand(4321);
+    for (uint32_t id = 0; id < N; id++) {
+        keys[id] = rand() % 100000;
+        iheap_push_uint32_t(&heap, id, keys[id]);
+    }
+    for (uint32_t i = 0; i < 4 * N; i++) {
+        uint32_t id = rand() % N;
+        keys[id] = rand() % 100000;
+        ASSERTF(iheap_update_key_uint32_t(&heap, id, keys[id]), "Updating %u failed", id);
+    }
+    uint32_t last = UINT32_MAX;
+    for (uint32_t i = 0; i < N; i++) {
+        value_result = iheap_pop_uint32_t(&heap);
+        uint32_t id = Result_uint32_t_unwrap(&value_result);
+        ASSERTF(keys[id] <= last, "Id %u popped out of order", id);
+        last = keys[id];
+    }
+    ASSERT(iheap_is_empty_uint32_t(&heap), "Heap should be empty after popping everything");
+    iheap_clear_uint32_t(&heap);
+    free(keys);
+}
+
+int main(int argc, const char* argv[])
+{
+    printf("Starting Test: HeapTester\n");
+    ASSERT(argc > 1, "Test executable needs more than one argument");
+    int test_num = atoi(argv[1]);
+    switch (test_num) {
+    case 0:
+        test_case_0(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 1:
+        test_case_1(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 2:
+        test_case_2(argc, argv);
+        exit(EXIT_SUCCESS);
+    default:
+        ASSERTF(false, "Invalid test case number given %i", test_num);
+    }
+}
@@ -0,0 +1,263 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tree.h"
+#include "utils/asserts.h"
+
+/* Checks that the values of the subtree lie in [lo, hi] and that no slot is linked twice. Returns
+ * the number of nodes of the subtree */
+static size_t check_ibt_node(
+    ibt_uint32_t* tree, uint32_t index, uint64_t lo, uint64_t hi, bool* seen)
+{
+    if (index == IB_TREE_NIL)
+        return 0;
+    ASSERTF(index < tree->length, "Index %u is beyond the used slots", index);
+    ASSERTF(!seen[index], "Slot %u is linked twice", index);
+    seen[index] = true;
+
+    uint32_t value = tree->nodes[index].value;
+    ASSERTF(value >= lo && value <= hi, "Value %u of slot %u is out of order", value, index);
+    return 1 + check_ibt_node(tree, tree->nodes[index].left, lo, value, seen)
+        + check_ibt_node(tree, tree->nodes[index].right, value, hi, seen);
+}
+
+static void check_ibt(ibt_uint32_t* tree)
+{
+    bool* seen = calloc(tree->length + 1, sizeof(bool));
+    size_t count = check_ibt_node(tree, tree->root, 0, UINT32_MAX, seen);
+    ASSERTF(
+        count == ibt_size_uint32_t(tree),
+        "Counted %zu nodes but size says %zu",
+        count,
+        ibt_size_uint32_t(tree));
+    // Every slot but nil is either linked into the tree or chained as free
+    size_t free_slots = 0;
+    for (uint32_t index = tree->free; index != IB_TREE_NIL; index = tree->nodes[index].left) {
+        ASSERTF(!seen[index], "Slot %u is both linked and free", index);
+        seen[index] = true;
+        free_slots++;
+    }
+    ASSERT(tree->length == 0 || count + free_slots == tree->length - 1, "Slots got lost");
+    free(seen);
+}
+
+typedef struct collected {
+    uint32_t* values;
+    size_t count;
+} collected_t;
+
+static void collect_value(uint32_t value, void* ctx)
+{
+    collected_t* collected = ctx;
+    collected->values[collected->count++] = value;
+}
+
+typedef struct nested {
+    ibt_uint32_t* tree;
+    size_t count;
+} nested_t;
+
+static void nested_lookup(uint32_t value, void* ctx)
+{
+    nested_t* nested = ctx;
+    nested->count += ibt_contains_uint32_t(nested->tree, value);
+}
+
+static void count_value(uint32_t value, void* ctx)
+{
+    (*(size_t*)ctx)++;
+}
+
+static void nested_traverse(uint32_t value, void* ctx)
+{
+    nested_t* nested = ctx;
+    ibt_traverse_uint32_t(nested->tree, count_value, &nested->count);
+}
+
+/* Testing basic creation and usage */
+void test_case_0(int argc, const char* argv[])
+{
+    printf("Starting test case 0\n");
+    ASSERT(sizeof(ibt_node_uint32_t) == 12, "Nodes should take 12 bytes");
+
+    ibt_uint32_t tree = ibt_new_uint32_t();
+    ASSERT(ibt_is_empty_uint32_t(&tree), "New tree should be empty");
+    ASSERT(ibt_memory_uint32_t(&tree) == 0, "New tree shouldn't allocate");
+    ASSERT(!ibt_contains_uint32_t(&tree, 0), "Empty tree contains nothing");
+    ASSERT(!ibt_del_value_uint32_t(&tree, 0), "Deleting from the empty tree should fail");
+    Result_uint32_t result = ibt_min_uint32_t(&tree);
+    ASSERT(Result_uint32_t_is_err(&result), "Empty tree has no min");
+    result = ibt_max_uint32_t(&tree);
+    ASSERT(Result_uint32_t_is_err(&result), "Empty tree has no max");
+
+    uint32_t values[] = { 50, 20, 80, 10, 30, 70, 90, 30, 0 };
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+        ASSERT(ibt_add_value_uint32_t(&tree, values[i]), "Adding failed");
+    ibt_print_uint32_t(&tree);
+    check_ibt(&tree);
+    ASSERT(ibt_size_uint32_t(&tree) == 9, "Tree should hold 9 values");
+    ASSERT(ibt_min_uint32_t(&tree).value == 0, "Min should be 0");
+    ASSERT(ibt_max_uint32_t(&tree).value == 90, "Max should be 90");
+    ASSERT(ibt_contains_uint32_t(&tree, 70) && !ibt_contains_uint32_t(&tree, 60), "Wrong contains");
+    ASSERT(ibt_lower_bound_uint32_t(&tree, 55).value == 70, "Lower bound of 55 should be 70");
+    ASSERT(ibt_lower_bound_uint32_t(&tree, 30).value == 30, "Lower bound of 30 should be 30");
+    result = ibt_lower_bound_uint32_t(&tree, 91);
+    ASSERT(Result_uint32_t_is_err(&result), "Nothing is at least 91");
+
+    // The duplicate 30 goes once per deletion, 50 is the root with two children
+    ASSERT(ibt_del_value_uint32_t(&tree, 30), "Deleting 30 failed");
+    ASSERT(ibt_contains_uint32_t(&tree, 30), "The other 30 should be left");
+    ASSERT(ibt_del_value_uint32_t(&tree, 30), "Deleting the other 30 failed");
+    ASSERT(!ibt_contains_uint32_t(&tree, 30), "No 30 should be left");
+    ASSERT(ibt_del_value_uint32_t(&tree, 50), "Deleting the root failed");
+    ASSERT(!ibt_del_value_uint32_t(&tree, 50), "Deleting 50 twice should fail");
+    check_ibt(&tree);
+
+    uint32_t out[16];
+    collected_t collected = { .values = out, .count = 0 };
+    ASSERT(ibt_traverse_uint32_t(&tree, collect_value, &collected) == 6, "Expected 6 values");
+    uint32_t expected[] = { 0, 10, 20, 70, 80, 90 };
+    ASSERT(memcmp(out, expected, sizeof(expected)) == 0, "Traversal should be ascending");
+    check_ibt(&tree);
+
+    ASSERT(ibt_clear_uint32_t(&tree), "Clearing failed");
+    ASSERT(ibt_is_empty_uint32_t(&tree) && ibt_size_uint32_t(&tree) == 0, "Cleared tree is empty");
+    ASSERT(ibt_memory_uint32_t(&tree) == 0, "Clearing should release the nodes");
+}
+
+/* Random operations against a reference, slot recycling and growth */
+void test_case_1(int argc, const char* argv[])
+{
+    printf("Starting test case 1\n");
+    const uint32_t universe = 2000;
+    uint32_t* counts = calloc(universe, sizeof(uint32_t));
+    ibt_uint32_t tree = ibt_new_uint32_t();
+    size_t size = 0;
+
+    srand(25);
+    for (int i = 0; i < 40000; i++) {
+        uint32_t value = rand() % universe;
+        if (rand() % 3 != 0) {
+            ASSERT(ibt_add_value_uint32_t(&tree, value), "Adding failed");
+            counts[value]++;
+            size++;
+        } else {
+            bool deleted = ibt_del_value_uint32_t(&tree, value);
+            ASSERTF(deleted == (counts[value] > 0), "Deleting %u disagrees", value);
+            if (deleted) {
+                counts[value]--;
+                size--;
+            }
+        }
+        if (i % 5000 == 0)
+            check_ibt(&tree);
+    }
+    check_ibt(&tree);
+    ASSERT(ibt_size_uint32_t(&tree) == size, "Size disagrees with the reference");
+    for (uint32_t v = 0; v < universe; v++)
+        ASSERTF(ibt_contains_uint32_t(&tree, v) == (counts[v] > 0), "Contains disagrees on %u", v);
+
+    // Freed slots are reused before the array grows
+    size_t length = tree.length;
+    ASSERT(ibt_del_value_uint32_t(&tree, ibt_min_uint32_t(&tree).value), "Deleting min failed");
+    ASSERT(tree.free != IB_TREE_NIL, "Deleting should free a slot");
+    ASSERT(ibt_add_value_uint32_t(&tree, 7), "Adding failed");
+    ASSERT(tree.length == length, "Adding should reuse a freed slot");
+
+    // Reserving makes room up front
+    ibt_clear_uint32_t(&tree);
+    ASSERT(ibt_reserve_uint32_t(&tree, 10000), "Reserving failed");
+    ibt_node_uint32_t* nodes = tree.nodes;
+    for (uint32_t v = 0; v < 10000; v++)
+        ibt_add_value_uint32_t(&tree, (v * 7919) % 10000);
+    ASSERT(tree.nodes == nodes, "Adding reserved values shouldn't reallocate");
+    ASSERT(!ibt_reserve_uint32_t(&tree, (size_t)UINT32_MAX + 1), "At most UINT32_MAX values fit");
+    check_ibt(&tree);
+    ibt_clear_uint32_t(&tree);
+    free(counts);
+}
+
+/* Building from sorted values */
+void test_case_2(int argc, const char* argv[])
+{
+    printf("Starting test case 2\n");
+    const size_t n = 100000;
+    uint32_t* values = malloc(n * sizeof(uint32_t));
+    for (size_t i = 0; i < n; i++)
+        values[i] = (uint32_t)(3 * i);
+
+    ibt_uint32_t tree = ibt_build_from_sorted_uint32_t(values, n);
+    ASSERT(ibt_size_uint32_t(&tree) == n, "Built tree should hold n values");
+    ASSERT(tree.capacity == n + 1, "Building should allocate exactly n + 1 slots");
+    check_ibt(&tree);
+    for (size_t i = 0; i < n; i += 97) {
+        ASSERT(ibt_contains_uint32_t(&tree, values[i]), "Built tree should contain every value");
+        ASSERT(!ibt_contains_uint32_t(&tree, values[i] + 1), "Built tree has extra values");
+        ASSERT(ibt_lower_bound_uint32_t(&tree, values[i] + 1).value == values[i] + 3, "Bound");
+    }
+
+    // Perfectly balanced: the path to the largest value is as long as log2(n + 1) rounded up
+    size_t depth = 1;
+    for (uint32_t cur = tree.root; tree.nodes[cur].right != IB_TREE_NIL; depth++)
+        cur = tree.nodes[cur].right;
+    ASSERTF(depth <= 17, "Path to the max should be at most 17 nodes, got %zu", depth);
+
+    uint32_t* out = malloc(n * sizeof(uint32_t));
+    collected_t collected = { .values = out, .count = 0 };
+    ASSERT(ibt_traverse_uint32_t(&tree, collect_value, &collected) == n, "Expected n values");
+    ASSERT(memcmp(out, values, n * sizeof(uint32_t)) == 0, "Traversal should match the input");
+    check_ibt(&tree);
+
+    // Traversing only reads, so consume may look up values and traverse the tree again
+    nested_t nested = { .tree = &tree, .count = 0 };
+    ASSERT(ibt_traverse_uint32_t(&tree, nested_lookup, &nested) == n, "Expected n values");
+    ASSERT(nested.count == n, "Every value should be found from inside the traversal");
+    ibt_uint32_t small = ibt_build_from_sorted_uint32_t(values, 3);
+    nested = (nested_t) { .tree = &small, .count = 0 };
+    ASSERT(ibt_traverse_uint32_t(&small, nested_traverse, &nested) == 3, "Expected 3 values");
+    ASSERT(nested.count == 9, "Every nested traversal should see all 3 values");
+    ibt_clear_uint32_t(&small);
+
+    // A chain deeper than the stack kept on the call stack
+    ibt_uint32_t chain = ibt_new_uint32_t();
+    for (uint32_t v = 1000; v > 0; v--)
+        ibt_add_value_uint32_t(&chain, v);
+    collected = (collected_t) { .values = out, .count = 0 };
+    ASSERT(ibt_traverse_uint32_t(&chain, collect_value, &collected) == 1000, "Expected 1000");
+    ASSERT(out[0] == 1 && out[999] == 1000, "Chain should be traversed in ascending order");
+    ibt_clear_uint32_t(&chain);
+
+    // The built tree takes further insertions and deletions
+    ASSERT(ibt_add_value_uint32_t(&tree, 1), "Adding to the built tree failed");
+    ASSERT(ibt_del_value_uint32_t(&tree, values[n / 2]), "Deleting the root failed");
+    ASSERT(ibt_contains_uint32_t(&tree, 1), "Tree should contain the added 1");
+    ASSERT(!ibt_contains_uint32_t(&tree, values[n / 2]), "Deleted root should be gone");
+    check_ibt(&tree);
+    ibt_clear_uint32_t(&tree);
+
+    tree = ibt_build_from_sorted_uint32_t(values, 0);
+    ASSERT(ibt_is_empty_uint32_t(&tree) && tree.nodes == nullptr, "Empty input builds nothing");
+    free(values);
+    free(out);
+}
+
+int main(int argc, const char* argv[])
+{
+    printf("Starting Test: IndexTreeTester\n");
+    ASSERT(argc > 1, "Test executable needs more than one argument");
+    int test_num = atoi(argv[1]);
+    switch (test_num) {
+    case 0:
+        test_case_0(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 1:
+        test_case_1(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 2:
+        test_case_2(argc, argv);
+        exit(EXIT_SUCCESS);
+    default:
+        ASSERTF(false, "Invalid test case number given %i", test_num);
+    }
+}
@@ -1,9 +1,36 @@
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 #include "list.h"
 #include "utils/asserts.h"
 
+/* Lists of other value types, instantiated in this translation unit */
+static void print_uint64(const uint64_t value)
+{
+    printf("%" PRIu64, value);
+}
+
+LL_DECLARE(uint64_t);
+LL_DEFINE(uint64_t, LL_DEFAULT_EQUALS, print_uint64)
+
+typedef struct entry {
+    uint32_t key;
+    uint32_t payload;
+} entry_t;
+
+static void print_entry(const entry_t entry)
+{
+    printf("%u:%u", entry.key, entry.payload);
+}
+
+#define ENTRY_EQUALS(a, b) ((a).key == (b).key)
+
+RESULT_DECLARE(entry_t)
+RESULT_DEFINE(entry_t)
+LL_DECLARE(entry_t);
+LL_DEFINE(entry_t, ENTRY_EQUALS, print_entry)
+
 /* Testing Basic creation and usage */
 void test_case_0(int argc, const char* argv[])
 {
@@ -110,6 +137,261 @@ void test_case_1(int argc, const char* argv[])
     ll_print_uint32_t(&list);
 }
 
+/* Testing pooled node allocation */
+void test_case_2(int argc, const char* argv[])
+{
+    const size_t N = 100000;
+
+    ll_uint32_t list = ll_new_pooled_list_uint32_t();
+    ASSERT(ll_is_empty_uint32_t(&list), "Is empty should say list is empty");
+
+    printf("Adding %zu numbers to pooled list\n", N);
+    for (size_t i = 0; i < N; i++) {
+        ll_add_value_uint32_t(&list, i);
+    }
+    ASSERTF(ll_length_uint32_t(&list) == N, "We should have a list length of %zu", N);
+
+    printf("Deleting head and tail\n");
+    ASSERT(ll_del_value_uint32_t(&list, 0), "Deleting the head should be possible");
+    ASSERT(ll_del_value_uint32_t(&list, N - 1), "Deleting the tail should be possible");
+    ASSERTF(ll_length_uint32_t(&list) == N - 2, "We should have a list length of %zu", N - 2);
+    Result_uint32_t value_result = ll_get_uint32_t(&list, 0);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == 1, "Expected value 1 at the new head");
+    ASSERT(list.tail->value == N - 2, "Tail should point to the new last node");
+
+    printf("Recycling deleted nodes\n");
+    ll_node_uint32_t* tail = list.tail;
+    ll_del_value_uint32_t(&list, N - 2);
+    ll_add_value_uint32_t(&list, 42);
+    ASSERT(list.tail == tail, "Deleted node should be reused by the next add");
+    value_result = ll_pop_value_uint32_t(&list);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == 42, "Expected value 42 after popping");
+
+    printf("Clearing...\n");
+    ll_clear_list_uint32_t(&list);
+    ASSERT(ll_is_empty_uint32_t(&list), "Is empty should say list is empty");
+
+    printf("Reusing cleared list\n");
+    ll_add_value_uint32_t(&list, 7);
+    ASSERT(ll_length_uint32_t(&list) == 1, "We should have a list length of 1");
+    ll_clear_list_uint32_t(&list);
+}
+
+/* Testing basic usage of the doubly linked list */
+void test_case_3(int argc, const char* argv[])
+{
+    printf("Starting test case 3\n");
+
+    // Basic initialization
+    dll_uint32_t list = dll_new_list_uint32_t();
+    ASSERT(list.head == nullptr && list.tail == nullptr, "Initialization failed");
+    ASSERT(dll_is_empty_uint32_t(&list), "Is empty should say list is empty");
+
+    // Append and prepend
+    dll_add_value_uint32_t(&list, 123);
+    dll_add_value_uint32_t(&list, 321);
+    dll_push_front_uint32_t(&list, 111);
+    dll_add_value_uint32_t(&list, 0);
+    dll_push_front_uint32_t(&list, 7);
+    dll_print_uint32_t(&list);
+    size_t len = dll_length_uint32_t(&list);
+    ASSERTF(len == 5, "Wrong length returned %zu", len);
+
+    // Get and Set from both halves
+    const uint32_t expected[] = { 7, 111, 123, 321, 0 };
+    for (size_t i = 0; i < 5; i++) {
+        Result_uint32_t value_result = dll_get_uint32_t(&list, i);
+        uint32_t value = Result_uint32_t_unwrap(&value_result);
+        ASSERTF(
+            value == expected[i],
+            "Expected value %u at index %zu, got %u",
+            expected[i],
+            i,
+            value);
+    }
+    ASSERT(dll_set_uint32_t(&list, 3, 31), "Setting was not successfull");
+    Result_uint32_t value_result = dll_get_uint32_t(&list, 3);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == 31, "Expected value 31 at index 3");
+    value_result = dll_get_uint32_t(&list, 5);
+    ASSERT(Result_uint32_t_is_err(&value_result), "We should have an out of range exception");
+    ASSERT(!dll_set_uint32_t(&list, 5, 1), "Setting out of range should fail");
+
+    // Deletion of head, middle and tail
+    ASSERT(dll_del_value_uint32_t(&list, 7), "Deleting the head should be possible");
+    ASSERT(dll_del_value_uint32_t(&list, 123), "Deleting 123 should be possible");
+    ASSERT(dll_del_value_uint32_t(&list, 0), "Deleting the tail should be possible");
+    ASSERT(!dll_del_value_uint32_t(&list, 42), "Deleting 42 should not be possible");
+    dll_print_uint32_t(&list);
+    ASSERT(dll_length_uint32_t(&list) == 2, "After deleting, we should have a length of 2");
+    ASSERT(list.head->value == 111 && list.tail->value == 31, "Head and tail are wrong");
+
+    // Popping from both ends
+    value_result = dll_pop_value_uint32_t(&list);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == 31, "Expected value 31 after popping");
+    value_result = dll_pop_front_uint32_t(&list);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == 111, "Expected value 111 after popping");
+    value_result = dll_pop_value_uint32_t(&list);
+    ASSERT(Result_uint32_t_is_err(&value_result), "Popping an empty list should give an error");
+    value_result = dll_pop_front_uint32_t(&list);
+    ASSERT(Result_uint32_t_is_err(&value_result), "Popping an empty list should give an error");
+    ASSERT(dll_is_empty_uint32_t(&list), "Is empty should say list is empty");
+
+    printf("Clearing list\n");
+    dll_add_value_uint32_t(&list, 1);
+    dll_add_value_uint32_t(&list, 2);
+    dll_clear_list_uint32_t(&list);
+    ASSERT(dll_is_empty_uint32_t(&list), "Is empty should say list is empty");
+    dll_print_uint32_t(&list);
+}
+
+/* Draining a lot of numbers from both ends of the doubly linked list */
+void test_case_4(int argc, const char* argv[])
+{
+    printf("Starting test case 4\n");
+    const uint32_t N = 1000000;
+    dll_uint32_t list = dll_new_list_uint32_t();
+
+    printf("Adding %u numbers to list\n", N);
+    for (uint32_t i = 0; i < N; i++) {
+        dll_add_value_uint32_t(&list, i);
+    }
+    ASSERTF(dll_length_uint32_t(&list) == N, "We should have a list length of %u", N);
+
+    Result_uint32_t value_result = dll_get_uint32_t(&list, N - 10);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == N - 10, "Unexpected value near the tail");
+
+    printf("Draining from both ends\n");
+    for (uint32_t i = 0; i < N / 2; i++) {
+        value_result = dll_pop_value_uint32_t(&list);
+        ASSERT(Result_uint32_t_unwrap(&value_result) == N - 1 - i, "Unexpected value at the tail");
+        value_result = dll_pop_front_uint32_t(&list);
+        ASSERT(Result_uint32_t_unwrap(&value_result) == i, "Unexpected value at the head");
+    }
+    ASSERT(dll_is_empty_uint32_t(&list), "Is empty should say list is empty");
+    dll_clear_list_uint32_t(&list);
+}
+
+/* Testing the unrolled linked list across node boundaries */
+void test_case_5(int argc, const char* argv[])
+{
+    printf("Starting test case 5\n");
+    const uint32_t N = 100;
+    ull_uint32_t list = ull_new_list_uint32_t();
+    ASSERT(ull_is_empty_uint32_t(&list), "Is empty should say list is empty");
+    ull_print_uint32_t(&list);
+
+    for (uint32_t i = 0; i < N; i++) {
+        ull_add_value_uint32_t(&list, i);
+    }
+    ull_print_uint32_t(&list);
+    ASSERTF(ull_length_uint32_t(&list) == N, "We should have a list length of %u", N);
+    ASSERT(list.head != list.tail, "Values should span multiple nodes");
+
+    // Get and Set
+    for (uint32_t i = 0; i < N; i++) {
+        Result_uint32_t value_result = ull_get_uint32_t(&list, i);
+        ASSERTF(Result_uint32_t_unwrap(&value_result) == i, "Expected value %u at index %u", i, i);
+    }
+    ASSERT(ull_set_uint32_t(&list, 51, 510), "Setting was not successfull");
+    Result_uint32_t value_result = ull_get_uint32_t(&list, 51);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == 510, "Expected value 510 at index 51");
+    value_result = ull_get_uint32_t(&list, N);
+    ASSERT(Result_uint32_t_is_err(&value_result), "We should have an out of range exception");
+
+    // Deleting every value but multiples of 10 merges the nodes again
+    for (uint32_t i = 0; i < N; i++) {
+        if (i % 10 != 0)
+            ASSERTF(ull_del_value_uint32_t(&list, (i == 51) ? 510 : i), "Deleting %u failed", i);
+    }
+    ASSERT(!ull_del_value_uint32_t(&list, 42), "Deleting 42 should not be possible");
+    ull_print_uint32_t(&list);
+    ASSERT(ull_length_uint32_t(&list) == N / 10, "After deleting, we should have a length of 10");
+    ASSERT(list.head == list.tail, "Remaining values should have been merged into one node");
+    for (uint32_t i = 0; i < N / 10; i++) {
+        value_result = ull_get_uint32_t(&list, i);
+        ASSERTF(Result_uint32_t_unwrap(&value_result) == 10 * i, "Expected value %u", 10 * i);
+    }
+
+    // The back links should mirror the forward links after deleting and merging
+    size_t back_length = 0;
+    for (ull_node_uint32_t* cur = list.tail; cur != nullptr; cur = cur->prev) {
+        ASSERT(cur->prev == nullptr || cur->prev->next == cur, "Back link should match");
+        back_length += cur->count;
+    }
+    ASSERT(back_length == ull_length_uint32_t(&list), "Back links should reach every value");
+
+    // Popping everything across node boundaries
+    ull_add_value_uint32_t(&list, 1000);
+    for (uint32_t i = 0; i < 20; i++) {
+        ull_add_value_uint32_t(&list, 1001 + i);
+    }
+    for (uint32_t i = 20; i > 0; i--) {
+        value_result = ull_pop_value_uint32_t(&list);
+        ASSERTF(Result_uint32_t_unwrap(&value_result) == 1000 + i, "Expected %u", 1000 + i);
+    }
+    value_result = ull_pop_value_uint32_t(&list);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == 1000, "Expected value 1000 after popping");
+    for (uint32_t i = N / 10; i > 0; i--) {
+        value_result = ull_pop_value_uint32_t(&list);
+        ASSERT(Result_uint32_t_unwrap(&value_result) == 10 * (i - 1), "Unexpected popped value");
+    }
+    value_result = ull_pop_value_uint32_t(&list);
+    ASSERT(Result_uint32_t_is_err(&value_result), "Popping an empty list should give an error");
+    ASSERT(list.head == nullptr && list.tail == nullptr, "Empty list should have no nodes");
+
+    printf("Clearing list\n");
+    for (uint32_t i = 0; i < N; i++) {
+        ull_add_value_uint32_t(&list, i);
+    }
+    ull_clear_list_uint32_t(&list);
+    ASSERT(ull_is_empty_uint32_t(&list), "Is empty should say list is empty");
+}
+
+/* Testing lists instantiated for 64-bit values and for structs with an equality hook */
+void test_case_6(int argc, const char* argv[])
+{
+    printf("Starting test case 6\n");
+
+    // Values that don't fit 32 bits must survive unchanged
+    ll_uint64_t list = ll_new_list_uint64_t();
+    const uint64_t big = (uint64_t)1 << 40;
+    for (uint64_t i = 0; i < 10; i++) {
+        ll_add_value_uint64_t(&list, big + i);
+    }
+    ll_print_uint64_t(&list);
+    Result_uint64_t value_result = ll_get_uint64_t(&list, 3);
+    ASSERT(Result_uint64_t_unwrap(&value_result) == big + 3, "Expected 2^40 + 3 at index 3");
+    ASSERT(!ll_del_value_uint64_t(&list, 3), "3 should not match 2^40 + 3");
+    ASSERT(ll_del_value_uint64_t(&list, big + 3), "Deleting 2^40 + 3 should be possible");
+    ASSERT(ll_length_uint64_t(&list) == 9, "Length should be 9 after deleting");
+    value_result = ll_pop_value_uint64_t(&list);
+    ASSERT(Result_uint64_t_unwrap(&value_result) == big + 9, "Expected to pop 2^40 + 9");
+    ll_clear_list_uint64_t(&list);
+
+    // Entries are equal if their keys are, whatever the payload
+    ll_entry_t entries = ll_new_pooled_list_entry_t();
+    for (uint32_t i = 0; i < 5; i++) {
+        ll_add_value_entry_t(&entries, (entry_t) { .key = i, .payload = 100 + i });
+    }
+    ll_print_entry_t(&entries);
+    ASSERT(
+        ll_del_value_entry_t(&entries, (entry_t) { .key = 2, .payload = 0 }),
+        "Deleting the entry with key 2 should be possible");
+    ASSERT(
+        !ll_del_value_entry_t(&entries, (entry_t) { .key = 2, .payload = 102 }),
+        "Entry with key 2 should be gone");
+    ASSERT(
+        ll_set_entry_t(&entries, 0, (entry_t) { .key = 7, .payload = 7 }),
+        "Setting index 0 should be possible");
+    Result_entry_t entry_result = ll_get_entry_t(&entries, 2);
+    entry_t entry = Result_entry_t_unwrap(&entry_result);
+    ASSERT(entry.key == 3 && entry.payload == 103, "Expected entry 3:103 at index 2");
+    entry_result = ll_get_entry_t(&entries, 0);
+    ASSERT(Result_entry_t_unwrap(&entry_result).key == 7, "Expected key 7 at index 0");
+    ll_clear_list_entry_t(&entries);
+    ASSERT(ll_is_empty_entry_t(&entries), "List should be empty after clearing");
+}
+
 int main(int argc, const char* argv[])
 {
     printf("Starting Test: LinkedListTest\n");
@@ -122,6 +404,21 @@ int main(int argc, const char* argv[])
     case 1:
         test_case_1(argc, argv);
         exit(EXIT_SUCCESS);
+    case 2:
+        test_case_2(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 3:
+        test_case_3(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 4:
+        test_case_4(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 5:
+        test_case_5(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 6:
+        test_case_6(argc, argv);
+        exit(EXIT_SUCCESS);
     default:
         ASSERTF(false, "Invalid test number given %i", test_num);
     }
@@ -0,0 +1,182 @@
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "lsm.h"
+#include "utils/asserts.h"
+#include "utils/failing_alloc.h"
+
+typedef struct checked {
+    uint32_t last;
+    size_t count;
+} checked_t;
+
+static void check_ascending(uint32_t value, void* ctx)
+{
+    checked_t* checked = ctx;
+    ASSERTF(checked->count == 0 || value > checked->last, "Range is out of order at %u", value);
+    checked->last = value;
+    checked->count++;
+}
+
+/* Removes dir and the files in it */
+static void remove_dir(const char* dir)
+{
+    DIR* handle = opendir(dir);
+    if (handle == nullptr)
+        return;
+    char path[512];
+    for (struct dirent* entry = readdir(handle); entry != nullptr; entry = readdir(handle)) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+            continue;
+        snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+        remove(path);
+    }
+    closedir(handle);
+    rmdir(dir);
+}
+
+/* Adding with many flushes, contains and ranges */
+void test_case_0(int argc, const char* argv[])
+{
+    printf("Starting test case 0\n");
+    const char* dir = "lsm_case_0";
+    remove_dir(dir);
+    const uint32_t n = 50000;
+
+    lsm_set_t set;
+    ASSERT(lsm_open(&set, dir, 1000), "Creating the set failed");
+    ASSERT(lsm_run_count(&set) == 0, "New set should have no runs");
+    // Every even value below 2n, each one added twice in scrambled order
+    for (uint32_t i = 0; i < 2 * n; i++)
+        ASSERT(lsm_add(&set, (uint32_t)((uint64_t)i * 2654435761u % n) * 2), "Adding failed");
+    ASSERTF(lsm_run_count(&set) <= 8, "Expected few runs, got %zu", lsm_run_count(&set));
+
+    for (uint32_t v = 0; v < 2 * n + 10; v++)
+        ASSERTF(lsm_contains(&set, v) == (v % 2 == 0 && v < 2 * n), "Set disagrees about %u", v);
+
+    // Duplicates across the memtable and the runs come out once
+    checked_t checked = { .count = 0 };
+    ASSERT(lsm_range(&set, 0, UINT32_MAX, check_ascending, &checked) == n, "Expected n values");
+    ASSERT(checked.count == n, "Every value should be consumed once");
+    checked = (checked_t) { .count = 0 };
+    ASSERT(lsm_range(&set, 101, 120, check_ascending, &checked) == 10, "Expected 10 values");
+    ASSERT(checked.last == 120, "Range should end at 120");
+    ASSERT(lsm_range(&set, 20, 10, check_ascending, &checked) == 0, "Reversed range is empty");
+    ASSERT(lsm_close(&set), "Closing the set failed");
+    remove_dir(dir);
+}
+
+/* Reopening and compacting */
+void test_case_1(int argc, const char* argv[])
+{
+    printf("Starting test case 1\n");
+    const char* dir = "lsm_case_1";
+    remove_dir(dir);
+
+    lsm_set_t set;
+    ASSERT(lsm_open(&set, dir, 4096), "Creating the set failed");
+    for (uint32_t v = 0; v < 30000; v++)
+        lsm_add(&set, v * 3);
+    // The memtable is written as a run on close
+    ASSERT(lsm_close(&set), "Closing the set failed");
+
+    ASSERT(lsm_open(&set, dir, 4096), "Reopening the set failed");
+    ASSERT(lsm_run_count(&set) > 1, "Set should consist of several runs");
+    for (uint32_t v = 0; v < 90000; v += 7)
+        ASSERTF(lsm_contains(&set, v) == (v % 3 == 0), "Set disagrees about %u", v);
+    for (uint32_t v = 0; v < 30000; v++)
+        lsm_add(&set, v * 3 + 1);
+    ASSERT(lsm_compact(&set), "Compacting the set failed");
+    ASSERT(lsm_run_count(&set) == 1, "Compacted set should consist of one run");
+    ASSERT(set.runs[0].snapshot.count == 60000, "Compacted run should hold every value once");
+    ASSERT(lsm_compact(&set), "Compacting a compacted set should succeed");
+    ASSERT(lsm_close(&set), "Closing the set failed");
+
+    ASSERT(lsm_open(&set, dir, 4096), "Reopening the compacted set failed");
+    ASSERT(lsm_run_count(&set) == 1, "Only the compacted run should be left");
+    checked_t checked = { .count = 0 };
+    ASSERT(lsm_range(&set, 0, 89999, check_ascending, &checked) == 60000, "Expected all values");
+    ASSERT(lsm_contains(&set, 89998) && !lsm_contains(&set, 89999), "Wrong largest values");
+    ASSERT(lsm_close(&set), "Closing the set failed");
+    remove_dir(dir);
+}
+
+/* Leftovers of interrupted writes are ignored, corrupted runs are rejected */
+void test_case_2(int argc, const char* argv[])
+{
+    printf("Starting test case 2\n");
+    const char* dir = "lsm_case_2";
+    remove_dir(dir);
+
+    lsm_set_t set;
+    ASSERT(!lsm_open(&set, "missing_directory/lsm", 16), "Opening in a missing directory fails");
+    ASSERT(lsm_open(&set, dir, 100), "Creating the set failed");
+    for (uint32_t v = 0; v < 250; v++)
+        lsm_add(&set, v);
+    ASSERT(lsm_close(&set), "Closing the set failed");
+
+    FILE* file = fopen("lsm_case_2/run_0000000099.snap.tmp", "wb");
+    fputs("partial", file);
+    fclose(file);
+    ASSERT(lsm_open(&set, dir, 100), "Temporary files should be skipped");
+    ASSERT(lsm_contains(&set, 249), "Set should contain 249");
+    ASSERT(lsm_close(&set), "Closing the set failed");
+
+    // A run that isn't a valid snapshot makes the whole set unusable
+    file = fopen("lsm_case_2/run_0000000100.snap", "wb");
+    fputs("not a snapshot", file);
+    fclose(file);
+    ASSERT(!lsm_open(&set, dir, 100), "A corrupted run should be rejected");
+    remove_dir(dir);
+}
+
+/* Running out of memory while adding */
+void test_case_3(int argc, const char* argv[])
+{
+    printf("Starting test case 3\n");
+    const char* dir = "lsm_case_3";
+    remove_dir(dir);
+
+    lsm_set_t set;
+    ASSERT(lsm_open(&set, dir, 1000), "Creating the set failed");
+    failing_alloc_arm(0);
+    bool added = lsm_add(&set, 7);
+    failing_alloc_disarm();
+    ASSERT(!added, "Adding to a memtable that can't grow should fail");
+    ASSERT(!lsm_contains(&set, 7), "Failing to add 7 added it");
+
+    ASSERT(lsm_add(&set, 7), "Adding 7 failed");
+    failing_alloc_arm(0);
+    added = lsm_add(&set, 7);
+    failing_alloc_disarm();
+    ASSERT(added, "Adding a duplicate needs no memory and should succeed");
+    ASSERT(lsm_contains(&set, 7), "Set should contain 7");
+    ASSERT(lsm_close(&set), "Closing the set failed");
+    remove_dir(dir);
+}
+
+int main(int argc, const char* argv[])
+{
+    printf("Starting Test: LSMSetTester\n");
+    ASSERT(argc > 1, "Test executable needs more than one argument");
+    int test_num = atoi(argv[1]);
+    switch (test_num) {
+    case 0:
+        test_case_0(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 1:
+        test_case_1(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 2:
+        test_case_2(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 3:
+        test_case_3(argc, argv);
+        exit(EXIT_SUCCESS);
+    default:
+        ASSERTF(false, "Invalid test case number given %i", test_num);
+    }
+}
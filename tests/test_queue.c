@@ -0,0 +1,203 @@
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "queue.h"
+#include "utils/asserts.h"
+
+#define PRODUCERS 2
+#define CONSUMERS 2
+#define BATCH 16
+
+typedef struct worker {
+    mpmc_uint32_t* queue;
+    uint32_t id;
+    uint32_t count;
+    bool batched;
+    /**
+     * @brief Number of times each value was popped, shared by all consumers
+     */
+    _Atomic(uint8_t) * seen;
+    atomic_uint* popped;
+} worker_t;
+
+/* Testing Basic creation and usage */
+void test_case_0(int argc, const char* argv[])
+{
+    printf("Starting test case 0\n");
+
+    // Capacities are rounded up to powers of two
+    mpmc_uint32_t queue = mpmc_new_uint32_t(5);
+    ASSERT(mpmc_capacity_uint32_t(&queue) == 8, "Capacity should be rounded up to 8");
+    ASSERT(mpmc_is_empty_uint32_t(&queue), "Is empty should say queue is empty");
+    Result_uint32_t value_result = mpmc_try_pop_uint32_t(&queue);
+    ASSERT(Result_uint32_t_is_err(&value_result), "Popping an empty queue should fail");
+
+    // Filling the queue
+    for (uint32_t i = 0; i < 8; i++)
+        ASSERTF(mpmc_try_push_uint32_t(&queue, i), "Pushing %u should be possible", i);
+    ASSERT(!mpmc_try_push_uint32_t(&queue, 8), "Pushing into a full queue should fail");
+    ASSERT(mpmc_size_uint32_t(&queue) == 8, "Size of queue should be 8");
+
+    // Values come out in order, also after the positions wrapped around the ring
+    for (uint32_t round = 0; round < 5; round++) {
+        for (uint32_t i = 0; i < 8; i++) {
+            value_result = mpmc_try_pop_uint32_t(&queue);
+            ASSERTF(
+                Result_uint32_t_unwrap(&value_result) == 8 * round + i,
+                "Expected %u to be popped",
+                8 * round + i);
+            ASSERT(mpmc_try_push_uint32_t(&queue, 8 * (round + 1) + i), "Pushing should work");
+        }
+    }
+
+    // Batches are cut to what fits and what is there
+    uint32_t values[12];
+    ASSERT(mpmc_pop_batch_uint32_t(&queue, values, 3) == 3, "Popping 3 values should work");
+    ASSERT(values[0] == 40 && values[2] == 42, "Batch should be popped in order");
+    for (uint32_t i = 0; i < 12; i++)
+        values[i] = 100 + i;
+    ASSERT(mpmc_push_batch_uint32_t(&queue, values, 12) == 3, "Only 3 values should fit");
+    ASSERT(mpmc_push_batch_uint32_t(&queue, values, 12) == 0, "No value should fit");
+    ASSERT(mpmc_pop_batch_uint32_t(&queue, values, 12) == 8, "Only 8 values should be there");
+    ASSERT(values[2] == 45 && values[5] == 100 && values[7] == 102, "Batch out of order");
+    ASSERT(mpmc_is_empty_uint32_t(&queue), "Is empty should say queue is empty");
+
+    printf("Clearing queue\n");
+    mpmc_clear_uint32_t(&queue);
+    ASSERT(!mpmc_try_push_uint32_t(&queue, 1), "Pushing into a cleared queue should fail");
+}
+
+static void* producer(void* arg)
+{
+    worker_t* worker = arg;
+    uint32_t values[BATCH];
+    uint32_t next = worker->id * worker->count;
+    uint32_t end = next + worker->count;
+    while (next < end) {
+        if (worker->batched && next % 3 != 0) {
+            uint32_t count = (end - next < BATCH) ? end - next : BATCH;
+            for (uint32_t i = 0; i < count; i++)
+                values[i] = next + i;
+            size_t pushed = mpmc_push_batch_uint32_t(worker->queue, values, count);
+            next += pushed;
+            if (pushed == 0)
+                sched_yield();
+        } else if (mpmc_try_push_uint32_t(worker->queue, next)) {
+            next++;
+        } else {
+            // Lets the consumers run when there are fewer cores than threads
+            sched_yield();
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Records a popped value, checking that values of one producer come out in order
+ */
+static void record(worker_t* worker, uint32_t* last, const uint32_t value)
+{
+    uint32_t from = value / worker->count;
+    ASSERTF(from < PRODUCERS, "Popped value %u that was never pushed", value);
+    ASSERTF(last[from] == UINT32_MAX || last[from] < value, "Popped %u out of order", value);
+    last[from] = value;
+    atomic_fetch_add(&worker->seen[value], 1);
+    atomic_fetch_add(worker->popped, 1);
+}
+
+static void* consumer(void* arg)
+{
+    worker_t* worker = arg;
+    uint32_t values[BATCH];
+    uint32_t last[PRODUCERS] = { UINT32_MAX, UINT32_MAX };
+    uint32_t total = PRODUCERS * worker->count;
+    uint32_t round = 0;
+    while (atomic_load(worker->popped) < total) {
+        if (worker->batched && round++ % 2 == 0) {
+            size_t count = mpmc_pop_batch_uint32_t(worker->queue, values, BATCH);
+            for (size_t i = 0; i < count; i++)
+                record(worker, last, values[i]);
+            if (count == 0)
+                sched_yield();
+        } else {
+            Result_uint32_t value_result = mpmc_try_pop_uint32_t(worker->queue);
+            if (Result_uint32_t_is_ok(&value_result)) {
+                record(worker, last, Result_uint32_t_unwrap(&value_result));
+            } else {
+                sched_yield();
+            }
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Hands values from the producers to the consumers through a small queue
+ */
+static void run_handoff(const bool batched)
+{
+    const uint32_t N = 100000;
+    mpmc_uint32_t queue = mpmc_new_uint32_t(64);
+    _Atomic(uint8_t)* seen = calloc(PRODUCERS * N, sizeof(_Atomic(uint8_t)));
+    atomic_uint popped = 0;
+    pthread_t threads[PRODUCERS + CONSUMERS];
+    worker_t workers[PRODUCERS + CONSUMERS];
+
+    for (uint32_t i = 0; i < PRODUCERS + CONSUMERS; i++) {
+        workers[i] = (worker_t) {
+            .queue = &queue,
+            .id = (i < PRODUCERS) ? i : i - PRODUCERS,
+            .count = N,
+            .batched = batched,
+            .seen = seen,
+            .popped = &popped,
+        };
+        pthread_create(&threads[i], nullptr, (i < PRODUCERS) ? producer : consumer, &workers[i]);
+    }
+    for (int i = 0; i < PRODUCERS + CONSUMERS; i++)
+        pthread_join(threads[i], nullptr);
+
+    for (uint32_t value = 0; value < PRODUCERS * N; value++)
+        ASSERTF(atomic_load(&seen[value]) == 1, "Value %u was not popped exactly once", value);
+    ASSERT(mpmc_is_empty_uint32_t(&queue), "Is empty should say queue is empty");
+
+    free(seen);
+    mpmc_clear_uint32_t(&queue);
+}
+
+/* Producers and consumers pushing and popping single values */
+void test_case_1(int argc, const char* argv[])
+{
+    printf("Starting test case 1\n");
+    run_handoff(false);
+}
+
+/* Producers and consumers mixing batches and single values */
+void test_case_2(int argc, const char* argv[])
+{
+    printf("Starting test case 2\n");
+    run_handoff(true);
+}
+
+int main(int argc, const char* argv[])
+{
+    printf("Starting Test: QueueTester\n");
+    ASSERT(argc > 1, "Test executable needs more than one argument");
+    int test_num = atoi(argv[1]);
+    switch (test_num) {
+    case 0:
+        test_case_0(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 1:
+        test_case_1(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 2:
+        test_case_2(argc, argv);
+        exit(EXIT_SUCCESS);
+    default:
+        ASSERTF(false, "Invalid test case number given %i", test_num);
+    }
+}
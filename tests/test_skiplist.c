@@ -0,0 +1,225 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "skiplist.h"
+#include "utils/asserts.h"
+#include "utils/ebr.h"
+
+#define THREADS 4
+
+typedef struct worker {
+    csl_uint32_t* list;
+    uint32_t id;
+    uint32_t count;
+    /**
+     * @brief Successful adds minus successful deletes per value, filled in by the contended workers
+     */
+    int* net;
+} worker_t;
+
+typedef struct scan {
+    uint32_t last;
+    size_t count;
+    bool ascending;
+} scan_t;
+
+static void check_order(uint32_t value, void* ctx)
+{
+    scan_t* scan = ctx;
+    if (scan->count > 0 && value <= scan->last)
+        scan->ascending = false;
+    scan->last = value;
+    scan->count++;
+}
+
+/* Testing Basic creation and usage */
+void test_case_0(int argc, const char* argv[])
+{
+    printf("Starting test case 0\n");
+
+    // Basic initialization
+    csl_uint32_t list = csl_new_uint32_t();
+    ebr_thread_t* thread = ebr_register(&list.ebr);
+    ASSERT(csl_is_empty_uint32_t(&list), "Is empty should say list is empty");
+    Result_uint32_t value_result = csl_min_uint32_t(&list, thread);
+    ASSERT(Result_uint32_t_is_err(&value_result), "An empty list should have no minimum");
+    csl_print_uint32_t(&list);
+
+    // Adding
+    for (uint32_t i = 0; i < 1000; i++) {
+        uint32_t value = (i * 7919) % 1000 * 2;
+        ASSERTF(csl_add_value_uint32_t(&list, thread, value), "Adding %u should work", value);
+    }
+    ASSERT(!csl_add_value_uint32_t(&list, thread, 10), "Adding 10 twice should not be possible");
+    ASSERT(csl_size_uint32_t(&list) == 1000, "Size of list should be 1000");
+    ASSERT(csl_contains_uint32_t(&list, thread, 1998), "List should contain 1998");
+    ASSERT(!csl_contains_uint32_t(&list, thread, 11), "List should not contain 11");
+
+    // Ordered queries
+    value_result = csl_min_uint32_t(&list, thread);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == 0, "Minimum should be 0");
+    value_result = csl_lower_bound_uint32_t(&list, thread, 11);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == 12, "Lower bound of 11 should be 12");
+    value_result = csl_lower_bound_uint32_t(&list, thread, 1999);
+    ASSERT(Result_uint32_t_is_err(&value_result), "1999 should have no lower bound");
+
+    // Deleting
+    ASSERT(csl_del_value_uint32_t(&list, thread, 0), "Deleting 0 should be possible");
+    ASSERT(!csl_del_value_uint32_t(&list, thread, 0), "Deleting 0 twice should not be possible");
+    ASSERT(!csl_del_value_uint32_t(&list, thread, 1), "Deleting 1 should not be possible");
+    value_result = csl_min_uint32_t(&list, thread);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == 2, "Minimum should be 2 after deleting 0");
+
+    // Range scans
+    scan_t scan = { .ascending = true };
+    ASSERT(csl_range_uint32_t(&list, thread, 99, 201, check_order, &scan) == 51, "Expected 51");
+    ASSERT(scan.ascending && scan.last == 200, "Range should be scanned in order up to 200");
+    scan = (scan_t) { .ascending = true };
+    ASSERT(csl_range_uint32_t(&list, thread, 0, UINT32_MAX, check_order, &scan) == 999, "All");
+    ASSERT(scan.ascending, "Whole list should be scanned in order");
+    ASSERT(csl_range_uint32_t(&list, thread, 5, 1, check_order, &scan) == 0, "Empty range");
+
+    printf("Clearing list\n");
+    csl_clear_uint32_t(&list);
+}
+
+static void* disjoint_worker(void* arg)
+{
+    worker_t* worker = arg;
+    ebr_thread_t* thread = ebr_register(&worker->list->ebr);
+    for (uint32_t v = worker->id; v < worker->count; v += THREADS)
+        ASSERTF(csl_add_value_uint32_t(worker->list, thread, v), "Adding %u failed", v);
+    for (uint32_t v = worker->id; v < worker->count; v += THREADS) {
+        if (v % 2 == 1)
+            ASSERTF(csl_del_value_uint32_t(worker->list, thread, v), "Deleting %u failed", v);
+    }
+    for (uint32_t v = worker->id; v < worker->count; v += THREADS) {
+        ASSERTF(
+            csl_contains_uint32_t(worker->list, thread, v) == (v % 2 == 0),
+            "Unexpected membership of %u",
+            v);
+    }
+    ebr_unregister(thread);
+    return nullptr;
+}
+
+/* Threads adding and deleting interleaved values */
+void test_case_1(int argc, const char* argv[])
+{
+    printf("Starting test case 1\n");
+    const uint32_t N = 20000;
+    csl_uint32_t list = csl_new_uint32_t();
+    pthread_t threads[THREADS];
+    worker_t workers[THREADS];
+
+    for (uint32_t i = 0; i < THREADS; i++) {
+        workers[i] = (worker_t) { .list = &list, .id = i, .count = N, .net = nullptr };
+        pthread_create(&threads[i], nullptr, disjoint_worker, &workers[i]);
+    }
+    for (int i = 0; i < THREADS; i++)
+        pthread_join(threads[i], nullptr);
+
+    ebr_thread_t* thread = ebr_register(&list.ebr);
+    ASSERT(csl_size_uint32_t(&list) == N / 2, "Only the even values should be left");
+    scan_t scan = { .ascending = true };
+    csl_range_uint32_t(&list, thread, 0, N, check_order, &scan);
+    ASSERT(scan.ascending && scan.count == N / 2, "Even values should be scanned in order");
+    csl_clear_uint32_t(&list);
+}
+
+static void* contended_worker(void* arg)
+{
+    worker_t* worker = arg;
+    ebr_thread_t* thread = ebr_register(&worker->list->ebr);
+    uint32_t state = worker->id + 1;
+    for (uint32_t i = 0; i < worker->count; i++) {
+        // xorshift, since rand is not thread safe
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        uint32_t value = state % 256;
+        switch ((state >> 8) % 4) {
+        case 0:
+            worker->net[value] += csl_add_value_uint32_t(worker->list, thread, value);
+            break;
+        case 1:
+            worker->net[value] -= csl_del_value_uint32_t(worker->list, thread, value);
+            break;
+        case 2:
+            csl_contains_uint32_t(worker->list, thread, value);
+            break;
+        default: {
+            // Scans racing with writers still see every value at most once and in order
+            scan_t scan = { .ascending = true };
+            csl_range_uint32_t(worker->list, thread, value, value + 64, check_order, &scan);
+            ASSERT(scan.ascending, "Concurrent range scan went out of order");
+        }
+        }
+    }
+    ebr_unregister(thread);
+    return nullptr;
+}
+
+/* Threads adding, deleting and scanning the same few values */
+void test_case_2(int argc, const char* argv[])
+{
+    printf("Starting test case 2\n");
+    const uint32_t OPS = 40000;
+    csl_uint32_t list = csl_new_uint32_t();
+    pthread_t threads[THREADS];
+    worker_t workers[THREADS];
+
+    for (uint32_t i = 0; i < THREADS; i++) {
+        workers[i] = (worker_t) {
+            .list = &list,
+            .id = i,
+            .count = OPS,
+            .net = calloc(256, sizeof(int)),
+        };
+        pthread_create(&threads[i], nullptr, contended_worker, &workers[i]);
+    }
+    for (int i = 0; i < THREADS; i++)
+        pthread_join(threads[i], nullptr);
+
+    // Every value is in the list exactly if it was added once more than it was deleted
+    ebr_thread_t* thread = ebr_register(&list.ebr);
+    size_t expected_size = 0;
+    for (uint32_t v = 0; v < 256; v++) {
+        int net = 0;
+        for (int i = 0; i < THREADS; i++)
+            net += workers[i].net[v];
+        ASSERTF(net == 0 || net == 1, "Value %u was added %d times more than deleted", v, net);
+        ASSERTF(
+            csl_contains_uint32_t(&list, thread, v) == (net == 1),
+            "Unexpected membership of %u",
+            v);
+        expected_size += net;
+    }
+    ASSERT(csl_size_uint32_t(&list) == expected_size, "Unexpected size of list");
+    csl_print_uint32_t(&list);
+
+    for (int i = 0; i < THREADS; i++)
+        free(workers[i].net);
+    csl_clear_uint32_t(&list);
+}
+
+int main(int argc, const char* argv[])
+{
+    printf("Starting Test: SkipListTester\n");
+    ASSERT(argc > 1, "Test executable needs more than one argument");
+    int test_num = atoi(argv[1]);
+    switch (test_num) {
+    case 0:
+        test_case_0(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 1:
+        test_case_1(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 2:
+        test_case_2(argc, argv);
+        exit(EXIT_SUCCESS);
+    default:
+        ASSERTF(false, "Invalid test case number given %i", test_num);
+    }
+}
@@ -0,0 +1,214 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "snapshot.h"
+#include "utils/asserts.h"
+
+typedef struct collected {
+    uint32_t values[64];
+    size_t count;
+} collected_t;
+
+static void collect(uint32_t value, void* ctx)
+{
+    collected_t* collected = ctx;
+    if (collected->count < 64)
+        collected->values[collected->count] = value;
+    collected->count++;
+}
+
+/* Overwrites the byte at offset of the file at path */
+static void patch_file(const char* path, const long offset, const char byte)
+{
+    FILE* file = fopen(path, "r+b");
+    ASSERT(file != nullptr, "Opening the snapshot for patching failed");
+    fseek(file, offset, SEEK_SET);
+    fputc(byte, file);
+    fclose(file);
+}
+
+/* Tree snapshots */
+void test_case_0(int argc, const char* argv[])
+{
+    printf("Starting test case 0\n");
+    const char* path = "snapshot_case_0.bin";
+
+    // Values with duplicates, inserted in scrambled order
+    bt_uint32_t tree = bt_new_uint32_t();
+    for (uint32_t i = 0; i < 10000; i++)
+        bt_add_value_uint32_t(&tree, (uint32_t)((uint64_t)i * 2654435761u % 10000) / 2 * 3);
+    ASSERT(snapshot_save_bt(&tree, path), "Saving the tree failed");
+
+    snapshot_t snapshot;
+    ASSERT(snapshot_open(&snapshot, path), "Opening the tree snapshot failed");
+    ASSERT(snapshot.kind == SNAPSHOT_TREE, "Snapshot should hold a tree");
+    ASSERT(snapshot_size(&snapshot) == 10000, "Snapshot should hold 10000 values");
+    for (uint32_t v = 0; v < 15010; v++) {
+        ASSERTF(
+            snapshot_contains(&snapshot, v) == bt_contains_uint32_t(&tree, v),
+            "Snapshot disagrees with the tree about %u",
+            v);
+    }
+    Result_uint32_t value_result = snapshot_get(&snapshot, 4001);
+    Result_uint32_t expected = bt_select_uint32_t(&tree, 4001);
+    ASSERT(
+        Result_uint32_t_unwrap(&value_result) == Result_uint32_t_unwrap(&expected),
+        "Value 4001 of the snapshot should be the 4001st smallest value");
+    value_result = snapshot_get(&snapshot, 10000);
+    ASSERT(Result_uint32_t_is_err(&value_result), "Getting value 10000 should be out of range");
+    value_result = snapshot_lower_bound(&snapshot, 7);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == 9, "Lower bound of 7 should be 9");
+    value_result = snapshot_lower_bound(&snapshot, 15000);
+    ASSERT(Result_uint32_t_is_err(&value_result), "15000 should have no lower bound");
+
+    collected_t collected = { .count = 0 };
+    ASSERT(snapshot_range(&snapshot, 10, 20, collect, &collected) == 6, "Expected 6 values");
+    const uint32_t range[] = { 12, 12, 15, 15, 18, 18 };
+    for (size_t i = 0; i < 6; i++)
+        ASSERTF(collected.values[i] == range[i], "Expected %u in the range", range[i]);
+
+    // The snapshot outlives the tree and rebuilds it balanced
+    bt_clear_uint32_t(&tree);
+    bt_uint32_t rebuilt;
+    ASSERT(snapshot_to_bt(&snapshot, &rebuilt), "Rebuilding the tree failed");
+    ASSERT(bt_size_uint32_t(&rebuilt) == 10000, "Rebuilt tree should hold 10000 values");
+    ASSERT(bt_contains_uint32_t(&rebuilt, 14997), "Rebuilt tree should contain 14997");
+    bt_clear_uint32_t(&rebuilt);
+    snapshot_close(&snapshot);
+
+    // Empty trees give empty snapshots
+    ASSERT(snapshot_save_bt(&tree, path), "Saving the empty tree failed");
+    ASSERT(snapshot_open(&snapshot, path), "Opening the empty snapshot failed");
+    ASSERT(snapshot_size(&snapshot) == 0, "Empty snapshot should hold no values");
+    ASSERT(!snapshot_contains(&snapshot, 0), "Empty snapshot should contain nothing");
+    snapshot_close(&snapshot);
+    remove(path);
+}
+
+/* List snapshots */
+void test_case_1(int argc, const char* argv[])
+{
+    printf("Starting test case 1\n");
+    const char* path = "snapshot_case_1.bin";
+
+    ll_uint32_t list = ll_new_list_uint32_t();
+    for (uint32_t i = 0; i < 5000; i++)
+        ll_add_value_uint32_t(&list, (i * 7919) % 5000);
+    ASSERT(snapshot_save_ll(&list, path), "Saving the list failed");
+
+    snapshot_t snapshot;
+    ASSERT(snapshot_open(&snapshot, path), "Opening the list snapshot failed");
+    ASSERT(snapshot.kind == SNAPSHOT_LIST, "Snapshot should hold a list");
+    ASSERT(snapshot_size(&snapshot) == ll_length_uint32_t(&list), "Snapshot should hold 5000");
+    for (int i = 0; i < 5000; i += 37) {
+        Result_uint32_t value_result = snapshot_get(&snapshot, i);
+        Result_uint32_t expected = ll_get_uint32_t(&list, i);
+        ASSERTF(
+            Result_uint32_t_unwrap(&value_result) == Result_uint32_t_unwrap(&expected),
+            "Snapshot should keep the list order at %i",
+            i);
+    }
+    ASSERT(snapshot_contains(&snapshot, 4999), "Snapshot should contain 4999");
+    ASSERT(!snapshot_contains(&snapshot, 5000), "Snapshot should not contain 5000");
+    Result_uint32_t value_result = snapshot_lower_bound(&snapshot, 10);
+    ASSERT(Result_uint32_t_is_err(&value_result), "List snapshots have no lower bound");
+
+    // Ranges of lists come in list order
+    collected_t collected = { .count = 0 };
+    ASSERT(snapshot_range(&snapshot, 0, 9, collect, &collected) == 10, "Expected 10 values");
+    size_t i = 0;
+    for (ll_node_uint32_t* node = list.head; node != nullptr; node = node->next) {
+        if (node->value < 10)
+            ASSERTF(collected.values[i++] == node->value, "Expected %u in the range", node->value);
+    }
+    bt_uint32_t rebuilt;
+    ASSERT(!snapshot_to_bt(&snapshot, &rebuilt), "Lists should not be rebuilt as trees");
+    ASSERT(bt_is_empty_uint32_t(&rebuilt), "Failing to rebuild should give an empty tree");
+    snapshot_close(&snapshot);
+    ll_clear_list_uint32_t(&list);
+    remove(path);
+}
+
+/* Invalid snapshots are rejected */
+void test_case_2(int argc, const char* argv[])
+{
+    printf("Starting test case 2\n");
+    const char* path = "snapshot_case_2.bin";
+    snapshot_t snapshot = { .map = nullptr };
+
+    ASSERT(!snapshot_open(&snapshot, "does_not_exist.bin"), "Opening a missing file should fail");
+    bt_uint32_t tree = bt_new_uint32_t();
+    for (uint32_t v = 0; v < 100; v++)
+        bt_add_value_uint32_t(&tree, v);
+    ASSERT(
+        !snapshot_save_bt(&tree, "missing_directory/snapshot.bin"),
+        "Saving into a missing directory should fail");
+
+    // A flipped value breaks the checksum
+    ASSERT(snapshot_save_bt(&tree, path), "Saving the tree failed");
+    patch_file(path, sizeof(snapshot_header_t) + 4 * 50, 0x7f);
+    ASSERT(!snapshot_open(&snapshot, path), "A corrupted value should be detected");
+
+    // Unknown versions and foreign files
+    ASSERT(snapshot_save_bt(&tree, path), "Saving the tree failed");
+    patch_file(path, offsetof(snapshot_header_t, version), SNAPSHOT_VERSION + 1);
+    ASSERT(!snapshot_open(&snapshot, path), "An unknown version should be rejected");
+    ASSERT(snapshot_save_bt(&tree, path), "Saving the tree failed");
+    patch_file(path, 0, 'X');
+    ASSERT(!snapshot_open(&snapshot, path), "A wrong magic should be rejected");
+
+    // A truncated file doesn't match its count
+    ASSERT(snapshot_save_bt(&tree, path), "Saving the tree failed");
+    FILE* file = fopen(path, "r+b");
+    char buffer[sizeof(snapshot_header_t) + 4 * 10];
+    ASSERT(fread(buffer, 1, sizeof(buffer), file) == sizeof(buffer), "Reading the file failed");
+    fclose(file);
+    file = fopen(path, "wb");
+    fwrite(buffer, 1, sizeof(buffer), file);
+    fclose(file);
+    ASSERT(!snapshot_open(&snapshot, path), "A truncated file should be rejected");
+
+    // Tree values out of order fail the writer, and are rejected when a file holds them anyway
+    snapshot_writer_t* writer = snapshot_writer_open(path);
+    ASSERT(writer != nullptr, "Opening the writer failed");
+    snapshot_writer_add(writer, 5);
+    snapshot_writer_add(writer, 5);
+    snapshot_writer_add(writer, 3);
+    ASSERT(!snapshot_writer_close(writer), "Descending values should fail the writer");
+    ASSERT(!snapshot_open(&snapshot, path), "A failed writer shouldn't leave a file behind");
+    ll_uint32_t list = ll_new_list_uint32_t();
+    ll_add_value_uint32_t(&list, 7);
+    ll_add_value_uint32_t(&list, 2);
+    ASSERT(snapshot_save_ll(&list, path), "Saving the list failed");
+    ll_clear_list_uint32_t(&list);
+    patch_file(path, offsetof(snapshot_header_t, kind), SNAPSHOT_TREE);
+    ASSERT(!snapshot_open(&snapshot, path), "An unsorted tree snapshot should be rejected");
+
+    // Saving over an existing snapshot replaces it
+    ASSERT(snapshot_save_bt(&tree, path), "Saving the tree failed");
+    ASSERT(snapshot_open(&snapshot, path), "A fresh snapshot should open again");
+    ASSERT(snapshot_size(&snapshot) == 100, "Snapshot should hold 100 values");
+    snapshot_close(&snapshot);
+    bt_clear_uint32_t(&tree);
+    remove(path);
+}
+
+int main(int argc, const char* argv[])
+{
+    printf("Starting Test: SnapshotTester\n");
+    ASSERT(argc > 1, "Test executable needs more than one argument");
+    int test_num = atoi(argv[1]);
+    switch (test_num) {
+    case 0:
+        test_case_0(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 1:
+        test_case_1(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 2:
+        test_case_2(argc, argv);
+        exit(EXIT_SUCCESS);
+    default:
+        ASSERTF(false, "Invalid test case number given %i", test_num);
+    }
+}
@@ -0,0 +1,210 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "list.h"
+#include "tree.h"
+#include "utils/asserts.h"
+
+/* This tester is built with DS_STATS, its structures are instantiated in this translation unit */
+static void print_uint64(const uint64_t value)
+{
+    printf("%" PRIu64, value);
+}
+
+static void skip_value(const uint64_t value, void* ctx) { }
+
+B_TREE_DECLARE(uint64_t);
+B_TREE_DEFINE(uint64_t, B_TREE_DEFAULT_LESS, print_uint64)
+LL_DECLARE(uint64_t);
+LL_DEFINE(uint64_t, LL_DEFAULT_EQUALS, print_uint64)
+
+/* Tree counters of allocations, searches and comparisons */
+void test_case_0(int argc, const char* argv[])
+{
+    printf("Starting test case 0\n");
+    ASSERT(DS_STATS_ENABLED, "Tester should be built with DS_STATS");
+    const size_t node_bytes = sizeof(bt_node_uint64_t);
+
+    bt_uint64_t tree = bt_new_uint64_t();
+    for (uint64_t v = 0; v < 100; v++)
+        bt_add_value_uint64_t(&tree, (v * 37) % 100);
+    ds_stats_t stats = bt_stats_uint64_t(&tree);
+    ASSERT(stats.allocs == 100 && stats.frees == 0, "Every value should allocate one node");
+    ASSERT(stats.bytes == 100 * node_bytes, "Live bytes should be 100 nodes");
+    ASSERT(stats.peak_bytes == stats.bytes, "Peak should be the live bytes");
+
+    bt_stats_reset_uint64_t(&tree);
+    stats = bt_stats_uint64_t(&tree);
+    ASSERT(stats.searches == 0 && stats.comparisons == 0, "Reset should zero the counters");
+    ASSERT(stats.bytes == 100 * node_bytes, "Reset should keep the live bytes");
+
+    // A lookup visits the nodes on the path to the value and compares at most twice per node
+    size_t depths = 0;
+    for (uint64_t v = 0; v < 100; v++)
+        ASSERT(bt_contains_uint64_t(&tree, v), "Tree should contain every value");
+    stats = bt_stats_uint64_t(&tree);
+    ASSERTF(stats.searches == 100, "Expected 100 searches, got %" PRIu64, stats.searches);
+    size_t histogram[128];
+    size_t height = bt_depth_histogram_uint64_t(&tree, histogram, 128);
+    for (size_t d = 0; d < height; d++)
+        depths += (d + 1) * histogram[d];
+    ASSERTF(
+        stats.node_visits == depths,
+        "Expected %zu visits, got %" PRIu64,
+        depths,
+        stats.node_visits);
+    ASSERT(stats.comparisons >= depths && stats.comparisons <= 2 * depths, "Comparisons per visit");
+
+    // Ranges and batches count the comparisons after their descent as well
+    bt_stats_reset_uint64_t(&tree);
+    ASSERT(bt_range_uint64_t(&tree, 0, 99, skip_value, nullptr) == 100, "Range should hold 100");
+    ASSERT(bt_stats_uint64_t(&tree).comparisons > 100, "Range should compare every value");
+    bt_stats_reset_uint64_t(&tree);
+    bt_range_uint64_t(&tree, 42, 42, skip_value, nullptr);
+    const uint64_t range_comparisons = bt_stats_uint64_t(&tree).comparisons;
+    const uint64_t batch[1] = { 42 };
+    bool found[1];
+    bt_stats_reset_uint64_t(&tree);
+    bt_contains_batch_uint64_t(&tree, batch, 1, found);
+    ASSERT(found[0], "Batch should find 42");
+    // Both descend to the lower bound, then the range compares 42 and 43 and the batch only 42
+    ASSERTF(
+        bt_stats_uint64_t(&tree).comparisons == range_comparisons - 1,
+        "Expected %" PRIu64 " batch comparisons",
+        range_comparisons - 1);
+
+    ASSERT(bt_del_value_uint64_t(&tree, 50), "Deleting 50 failed");
+    stats = bt_stats_uint64_t(&tree);
+    ASSERT(stats.frees == 1 && stats.bytes == 99 * node_bytes, "Deleting should free one node");
+    bt_clear_uint64_t(&tree);
+    stats = bt_stats_uint64_t(&tree);
+    ASSERT(stats.frees == 100 && stats.bytes == 0, "Clearing should free every node");
+    ASSERT(stats.peak_bytes == 100 * node_bytes, "Peak should outlive clearing");
+
+    // Pooled trees release whole slabs and still account for every node
+    tree = bt_new_pooled_uint64_t();
+    for (uint64_t v = 0; v < 1000; v++)
+        bt_add_value_uint64_t(&tree, v);
+    ASSERT(bt_stats_uint64_t(&tree).bytes == 1000 * node_bytes, "Pooled nodes should count");
+    bt_clear_uint64_t(&tree);
+    stats = bt_stats_uint64_t(&tree);
+    ASSERT(stats.allocs == 1000 && stats.frees == 1000, "Pooled clear should free every node");
+}
+
+/* Height and depth histograms */
+void test_case_1(int argc, const char* argv[])
+{
+    printf("Starting test case 1\n");
+    bt_uint64_t tree = bt_new_uint64_t();
+    size_t histogram[8];
+    ASSERT(bt_height_uint64_t(&tree) == 0, "Empty tree should have height 0");
+    ASSERT(bt_depth_histogram_uint64_t(&tree, histogram, 8) == 0, "Empty tree has no depths");
+    ASSERT(histogram[0] == 0, "Histogram of the empty tree should be zeroed");
+
+    // Ascending insertions degenerate into a chain of 20 nodes
+    for (uint64_t v = 0; v < 20; v++)
+        bt_add_value_uint64_t(&tree, v);
+    ASSERT(bt_height_uint64_t(&tree) == 20, "Chain should be as high as it is long");
+    ASSERT(bt_depth_histogram_uint64_t(&tree, histogram, 8) == 20, "Height of the chain");
+    for (size_t d = 0; d < 7; d++)
+        ASSERTF(histogram[d] == 1, "Chain should have one node at depth %zu", d);
+    ASSERT(histogram[7] == 13, "The last bucket should count all deeper nodes");
+    bt_rebalance_uint64_t(&tree);
+    ASSERT(bt_height_uint64_t(&tree) == 5, "Rebalanced tree of 20 nodes should have height 5");
+    bt_clear_uint64_t(&tree);
+
+    // A perfect tree has 2^d nodes at depth d
+    uint64_t values[255];
+    for (size_t i = 0; i < 255; i++)
+        values[i] = i;
+    ASSERT(bt_build_from_sorted_uint64_t(&tree, values, 255), "Building the tree failed");
+    ASSERT(bt_depth_histogram_uint64_t(&tree, histogram, 8) == 8, "Perfect tree has height 8");
+    for (size_t d = 0; d < 8; d++)
+        ASSERTF(histogram[d] == (size_t)1 << d, "Wrong number of nodes at depth %zu", d);
+    ASSERT(bt_stats_uint64_t(&tree).allocs == 255, "Building should count its nodes");
+
+    // The JSON report holds the shape and the counters
+    FILE* file = tmpfile();
+    ASSERT(file != nullptr, "Creating a temporary file failed");
+    ASSERT(bt_stats_write_json_uint64_t(&tree, file), "Writing the JSON report failed");
+    char json[1024] = { 0 };
+    rewind(file);
+    ASSERT(fread(json, 1, sizeof(json) - 1, file) > 0, "Reading the JSON report failed");
+    fclose(file);
+    ASSERTF(strstr(json, "\"size\": 255, \"height\": 8") != nullptr, "Wrong shape in %s", json);
+    ASSERTF(strstr(json, "\"depths\": [1, 2, 4, 8, 16, 32, 64, 128]") != nullptr, "Wrong depths");
+    ASSERTF(strstr(json, "\"avg_depth\": 7.031") != nullptr, "Wrong average depth in %s", json);
+    ASSERTF(strstr(json, "\"allocs\": 255") != nullptr, "Wrong counters in %s", json);
+    ASSERT(strstr(json, "\"stats_enabled\": true}\n") != nullptr, "Report should end the line");
+    bt_clear_uint64_t(&tree);
+}
+
+/* List counters */
+void test_case_2(int argc, const char* argv[])
+{
+    printf("Starting test case 2\n");
+    const size_t node_bytes = sizeof(ll_node_uint64_t);
+    ll_uint64_t list = ll_new_list_uint64_t();
+    for (uint64_t v = 0; v < 10; v++)
+        ll_add_value_uint64_t(&list, v);
+    ds_stats_t stats = ll_stats_uint64_t(&list);
+    ASSERT(stats.allocs == 10 && stats.bytes == 10 * node_bytes, "Every value should be a node");
+
+    // Deleting 4 compares the head, then walks up to it comparing every node twice
+    ll_stats_reset_uint64_t(&list);
+    ASSERT(ll_del_value_uint64_t(&list, 4), "Deleting 4 failed");
+    stats = ll_stats_uint64_t(&list);
+    ASSERT(stats.searches == 1, "Deleting should search once");
+    ASSERTF(stats.node_visits == 5, "Expected 5 visits, got %" PRIu64, stats.node_visits);
+    ASSERTF(stats.comparisons == 11, "Expected 11 comparisons, got %" PRIu64, stats.comparisons);
+    ASSERT(stats.frees == 1 && stats.bytes == 9 * node_bytes, "Deleting should free one node");
+
+    ll_stats_reset_uint64_t(&list);
+    ASSERT(ll_get_uint64_t(&list, 3).value == 3, "Value at index 3 should be 3");
+    stats = ll_stats_uint64_t(&list);
+    ASSERT(stats.searches == 1, "Getting should search once");
+    ASSERT(stats.node_visits == 9 + 4, "Getting walks the length and then the index");
+
+    ll_clear_list_uint64_t(&list);
+    stats = ll_stats_uint64_t(&list);
+    ASSERT(stats.frees == 9 && stats.bytes == 0, "Clearing should free the 9 nodes left");
+
+    list = ll_new_pooled_list_uint64_t();
+    for (uint64_t v = 0; v < 100; v++)
+        ll_add_value_uint64_t(&list, v);
+    ll_pop_value_uint64_t(&list);
+    ll_clear_list_uint64_t(&list);
+    stats = ll_stats_uint64_t(&list);
+    ASSERT(stats.allocs == 100 && stats.frees == 100, "Pooled list should free every node");
+
+    FILE* file = tmpfile();
+    ASSERT(file != nullptr, "Creating a temporary file failed");
+    ASSERT(ds_stats_write_json(&stats, file), "Writing the counters failed");
+    char json[512] = { 0 };
+    rewind(file);
+    ASSERT(fread(json, 1, sizeof(json) - 1, file) > 0, "Reading the counters failed");
+    fclose(file);
+    ASSERTF(strstr(json, "\"frees\": 100, \"bytes\": 0") != nullptr, "Wrong counters %s", json);
+}
+
+int main(int argc, const char* argv[])
+{
+    printf("Starting Test: StatsTester\n");
+    ASSERT(argc > 1, "Test executable needs more than one argument");
+    int test_num = atoi(argv[1]);
+    switch (test_num) {
+    case 0:
+        test_case_0(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 1:
+        test_case_1(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 2:
+        test_case_2(argc, argv);
+        exit(EXIT_SUCCESS);
+    default:
+        ASSERTF(false, "Invalid test case number given %i", test_num);
+    }
+}
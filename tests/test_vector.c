@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "utils/asserts.h"
+#include "vector.h"
+
+/* Testing Basic creation and usage */
+void test_case_0(int argc, const char* argv[])
+{
+    printf("Starting test case 0\n");
+
+    // Basic initialization
+    vec_uint32_t vec = vec_new_uint32_t();
+    ASSERT(vec.data == nullptr && vec.capacity == 0, "Initialization failed");
+    ASSERT(vec_is_empty_uint32_t(&vec), "Is empty should say vector is empty");
+    vec_print_uint32_t(&vec);
+
+    // Append
+    vec_push_uint32_t(&vec, 123);
+    vec_push_uint32_t(&vec, 321);
+    vec_push_uint32_t(&vec, 111);
+    vec_push_uint32_t(&vec, 0);
+    vec_print_uint32_t(&vec);
+    ASSERT(vec_length_uint32_t(&vec) == 4, "We should have a vector length of 4");
+
+    // Get and Set
+    Result_uint32_t value_result = vec_get_uint32_t(&vec, 2);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == 111, "Expected value 111 at index 2");
+    ASSERT(vec_set_uint32_t(&vec, 2, 31), "Setting was not successfull");
+    value_result = vec_get_uint32_t(&vec, 2);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == 31, "Expected value 31 at index 2");
+    value_result = vec_get_uint32_t(&vec, 4);
+    ASSERT(Result_uint32_t_is_err(&value_result), "We should have an out of range exception");
+    ASSERT(!vec_set_uint32_t(&vec, 4, 1), "Setting out of range should fail");
+
+    // Insert and erase
+    ASSERT(vec_insert_uint32_t(&vec, 0, 7), "Inserting at the front should be possible");
+    ASSERT(vec_insert_uint32_t(&vec, 5, 8), "Inserting at the end should be possible");
+    ASSERT(!vec_insert_uint32_t(&vec, 7, 9), "Inserting behind the end should fail");
+    vec_print_uint32_t(&vec);
+    ASSERT(vec_erase_uint32_t(&vec, 1), "Erasing index 1 should be possible");
+    ASSERT(!vec_erase_uint32_t(&vec, 5), "Erasing out of range should fail");
+    const uint32_t expected[] = { 7, 321, 31, 0, 8 };
+    for (size_t i = 0; i < 5; i++) {
+        value_result = vec_get_uint32_t(&vec, i);
+        ASSERTF(
+            Result_uint32_t_unwrap(&value_result) == expected[i],
+            "Expected value %u at index %zu",
+            expected[i],
+            i);
+    }
+
+    // Pop
+    value_result = vec_pop_uint32_t(&vec);
+    ASSERT(Result_uint32_t_unwrap(&value_result) == 8, "Expected value 8 after popping");
+
+    // Reserve and shrink
+    ASSERT(vec_reserve_uint32_t(&vec, 100), "Reserving should be possible");
+    ASSERT(vec.capacity >= 100, "Capacity should be at least 100 after reserving");
+    ASSERT(vec_shrink_uint32_t(&vec), "Shrinking should be possible");
+    ASSERT(vec.capacity == 4, "Capacity should match the length after shrinking");
+
+    printf("Clearing vector\n");
+    vec_clear_uint32_t(&vec);
+    ASSERT(vec_is_empty_uint32_t(&vec), "Is empty should say vector is empty");
+    value_result = vec_pop_uint32_t(&vec);
+    ASSERT(Result_uint32_t_is_err(&value_result), "Popping an empty vector should give an error");
+}
+
+/* Testing find and count against a scalar reference */
+void test_case_1(int argc, const char* argv[])
+{
+    printf("Starting test case 1\n");
+    const uint32_t N = 1000003;
+    vec_uint32_t vec = vec_new_uint32_t();
+
+    printf("Adding %u numbers to vector\n", N);
+    for (uint32_t i = 0; i < N; i++) {
+        vec_push_uint32_t(&vec, i % 1000);
+    }
+    ASSERTF(vec_length_uint32_t(&vec) == N, "We should have a vector length of %u", N);
+
+    // Every value below 1000 first appears at its own index, whatever the lane it falls into
+    for (uint32_t value = 0; value < 1000; value++) {
+        Result_uint64_t idx_result = vec_find_uint32_t(&vec, value);
+        ASSERTF(Result_uint64_t_unwrap(&idx_result) == value, "Expected %u at its index", value);
+        size_t expected = N / 1000 + (value < N % 1000);
+        ASSERTF(
+            vec_count_uint32_t(&vec, value) == expected,
+            "Expected %zu appearances of %u",
+            expected,
+            value);
+    }
+    Result_uint64_t idx_result = vec_find_uint32_t(&vec, 1000);
+    ASSERT(Result_uint64_t_is_err(&idx_result), "1000 should not be found");
+    ASSERT(vec_count_uint32_t(&vec, 1000) == 0, "1000 should not be counted");
+
+    // Values only in the scalar tail
+    vec_set_uint32_t(&vec, N - 1, 5000);
+    idx_result = vec_find_uint32_t(&vec, 5000);
+    ASSERT(Result_uint64_t_unwrap(&idx_result) == N - 1, "5000 should be found at the end");
+
+    printf("Clearing...\n");
+    vec_clear_uint32_t(&vec);
+}
+
+int main(int argc, const char* argv[])
+{
+    printf("Starting Test: VectorTester\n");
+    ASSERT(argc > 1, "Test executable needs more than one argument");
+    int test_num = atoi(argv[1]);
+    switch (test_num) {
+    case 0:
+        test_case_0(argc, argv);
+        exit(EXIT_SUCCESS);
+    case 1:
+        test_case_1(argc, argv);
+        exit(EXIT_SUCCESS);
+    default:
+        ASSERTF(false, "Invalid test case number given %i", test_num);
+    }
+}
@@ -0,0 +1,33 @@
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "failing_alloc.h"
+
+void* __real_malloc(size_t size);
+
+static bool armed = false;
+static size_t successes_left = 0;
+
+void failing_alloc_arm(size_t successes)
+{
+    successes_left = successes;
+    armed = true;
+}
+
+void failing_alloc_disarm()
+{
+    armed = false;
+}
+
+/**
+ * @brief: Every malloc of the tester and the libraries linked into it lands here
+ */
+void* __wrap_malloc(size_t size)
+{
+    if (armed) {
+        if (successes_left == 0)
+            return nullptr;
+        successes_left--;
+    }
+    return __real_malloc(size);
+}
@@ -0,0 +1,12 @@
+#include <stddef.h>
+
+/**
+ * @brief: Lets the next successes calls of malloc succeed and fails every call after them
+ * @details: Only takes effect in testers linked with -Wl,--wrap=malloc and failing_alloc_test
+ */
+void failing_alloc_arm(size_t successes);
+
+/**
+ * @brief: Lets every call of malloc succeed again
+ */
+void failing_alloc_disarm();